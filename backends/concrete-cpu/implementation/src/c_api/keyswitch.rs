@@ -1,4 +1,5 @@
 use concrete_csprng::generators::SoftwareRandomGenerator;
+use tfhe::core_crypto::commons::math::decomposition::SignedDecomposer;
 use tfhe::core_crypto::commons::math::random::{CompressionSeed, Seed};
 use tfhe::core_crypto::prelude::*;
 
@@ -183,33 +184,107 @@ pub unsafe extern "C" fn concrete_cpu_keyswitch_lwe_ciphertext_u64(
     output_dimension: usize,
 ) {
     nounwind(|| {
-        let mut ct_out = LweCiphertext::from_container(
-            core::slice::from_raw_parts_mut(ct_out, output_dimension + 1),
-            CiphertextModulus::new_native(),
-        );
-        let ct_in = LweCiphertext::from_container(
-            core::slice::from_raw_parts(ct_in, input_dimension + 1),
-            CiphertextModulus::new_native(),
+        let ct_out = core::slice::from_raw_parts_mut(ct_out, output_dimension + 1);
+        let ct_in = core::slice::from_raw_parts(ct_in, input_dimension + 1);
+        let keyswitch_key = core::slice::from_raw_parts(
+            keyswitch_key,
+            concrete_cpu_keyswitch_key_size_u64(
+                decomposition_level_count,
+                input_dimension,
+                output_dimension,
+            ),
         );
 
-        let keyswitch_key = LweKeyswitchKey::from_container(
-            core::slice::from_raw_parts(
+        // The level counts chosen by the optimizer are small, so the kernel
+        // is specialized on them
+        let base_log = decomposition_base_log;
+        match decomposition_level_count {
+            1 => keyswitch_fused::<1>(ct_out, ct_in, keyswitch_key, base_log),
+            2 => keyswitch_fused::<2>(ct_out, ct_in, keyswitch_key, base_log),
+            3 => keyswitch_fused::<3>(ct_out, ct_in, keyswitch_key, base_log),
+            4 => keyswitch_fused::<4>(ct_out, ct_in, keyswitch_key, base_log),
+            5 => keyswitch_fused::<5>(ct_out, ct_in, keyswitch_key, base_log),
+            6 => keyswitch_fused::<6>(ct_out, ct_in, keyswitch_key, base_log),
+            7 => keyswitch_fused::<7>(ct_out, ct_in, keyswitch_key, base_log),
+            8 => keyswitch_fused::<8>(ct_out, ct_in, keyswitch_key, base_log),
+            _ => keyswitch_generic(
+                ct_out,
+                ct_in,
                 keyswitch_key,
-                concrete_cpu_keyswitch_key_size_u64(
-                    decomposition_level_count,
-                    input_dimension,
-                    output_dimension,
-                ),
+                decomposition_level_count,
+                base_log,
             ),
-            DecompositionBaseLog(decomposition_base_log),
-            DecompositionLevelCount(decomposition_level_count),
-            LweDimension(output_dimension).to_lwe_size(),
-            CiphertextModulus::new_native(),
-        );
-        keyswitch_lwe_ciphertext(&keyswitch_key, &ct_in, &mut ct_out);
+        }
     })
 }
 
+/// Keyswitches `ct_in` into `ct_out` with a key of `LEVELS` decomposition
+/// levels. The products of all the levels of an input coefficient are summed
+/// before being subtracted from the output, which is thus traversed once per
+/// input coefficient rather than once per level.
+fn keyswitch_fused<const LEVELS: usize>(
+    ct_out: &mut [u64],
+    ct_in: &[u64],
+    keyswitch_key: &[u64],
+    decomposition_base_log: usize,
+) {
+    let output_size = ct_out.len();
+    let (mask, body) = ct_in.split_at(ct_in.len() - 1);
+
+    ct_out.fill(0);
+    ct_out[output_size - 1] = body[0];
+
+    let decomposer = SignedDecomposer::<u64>::new(
+        DecompositionBaseLog(decomposition_base_log),
+        DecompositionLevelCount(LEVELS),
+    );
+
+    for (block, &mask_element) in keyswitch_key.chunks_exact(LEVELS * output_size).zip(mask) {
+        // The decomposition starts from the least significant level, whose
+        // key ciphertext is the last one of the block
+        let mut digits = [0u64; LEVELS];
+        for (digit, term) in digits
+            .iter_mut()
+            .rev()
+            .zip(decomposer.decompose(mask_element))
+        {
+            *digit = term.value();
+        }
+
+        let levels: [&[u64]; LEVELS] =
+            core::array::from_fn(|l| &block[l * output_size..(l + 1) * output_size]);
+
+        for (j, out) in ct_out.iter_mut().enumerate() {
+            let mut sum = 0u64;
+            for l in 0..LEVELS {
+                sum = sum.wrapping_add(levels[l][j].wrapping_mul(digits[l]));
+            }
+            *out = out.wrapping_sub(sum);
+        }
+    }
+}
+
+fn keyswitch_generic(
+    ct_out: &mut [u64],
+    ct_in: &[u64],
+    keyswitch_key: &[u64],
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+) {
+    let output_size = ct_out.len();
+    let mut ct_out = LweCiphertext::from_container(ct_out, CiphertextModulus::new_native());
+    let ct_in = LweCiphertext::from_container(ct_in, CiphertextModulus::new_native());
+
+    let keyswitch_key = LweKeyswitchKey::from_container(
+        keyswitch_key,
+        DecompositionBaseLog(decomposition_base_log),
+        DecompositionLevelCount(decomposition_level_count),
+        LweSize(output_size),
+        CiphertextModulus::new_native(),
+    );
+    keyswitch_lwe_ciphertext(&keyswitch_key, &ct_in, &mut ct_out);
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_keyswitch_key_size_u64(
     decomposition_level_count: usize,
@@ -233,3 +308,67 @@ pub unsafe extern "C" fn concrete_cpu_seeded_keyswitch_key_size_u64(
             decomposition_level_count,
         ))
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const INPUT_DIMENSION: usize = 10;
+    const OUTPUT_DIMENSION: usize = 7;
+
+    fn random_vec(len: usize, seed: u64) -> Vec<u64> {
+        let mut state = seed.wrapping_mul(0x9e37_79b9_7f4a_7c15) | 1;
+        (0..len)
+            .map(|_| {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                state
+            })
+            .collect()
+    }
+
+    fn keyswitch(level_count: usize, base_log: usize, seed: u64) -> (Vec<u64>, Vec<u64>) {
+        let key_size = unsafe {
+            concrete_cpu_keyswitch_key_size_u64(level_count, INPUT_DIMENSION, OUTPUT_DIMENSION)
+        };
+        let keyswitch_key = random_vec(key_size, seed);
+        let ct_in = random_vec(INPUT_DIMENSION + 1, seed + 1);
+
+        let mut expected = vec![0u64; OUTPUT_DIMENSION + 1];
+        keyswitch_generic(&mut expected, &ct_in, &keyswitch_key, level_count, base_log);
+
+        let mut actual = vec![0u64; OUTPUT_DIMENSION + 1];
+        unsafe {
+            concrete_cpu_keyswitch_lwe_ciphertext_u64(
+                actual.as_mut_ptr(),
+                ct_in.as_ptr(),
+                keyswitch_key.as_ptr(),
+                level_count,
+                base_log,
+                INPUT_DIMENSION,
+                OUTPUT_DIMENSION,
+            );
+        }
+        (expected, actual)
+    }
+
+    #[test]
+    fn test_specialized_keyswitch_matches_generic() {
+        for level_count in 1..=8 {
+            for base_log in [1, 3, 48 / level_count] {
+                let (expected, actual) = keyswitch(level_count, base_log, level_count as u64);
+                assert_eq!(
+                    actual, expected,
+                    "levels {level_count}, base log {base_log}"
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn test_keyswitch_falls_back_to_generic() {
+        let (expected, actual) = keyswitch(10, 2, 42);
+        assert_eq!(actual, expected);
+    }
+}
@@ -1,11 +1,17 @@
 use super::utils::nounwind;
-use core::slice;
+use core::ptr;
+
+// The output of the linear operations may be one of their inputs, so that they can be computed in
+// place. Each word of the output only depends on the words at the same index in the inputs, so
+// the kernels work on raw pointers and read these words before writing the output one, instead of
+// building slices that would alias.
 
 /// # Safety
 ///
-/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and must not alias
-/// `[ct_in0, ct_in0 + lwe_dimension + 1[` or `[ct_in1, ct_in1 + lwe_dimension + 1[`, both of which
-/// must be valid ranges for reads.
+/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and
+/// `[ct_in0, ct_in0 + lwe_dimension + 1[` and `[ct_in1, ct_in1 + lwe_dimension + 1[` must be valid
+/// ranges for reads. `ct_out` may be equal to `ct_in0` and/or `ct_in1`, but must not otherwise
+/// overlap them.
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_add_lwe_ciphertext_u64(
     ct_out: *mut u64,
@@ -15,27 +21,29 @@ pub unsafe extern "C" fn concrete_cpu_add_lwe_ciphertext_u64(
 ) {
     nounwind(|| {
         #[inline]
-        fn implementation(ct_out: &mut [u64], ct_in0: &[u64], ct_in1: &[u64]) {
-            for ((out, &c0), &c1) in ct_out.iter_mut().zip(ct_in0).zip(ct_in1) {
-                *out = c0.wrapping_add(c1)
+        unsafe fn implementation(
+            ct_out: *mut u64,
+            ct_in0: *const u64,
+            ct_in1: *const u64,
+            lwe_size: usize,
+        ) {
+            for i in 0..lwe_size {
+                let c0 = ptr::read(ct_in0.add(i));
+                let c1 = ptr::read(ct_in1.add(i));
+                ptr::write(ct_out.add(i), c0.wrapping_add(c1));
             }
         }
 
         let lwe_size = lwe_dimension + 1;
-        pulp::Arch::new().dispatch(|| {
-            implementation(
-                slice::from_raw_parts_mut(ct_out, lwe_size),
-                slice::from_raw_parts(ct_in0, lwe_size),
-                slice::from_raw_parts(ct_in1, lwe_size),
-            )
-        });
+        pulp::Arch::new().dispatch(|| implementation(ct_out, ct_in0, ct_in1, lwe_size));
     })
 }
 
 /// # Safety
 ///
-/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and must not alias
-/// `[ct_in, ct_in + lwe_dimension + 1[`, which must be a valid range for reads.
+/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and
+/// `[ct_in, ct_in + lwe_dimension + 1[` must be a valid range for reads. `ct_out` may be equal to
+/// `ct_in`, but must not otherwise overlap it.
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_add_plaintext_lwe_ciphertext_u64(
     ct_out: *mut u64,
@@ -45,29 +53,29 @@ pub unsafe extern "C" fn concrete_cpu_add_plaintext_lwe_ciphertext_u64(
 ) {
     nounwind(|| {
         #[inline]
-        fn implementation(ct_out: &mut [u64], ct_in: &[u64], plaintext: u64) {
-            ct_out.copy_from_slice(ct_in);
-
-            let last = ct_out.last_mut().unwrap();
+        unsafe fn implementation(
+            ct_out: *mut u64,
+            ct_in: *const u64,
+            plaintext: u64,
+            lwe_dimension: usize,
+        ) {
+            if ct_out as *const u64 != ct_in {
+                ptr::copy_nonoverlapping(ct_in, ct_out, lwe_dimension);
+            }
 
-            *last = last.wrapping_add(plaintext);
+            let body = ptr::read(ct_in.add(lwe_dimension));
+            ptr::write(ct_out.add(lwe_dimension), body.wrapping_add(plaintext));
         }
 
-        let lwe_size = lwe_dimension + 1;
-        pulp::Arch::new().dispatch(|| {
-            implementation(
-                slice::from_raw_parts_mut(ct_out, lwe_size),
-                slice::from_raw_parts(ct_in, lwe_size),
-                plaintext,
-            )
-        });
+        pulp::Arch::new().dispatch(|| implementation(ct_out, ct_in, plaintext, lwe_dimension));
     })
 }
 
 /// # Safety
 ///
-/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and must not alias
-/// `[ct_in, ct_in + lwe_dimension + 1[`, which must be a valid range for reads.
+/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and
+/// `[ct_in, ct_in + lwe_dimension + 1[` must be a valid range for reads. `ct_out` may be equal to
+/// `ct_in`, but must not otherwise overlap it.
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_mul_cleartext_lwe_ciphertext_u64(
     ct_out: *mut u64,
@@ -77,27 +85,28 @@ pub unsafe extern "C" fn concrete_cpu_mul_cleartext_lwe_ciphertext_u64(
 ) {
     nounwind(|| {
         #[inline]
-        fn implementation(ct_out: &mut [u64], ct_in: &[u64], cleartext: u64) {
-            for (out, &c) in ct_out.iter_mut().zip(ct_in) {
-                *out = c.wrapping_mul(cleartext)
+        unsafe fn implementation(
+            ct_out: *mut u64,
+            ct_in: *const u64,
+            cleartext: u64,
+            lwe_size: usize,
+        ) {
+            for i in 0..lwe_size {
+                let c = ptr::read(ct_in.add(i));
+                ptr::write(ct_out.add(i), c.wrapping_mul(cleartext));
             }
         }
 
         let lwe_size = lwe_dimension + 1;
-        pulp::Arch::new().dispatch(|| {
-            implementation(
-                slice::from_raw_parts_mut(ct_out, lwe_size),
-                slice::from_raw_parts(ct_in, lwe_size),
-                cleartext,
-            )
-        });
+        pulp::Arch::new().dispatch(|| implementation(ct_out, ct_in, cleartext, lwe_size));
     })
 }
 
 /// # Safety
 ///
-/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and must not alias
-/// `[ct_in, ct_in + lwe_dimension + 1[`, which must be a valid range for reads.
+/// `[ct_out, ct_out + lwe_dimension + 1[` must be a valid mutable range, and
+/// `[ct_in, ct_in + lwe_dimension + 1[` must be a valid range for reads. `ct_out` may be equal to
+/// `ct_in`, but must not otherwise overlap it.
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_negate_lwe_ciphertext_u64(
     ct_out: *mut u64,
@@ -106,19 +115,130 @@ pub unsafe extern "C" fn concrete_cpu_negate_lwe_ciphertext_u64(
 ) {
     nounwind(|| {
         #[inline]
-        fn implementation(ct_out: &mut [u64], ct_in: &[u64]) {
-            for (out, &c) in ct_out.iter_mut().zip(ct_in) {
-                *out = c.wrapping_neg();
+        unsafe fn implementation(ct_out: *mut u64, ct_in: *const u64, lwe_size: usize) {
+            for i in 0..lwe_size {
+                let c = ptr::read(ct_in.add(i));
+                ptr::write(ct_out.add(i), c.wrapping_neg());
             }
         }
 
         let lwe_size = lwe_dimension + 1;
-
-        pulp::Arch::new().dispatch(|| {
-            implementation(
-                slice::from_raw_parts_mut(ct_out, lwe_size),
-                slice::from_raw_parts(ct_in, lwe_size),
-            )
-        });
+        pulp::Arch::new().dispatch(|| implementation(ct_out, ct_in, lwe_size));
     })
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const LWE_DIMENSION: usize = 4;
+
+    fn ciphertext(seed: u64) -> Vec<u64> {
+        (0..LWE_DIMENSION as u64 + 1)
+            .map(|i| seed.wrapping_mul(0x9e37_79b9_7f4a_7c15).wrapping_add(i))
+            .collect()
+    }
+
+    #[test]
+    fn test_add_in_place() {
+        let ct0 = ciphertext(1);
+        let ct1 = ciphertext(2);
+        let mut expected = vec![0; LWE_DIMENSION + 1];
+        let mut out = ct0.clone();
+        unsafe {
+            concrete_cpu_add_lwe_ciphertext_u64(
+                expected.as_mut_ptr(),
+                ct0.as_ptr(),
+                ct1.as_ptr(),
+                LWE_DIMENSION,
+            );
+            concrete_cpu_add_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                out.as_ptr(),
+                ct1.as_ptr(),
+                LWE_DIMENSION,
+            );
+        }
+        assert_eq!(out, expected);
+
+        // Doubling, both inputs being the output
+        let mut out = ct0.clone();
+        unsafe {
+            concrete_cpu_add_lwe_ciphertext_u64(
+                expected.as_mut_ptr(),
+                ct0.as_ptr(),
+                ct0.as_ptr(),
+                LWE_DIMENSION,
+            );
+            concrete_cpu_add_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                out.as_ptr(),
+                out.as_ptr(),
+                LWE_DIMENSION,
+            );
+        }
+        assert_eq!(out, expected);
+    }
+
+    #[test]
+    fn test_add_plaintext_in_place() {
+        let ct = ciphertext(3);
+        let mut expected = vec![0; LWE_DIMENSION + 1];
+        let mut out = ct.clone();
+        unsafe {
+            concrete_cpu_add_plaintext_lwe_ciphertext_u64(
+                expected.as_mut_ptr(),
+                ct.as_ptr(),
+                42,
+                LWE_DIMENSION,
+            );
+            concrete_cpu_add_plaintext_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                out.as_ptr(),
+                42,
+                LWE_DIMENSION,
+            );
+        }
+        assert_eq!(expected[..LWE_DIMENSION], ct[..LWE_DIMENSION]);
+        assert_eq!(expected[LWE_DIMENSION], ct[LWE_DIMENSION].wrapping_add(42));
+        assert_eq!(out, expected);
+    }
+
+    #[test]
+    fn test_mul_cleartext_in_place() {
+        let ct = ciphertext(4);
+        let mut expected = vec![0; LWE_DIMENSION + 1];
+        let mut out = ct.clone();
+        unsafe {
+            concrete_cpu_mul_cleartext_lwe_ciphertext_u64(
+                expected.as_mut_ptr(),
+                ct.as_ptr(),
+                7,
+                LWE_DIMENSION,
+            );
+            concrete_cpu_mul_cleartext_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                out.as_ptr(),
+                7,
+                LWE_DIMENSION,
+            );
+        }
+        assert_eq!(out, expected);
+    }
+
+    #[test]
+    fn test_negate_in_place() {
+        let ct = ciphertext(5);
+        let mut expected = vec![0; LWE_DIMENSION + 1];
+        let mut out = ct.clone();
+        unsafe {
+            concrete_cpu_negate_lwe_ciphertext_u64(
+                expected.as_mut_ptr(),
+                ct.as_ptr(),
+                LWE_DIMENSION,
+            );
+            concrete_cpu_negate_lwe_ciphertext_u64(out.as_mut_ptr(), out.as_ptr(), LWE_DIMENSION);
+        }
+        assert_eq!(out, expected);
+    }
+}
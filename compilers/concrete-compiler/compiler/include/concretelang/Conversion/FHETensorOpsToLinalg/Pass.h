@@ -12,9 +12,13 @@
 namespace mlir {
 namespace concretelang {
 /// Create a pass to convert `FHE` tensor operators to linal.generic
-/// operators.
+/// operators. If `lowerMatmulToGemm` is set, products of matrices of
+/// encrypted integers by matrices of clear integers and dot products are
+/// left to `FHELinalg.matmul_eint_int` operations, and 2D convolutions to
+/// `FHELinalg.conv2d` operations without bias, lowered to a single kernel
+/// call by the scalar lowering of `FHE` to `TFHE`.
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
-createConvertFHETensorOpsToLinalg();
+createConvertFHETensorOpsToLinalg(bool lowerMatmulToGemm = false);
 } // namespace concretelang
 } // namespace mlir
 
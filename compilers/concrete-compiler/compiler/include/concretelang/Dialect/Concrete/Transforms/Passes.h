@@ -6,14 +6,23 @@
 #ifndef CONCRETELANG_DIALECT_CONCRETE_TRANSFORMS_PASSES_H_
 #define CONCRETELANG_DIALECT_CONCRETE_TRANSFORMS_PASSES_H_
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Pass/Pass.h"
 
+#include "concretelang/Dialect/RT/IR/RTDialect.h"
+
 #define GEN_PASS_CLASSES
 #include "concretelang/Dialect/Concrete/Transforms/Passes.h.inc"
 
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<OperationPass<ModuleOp>> createAddRuntimeContext();
+std::unique_ptr<OperationPass<ModuleOp>> createPoolCiphertextBuffersPass();
+std::unique_ptr<OperationPass<ModuleOp>> createFuseLeveledOpsPass();
+std::unique_ptr<OperationPass<ModuleOp>>
+createFuseBatchedOpsPass(uint64_t cacheSize = 1024 * 1024);
 } // namespace concretelang
 } // namespace mlir
 
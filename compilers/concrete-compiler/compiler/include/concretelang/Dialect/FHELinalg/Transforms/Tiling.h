@@ -14,9 +14,24 @@
 
 namespace mlir {
 namespace concretelang {
+
+/// Characteristics of the execution target used to choose tile sizes
+/// automatically.
+struct FHELinalgTilingTarget {
+  /// Size in bytes of a ciphertext
+  uint64_t ciphertextSize;
+  /// Size in bytes of the cache the working set of a tile should fit in
+  uint64_t cacheSize;
+  /// Number of threads among which the tiles are distributed
+  uint64_t numThreads;
+};
+
 std::unique_ptr<mlir::OperationPass<>>
 createFHELinalgTilingMarkerPass(llvm::ArrayRef<int64_t> tileSizes);
 
+std::unique_ptr<mlir::OperationPass<>>
+createFHELinalgAutoTilingMarkerPass(FHELinalgTilingTarget target);
+
 std::unique_ptr<mlir::OperationPass<>> createFHELinalgTilingPass();
 } // namespace concretelang
 } // namespace mlir
@@ -18,7 +18,7 @@ class RewritePatternSet;
 
 namespace concretelang {
 std::unique_ptr<mlir::Pass>
-createBuildDataflowTaskGraphPass(bool debug = false);
+createBuildDataflowTaskGraphPass(bool debug = false, uint64_t granularity = 0);
 std::unique_ptr<mlir::Pass> createLowerDataflowTasksPass(bool debug = false);
 std::unique_ptr<mlir::Pass>
 createBufferizeDataflowTaskOpsPass(bool debug = false);
@@ -0,0 +1,85 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_BUFFER_POOL_H
+#define CONCRETELANG_RUNTIME_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+/// Statistics of a `BufferPool`.
+typedef struct BufferPoolStats {
+  /// Number of buffers requested from the pool.
+  uint64_t allocations = 0;
+  /// Number of requests served with a cached buffer.
+  uint64_t cacheHits = 0;
+  /// Number of bytes of the buffers currently cached by the pool.
+  uint64_t bytesCached = 0;
+  /// Highest number of bytes simultaneously handed out by the pool.
+  uint64_t highWaterMark = 0;
+} BufferPoolStats;
+
+/// A pool of the buffers allocated by compiled circuits for their
+/// ciphertexts. Sizes repeat endlessly during an execution (one or a batch
+/// of lwe_dim+1 words), so released buffers are cached per size class and
+/// handed out again instead of going back to the system allocator. Each
+/// thread has its own cache, which keeps the pool lock-free except the first
+/// time a thread uses it.
+class BufferPool {
+public:
+  /// Alignment of the buffers, and granularity of the size classes.
+  static constexpr size_t alignment = 64;
+  /// Maximum number of buffers cached per size class and per thread.
+  static constexpr size_t maxCachedBuffers = 256;
+
+  BufferPool();
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+  ~BufferPool();
+
+  /// Returns a buffer of at least `size` bytes.
+  void *allocate(size_t size);
+
+  /// Releases a buffer obtained with `allocate(size)`, possibly from
+  /// another thread.
+  void release(void *buffer, size_t size);
+
+  BufferPoolStats getStats() const;
+
+private:
+  struct ThreadCache {
+    std::unordered_map<size_t, std::vector<void *>> freeBuffers;
+  };
+
+  ThreadCache &getThreadCache();
+
+  /// Identifies the pool in the thread local caches, unlike its address
+  /// which may be reused by a later pool.
+  const uint64_t id;
+
+  std::mutex mutex;
+  std::unordered_map<std::thread::id, std::unique_ptr<ThreadCache>>
+      threadCaches;
+
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> cacheHits{0};
+  std::atomic<uint64_t> bytesCached{0};
+  std::atomic<uint64_t> bytesInUse{0};
+  std::atomic<uint64_t> highWaterMark{0};
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
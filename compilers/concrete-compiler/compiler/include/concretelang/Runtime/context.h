@@ -9,9 +9,11 @@
 #include "concrete-cpu.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keysets.h"
+#include "concretelang/Runtime/buffer_pool.h"
 #include <assert.h>
 #include <complex>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <pthread.h>
 #include <vector>
@@ -38,10 +40,53 @@ typedef struct FFT {
   size_t polynomial_size;
 } FFT;
 
+/// Size and alignment of the scratch of a bootstrap with a given bootstrap
+/// key.
+typedef struct BootstrapScratch {
+  size_t size;
+  size_t align;
+} BootstrapScratch;
+
+/// The keys of a server keyset prepared for the computations: each bootstrap
+/// key converted to the fourier domain, with its fft and the scratch
+/// requirements of its bootstraps.
+struct PreparedKeyset {
+  PreparedKeyset(ServerKeyset serverKeyset);
+
+  std::vector<std::shared_ptr<std::vector<std::complex<double>>>>
+      fourier_bootstrap_keys;
+  std::vector<FFT> ffts;
+  std::vector<BootstrapScratch> bootstrap_scratches;
+};
+
+/// Caches the prepared keys of the last keyset used by a program, so that its
+/// successive calls with the same keys prepare them only once.
+class PreparedKeysetCache {
+public:
+  /// Returns the prepared keys of `serverKeyset`, which are only prepared
+  /// when its bootstrap keys differ from the ones of the previous call.
+  std::shared_ptr<const PreparedKeyset> get(const ServerKeyset &serverKeyset);
+
+private:
+  std::mutex mutex;
+  // Keeps the buffers of the cached keys alive, so that their addresses
+  // cannot be reused by other keys and identify them
+  ServerKeyset keyset;
+  std::shared_ptr<const PreparedKeyset> prepared;
+};
+
 typedef struct RuntimeContext {
 
   RuntimeContext() = delete;
-  RuntimeContext(ServerKeyset serverKeyset);
+  /// Creates the context of a call with the keys of `serverKeyset`. The
+  /// ciphertext buffers of the call come from `bufferPool`, which may be
+  /// shared by the successive calls of a program so that the buffers cached
+  /// by one call serve the next ones. The keys are prepared for the call,
+  /// unless `preparedKeyset` already holds them.
+  RuntimeContext(
+      ServerKeyset serverKeyset,
+      std::shared_ptr<BufferPool> bufferPool = std::make_shared<BufferPool>(),
+      std::shared_ptr<const PreparedKeyset> preparedKeyset = nullptr);
   ~RuntimeContext() {
 #ifdef CONCRETELANG_CUDA_SUPPORT
     for (int i = 0; i < num_devices; ++i) {
@@ -58,22 +103,33 @@ typedef struct RuntimeContext {
   }
 
   const std::complex<double> *fourier_bootstrap_key_buffer(size_t keyId) {
-    return fourier_bootstrap_keys[keyId]->data();
+    return preparedKeyset->fourier_bootstrap_keys[keyId]->data();
   }
 
   const uint64_t *fp_keyswitch_key_buffer(size_t keyId) {
     return serverKeyset.packingKeyswitchKeys[keyId].getRawPtr();
   }
 
-  const struct Fft *fft(size_t keyId) { return ffts[keyId].fft; }
+  const struct Fft *fft(size_t keyId) {
+    return preparedKeyset->ffts[keyId].fft;
+  }
+
+  /// Scratch requirements of the bootstraps with the bootstrap key `keyId`,
+  /// which only depend on its parameters and are computed along with its
+  /// fourier form.
+  const BootstrapScratch &bootstrap_scratch(size_t keyId) {
+    return preparedKeyset->bootstrap_scratches[keyId];
+  }
 
   const ServerKeyset getKeys() const { return serverKeyset; }
 
+  /// Pool of the ciphertext buffers allocated by the circuit.
+  BufferPool &buffer_pool() { return *bufferPool; }
+
 private:
   ServerKeyset serverKeyset;
-  std::vector<std::shared_ptr<std::vector<std::complex<double>>>>
-      fourier_bootstrap_keys;
-  std::vector<FFT> ffts;
+  std::shared_ptr<BufferPool> bufferPool;
+  std::shared_ptr<const PreparedKeyset> preparedKeyset;
 
 #ifdef CONCRETELANG_CUDA_SUPPORT
 public:
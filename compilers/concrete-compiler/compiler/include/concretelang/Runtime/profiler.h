@@ -0,0 +1,34 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_PROFILER_H
+#define CONCRETELANG_RUNTIME_PROFILER_H
+
+#include <stdint.h>
+
+/// Entry points of the profiler of the runtime calls, inserted by the
+/// compiler around each call site with `--profile-runtime-calls`. Each
+/// thread records its calls in its own buffers without any lock, the dumps
+/// swapping them atomically.
+extern "C" {
+
+/// Returns the timestamp of the start of a profiled call.
+uint64_t concrete_profile_start();
+
+/// Records a call started at `start`. `site` points to the name of the
+/// called operation followed by the location of the call site, as two
+/// consecutive null-terminated strings.
+void concrete_profile_record(uint64_t start, char *site);
+
+/// Appends the calls recorded since the last dump to a Chrome trace in the
+/// file named by the `CONCRETE_PROFILE_OUTPUT` environment variable, or
+/// `concrete-profile.json` if unset. The file is created by the first dump of
+/// the process. The total time per operation and call site of all the dumped
+/// calls is written to the same path with a `.folded` suffix, in the folded
+/// stacks format of flame graphs.
+void concrete_profile_dump();
+}
+
+#endif
@@ -0,0 +1,62 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_SCRATCH_POOL_H
+#define CONCRETELANG_RUNTIME_SCRATCH_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace mlir {
+namespace concretelang {
+
+/// A pool of aligned scratch buffers, so that the large fft scratch of the
+/// bootstraps and of the wop-pbs steps is reused across calls instead of
+/// being allocated for each of them. Buffers are handed out to a single user
+/// at a time, which allows concurrent calls. The pool retains at most
+/// `maxRetainedBytes` of released buffers, the least recently released ones
+/// being freed first.
+class ScratchPool {
+public:
+  struct Scratch {
+    uint8_t *ptr;
+    size_t size;
+    size_t align;
+  };
+
+  /// Default bound of the bytes retained by the pool.
+  static constexpr size_t defaultMaxRetainedBytes = size_t(256) << 20;
+
+  /// Returns the pool shared by the runtime, whose bound is set by
+  /// `CONCRETE_SCRATCH_POOL_MAX_BYTES`.
+  static ScratchPool &instance();
+
+  explicit ScratchPool(size_t maxRetainedBytes = defaultMaxRetainedBytes);
+  ScratchPool(const ScratchPool &) = delete;
+  ScratchPool &operator=(const ScratchPool &) = delete;
+  ~ScratchPool();
+
+  /// Returns a buffer of at least `size` bytes aligned on `align`.
+  Scratch acquire(size_t size, size_t align);
+
+  /// Gives a buffer back to the pool.
+  void release(Scratch scratch);
+
+  /// Number of bytes of the buffers currently retained by the pool.
+  size_t retainedBytes();
+
+private:
+  const size_t maxRetainedBytes;
+  std::mutex mutex;
+  std::deque<Scratch> available;
+  size_t retained = 0;
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
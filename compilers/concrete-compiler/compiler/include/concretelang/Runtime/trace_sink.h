@@ -0,0 +1,67 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_TRACE_SINK_H
+#define CONCRETELANG_RUNTIME_TRACE_SINK_H
+
+#include <cstdint>
+
+namespace mlir {
+namespace concretelang {
+namespace trace {
+
+/// Binary sink of the values traced by the Tracing dialect, enabled by
+/// setting the `CONCRETE_TRACE_FILE` environment variable to the path of
+/// the trace. Each thread appends its records to its own chunk without any
+/// lock, and full chunks are written to the file by a background thread
+/// before being recycled. The trace is decoded offline by
+/// `concrete-trace-decoder`.
+///
+/// The file starts with `TRACE_MAGIC`, followed by records made of a
+/// `RecordHeader` and, for `STRING` records, the `length` bytes of the
+/// string. A message is written once per thread as a `STRING` record
+/// defining its identifier, then referred to by this identifier.
+
+constexpr char TRACE_MAGIC[8] = {'C', 'C', 'T', 'R', 'A', 'C', 'E', '1'};
+
+enum class RecordKind : uint8_t {
+  CIPHERTEXT = 0,
+  PLAINTEXT = 1,
+  MESSAGE = 2,
+  STRING = 3,
+};
+
+struct __attribute__((packed)) RecordHeader {
+  uint8_t kind;
+  /// Position of the most significant bit of the message, after which a
+  /// space is printed
+  uint8_t msb;
+  /// Number of bits of the value
+  uint8_t width;
+  uint8_t reserved;
+  /// Index of the thread in the order of their first record
+  uint32_t thread;
+  /// Identifier of the message of the record, or defined by a `STRING`
+  /// record
+  uint32_t stringId;
+  /// Length of the string of a `STRING` record
+  uint32_t length;
+  /// Nanoseconds since the opening of the trace
+  uint64_t timestamp;
+  /// Body of the ciphertext or plaintext
+  uint64_t value;
+};
+
+/// Appends a record of `value` with the message `message` of `messageLength`
+/// bytes to the binary trace. Returns false if the binary trace is not
+/// enabled.
+bool appendRecord(RecordKind kind, uint64_t value, uint8_t width, uint8_t msb,
+                  const char *message, uint32_t messageLength);
+
+} // namespace trace
+} // namespace concretelang
+} // namespace mlir
+
+#endif
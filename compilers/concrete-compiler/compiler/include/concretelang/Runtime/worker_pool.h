@@ -0,0 +1,63 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_WORKER_POOL_H
+#define CONCRETELANG_RUNTIME_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+/// A process-wide pool of threads running the independent parts of the
+/// runtime operators (e.g. the rows of a matmul or the wop-pbs of a batch),
+/// so that their threads are created once instead of on each call.
+///
+/// The calling thread takes part in the work, so a call completes even when
+/// all the workers are busy with other calls. Calls made from the work of
+/// another call, or from an OpenMP parallel region, run sequentially on their
+/// thread, as the parallelism is already exploited by the enclosing region.
+class WorkerPool {
+public:
+  /// Returns the pool shared by the runtime, with one worker per hardware
+  /// thread besides the calling one.
+  static WorkerPool &instance();
+
+  explicit WorkerPool(size_t numWorkers);
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+  ~WorkerPool();
+
+  /// Number of threads that may run the tasks of a call, including the
+  /// calling one, or 1 when called from a parallel region.
+  size_t concurrency() const;
+
+  /// Runs `task(i)` for each `i` in [0, count) and waits for their
+  /// completion.
+  void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+private:
+  struct Job;
+
+  void work();
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::shared_ptr<Job>> queue;
+  std::vector<std::thread> workers;
+  bool stopping = false;
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -7,6 +7,7 @@
 #define CONCRETELANG_RUNTIME_WRAPPERS_H
 
 #include "concretelang/Runtime/context.h"
+#include "concretelang/Runtime/leveled_wrappers.h"
 
 extern "C" {
 
@@ -50,31 +51,6 @@ void memref_encode_plaintext_with_crt(
     uint64_t mods_offset, uint64_t output_lut_size, uint64_t mods_stride,
     uint64_t mods_product);
 
-void memref_add_lwe_ciphertexts_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, uint64_t *ct1_allocated, uint64_t *ct1_aligned,
-    uint64_t ct1_offset, uint64_t ct1_size, uint64_t ct1_stride);
-
-void memref_add_plaintext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, uint64_t plaintext);
-
-void memref_mul_cleartext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, uint64_t cleartext);
-
-void memref_negate_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride);
-
 void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
                               uint64_t out_offset, uint64_t out_size,
                               uint64_t out_stride, uint64_t *ct0_allocated,
@@ -85,53 +61,32 @@ void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
                               uint32_t ksk_index,
                               mlir::concretelang::RuntimeContext *context);
 
-void memref_batched_add_lwe_ciphertexts_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
-    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size0,
-    uint64_t ct1_size1, uint64_t ct1_stride0, uint64_t ct1_stride1);
-
-void memref_batched_add_plaintext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
-    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
-    uint64_t ct1_stride);
-
-void memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t plaintext);
-
-void memref_batched_mul_cleartext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
-    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
-    uint64_t ct1_stride);
-
-void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
+void memref_matmul_cleartext_lwe_ciphertext_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext);
-
-void memref_batched_negate_lwe_ciphertext_u64(
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_size2,
+    uint64_t out_stride0, uint64_t out_stride1, uint64_t out_stride2,
+    uint64_t *ct0_allocated, uint64_t *ct0_aligned, uint64_t ct0_offset,
+    uint64_t ct0_size0, uint64_t ct0_size1, uint64_t ct0_size2,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t ct0_stride2,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1);
+
+void memref_conv2d_cleartext_lwe_ciphertext_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_size2,
+    uint64_t out_size3, uint64_t out_size4, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t out_stride2, uint64_t out_stride3,
+    uint64_t out_stride4, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1);
+    uint64_t ct0_size2, uint64_t ct0_size3, uint64_t ct0_size4,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t ct0_stride2,
+    uint64_t ct0_stride3, uint64_t ct0_stride4, uint64_t *weight_allocated,
+    uint64_t *weight_aligned, uint64_t weight_offset, uint64_t weight_size0,
+    uint64_t weight_size1, uint64_t weight_size2, uint64_t weight_size3,
+    uint64_t weight_stride0, uint64_t weight_stride1, uint64_t weight_stride2,
+    uint64_t weight_stride3, uint64_t stride_h, uint64_t stride_w,
+    uint64_t dilation_h, uint64_t dilation_w, uint64_t group);
 
 void memref_batched_keyswitch_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
@@ -227,12 +182,49 @@ void memref_wop_pbs_crt_buffer(
     // runtime context that hold evluation keys
     mlir::concretelang::RuntimeContext *context);
 
+void memref_batched_wop_pbs_crt_buffer(
+    // Output 3D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_size_2,
+    uint64_t out_stride_0, uint64_t out_stride_1, uint64_t out_stride_2,
+    // Input 3D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_size_2,
+    uint64_t in_stride_0, uint64_t in_stride_1, uint64_t in_stride_2,
+    // clear text lut
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_size, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key indices
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evluation keys
+    mlir::concretelang::RuntimeContext *context);
+
 void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
                           uint64_t src_offset, uint64_t src_size,
                           uint64_t src_stride, uint64_t *dst_allocated,
                           uint64_t *dst_aligned, uint64_t dst_offset,
                           uint64_t dst_size, uint64_t dst_stride);
 
+/// \brief Allocate a buffer of `size` bytes from the buffer pool of the
+/// runtime context.
+uint64_t *memref_pool_alloc_u64(size_t size,
+                                mlir::concretelang::RuntimeContext *context);
+
+/// \brief Release a buffer allocated with `memref_pool_alloc_u64` to the
+/// buffer pool of the runtime context.
+void memref_pool_free_u64(uint64_t *buffer, size_t size,
+                          mlir::concretelang::RuntimeContext *context);
+
 // Single ciphertext CUDA functions ///////////////////////////////////////////
 
 /// \brief Run Keyswitch on GPU.
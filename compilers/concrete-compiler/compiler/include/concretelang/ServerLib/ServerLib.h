@@ -13,6 +13,7 @@
 #include "concretelang/Common/Protocol.h"
 #include "concretelang/Common/Transformers.h"
 #include "concretelang/Common/Values.h"
+#include "concretelang/Runtime/buffer_pool.h"
 #include "llvm/ADT/ArrayRef.h"
 #include <cassert>
 #include <dlfcn.h>
@@ -26,6 +27,12 @@ using concretelang::transformers::ReturnTransformer;
 using concretelang::transformers::TransformerFactory;
 using concretelang::values::Value;
 
+namespace mlir {
+namespace concretelang {
+class PreparedKeysetCache;
+} // namespace concretelang
+} // namespace mlir
+
 namespace concretelang {
 namespace serverlib {
 
@@ -38,8 +45,18 @@ public:
   static Result<std::shared_ptr<DynamicModule>>
   open(const std::string &outputPath);
 
+  /// Creates a dynamic module whose symbols are resolved by `lookup`, e.g.,
+  /// in code compiled in memory that `lookup` keeps alive. `lookup` returns
+  /// a null pointer for unknown symbols.
+  static std::shared_ptr<DynamicModule>
+  fromSymbolLookup(std::function<void *(const std::string &)> lookup);
+
 private:
-  void *libraryHandle;
+  /// Returns the address of the symbol `name`.
+  Result<void *> getSymbol(const std::string &name);
+
+  void *libraryHandle = nullptr;
+  std::function<void *(const std::string &)> lookup;
 };
 
 class ServerCircuit {
@@ -56,12 +73,19 @@ public:
   /// Returns the name of this circuit.
   std::string getName();
 
+  /// Returns the statistics of the ciphertext buffer pool, which is shared
+  /// by the circuits of the program and accumulates over their calls.
+  mlir::concretelang::BufferPoolStats getBufferPoolStats();
+
 private:
   ServerCircuit() = default;
 
   static Result<ServerCircuit>
   fromDynamicModule(const Message<concreteprotocol::CircuitInfo> &circuitInfo,
                     std::shared_ptr<DynamicModule> dynamicModule,
+                    std::shared_ptr<mlir::concretelang::BufferPool> bufferPool,
+                    std::shared_ptr<mlir::concretelang::PreparedKeysetCache>
+                        preparedKeysets,
                     bool useSimulation);
 
   void invoke(const ServerKeyset &serverKeyset);
@@ -78,6 +102,8 @@ private:
   std::vector<size_t> returnDescriptorSizes;
   size_t argRawSize;
   size_t returnRawSize;
+  std::shared_ptr<mlir::concretelang::BufferPool> bufferPool;
+  std::shared_ptr<mlir::concretelang::PreparedKeysetCache> preparedKeysets;
 };
 
 /// ServerProgram contains multiple
@@ -88,6 +114,11 @@ public:
   load(const Message<concreteprotocol::ProgramInfo> &programInfo,
        const std::string &outputPath, bool useSimulation);
 
+  /// Loads a server program from an already opened dynamic module.
+  static Result<ServerProgram>
+  load(const Message<concreteprotocol::ProgramInfo> &programInfo,
+       std::shared_ptr<DynamicModule> dynamicModule, bool useSimulation);
+
   Result<ServerCircuit> getServerCircuit(const std::string &circuitName);
 
 private:
@@ -0,0 +1,49 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_BENCH_H
+#define CONCRETELANG_SUPPORT_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "concretelang/Support/CompilerEngine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/JSON.h"
+
+namespace mlir {
+namespace concretelang {
+
+struct BenchOptions {
+  /// Name of the circuit to run, the first circuit of the program if empty.
+  std::string circuitName;
+  /// Number of measured calls of the circuit.
+  size_t iterations = 10;
+  /// Number of concurrent callers for the measurement of the throughput.
+  size_t concurrency = 1;
+  /// Directory of the keyset cache. The keyset is generated at each run if
+  /// empty.
+  std::string keysetCachePath;
+  /// Seed of the random inputs.
+  uint64_t seed = 0;
+  /// Run the simulated circuit, without keys nor encryption.
+  bool simulate = false;
+};
+
+/// Runs the circuit of `library`, whose shared library and program info
+/// have been emitted, on random inputs matching its gates, and returns a
+/// JSON report of the keyset generation time, the latency percentiles of
+/// the encryption, execution and decryption, the throughput of the
+/// execution with `options.concurrency` callers and the peak resident set
+/// size of the process.
+llvm::Expected<llvm::json::Object>
+benchLibrary(const CompilerEngine::Library &library,
+             const BenchOptions &options);
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -49,8 +49,15 @@ struct Statistic {
 };
 
 struct CompilationFeedback {
+  /// @brief complexity of the objective minimized by the optimizer
   double complexity;
 
+  /// @brief cost minimized by the optimizer, "total-work" or "latency"
+  std::string optimizerObjective = "total-work";
+
+  /// @brief number of cores of the latency objective, 0 for the total work
+  uint64_t optimizerCores = 0;
+
   /// @brief Probability of error for every PBS.
   double pError;
 
@@ -81,9 +88,33 @@ struct CompilationFeedback {
   /// @brief memory usage per location
   std::map<std::string, int64_t> memoryUsagePerLoc;
 
+  /// @brief peak number of bytes of the buffers simultaneously allocated by
+  /// the circuit
+  int64_t peakMemoryUsage = 0;
+
+  /// @brief number of bootstraps of the longest chain of dependent
+  /// bootstraps
+  uint64_t pbsCriticalPath = 0;
+
+  /// @brief number of independent bootstraps at each depth of the critical
+  /// path, the first element being the bootstraps of the inputs
+  std::vector<uint64_t> pbsWidthProfile;
+
+  /// @brief number of cores of the runtime prediction
+  uint64_t predictionCores = 0;
+
+  /// @brief predicted runtime of the bootstraps on `predictionCores` cores,
+  /// in bootstrap latencies
+  uint64_t predictedPbsRounds = 0;
+
   /// Fill the sizes from the program info.
   void fillFromProgramInfo(const Message<protocol::ProgramInfo> &params);
 
+  /// Predict the runtime of the bootstraps on `cores` cores from the width
+  /// profile, the bootstraps of a depth running in rounds of `cores`
+  /// bootstraps.
+  void predictRuntime(uint64_t cores);
+
   /// Load the compilation feedback from a path
   static outcome::checked<CompilationFeedback, StringError>
   load(std::string path);
@@ -68,9 +68,37 @@ struct CompilationOptions {
   bool loopParallelize;
   bool batchTFHEOps;
   int64_t maxBatchSize;
+  /// Emit a remark for each batched operation, each loop split into
+  /// chunks fitting `maxBatchSize` and each batchable operation left in a
+  /// loop with the reason why it could not be batched.
+  bool batchingReport;
+  /// Stream the batched leveled operations, keyswitches and bootstraps
+  /// feeding each other through chunks of the batch fitting in the cache,
+  /// instead of materializing the intermediate batches. Ignored when
+  /// generating GPU or SDFG operations.
+  bool fuseBatchedOps;
+  /// Size in bytes of the cache targeted by `fuseBatchedOps`. The cache
+  /// size of the host is used if 0.
+  uint64_t fusedBatchCacheSize;
   bool emitSDFGOps;
   bool unrollLoopsWithSDFGConvertibleOps;
   bool dataflowParallelize;
+  /// Target number of programmable bootstraps per dataflow task. Small
+  /// tasks are merged and large linalg generics are split to
+  /// approach this target. A value of 0 keeps one task per candidate
+  /// operation.
+  uint64_t dataflowTaskGranularity;
+  /// Reuse statically-shaped buffers whose lifetimes do not overlap
+  /// instead of allocating fresh ones. Ignored when generating dataflow
+  /// tasks or SDFG operations.
+  bool staticMemoryPlanning;
+  /// Allocate the ciphertext buffers from the buffer pool of the runtime
+  /// context instead of malloc. Ignored when generating dataflow tasks.
+  bool poolCiphertextBuffers;
+  /// Compute encrypted matrix and dot products, and 2D convolutions, with a
+  /// single call to the cleartext-ciphertext gemm kernel of the runtime
+  /// instead of loops of scalar multiplications and additions.
+  bool lowerMatmulToGemm;
   bool optimizeTFHE;
   /// simulate crypto operations
   bool simulate;
@@ -78,10 +106,25 @@ struct CompilationOptions {
   bool emitGPUOps;
 
   std::optional<std::vector<int64_t>> fhelinalgTileSizes;
+  /// Choose the tile sizes of FHELinalg operations from the size of the
+  /// ciphertexts, the cache size and the number of threads. Ignored if
+  /// `fhelinalgTileSizes` is set.
+  bool fhelinalgAutoTiling;
+  /// Size in bytes of the cache targeted by the automatic tiling. The
+  /// cache size of the host is used if 0.
+  uint64_t fhelinalgTilingCacheSize;
 
   std::optional<std::string> mainFuncName;
 
   optimizer::Config optimizerConfig;
+  /// Directory of the persistent cache of the multi-parameter solutions of
+  /// the optimizer, keyed on the dag and the optimizer config. Disabled if
+  /// empty.
+  std::string optimizerSolutionCachePath;
+  /// Cost profile of the cpu operators measured on the target host by
+  /// concrete-cost-calibration, correcting the analytical complexity model
+  /// of the optimizer. The analytical model is used if empty.
+  std::string optimizerCostProfilePath;
 
   /// When decomposing big integers into chunks, chunkSize is the total number
   /// of bits used for the message, including the carry, while chunkWidth is
@@ -96,15 +139,33 @@ struct CompilationOptions {
 
   bool compressEvaluationKeys;
 
+  /// Path to the LLVM bitcode of the leveled runtime operations. When not
+  /// empty, the operations are linked into the LLVM IR of the circuits and
+  /// the module is optimized at -O3, so that they are inlined and
+  /// vectorized with the code calling them.
+  std::string runtimeBitcodePath;
+
+  /// Record the duration of each call to the runtime and each allocation,
+  /// per thread, and dump them as a Chrome trace at the end of each call
+  /// of the circuit (see concretelang/Runtime/profiler.h).
+  bool profileRuntimeCalls;
+
   CompilationOptions()
       : v0FHEConstraints(std::nullopt), verifyDiagnostics(false),
         autoParallelize(false), loopParallelize(false), batchTFHEOps(false),
-        maxBatchSize(std::numeric_limits<int64_t>::max()), emitSDFGOps(false),
-        unrollLoopsWithSDFGConvertibleOps(false), dataflowParallelize(false),
-        optimizeTFHE(true), simulate(false), emitGPUOps(false),
+        maxBatchSize(std::numeric_limits<int64_t>::max()),
+        batchingReport(false), fuseBatchedOps(true), fusedBatchCacheSize(0),
+        emitSDFGOps(false), unrollLoopsWithSDFGConvertibleOps(false),
+        dataflowParallelize(false), dataflowTaskGranularity(0),
+        staticMemoryPlanning(true), poolCiphertextBuffers(true),
+        lowerMatmulToGemm(true), optimizeTFHE(true), simulate(false),
+        emitGPUOps(false), fhelinalgAutoTiling(false),
+        fhelinalgTilingCacheSize(0),
         mainFuncName(std::nullopt), optimizerConfig(optimizer::DEFAULT_CONFIG),
+        optimizerSolutionCachePath(""), optimizerCostProfilePath(""),
         chunkIntegers(false), chunkSize(4), chunkWidth(2),
-        encodings(std::nullopt), compressEvaluationKeys(false){};
+        encodings(std::nullopt), compressEvaluationKeys(false),
+        runtimeBitcodePath(""), profileRuntimeCalls(false){};
 
   CompilationOptions(std::string funcname) : CompilationOptions() {
     mainFuncName = funcname;
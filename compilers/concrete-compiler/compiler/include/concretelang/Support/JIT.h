@@ -0,0 +1,30 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_JIT_H
+#define CONCRETELANG_SUPPORT_JIT_H
+
+#include "concretelang/ServerLib/ServerLib.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Error.h"
+#include <memory>
+#include <string>
+
+namespace mlir {
+namespace concretelang {
+
+/// Compiles the optimized LLVM IR `module` in memory with the ORC JIT and
+/// returns a dynamic module resolving the circuits in the generated code,
+/// from which a `ServerProgram` can be loaded without emitting, linking and
+/// loading a shared library. `module` is left untouched. The runtime
+/// symbols are resolved in `runtimeLibraryPath` if not empty, and in the
+/// current process otherwise.
+llvm::Expected<std::shared_ptr<::concretelang::serverlib::DynamicModule>>
+jitCompile(const llvm::Module &module, std::string runtimeLibraryPath = "");
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
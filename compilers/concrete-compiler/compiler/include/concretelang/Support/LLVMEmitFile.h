@@ -7,10 +7,22 @@
 #define CONCRETELANG_SUPPORT_LLVMEMITFILE
 
 #include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
 
 namespace mlir {
 namespace concretelang {
 
+/// Returns a target machine for the host, with the data layout and target
+/// triple of `llvmModule` set accordingly, or nullptr on failure.
+std::unique_ptr<llvm::TargetMachine>
+getTargetMachineAndSetupModule(llvm::Module *llvmModule);
+
+/// Defines for each function of `module` an interface function taking all
+/// its arguments and results as a single `i8**`, which is the entry point
+/// called by the server library.
+void packFunctionArguments(llvm::Module *module);
+
 llvm::Error emitObject(llvm::Module &module, std::string objectPath);
 
 llvm::Error callCmd(std::string cmd);
@@ -0,0 +1,42 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_OPTIMIZER_CACHE_H
+#define CONCRETELANG_SUPPORT_OPTIMIZER_CACHE_H
+
+#include <optional>
+#include <string>
+
+#include "concretelang/Support/V0Parameters.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+namespace mlir {
+namespace concretelang {
+namespace optimizer {
+
+/// Returns the key of the solution of `dag` with `config` in a solution
+/// cache: a hash of the dump of the dag without its locations nor the tables
+/// of its lookups, of the fields of the config that change the solution and
+/// of the factors of the cost profile in use, if any.
+std::string solutionCacheKey(const Dag &dag, const Config &config);
+
+/// Returns the circuit solution stored under `key` in the cache directory
+/// `cachePath`, or std::nullopt if there is none or it cannot be read.
+std::optional<CircuitSolution> loadCircuitSolution(llvm::StringRef cachePath,
+                                                   llvm::StringRef key);
+
+/// Stores `solution` under `key` in the cache directory `cachePath`, which
+/// is created if needed. The file is written aside and renamed, so that
+/// concurrent compilations never read a partial solution.
+llvm::Error storeCircuitSolution(llvm::StringRef cachePath,
+                                 llvm::StringRef key,
+                                 const CircuitSolution &solution);
+
+} // namespace optimizer
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -6,6 +6,7 @@
 #ifndef CONCRETELANG_SUPPORT_PIPELINE_H_
 #define CONCRETELANG_SUPPORT_PIPELINE_H_
 
+#include "concretelang/Dialect/FHELinalg/Transforms/Tiling.h"
 #include "concretelang/Support/V0Parameters.h"
 #include "mlir/Dialect/LLVMIR/LLVMTypes.h"
 #include "mlir/Support/LogicalResult.h"
@@ -17,7 +18,8 @@ namespace concretelang {
 namespace pipeline {
 
 mlir::LogicalResult autopar(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                            std::function<bool(mlir::Pass *)> enablePass);
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            uint64_t taskGranularity = 0);
 
 llvm::Expected<std::map<std::string, std::optional<optimizer::Description>>>
 getFHEContextFromFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -33,13 +35,19 @@ markFHELinalgForTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
                        llvm::ArrayRef<int64_t> tileSizes,
                        std::function<bool(mlir::Pass *)> enablePass);
 
+mlir::LogicalResult
+markFHELinalgForAutoTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                           FHELinalgTilingTarget target,
+                           std::function<bool(mlir::Pass *)> enablePass);
+
 mlir::LogicalResult
 transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
                          std::function<bool(mlir::Pass *)> enablePass);
 
 mlir::LogicalResult
 lowerFHELinalgToFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass);
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    bool lowerMatmulToGemm);
 
 mlir::LogicalResult
 lowerLinalgGenericToLoops(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -68,7 +76,7 @@ parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult batchTFHE(mlir::MLIRContext &context,
                               mlir::ModuleOp &module,
                               std::function<bool(mlir::Pass *)> enablePass,
-                              int64_t maxBatchSize);
+                              int64_t maxBatchSize, bool report);
 
 mlir::LogicalResult
 normalizeTFHEKeys(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -81,7 +89,13 @@ extractTFHEStatistics(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerTFHEToConcrete(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass);
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    bool fuseLeveledOps);
+
+mlir::LogicalResult
+fuseBatchedOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
+               std::function<bool(mlir::Pass *)> enablePass,
+               uint64_t cacheSize);
 
 mlir::LogicalResult
 computeMemoryUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -123,13 +137,35 @@ mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
                                std::function<bool(mlir::Pass *)> enablePass,
                                bool parallelizeLoops);
 
+mlir::LogicalResult
+planStaticMemory(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                 std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+poolCiphertextBuffers(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+profileRuntimeCalls(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                    std::function<bool(mlir::Pass *)> enablePass);
+
 mlir::LogicalResult lowerToCAPI(mlir::MLIRContext &context,
                                 mlir::ModuleOp &module,
                                 std::function<bool(mlir::Pass *)> enablePass,
                                 bool gpu);
 
+/// Optimizes `module` at `optLevel`. Above 0, the module is set up for the
+/// host target so that the optimizations take it into account.
 mlir::LogicalResult optimizeLLVMModule(llvm::LLVMContext &llvmContext,
-                                       llvm::Module &module);
+                                       llvm::Module &module,
+                                       unsigned optLevel = 0);
+
+/// Links the functions of the LLVM bitcode at `bitcodePath` called by
+/// `module` into it, with an internal linkage so that they can be inlined
+/// and dropped once inlined.
+mlir::LogicalResult linkRuntimeBitcode(llvm::LLVMContext &llvmContext,
+                                       llvm::Module &module,
+                                       llvm::StringRef bitcodePath);
 
 std::unique_ptr<llvm::Module>
 lowerLLVMDialectToLLVMIR(mlir::MLIRContext &context,
@@ -6,6 +6,7 @@
 #ifndef CONCRETELANG_SUPPORT_V0Parameter_H_
 #define CONCRETELANG_SUPPORT_V0Parameter_H_
 
+#include <string>
 #include <variant>
 
 #include "llvm/ADT/Optional.h"
@@ -81,6 +82,12 @@ constexpr bool DEFAULT_CACHE_ON_DISK = true;
 constexpr uint32_t DEFAULT_CIPHERTEXT_MODULUS_LOG = 64;
 constexpr uint32_t DEFAULT_FFT_PRECISION = 53;
 constexpr bool DEFAULT_COMPOSABLE = false;
+constexpr concrete_optimizer::Objective DEFAULT_OBJECTIVE =
+    concrete_optimizer::Objective::TotalWork;
+/// The cores of the host
+constexpr uint64_t DEFAULT_CORES = 0;
+/// The analytical cpu complexity model
+constexpr uint64_t DEFAULT_CPU_COST_PROFILE = 0;
 
 /// The strategy of the crypto optimization
 enum Strategy {
@@ -116,6 +123,13 @@ struct Config {
   uint32_t ciphertext_modulus_log;
   uint32_t fft_precision;
   bool composable;
+  /// The cost minimized by the multi-parameter optimizer, the total work or
+  /// the latency on `cores` cores
+  concrete_optimizer::Objective objective;
+  uint64_t cores;
+  /// Handle of the cost profile correcting the cpu complexity model, as
+  /// returned by `concrete_optimizer::utils::load_cpu_cost_profile`
+  uint64_t cpu_cost_profile;
 };
 
 constexpr Config DEFAULT_CONFIG = {
@@ -133,6 +147,9 @@ constexpr Config DEFAULT_CONFIG = {
     DEFAULT_CIPHERTEXT_MODULUS_LOG,
     DEFAULT_FFT_PRECISION,
     DEFAULT_COMPOSABLE,
+    DEFAULT_OBJECTIVE,
+    DEFAULT_CORES,
+    DEFAULT_CPU_COST_PROFILE,
 };
 
 using Dag = rust::Box<concrete_optimizer::OperationDag>;
@@ -153,9 +170,18 @@ typedef std::variant<V0Parameter, CircuitSolution> Solution;
 
 struct CompilationFeedback;
 
+/// Returns the solution of the optimizer for `descr`. When
+/// `solutionCachePath` is not empty, the multi-parameter solutions are
+/// looked up in and stored to this directory, keyed on the dag and the
+/// config (see concretelang/Support/OptimizerCache.h). When
+/// `costProfilePath` is not empty, the complexities of the cpu operators
+/// are corrected with the cost profile measured in this file (see
+/// concrete-cost-calibration).
 llvm::Expected<optimizer::Solution>
 getSolution(optimizer::Description &descr, CompilationFeedback &feedback,
-            optimizer::Config optimizerConfig);
+            optimizer::Config optimizerConfig,
+            std::string solutionCachePath = "",
+            std::string costProfilePath = "");
 
 // As for now the solution which contains a crt encoding is mono parameter only
 // we have some parts of the pipeline that rely on that.
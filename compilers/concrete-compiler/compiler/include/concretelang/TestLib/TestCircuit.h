@@ -16,6 +16,7 @@
 #include "concretelang/Common/Values.h"
 #include "concretelang/ServerLib/ServerLib.h"
 #include "concretelang/Support/CompilerEngine.h"
+#include "concretelang/Support/JIT.h"
 #include "tests_tools/keySetCache.h"
 #include "llvm/Support/Path.h"
 #include <filesystem>
@@ -28,6 +29,7 @@ using concretelang::clientlib::ClientCircuit;
 using concretelang::clientlib::ClientProgram;
 using concretelang::error::Result;
 using concretelang::keysets::Keyset;
+using concretelang::serverlib::DynamicModule;
 using concretelang::serverlib::ServerCircuit;
 using concretelang::serverlib::ServerProgram;
 using concretelang::values::TransportValue;
@@ -48,7 +50,8 @@ public:
 
   TestCircuit(TestCircuit &&tc)
       : artifactDirectory(tc.artifactDirectory), compiler(tc.compiler),
-        library(tc.library), keyset(tc.keyset),
+        library(tc.library), jitProgramInfo(tc.jitProgramInfo),
+        jitModule(tc.jitModule), keyset(tc.keyset),
         encryptionCsprng(tc.encryptionCsprng) {
     tc.artifactDirectory = "";
   };
@@ -71,6 +74,28 @@ public:
     return outcome::success();
   }
 
+  /// Compiles `mlirProgram` in memory with the ORC JIT instead of emitting
+  /// and loading a library.
+  Result<void> compileJIT(std::string mlirProgram) {
+    auto compilationResult = compiler.compile(
+        mlirProgram,
+        mlir::concretelang::CompilerEngine::Target::OPTIMIZED_LLVM_IR);
+    if (!compilationResult) {
+      return StringError(llvm::toString(compilationResult.takeError()));
+    }
+    if (!compilationResult->programInfo.has_value()) {
+      return StringError("TestCircuit: no program info generated\n");
+    }
+    auto module = mlir::concretelang::jitCompile(
+        *compilationResult->llvmModule);
+    if (!module) {
+      return StringError(llvm::toString(module.takeError()));
+    }
+    jitProgramInfo = compilationResult->programInfo;
+    jitModule = module.get();
+    return outcome::success();
+  }
+
   Result<void> generateKeyset(__uint128_t secretSeed = 0,
                               __uint128_t encryptionSeed = 0,
                               bool tryCache = true) {
@@ -78,16 +103,16 @@ public:
       keyset = Keyset{};
       return outcome::success();
     }
-    OUTCOME_TRY(auto lib, getLibrary());
+    OUTCOME_TRY(auto programInfo, getProgramInfo());
     if (tryCache) {
       OUTCOME_TRY(keyset, getTestKeySetCachePtr()->getKeyset(
-                              lib.getProgramInfo().asReader().getKeyset(),
-                              secretSeed, encryptionSeed));
+                              programInfo.asReader().getKeyset(), secretSeed,
+                              encryptionSeed));
     } else {
       auto encryptionCsprng = csprng::EncryptionCSPRNG(encryptionSeed);
       auto secretCsprng = csprng::SecretCSPRNG(secretSeed);
       Message<concreteprotocol::KeysetInfo> keysetInfo =
-          lib.getProgramInfo().asReader().getKeyset();
+          programInfo.asReader().getKeyset();
       keyset = Keyset(keysetInfo, secretCsprng, encryptionCsprng);
     }
     return outcome::success();
@@ -147,9 +172,8 @@ public:
   }
 
   Result<ClientCircuit> getClientCircuit() {
-    OUTCOME_TRY(auto lib, getLibrary());
+    OUTCOME_TRY(auto programInfo, getProgramInfo());
     OUTCOME_TRY(auto ks, getKeyset());
-    auto programInfo = lib.getProgramInfo();
     OUTCOME_TRY(auto clientProgram,
                 ClientProgram::create(programInfo, ks.client, encryptionCsprng,
                                       isSimulation()));
@@ -160,12 +184,15 @@ public:
   }
 
   Result<ServerCircuit> getServerCircuit() {
-    OUTCOME_TRY(auto lib, getLibrary());
-    auto programInfo = lib.getProgramInfo();
+    OUTCOME_TRY(auto programInfo, getProgramInfo());
     OUTCOME_TRY(auto serverProgram,
-                ServerProgram::load(programInfo,
-                                    lib.getSharedLibraryPath(artifactDirectory),
-                                    isSimulation()));
+                jitModule ? ServerProgram::load(programInfo, jitModule,
+                                                isSimulation())
+                          : ServerProgram::load(
+                                programInfo,
+                                mlir::concretelang::CompilerEngine::Library::
+                                    getSharedLibraryPath(artifactDirectory),
+                                isSimulation()));
     OUTCOME_TRY(auto serverCircuit,
                 serverProgram.getServerCircuit(
                     programInfo.asReader().getCircuits()[0].getName()));
@@ -182,6 +209,14 @@ private:
     return *library;
   }
 
+  Result<Message<concreteprotocol::ProgramInfo>> getProgramInfo() {
+    if (jitProgramInfo.has_value()) {
+      return *jitProgramInfo;
+    }
+    OUTCOME_TRY(auto lib, getLibrary());
+    return lib.getProgramInfo();
+  }
+
   Result<Keyset> getKeyset() {
     if (!keyset.has_value()) {
       return StringError("TestCircuit: keyset has not been generated\n");
@@ -194,6 +229,8 @@ private:
   std::string artifactDirectory;
   mlir::concretelang::CompilerEngine compiler;
   std::optional<mlir::concretelang::CompilerEngine::Library> library;
+  std::optional<Message<concreteprotocol::ProgramInfo>> jitProgramInfo;
+  std::shared_ptr<DynamicModule> jitModule;
   std::optional<Keyset> keyset;
   std::shared_ptr<csprng::EncryptionCSPRNG> encryptionCsprng;
 
@@ -7,6 +7,7 @@
 #define CONCRETELANG_TRANSFORMS_PASS_H
 
 #include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
 #include <mlir/Dialect/MemRef/IR/MemRef.h>
 #include <mlir/Dialect/SCF/IR/SCF.h>
 #include <mlir/Pass/Pass.h>
@@ -21,7 +22,12 @@ std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 createCollapseParallelLoops();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createForLoopToParallel();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
-createBatchingPass(int64_t maxBatchSize = std::numeric_limits<int64_t>::max());
+createBatchingPass(int64_t maxBatchSize = std::numeric_limits<int64_t>::max(),
+                   bool report = false);
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createStaticMemoryPlanningPass();
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createProfileRuntimeCallsPass();
 } // namespace concretelang
 } // namespace mlir
 
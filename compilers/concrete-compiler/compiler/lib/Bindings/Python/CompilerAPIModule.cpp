@@ -78,6 +78,11 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
              concrete_optimizer::MultiParamStrategy::ByPrecisionAndNorm2)
       .export_values();
 
+  pybind11::enum_<concrete_optimizer::Objective>(m, "OptimizerObjective")
+      .value("TOTAL_WORK", concrete_optimizer::Objective::TotalWork)
+      .value("LATENCY", concrete_optimizer::Objective::Latency)
+      .export_values();
+
   pybind11::enum_<concrete_optimizer::Encoding>(m, "Encoding")
       .value("AUTO", concrete_optimizer::Encoding::Auto)
       .value("CRT", concrete_optimizer::Encoding::Crt)
@@ -105,6 +110,26 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
            [](CompilationOptions &options, bool b) {
              options.dataflowParallelize = b;
            })
+      .def("set_dataflow_task_granularity",
+           [](CompilationOptions &options, uint64_t granularity) {
+             options.dataflowTaskGranularity = granularity;
+           })
+      .def("set_static_memory_planning",
+           [](CompilationOptions &options, bool b) {
+             options.staticMemoryPlanning = b;
+           })
+      .def("set_pool_ciphertext_buffers",
+           [](CompilationOptions &options, bool b) {
+             options.poolCiphertextBuffers = b;
+           })
+      .def("set_lower_matmul_to_gemm",
+           [](CompilationOptions &options, bool b) {
+             options.lowerMatmulToGemm = b;
+           })
+      .def("set_fhelinalg_auto_tiling",
+           [](CompilationOptions &options, bool b) {
+             options.fhelinalgAutoTiling = b;
+           })
       .def("set_compress_evaluation_keys",
            [](CompilationOptions &options, bool b) {
              options.compressEvaluationKeys = b;
@@ -128,6 +153,12 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
               concrete_optimizer::MultiParamStrategy strategy) {
              options.optimizerConfig.multi_param_strategy = strategy;
            })
+      .def("set_optimizer_objective",
+           [](CompilationOptions &options,
+              concrete_optimizer::Objective objective, uint64_t cores) {
+             options.optimizerConfig.objective = objective;
+             options.optimizerConfig.cores = cores;
+           })
       .def("set_global_p_error",
            [](CompilationOptions &options, double global_p_error) {
              options.optimizerConfig.global_p_error = global_p_error;
@@ -183,6 +214,30 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       .def("set_batch_tfhe_ops",
            [](CompilationOptions &options, bool batch_tfhe_ops) {
              options.batchTFHEOps = batch_tfhe_ops;
+           })
+      .def("set_batching_report",
+           [](CompilationOptions &options, bool batching_report) {
+             options.batchingReport = batching_report;
+           })
+      .def("set_fuse_batched_ops",
+           [](CompilationOptions &options, bool fuse_batched_ops) {
+             options.fuseBatchedOps = fuse_batched_ops;
+           })
+      .def("set_runtime_bitcode_path",
+           [](CompilationOptions &options, std::string runtime_bitcode_path) {
+             options.runtimeBitcodePath = runtime_bitcode_path;
+           })
+      .def("set_profile_runtime_calls",
+           [](CompilationOptions &options, bool profile_runtime_calls) {
+             options.profileRuntimeCalls = profile_runtime_calls;
+           })
+      .def("set_optimizer_solution_cache_path",
+           [](CompilationOptions &options, std::string cache_path) {
+             options.optimizerSolutionCachePath = cache_path;
+           })
+      .def("set_optimizer_cost_profile_path",
+           [](CompilationOptions &options, std::string profile_path) {
+             options.optimizerCostProfilePath = profile_path;
            });
 
   pybind11::enum_<mlir::concretelang::PrimitiveOperation>(m,
@@ -218,6 +273,11 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       m, "CompilationFeedback")
       .def_readonly("complexity",
                     &mlir::concretelang::CompilationFeedback::complexity)
+      .def_readonly(
+          "optimizer_objective",
+          &mlir::concretelang::CompilationFeedback::optimizerObjective)
+      .def_readonly("optimizer_cores",
+                    &mlir::concretelang::CompilationFeedback::optimizerCores)
       .def_readonly("p_error", &mlir::concretelang::CompilationFeedback::pError)
       .def_readonly("global_p_error",
                     &mlir::concretelang::CompilationFeedback::globalPError)
@@ -241,7 +301,18 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
                     &mlir::concretelang::CompilationFeedback::statistics)
       .def_readonly(
           "memory_usage_per_location",
-          &mlir::concretelang::CompilationFeedback::memoryUsagePerLoc);
+          &mlir::concretelang::CompilationFeedback::memoryUsagePerLoc)
+      .def_readonly("peak_memory_usage",
+                    &mlir::concretelang::CompilationFeedback::peakMemoryUsage)
+      .def_readonly("pbs_critical_path",
+                    &mlir::concretelang::CompilationFeedback::pbsCriticalPath)
+      .def_readonly("pbs_width_profile",
+                    &mlir::concretelang::CompilationFeedback::pbsWidthProfile)
+      .def_readonly("prediction_cores",
+                    &mlir::concretelang::CompilationFeedback::predictionCores)
+      .def_readonly(
+          "predicted_pbs_rounds",
+          &mlir::concretelang::CompilationFeedback::predictedPbsRounds);
 
   pybind11::class_<mlir::concretelang::CompilationContext,
                    std::shared_ptr<mlir::concretelang::CompilationContext>>(
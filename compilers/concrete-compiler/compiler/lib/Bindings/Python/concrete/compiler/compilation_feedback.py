@@ -57,6 +57,8 @@ class CompilationFeedback(WrapperCpp):
             )
 
         self.complexity = compilation_feedback.complexity
+        self.optimizer_objective = compilation_feedback.optimizer_objective
+        self.optimizer_cores = compilation_feedback.optimizer_cores
         self.p_error = compilation_feedback.p_error
         self.global_p_error = compilation_feedback.global_p_error
         self.total_secret_keys_size = compilation_feedback.total_secret_keys_size
@@ -69,6 +71,11 @@ class CompilationFeedback(WrapperCpp):
         )
         self.statistics = compilation_feedback.statistics
         self.memory_usage_per_location = compilation_feedback.memory_usage_per_location
+        self.peak_memory_usage = compilation_feedback.peak_memory_usage
+        self.pbs_critical_path = compilation_feedback.pbs_critical_path
+        self.pbs_width_profile = compilation_feedback.pbs_width_profile
+        self.prediction_cores = compilation_feedback.prediction_cores
+        self.predicted_pbs_rounds = compilation_feedback.predicted_pbs_rounds
 
         super().__init__(compilation_feedback)
 
@@ -10,6 +10,7 @@ from mlir._mlir_libs._concretelang._compiler import (
     CompilationOptions as _CompilationOptions,
     OptimizerStrategy as _OptimizerStrategy,
     OptimizerMultiParameterStrategy as _OptimizerMultiParameterStrategy,
+    OptimizerObjective,
     Encoding,
     Backend as _Backend,
 )
@@ -145,6 +146,77 @@ class CompilationOptions(WrapperCpp):
             raise TypeError("can't set the option to a non-boolean value")
         self.cpp().set_dataflow_parallelize(dataflow_parallelize)
 
+    def set_dataflow_task_granularity(self, granularity: int):
+        """Set the target number of programmable bootstraps per dataflow task.
+
+        Smaller tasks are merged and larger linalg generics are split to approach the
+        target. A value of 0 creates one task per candidate operation.
+
+        Args:
+            granularity (int): target number of bootstraps per task
+
+        Raises:
+            TypeError: if the value to set is not int
+            ValueError: if the value to set is negative
+        """
+        if not isinstance(granularity, int):
+            raise TypeError("can't set the option to a non-int value")
+        if granularity < 0:
+            raise ValueError("granularity must be non-negative")
+        self.cpp().set_dataflow_task_granularity(granularity)
+
+    def set_static_memory_planning(self, enable: bool):
+        """Set flag to enable/disable reuse of buffers with non-overlapping lifetimes.
+
+        Args:
+            enable (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(enable, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_static_memory_planning(enable)
+
+    def set_pool_ciphertext_buffers(self, enable: bool):
+        """Set flag to allocate ciphertext buffers from the runtime buffer pool.
+
+        Args:
+            enable (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(enable, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_pool_ciphertext_buffers(enable)
+
+    def set_lower_matmul_to_gemm(self, enable: bool):
+        """Set flag to compute encrypted matrix and dot products, and 2D convolutions, with the gemm kernel of the runtime.
+
+        Args:
+            enable (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(enable, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_lower_matmul_to_gemm(enable)
+
+    def set_fhelinalg_auto_tiling(self, enable: bool):
+        """Set flag to tile FHELinalg operations with automatically chosen tile sizes.
+
+        Args:
+            enable (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(enable, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_fhelinalg_auto_tiling(enable)
+
     def set_optimize_concrete(self, optimize: bool):
         """Set flag to enable/disable optimization of concrete intermediate representation.
 
@@ -230,6 +302,25 @@ class CompilationOptions(WrapperCpp):
             raise TypeError("enable should be a bool")
         self.cpp().set_optimizer_multi_parameter_strategy(strategy)
 
+    def set_optimizer_objective(self, objective: OptimizerObjective, cores: int = 0):
+        """Set the cost minimized by the multi-parameter optimizer.
+
+        The total work suits batch workloads, while the latency on `cores` cores suits circuits with
+        a long chain of lookup tables executed on a parallel host.
+
+        Args:
+            objective (OptimizerObjective): TOTAL_WORK or LATENCY.
+            cores (int): number of cores of the latency objective, the cores of the host if 0.
+
+        Raises:
+            TypeError: if the objective is not an OptimizerObjective or cores is not a non-negative int
+        """
+        if not isinstance(objective, OptimizerObjective):
+            raise TypeError("objective must be an OptimizerObjective")
+        if not isinstance(cores, int) or cores < 0:
+            raise TypeError("cores must be a non-negative int")
+        self.cpp().set_optimizer_objective(objective, cores)
+
     def set_global_p_error(self, global_p_error: float):
         """Set global error probability for the full circuit.
 
@@ -448,3 +539,90 @@ class CompilationOptions(WrapperCpp):
         if not isinstance(batch_tfhe_ops, bool):
             raise TypeError("batch_tfhe_ops must be boolean")
         self.cpp().set_batch_tfhe_ops(batch_tfhe_ops)
+
+    def set_batching_report(self, batching_report: bool):
+        """Set flag that triggers the report of the batching decisions as remarks.
+
+        Args:
+            batching_report (bool): whether to report batching decisions.
+
+        Raises:
+            TypeError: if the value to set is not bool
+        """
+        if not isinstance(batching_report, bool):
+            raise TypeError("batching_report must be boolean")
+        self.cpp().set_batching_report(batching_report)
+
+    def set_fuse_batched_ops(self, fuse_batched_ops: bool):
+        """Set flag that triggers the streaming of batched TFHE operations through cache-sized chunks.
+
+        Args:
+            fuse_batched_ops (bool): whether to fuse batched ops.
+
+        Raises:
+            TypeError: if the value to set is not bool
+        """
+        if not isinstance(fuse_batched_ops, bool):
+            raise TypeError("fuse_batched_ops must be boolean")
+        self.cpp().set_fuse_batched_ops(fuse_batched_ops)
+
+    def set_runtime_bitcode_path(self, runtime_bitcode_path: str):
+        """Set the path to the bitcode of the leveled runtime operations to inline into circuits.
+
+        An empty path disables the inlining.
+
+        Args:
+            runtime_bitcode_path (str): path to ConcretelangRuntimeLeveled.bc.
+
+        Raises:
+            TypeError: if the value to set is not str
+        """
+        if not isinstance(runtime_bitcode_path, str):
+            raise TypeError("runtime_bitcode_path must be str")
+        self.cpp().set_runtime_bitcode_path(runtime_bitcode_path)
+
+    def set_profile_runtime_calls(self, profile_runtime_calls: bool):
+        """Set flag that triggers the profiling of the calls to the runtime.
+
+        The calls are appended to a Chrome trace in $CONCRETE_PROFILE_OUTPUT at the end of each call of the circuit.
+
+        Args:
+            profile_runtime_calls (bool): whether to profile the runtime calls.
+
+        Raises:
+            TypeError: if the value to set is not bool
+        """
+        if not isinstance(profile_runtime_calls, bool):
+            raise TypeError("profile_runtime_calls must be boolean")
+        self.cpp().set_profile_runtime_calls(profile_runtime_calls)
+
+    def set_optimizer_solution_cache_path(self, cache_path: str):
+        """Set the directory of the persistent cache of the optimizer multi-parameter solutions.
+
+        The solutions are keyed on the circuit dag and the optimizer options. An empty path disables the cache.
+
+        Args:
+            cache_path (str): directory of the cache.
+
+        Raises:
+            TypeError: if the value to set is not str
+        """
+        if not isinstance(cache_path, str):
+            raise TypeError("cache_path must be str")
+        self.cpp().set_optimizer_solution_cache_path(cache_path)
+
+    def set_optimizer_cost_profile_path(self, profile_path: str):
+        """Set the cost profile of the cpu operators used by the optimizer.
+
+        The profile is measured on the target host by concrete-cost-calibration, and corrects the
+        analytical complexity model of the optimizer. An empty path uses the analytical model.
+
+        Args:
+            profile_path (str): path of the cost profile.
+
+        Raises:
+            TypeError: if the value to set is not str
+        """
+        if not isinstance(profile_path, str):
+            raise TypeError("profile_path must be str")
+        self.cpp().set_optimizer_cost_profile_path(profile_path)
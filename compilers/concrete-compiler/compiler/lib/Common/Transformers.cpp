@@ -12,7 +12,9 @@
 #include "concretelang/Common/Keysets.h"
 #include "concretelang/Common/Values.h"
 #include "concretelang/Runtime/simulation.h"
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <stdlib.h>
 #include <string>
 
@@ -239,325 +241,316 @@ getTransportValueVerifier(const Message<concreteprotocol::GateInfo> &gateInfo) {
   };
 }
 
-Result<Transformer> getBooleanEncodingTransformer() {
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+/// A private type for element encoders, writing the plaintexts encoding a
+/// single clear value at the given location.
+typedef std::function<void(uint64_t, uint64_t *)> ElementEncoder;
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      outputTensor.values[i] = inputTensor.values[i] << 61;
+/// A private type for element decoders, reconstructing a single clear value
+/// from the plaintexts stored at the given location.
+typedef std::function<uint64_t(const uint64_t *)> ElementDecoder;
+
+/// A private type for plaintext encrypters, writing the ciphertext of a
+/// plaintext at the given location.
+typedef std::function<void(uint64_t, uint64_t *)> PlaintextEncrypter;
+
+/// A private type for ciphertext decrypters, returning the plaintext of the
+/// ciphertext stored at the given location.
+typedef std::function<uint64_t(const uint64_t *)> CiphertextDecrypter;
+
+/// A private view over the blobs of a payload, addressed as one contiguous
+/// array of 64 bits words. The blobs are laid out as in
+/// `vectorToProtoPayload`, which allows the ciphertexts to be written to and
+/// read from the payload in place.
+template <typename Word> class PayloadWords {
+public:
+  static constexpr size_t wordsPerBlob =
+      capnp::MAX_TEXT_SIZE / sizeof(uint64_t);
+
+  void addBlob(Word *data, size_t size) {
+    blobs.push_back(data);
+    sizes.push_back(size);
+  }
+
+  /// Returns a pointer to the `length` words starting at `offset` if they are
+  /// stored in a single blob, and a null pointer otherwise.
+  Word *contiguous(size_t offset, size_t length) const {
+    size_t blob = offset / wordsPerBlob;
+    size_t start = offset % wordsPerBlob;
+    if (blob >= blobs.size() || start + length > sizes[blob]) {
+      return nullptr;
     }
+    return blobs[blob] + start;
+  }
 
-    return Value{outputTensor};
+  /// Copies the `length` words starting at `offset` to `output`.
+  void read(size_t offset, uint64_t *output, size_t length) const {
+    for (size_t i = 0; i < length; i++) {
+      auto word = offset + i;
+      output[i] = blobs[word / wordsPerBlob][word % wordsPerBlob];
+    }
+  }
+
+  /// Copies the `length` words of `input` starting at `offset`.
+  void write(size_t offset, const uint64_t *input, size_t length) const {
+    for (size_t i = 0; i < length; i++) {
+      auto word = offset + i;
+      blobs[word / wordsPerBlob][word % wordsPerBlob] = input[i];
+    }
+  }
+
+private:
+  std::vector<Word *> blobs;
+  std::vector<size_t> sizes;
+};
+
+/// Allocates `size` words in the payload, and returns a view over them.
+PayloadWords<uint64_t>
+initPayloadWords(concreteprotocol::Payload::Builder payload, size_t size) {
+  auto wordsPerBlob = PayloadWords<uint64_t>::wordsPerBlob;
+  auto nbBlobs = (size + wordsPerBlob - 1) / wordsPerBlob;
+  auto dataBuilder = payload.initData(nbBlobs);
+  PayloadWords<uint64_t> output;
+  for (size_t blobIndex = 0; blobIndex < nbBlobs; blobIndex++) {
+    auto blobSize = std::min(wordsPerBlob, size - blobIndex * wordsPerBlob);
+    auto blob = dataBuilder.init(blobIndex, blobSize * sizeof(uint64_t));
+    output.addBlob(reinterpret_cast<uint64_t *>(blob.begin()), blobSize);
+  }
+  return output;
+}
+
+/// Returns a view over the words of the payload.
+PayloadWords<const uint64_t>
+getPayloadWords(concreteprotocol::Payload::Reader payload) {
+  PayloadWords<const uint64_t> output;
+  for (auto blob : payload.getData()) {
+    output.addBlob(reinterpret_cast<const uint64_t *>(blob.begin()),
+                   blob.size() / sizeof(uint64_t));
+  }
+  return output;
+}
+
+Result<ElementEncoder> getBooleanElementEncoder() {
+  return [](uint64_t value, uint64_t *plaintexts) {
+    plaintexts[0] = value << 61;
   };
 }
 
-Result<Transformer> getNativeModeIntegerEncodingTransformer(
+Result<ElementDecoder> getBooleanElementDecoder() {
+  return [](const uint64_t *plaintexts) {
+    uint64_t output = plaintexts[0] >> 60;
+    uint64_t carry = output % 2;
+    uint64_t mod = 1 << 3;
+    return ((output >> 1) + carry) % mod;
+  };
+}
+
+Result<ElementEncoder> getNativeModeIntegerElementEncoder(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   auto width = info.asReader().getWidth();
-  auto isSigned = info.asReader().getIsSigned();
 
-  return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      outputTensor.values[i] = inputTensor.values[i] << (64 - (width + 1));
-    }
-    return Value{outputTensor};
+  return [=](uint64_t value, uint64_t *plaintexts) {
+    plaintexts[0] = value << (64 - (width + 1));
   };
 }
 
-Result<Transformer> getNativeModeIntegerDecodingTransformer(
+Result<ElementDecoder> getNativeModeIntegerElementDecoder(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   auto precision = info.asReader().getWidth();
   auto isSigned = info.asReader().getIsSigned();
 
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto input = inputTensor.values[i];
-
-      // Decode unsigned integer
-      uint64_t output = input >> (64 - precision - 2);
-      auto carry = output % 2;
-      uint64_t mod = (((uint64_t)1) << (precision + 1));
-      output = ((output >> 1) + carry) % mod;
-
-      // Further decode signed integers.
-      if (isSigned) {
-        uint64_t maxPos = (((uint64_t)1) << (precision - 1));
-        if (output >= maxPos) { // The output is actually negative.
-          // Set the preceding bits to zero
-          output |= UINT64_MAX << precision;
-          // This makes sure when the value is cast to int64, it has the
-          // correct value
-        };
-      }
+  return [=](const uint64_t *plaintexts) {
+    // Decode unsigned integer
+    uint64_t output = plaintexts[0] >> (64 - precision - 2);
+    auto carry = output % 2;
+    uint64_t mod = (((uint64_t)1) << (precision + 1));
+    output = ((output >> 1) + carry) % mod;
 
-      outputTensor.values[i] = output;
-    }
-
-    Value output;
+    // Further decode signed integers.
     if (isSigned) {
-      auto signedOutputTensor = (Tensor<int64_t>)outputTensor;
-      output = Value{signedOutputTensor};
-    } else {
-      output = Value{outputTensor};
+      uint64_t maxPos = (((uint64_t)1) << (precision - 1));
+      if (output >= maxPos) { // The output is actually negative.
+        // Set the preceding bits to zero
+        output |= UINT64_MAX << precision;
+        // This makes sure when the value is cast to int64, it has the
+        // correct value
+      };
     }
 
     return output;
   };
 }
 
-Result<Transformer> getChunkedModeIntegerEncodingTransformer(
+Result<ElementEncoder> getChunkedModeIntegerElementEncoder(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   auto size = info.asReader().getMode().getChunked().getSize();
   auto chunkWidth = info.asReader().getMode().getChunked().getWidth();
-  auto isSigned = info.asReader().getIsSigned();
   uint64_t mask = (1 << chunkWidth) - 1;
 
-  return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.push_back(size);
-    outputTensor.values.resize(outputTensor.values.size() * size);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto value = inputTensor.values[i];
-      for (size_t j = 0; j < size; j++) {
-        auto chunk = value & mask;
-        outputTensor.values[i * size + j] = ((uint64_t)chunk)
-                                            << (64 - (chunkWidth + 1));
-        value >>= chunkWidth;
-      }
+  return [=](uint64_t value, uint64_t *plaintexts) {
+    for (size_t j = 0; j < size; j++) {
+      auto chunk = value & mask;
+      plaintexts[j] = ((uint64_t)chunk) << (64 - (chunkWidth + 1));
+      value >>= chunkWidth;
     }
-
-    return Value{outputTensor};
   };
 }
 
-Result<Transformer> getChunkedModeIntegerDecodingTransformer(
+Result<ElementDecoder> getChunkedModeIntegerElementDecoder(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   auto chunkSize = info.asReader().getMode().getChunked().getSize();
   auto chunkWidth = info.asReader().getMode().getChunked().getWidth();
-  auto isSigned = info.asReader().getIsSigned();
   uint64_t mask = (1 << chunkWidth) - 1;
 
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / chunkSize);
-
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
-      uint64_t output = 0;
-      for (size_t j = 0; j < chunkSize; j++) {
-        auto input = inputTensor.values[i * chunkSize + j];
-
-        // Decode unsigned integer
-        uint64_t chunkOutput = input >> (64 - chunkWidth - 2);
-        auto carry = chunkOutput % 2;
-        uint64_t mod = (((uint64_t)1) << (chunkWidth + 1));
-        chunkOutput = ((chunkOutput >> 1) + carry) % mod;
-
-        // Further decode signed integers.
-        if (isSigned) {
-          uint64_t maxPos = (((uint64_t)1) << (chunkWidth - 1));
-          if (output >= maxPos) { // The output is actually negative.
-            // Set the preceding bits to zero
-            chunkOutput |= UINT64_MAX << chunkWidth;
-            // This makes sure when the value is cast to int64, it has the
-            // correct value
-          };
-        }
-
-        chunkOutput &= mask;
-        output += chunkOutput << (chunkWidth * j);
-      }
-      outputTensor.values[i] = output;
-    }
+  return [=](const uint64_t *plaintexts) {
+    uint64_t output = 0;
+    for (size_t j = 0; j < chunkSize; j++) {
+      // Decode unsigned integer. Signed integers are decoded the same way,
+      // as only the `chunkWidth` lowest bits of each chunk are kept.
+      uint64_t chunkOutput = plaintexts[j] >> (64 - chunkWidth - 2);
+      auto carry = chunkOutput % 2;
+      uint64_t mod = (((uint64_t)1) << (chunkWidth + 1));
+      chunkOutput = ((chunkOutput >> 1) + carry) % mod;
 
-    Value output;
-    if (isSigned) {
-      auto signedOutputTensor = (Tensor<int64_t>)outputTensor;
-      output = Value{signedOutputTensor};
-    } else {
-      output = Value{outputTensor};
+      chunkOutput &= mask;
+      output += chunkOutput << (chunkWidth * j);
     }
-
     return output;
   };
 }
 
-Result<Transformer> getCrtModeIntegerEncodingTransformer(
+Result<ElementEncoder> getCrtModeIntegerElementEncoder(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   std::vector<int64_t> moduli;
   for (auto modulus : info.asReader().getMode().getCrt().getModuli()) {
     moduli.push_back(modulus);
   }
-  auto size = info.asReader().getMode().getCrt().getModuli().size();
   auto productOfModuli = concretelang::crt::productOfModuli(moduli);
-  auto isSigned = info.asReader().getIsSigned();
 
-  return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
+  return [=](uint64_t value, uint64_t *plaintexts) {
+    for (size_t j = 0; j < moduli.size(); j++) {
+      plaintexts[j] =
+          concretelang::crt::encode(value, moduli[j], productOfModuli);
     }
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.push_back(size);
-    outputTensor.values.resize(outputTensor.values.size() * size);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto value = inputTensor.values[i];
-      for (size_t j = 0; j < (size_t)size; j++) {
-        outputTensor.values[i * size + j] =
-            concretelang::crt::encode(value, moduli[j], productOfModuli);
-      }
-    }
-
-    return Value{outputTensor};
   };
 }
 
-Result<Transformer> getCrtModeIntegerDecodingTransformer(
-    const Message<concreteprotocol::IntegerCiphertextEncodingInfo> info) {
+Result<ElementDecoder> getCrtModeIntegerElementDecoder(
+    const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   std::vector<int64_t> moduli;
   for (auto modulus : info.asReader().getMode().getCrt().getModuli()) {
     moduli.push_back(modulus);
   }
-  std::vector<int64_t> remainders(
-      info.asReader().getMode().getCrt().getModuli().size());
-  auto size = info.asReader().getMode().getCrt().getModuli().size();
+  std::vector<int64_t> remainders(moduli.size());
   auto isSigned = info.asReader().getIsSigned();
+  uint64_t maxPos = 1;
+  for (auto prime : moduli) {
+    maxPos *= prime;
+  }
+  maxPos /= 2;
 
-  return [=](Value input) mutable {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / size);
-
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
-      for (size_t j = 0; j < (size_t)size; j++) {
-        remainders[j] =
-            crt::decode(inputTensor.values[i * size + j], moduli[j]);
-      }
-
-      // Compute the inverse crt
-      uint64_t output = crt::iCrt(moduli, remainders);
-
-      // Further decode signed integers
-      if (isSigned) {
-        uint64_t maxPos = 1;
-        for (auto prime : moduli) {
-          maxPos *= prime;
-        }
-        maxPos /= 2;
-        if (output >= maxPos) {
-          output -= maxPos * 2;
-        }
-      }
-      outputTensor.values[i] = output;
+  return [=](const uint64_t *plaintexts) mutable {
+    for (size_t j = 0; j < moduli.size(); j++) {
+      remainders[j] = crt::decode(plaintexts[j], moduli[j]);
     }
 
-    Value output;
-    if (isSigned) {
-      auto signedOutputTensor = (Tensor<int64_t>)outputTensor;
-      output = Value{signedOutputTensor};
-    } else {
-      output = Value{outputTensor};
-    }
+    // Compute the inverse crt
+    uint64_t output = crt::iCrt(moduli, remainders);
 
+    // Further decode signed integers
+    if (isSigned && output >= maxPos) {
+      output -= maxPos * 2;
+    }
     return output;
   };
 }
 
-Result<Transformer> getEncryptionTransformer(
+Result<ElementEncoder> getIntegerElementEncoder(
+    const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
+  if (info.asReader().getMode().hasNative()) {
+    return getNativeModeIntegerElementEncoder(info);
+  } else if (info.asReader().getMode().hasChunked()) {
+    return getChunkedModeIntegerElementEncoder(info);
+  } else if (info.asReader().getMode().hasCrt()) {
+    return getCrtModeIntegerElementEncoder(info);
+  } else {
+    return StringError(
+        "Tried to construct integer encoding transformer without mode.");
+  }
+}
+
+Result<ElementDecoder> getIntegerElementDecoder(
+    const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
+  if (info.asReader().getMode().hasNative()) {
+    return getNativeModeIntegerElementDecoder(info);
+  } else if (info.asReader().getMode().hasChunked()) {
+    return getChunkedModeIntegerElementDecoder(info);
+  } else if (info.asReader().getMode().hasCrt()) {
+    return getCrtModeIntegerElementDecoder(info);
+  } else {
+    return StringError(
+        "Tried to construct integer decoding transformer without mode.");
+  }
+}
+
+/// Returns the number of plaintexts encoding a single clear value, or none if
+/// the encoding uses a single plaintext without a dedicated dimension.
+std::optional<size_t>
+getEncodingBlocks(concreteprotocol::LweCiphertextTypeInfo::Reader info) {
+  auto encoding = info.getEncoding();
+  if (encoding.hasInteger() && encoding.getInteger().getMode().hasChunked()) {
+    return encoding.getInteger().getMode().getChunked().getSize();
+  }
+  if (encoding.hasInteger() && encoding.getInteger().getMode().hasCrt()) {
+    return encoding.getInteger().getMode().getCrt().getModuli().size();
+  }
+  return std::nullopt;
+}
+
+Result<PlaintextEncrypter> getPlaintextEncrypter(
     ClientKeyset keyset,
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
 
   auto key = keyset.lweSecretKeys[info.asReader().getKeyId()];
   auto lweDimension = info.asReader().getLweDimension();
-  auto lweSize = lweDimension + 1;
   auto variance = info.asReader().getVariance();
 
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.push_back(lweSize);
-    outputTensor.values.resize(outputTensor.values.size() * lweSize);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      concrete_cpu_encrypt_lwe_ciphertext_u64(
-          key.getRawPtr(), &outputTensor.values[i * lweSize],
-          inputTensor.values[i], lweDimension, variance, csprng->ptr);
-    }
-
-    return Value{outputTensor};
+  return [=](uint64_t plaintext, uint64_t *ciphertext) {
+    concrete_cpu_encrypt_lwe_ciphertext_u64(key.getRawPtr(), ciphertext,
+                                            plaintext, lweDimension, variance,
+                                            csprng->ptr);
   };
 }
 
-Result<Transformer> getEncryptionSimulationTransformer(
+Result<PlaintextEncrypter> getPlaintextSimulationEncrypter(
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
 
   auto lweDimension = info.asReader().getLweDimension();
 
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      outputTensor.values[i] = sim_encrypt_lwe_u64(
-          inputTensor.values[i], lweDimension, (void *)(*csprng).ptr);
-    }
-
-    return Value{outputTensor};
+  return [=](uint64_t plaintext, uint64_t *ciphertext) {
+    ciphertext[0] =
+        sim_encrypt_lwe_u64(plaintext, lweDimension, (void *)(*csprng).ptr);
   };
 }
 
-Result<Transformer> getDecryptionTransformer(
+Result<CiphertextDecrypter> getCiphertextDecrypter(
     ClientKeyset keyset,
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info) {
 
   auto key = keyset.lweSecretKeys[info.asReader().getKeyId()];
   auto lweDimension = info.asReader().getLweDimension();
-  auto lweSize = lweDimension + 1;
 
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-    outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / lweSize);
-
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
-      concrete_cpu_decrypt_lwe_ciphertext_u64(
-          key.getRawPtr(), &inputTensor.values[i * lweSize], lweDimension,
-          &outputTensor.values[i]);
-    }
-
-    return Value{outputTensor};
+  return [=](const uint64_t *ciphertext) {
+    uint64_t plaintext;
+    concrete_cpu_decrypt_lwe_ciphertext_u64(key.getRawPtr(), ciphertext,
+                                            lweDimension, &plaintext);
+    return plaintext;
   };
 }
 
-Result<Transformer> getDecryptionSimulationTransformer() {
-  return [](auto input) { return input; };
+Result<CiphertextDecrypter> getCiphertextSimulationDecrypter() {
+  return [](const uint64_t *ciphertext) { return ciphertext[0]; };
 }
 
 Result<Transformer> getNoneCompressionTransformer() {
@@ -568,52 +561,6 @@ Result<Transformer> getNoneDecompressionTransformer() {
   return [](auto input) { return input; };
 }
 
-Result<Transformer> getBooleanDecodingTransformer() {
-  return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
-
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto input = inputTensor.values[i];
-      uint64_t output = input >> 60;
-      uint64_t carry = output % 2;
-      uint64_t mod = 1 << 3;
-      output = ((output >> 1) + carry) % mod;
-      outputTensor.values[i] = output;
-    }
-
-    return Value{outputTensor};
-  };
-}
-
-Result<Transformer> getIntegerEncodingTransformer(
-    const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
-  if (info.asReader().getMode().hasNative()) {
-    return getNativeModeIntegerEncodingTransformer(info);
-  } else if (info.asReader().getMode().hasChunked()) {
-    return getChunkedModeIntegerEncodingTransformer(info);
-  } else if (info.asReader().getMode().hasCrt()) {
-    return getCrtModeIntegerEncodingTransformer(info);
-  } else {
-    return StringError(
-        "Tried to construct integer encoding transformer without mode.");
-  }
-}
-
-Result<Transformer> getIntegerDecodingTransformer(
-    const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
-  if (info.asReader().getMode().hasNative()) {
-    return getNativeModeIntegerDecodingTransformer(info);
-  } else if (info.asReader().getMode().hasChunked()) {
-    return getChunkedModeIntegerDecodingTransformer(info);
-  } else if (info.asReader().getMode().hasCrt()) {
-    return getCrtModeIntegerDecodingTransformer(info);
-  } else {
-    return StringError(
-        "Tried to construct integer decoding transformer without mode.");
-  }
-}
-
 Result<InputTransformer> TransformerFactory::getIndexInputTransformer(
     Message<concreteprotocol::GateInfo> gateInfo) {
   if (!gateInfo.asReader().getTypeInfo().hasIndex()) {
@@ -738,65 +685,116 @@ Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
     }
   }
 
-  /// Generating the encoding transformer.
-  Transformer encodingTransformer;
+  /// Generating the element encoder.
+  ElementEncoder encode;
   if (gateInfo.asReader()
           .getTypeInfo()
           .getLweCiphertext()
           .getEncoding()
           .hasBoolean()) {
-    OUTCOME_TRY(encodingTransformer, getBooleanEncodingTransformer());
+    OUTCOME_TRY(encode, getBooleanElementEncoder());
   } else if (gateInfo.asReader()
                  .getTypeInfo()
                  .getLweCiphertext()
                  .getEncoding()
                  .hasInteger()) {
-    OUTCOME_TRY(encodingTransformer,
-                getIntegerEncodingTransformer(gateInfo.asReader()
-                                                  .getTypeInfo()
-                                                  .getLweCiphertext()
-                                                  .getEncoding()
-                                                  .getInteger()));
+    OUTCOME_TRY(encode, getIntegerElementEncoder(gateInfo.asReader()
+                                                     .getTypeInfo()
+                                                     .getLweCiphertext()
+                                                     .getEncoding()
+                                                     .getInteger()));
   } else {
     return StringError("Malformed gate info");
   }
 
-  /// Generating the encryption transformer.
-  Transformer encryptionTransformer;
+  /// Generating the plaintext encrypter.
+  PlaintextEncrypter encrypt;
   if (useSimulation) {
-    OUTCOME_TRY(encryptionTransformer,
-                getEncryptionSimulationTransformer(gateInfo.asReader()
-                                                       .getTypeInfo()
-                                                       .getLweCiphertext()
-                                                       .getEncryption(),
-                                                   csprng));
+    OUTCOME_TRY(encrypt,
+                getPlaintextSimulationEncrypter(gateInfo.asReader()
+                                                    .getTypeInfo()
+                                                    .getLweCiphertext()
+                                                    .getEncryption(),
+                                                csprng));
   } else {
-    OUTCOME_TRY(encryptionTransformer,
-                getEncryptionTransformer(keyset,
-                                         gateInfo.asReader()
-                                             .getTypeInfo()
-                                             .getLweCiphertext()
-                                             .getEncryption(),
-                                         csprng));
+    OUTCOME_TRY(encrypt, getPlaintextEncrypter(keyset,
+                                               gateInfo.asReader()
+                                                   .getTypeInfo()
+                                                   .getLweCiphertext()
+                                                   .getEncryption(),
+                                               csprng));
   }
 
-  /// Generating the compression transformer.
-  Transformer compressionTransformer;
-  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() ==
+  /// Only the none compression is supported, which leaves the ciphertexts
+  /// untouched.
+  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() !=
       concreteprotocol::Compression::NONE) {
-    OUTCOME_TRY(compressionTransformer, getNoneCompressionTransformer());
-  } else {
     return StringError(
         "Only none compression is currently supported for lwe ciphertext "
         "currently.");
   }
 
+  auto blocks = getEncodingBlocks(
+      gateInfo.asReader().getTypeInfo().getLweCiphertext());
+  size_t plaintextsPerElement = blocks.value_or(1);
+  auto lweDimension = gateInfo.asReader()
+                          .getTypeInfo()
+                          .getLweCiphertext()
+                          .getEncryption()
+                          .getLweDimension();
+  size_t ciphertextSize = useSimulation ? 1 : lweDimension + 1;
+
   OUTCOME_TRY(auto verify, getLweCiphertextInputValueVerifier(gateInfo));
   return [=](Value val) -> Result<TransportValue> {
     OUTCOME_TRYV(verify(val));
-    auto output =
-        compressionTransformer(encryptionTransformer(encodingTransformer(val)))
-            .intoRawTransportValue();
+
+    // The encoding, encryption and (none) compression are performed in a
+    // single pass, each ciphertext being encrypted directly into the payload
+    // of the transport value.
+    const uint64_t *values;
+    if (val.isSigned()) {
+      values = reinterpret_cast<const uint64_t *>(
+          val.getTensorPtr<int64_t>()->values.data());
+    } else {
+      values = val.getTensorPtr<uint64_t>()->values.data();
+    }
+    auto dimensions = val.getDimensions();
+    size_t numElements = 1;
+    for (auto dim : dimensions) {
+      numElements *= dim;
+    }
+    if (blocks.has_value()) {
+      dimensions.push_back(blocks.value());
+    }
+    if (!useSimulation) {
+      dimensions.push_back(ciphertextSize);
+    }
+
+    auto output = Message<concreteprotocol::Value>();
+    auto rawInfo = output.asBuilder().initRawInfo();
+    rawInfo.setShape(dimensionsToProtoShape(dimensions).asReader());
+    rawInfo.setIntegerPrecision(64);
+    rawInfo.setIsSigned(false);
+    auto payload = initPayloadWords(
+        output.asBuilder().initPayload(),
+        numElements * plaintextsPerElement * ciphertextSize);
+
+    std::vector<uint64_t> plaintexts(plaintextsPerElement);
+    std::vector<uint64_t> ciphertext(ciphertextSize);
+    for (size_t i = 0; i < numElements; i++) {
+      encode(values[i], plaintexts.data());
+      for (size_t j = 0; j < plaintextsPerElement; j++) {
+        auto offset = (i * plaintextsPerElement + j) * ciphertextSize;
+        // Ciphertexts straddling two blobs go through a scratch buffer.
+        if (auto ptr = payload.contiguous(offset, ciphertextSize)) {
+          encrypt(plaintexts[j], ptr);
+        } else {
+          encrypt(plaintexts[j], ciphertext.data());
+          payload.write(offset, ciphertext.data(), ciphertextSize);
+        }
+      }
+    }
+
     output.asBuilder().initTypeInfo().setLweCiphertext(
         gateInfo.asReader().getTypeInfo().getLweCiphertext());
     return output;
@@ -890,48 +888,44 @@ Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
     }
   }
 
-  /// Generating the decompression transformer.
-  Transformer decompressionTransformer;
-  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() ==
+  /// Only the none compression is supported, which leaves the ciphertexts
+  /// untouched.
+  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() !=
       concreteprotocol::Compression::NONE) {
-    OUTCOME_TRY(decompressionTransformer, getNoneDecompressionTransformer());
-  } else {
     return StringError(
         "Only none compression is currently supported for lwe ciphertext "
         "currently.");
   }
 
-  /// Generating the decryption transformer.
-  Transformer decryptionTransformer;
+  /// Generating the ciphertext decrypter.
+  CiphertextDecrypter decrypt;
   if (useSimulation) {
-    OUTCOME_TRY(decryptionTransformer, getDecryptionSimulationTransformer());
+    OUTCOME_TRY(decrypt, getCiphertextSimulationDecrypter());
   } else {
-    OUTCOME_TRY(decryptionTransformer,
-                getDecryptionTransformer(keyset, gateInfo.asReader()
-                                                     .getTypeInfo()
-                                                     .getLweCiphertext()
-                                                     .getEncryption()));
+    OUTCOME_TRY(decrypt, getCiphertextDecrypter(keyset, gateInfo.asReader()
+                                                            .getTypeInfo()
+                                                            .getLweCiphertext()
+                                                            .getEncryption()));
   }
 
-  /// Generating the decoding transformer.
-  Transformer decodingTransformer;
+  /// Generating the element decoder.
+  ElementDecoder decode;
+  bool isSigned = false;
   if (gateInfo.asReader()
           .getTypeInfo()
           .getLweCiphertext()
           .getEncoding()
           .hasBoolean()) {
-    OUTCOME_TRY(decodingTransformer, getBooleanDecodingTransformer());
+    OUTCOME_TRY(decode, getBooleanElementDecoder());
   } else if (gateInfo.asReader()
                  .getTypeInfo()
                  .getLweCiphertext()
                  .getEncoding()
                  .hasInteger()) {
-    OUTCOME_TRY(decodingTransformer,
-                getIntegerDecodingTransformer(gateInfo.asReader()
-                                                  .getTypeInfo()
-                                                  .getLweCiphertext()
-                                                  .getEncoding()
-                                                  .getInteger()));
+    auto info =
+        gateInfo.asReader().getTypeInfo().getLweCiphertext().getEncoding();
+    OUTCOME_TRY(decode, getIntegerElementDecoder(info.getInteger()));
+    isSigned = info.getInteger().getIsSigned();
   } else {
     return StringError("Malformed gate info");
   }
@@ -944,10 +938,64 @@ Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
     OUTCOME_TRY(verify, getTransportValueVerifier(gateInfo));
   }
 
+  auto blocks = getEncodingBlocks(
+      gateInfo.asReader().getTypeInfo().getLweCiphertext());
+  size_t plaintextsPerElement = blocks.value_or(1);
+  auto lweDimension = gateInfo.asReader()
+                          .getTypeInfo()
+                          .getLweCiphertext()
+                          .getEncryption()
+                          .getLweDimension();
+  size_t ciphertextSize = useSimulation ? 1 : lweDimension + 1;
+
   return [=](TransportValue transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
-    return decodingTransformer(decryptionTransformer(
-        decompressionTransformer(Value::fromRawTransportValue(transportVal))));
+
+    // The (none) decompression, decryption and decoding are performed in a
+    // single pass, each ciphertext being decrypted directly from the payload
+    // of the transport value.
+    auto dimensions =
+        protoShapeToDimensions(transportVal.asReader().getRawInfo().getShape());
+    if (!useSimulation) {
+      dimensions.pop_back();
+    }
+    if (blocks.has_value()) {
+      dimensions.pop_back();
+    }
+    size_t numElements = 1;
+    for (auto dim : dimensions) {
+      numElements *= dim;
+    }
+    auto payload = getPayloadWords(transportVal.asReader().getPayload());
+
+    std::vector<uint64_t> plaintexts(plaintextsPerElement);
+    std::vector<uint64_t> ciphertext(ciphertextSize);
+    auto decryptAndDecode = [&](auto &outputTensor) {
+      outputTensor.dimensions = dimensions;
+      outputTensor.values.resize(numElements);
+      for (size_t i = 0; i < numElements; i++) {
+        for (size_t j = 0; j < plaintextsPerElement; j++) {
+          auto offset = (i * plaintextsPerElement + j) * ciphertextSize;
+          // Ciphertexts straddling two blobs go through a scratch buffer.
+          if (auto ptr = payload.contiguous(offset, ciphertextSize)) {
+            plaintexts[j] = decrypt(ptr);
+          } else {
+            payload.read(offset, ciphertext.data(), ciphertextSize);
+            plaintexts[j] = decrypt(ciphertext.data());
+          }
+        }
+        outputTensor.values[i] = decode(plaintexts.data());
+      }
+    };
+
+    if (isSigned) {
+      Tensor<int64_t> outputTensor;
+      decryptAndDecode(outputTensor);
+      return Value{outputTensor};
+    }
+    Tensor<uint64_t> outputTensor;
+    decryptAndDecode(outputTensor);
+    return Value{outputTensor};
   };
 }
 
@@ -26,6 +26,8 @@ char memref_add_plaintext_lwe_ciphertext_u64[] =
 char memref_mul_cleartext_lwe_ciphertext_u64[] =
     "memref_mul_cleartext_lwe_ciphertext_u64";
 char memref_negate_lwe_ciphertext_u64[] = "memref_negate_lwe_ciphertext_u64";
+char memref_mul_cleartext_add_lwe_ciphertext_u64[] =
+    "memref_mul_cleartext_add_lwe_ciphertext_u64";
 char memref_keyswitch_lwe_u64[] = "memref_keyswitch_lwe_u64";
 char memref_bootstrap_lwe_u64[] = "memref_bootstrap_lwe_u64";
 char memref_batched_add_lwe_ciphertexts_u64[] =
@@ -40,6 +42,10 @@ char memref_batched_mul_cleartext_cst_lwe_ciphertext_u64[] =
     "memref_batched_mul_cleartext_cst_lwe_ciphertext_u64";
 char memref_batched_negate_lwe_ciphertext_u64[] =
     "memref_batched_negate_lwe_ciphertext_u64";
+char memref_matmul_cleartext_lwe_ciphertext_u64[] =
+    "memref_matmul_cleartext_lwe_ciphertext_u64";
+char memref_conv2d_cleartext_lwe_ciphertext_u64[] =
+    "memref_conv2d_cleartext_lwe_ciphertext_u64";
 char memref_batched_keyswitch_lwe_u64[] = "memref_batched_keyswitch_lwe_u64";
 char memref_batched_bootstrap_lwe_u64[] = "memref_batched_bootstrap_lwe_u64";
 char memref_batched_mapped_bootstrap_lwe_u64[] =
@@ -60,6 +66,8 @@ char memref_expand_lut_in_trivial_glwe_ct_u64[] =
     "memref_expand_lut_in_trivial_glwe_ct_u64";
 
 char memref_wop_pbs_crt_buffer[] = "memref_wop_pbs_crt_buffer";
+char memref_batched_wop_pbs_crt_buffer[] =
+    "memref_batched_wop_pbs_crt_buffer";
 
 char memref_encode_plaintext_with_crt[] = "memref_encode_plaintext_with_crt";
 char memref_encode_expand_lut_for_bootstrap[] =
@@ -74,6 +82,12 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 1);
   auto memref2DType =
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 2);
+  auto memref3DType =
+      mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 3);
+  auto memref4DType =
+      mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 4);
+  auto memref5DType =
+      mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 5);
   auto futureType =
       mlir::concretelang::RT::FutureType::get(rewriter.getIndexType());
   auto contextType =
@@ -93,6 +107,10 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
     funcType = mlir::FunctionType::get(
         rewriter.getContext(),
         {memref1DType, memref1DType, rewriter.getI64Type()}, {});
+  } else if (funcName == memref_mul_cleartext_add_lwe_ciphertext_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref1DType, memref1DType, memref1DType, rewriter.getI64Type()}, {});
   } else if (funcName == memref_negate_lwe_ciphertext_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {memref1DType, memref1DType}, {});
@@ -141,6 +159,16 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
   } else if (funcName == memref_batched_negate_lwe_ciphertext_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {memref2DType, memref2DType}, {});
+  } else if (funcName == memref_matmul_cleartext_lwe_ciphertext_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(), {memref3DType, memref3DType, memref2DType}, {});
+  } else if (funcName == memref_conv2d_cleartext_lwe_ciphertext_u64) {
+    auto i64Type = rewriter.getI64Type();
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {memref5DType, memref5DType,
+                                        memref4DType, i64Type, i64Type, i64Type,
+                                        i64Type, i64Type},
+                                       {});
   } else if (funcName == memref_batched_keyswitch_lwe_u64 ||
              funcName == memref_batched_keyswitch_lwe_cuda_u64) {
     funcType =
@@ -176,11 +204,14 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                            memref1DType,
                                        },
                                        {});
-  } else if (funcName == memref_wop_pbs_crt_buffer) {
+  } else if (funcName == memref_wop_pbs_crt_buffer ||
+             funcName == memref_batched_wop_pbs_crt_buffer) {
+    auto ciphertextType =
+        funcName == memref_wop_pbs_crt_buffer ? memref2DType : memref3DType;
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {
-                                           memref2DType,
-                                           memref2DType,
+                                           ciphertextType,
+                                           ciphertextType,
                                            memref2DType,
                                            memref1DType,
                                            rewriter.getI32Type(),
@@ -332,8 +363,8 @@ void bootstrapAddOperands(BootstrapOp op,
   operands.push_back(getContextArgument(op));
 }
 
-void wopPBSAddOperands(Concrete::WopPBSCRTLweBufferOp op,
-                       mlir::SmallVector<mlir::Value> &operands,
+template <typename WopPBSOp>
+void wopPBSAddOperands(WopPBSOp op, mlir::SmallVector<mlir::Value> &operands,
                        mlir::RewriterBase &rewriter) {
   mlir::Type crtType = mlir::RankedTensorType::get(
       {(int)op.getCrtDecompositionAttr().size()}, rewriter.getI64Type());
@@ -426,6 +457,20 @@ void encodePlaintextWithCrtAddOperands(
       op.getLoc(), op.getModsProdAttr()));
 }
 
+void conv2dAddOperands(Concrete::Conv2dCleartextLweBufferOp op,
+                       mlir::SmallVector<mlir::Value> &operands,
+                       mlir::RewriterBase &rewriter) {
+  auto strides = op.getStrides();
+  auto dilations = op.getDilations();
+  // stride_h, stride_w, dilation_h, dilation_w
+  for (int64_t value : {strides[0], strides[1], dilations[0], dilations[1]})
+    operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+        op.getLoc(), rewriter.getI64IntegerAttr(value)));
+  // group
+  operands.push_back(
+      rewriter.create<mlir::arith::ConstantOp>(op.getLoc(), op.getGroupAttr()));
+}
+
 void encodeExpandLutForBootstrapAddOperands(
     Concrete::EncodeExpandLutForBootstrapBufferOp op,
     mlir::SmallVector<mlir::Value> &operands, mlir::RewriterBase &rewriter) {
@@ -523,6 +568,10 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
         ConcreteToCAPICallPattern<Concrete::MulCleartextLweBufferOp,
                                   memref_mul_cleartext_lwe_ciphertext_u64>>(
         &getContext());
+    patterns.add<
+        ConcreteToCAPICallPattern<Concrete::MulCleartextAddLweBufferOp,
+                                  memref_mul_cleartext_add_lwe_ciphertext_u64>>(
+        &getContext());
     patterns.add<ConcreteToCAPICallPattern<Concrete::NegateLweBufferOp,
                                            memref_negate_lwe_ciphertext_u64>>(
         &getContext());
@@ -558,6 +607,14 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
         ConcreteToCAPICallPattern<Concrete::BatchedNegateLweBufferOp,
                                   memref_batched_negate_lwe_ciphertext_u64>>(
         &getContext());
+    patterns.add<
+        ConcreteToCAPICallPattern<Concrete::MatMulCleartextLweBufferOp,
+                                  memref_matmul_cleartext_lwe_ciphertext_u64>>(
+        &getContext());
+    patterns.add<
+        ConcreteToCAPICallPattern<Concrete::Conv2dCleartextLweBufferOp,
+                                  memref_conv2d_cleartext_lwe_ciphertext_u64>>(
+        &getContext(), conv2dAddOperands);
     if (gpu) {
       patterns.add<ConcreteToCAPICallPattern<Concrete::KeySwitchLweBufferOp,
                                              memref_keyswitch_lwe_cuda_u64>>(
@@ -606,7 +663,12 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
 
     patterns.add<ConcreteToCAPICallPattern<Concrete::WopPBSCRTLweBufferOp,
                                            memref_wop_pbs_crt_buffer>>(
-        &getContext(), wopPBSAddOperands);
+        &getContext(), wopPBSAddOperands<Concrete::WopPBSCRTLweBufferOp>);
+    patterns.add<
+        ConcreteToCAPICallPattern<Concrete::BatchedWopPBSCRTLweBufferOp,
+                                  memref_batched_wop_pbs_crt_buffer>>(
+        &getContext(),
+        wopPBSAddOperands<Concrete::BatchedWopPBSCRTLweBufferOp>);
 
     // Apply conversion
     if (mlir::applyPartialConversion(op, target, std::move(patterns))
@@ -1936,11 +1936,150 @@ struct FHELinalgUnaryOpToLinalgGeneric
   };
 };
 
+/// Returns true if `matmulOp` multiplies two matrices, in which case it is
+/// left as is to be computed by a single matrix product kernel.
+bool isMatrixProduct(FHELinalg::MatMulEintIntOp matmulOp) {
+  auto lhsType = matmulOp.getLhs().getType().cast<mlir::RankedTensorType>();
+  auto rhsType = matmulOp.getRhs().getType().cast<mlir::RankedTensorType>();
+  return lhsType.getRank() == 2 && rhsType.getRank() == 2;
+}
+
+/// This rewrite pattern transforms any instance of
+/// `FHELinalg.dot_eint_int` to the product of a row vector by a column
+/// vector, so that it is computed by the matrix product kernel.
+///
+/// Example:
+///
+///   %o = "FHELinalg.dot_eint_int"(%arg0, %arg1) :
+///     (tensor<4x!FHE.eint<0>>, tensor<4xi32>) -> (!FHE.eint<0>)
+///
+/// becomes:
+///
+///   %0 = tensor.expand_shape %arg0 [[0, 1]] :
+///     tensor<4x!FHE.eint<0>> into tensor<1x4x!FHE.eint<0>>
+///   %1 = tensor.expand_shape %arg1 [[0, 1]] :
+///     tensor<4xi32> into tensor<4x1xi32>
+///   %2 = "FHELinalg.matmul_eint_int"(%0, %1) :
+///     (tensor<1x4x!FHE.eint<0>>, tensor<4x1xi32>) -> tensor<1x1x!FHE.eint<0>>
+///   %c0 = arith.constant 0 : index
+///   %o = tensor.extract %2[%c0, %c0] : tensor<1x1x!FHE.eint<0>>
+///
+struct DotToMatmul : public ::mlir::OpRewritePattern<FHELinalg::Dot> {
+  DotToMatmul(::mlir::MLIRContext *context)
+      : ::mlir::OpRewritePattern<FHELinalg::Dot>(
+            context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT + 1) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(FHELinalg::Dot dotOp,
+                  ::mlir::PatternRewriter &rewriter) const override {
+    mlir::Location location = dotOp.getLoc();
+
+    auto lhsType = dotOp.getLhs().getType().cast<mlir::RankedTensorType>();
+    auto rhsType = dotOp.getRhs().getType().cast<mlir::RankedTensorType>();
+    int64_t size = lhsType.getDimSize(0);
+
+    llvm::SmallVector<mlir::ReassociationIndices, 1> reassociation{{0, 1}};
+    mlir::Value row = rewriter.create<mlir::tensor::ExpandShapeOp>(
+        location,
+        mlir::RankedTensorType::get({1, size}, lhsType.getElementType()),
+        dotOp.getLhs(), reassociation);
+    mlir::Value column = rewriter.create<mlir::tensor::ExpandShapeOp>(
+        location,
+        mlir::RankedTensorType::get({size, 1}, rhsType.getElementType()),
+        dotOp.getRhs(), reassociation);
+
+    auto matmulOp = rewriter.create<FHELinalg::MatMulEintIntOp>(
+        location, mlir::RankedTensorType::get({1, 1}, dotOp.getType()), row,
+        column);
+    forwardOptimizerID(dotOp, matmulOp);
+
+    mlir::Value idx0 =
+        rewriter.create<mlir::arith::ConstantIndexOp>(location, 0);
+    rewriter.replaceOpWithNewOp<mlir::tensor::ExtractOp>(
+        dotOp, matmulOp.getResult(), mlir::ValueRange{idx0, idx0});
+
+    return ::mlir::success();
+  };
+};
+
+/// Returns true if `conv2dOp` has no bias, in which case it is left as is to
+/// be computed by the convolution kernel.
+bool isConv2dWithoutBias(FHELinalg::Conv2dOp conv2dOp) {
+  return !conv2dOp.getBias();
+}
+
+/// This rewrite pattern splits the bias of `FHELinalg.conv2d` into an
+/// addition, so that the convolution itself is computed by the convolution
+/// kernel. A bias made of zeros is simply dropped.
+///
+/// Example:
+///
+///   %o = "FHELinalg.conv2d"(%x, %w, %b) :
+///     (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>, tensor<2xi7>)
+///     -> tensor<1x2x6x6x!FHE.eint<6>>
+///
+/// becomes:
+///
+///   %0 = "FHELinalg.conv2d"(%x, %w) :
+///     (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>)
+///     -> tensor<1x2x6x6x!FHE.eint<6>>
+///   %1 = tensor.expand_shape %b [[0, 1, 2]] :
+///     tensor<2xi7> into tensor<2x1x1xi7>
+///   %o = "FHELinalg.add_eint_int"(%0, %1) :
+///     (tensor<1x2x6x6x!FHE.eint<6>>, tensor<2x1x1xi7>)
+///     -> tensor<1x2x6x6x!FHE.eint<6>>
+///
+struct SplitConv2dBias : public ::mlir::OpRewritePattern<FHELinalg::Conv2dOp> {
+  SplitConv2dBias(::mlir::MLIRContext *context)
+      : ::mlir::OpRewritePattern<FHELinalg::Conv2dOp>(
+            context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT + 1) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(FHELinalg::Conv2dOp conv2dOp,
+                  ::mlir::PatternRewriter &rewriter) const override {
+    mlir::Value bias = conv2dOp.getBias();
+    if (!bias)
+      return ::mlir::failure();
+
+    mlir::Location location = conv2dOp.getLoc();
+    auto newConv2dOp = rewriter.create<FHELinalg::Conv2dOp>(
+        location, conv2dOp.getType(), conv2dOp.getInput(),
+        conv2dOp.getWeight(), mlir::Value(), conv2dOp.getPaddingAttr(),
+        conv2dOp.getStridesAttr(), conv2dOp.getDilationsAttr(),
+        conv2dOp.getGroupAttr());
+    forwardOptimizerID(conv2dOp, newConv2dOp);
+
+    if (isZeroConstant(bias)) {
+      rewriter.replaceOp(conv2dOp, newConv2dOp.getResult());
+      return ::mlir::success();
+    }
+
+    auto biasType = bias.getType().cast<mlir::RankedTensorType>();
+    llvm::SmallVector<mlir::ReassociationIndices, 1> reassociation{{0, 1, 2}};
+    mlir::Value expandedBias = rewriter.create<mlir::tensor::ExpandShapeOp>(
+        location,
+        mlir::RankedTensorType::get({biasType.getDimSize(0), 1, 1},
+                                    biasType.getElementType()),
+        bias, reassociation);
+    auto addOp = rewriter.replaceOpWithNewOp<FHELinalg::AddEintIntOp>(
+        conv2dOp, conv2dOp.getType(), newConv2dOp.getResult(), expandedBias);
+    forwardOptimizerID(conv2dOp, addOp);
+
+    return ::mlir::success();
+  };
+};
+
 namespace {
 struct FHETensorOpsToLinalg
     : public FHETensorOpsToLinalgBase<FHETensorOpsToLinalg> {
 
+  FHETensorOpsToLinalg(bool lowerMatmulToGemm)
+      : lowerMatmulToGemm(lowerMatmulToGemm) {}
+
   void runOnOperation() final;
+
+private:
+  bool lowerMatmulToGemm;
 };
 
 void FHETensorOpsToLinalg::runOnOperation() {
@@ -1958,6 +2097,18 @@ void FHETensorOpsToLinalg::runOnOperation() {
 
   mlir::RewritePatternSet patterns(&getContext());
 
+  // Products of encrypted matrices by clear matrices and 2D convolutions are
+  // kept, to be lowered to a single call to the matrix product or convolution
+  // kernel of the runtime instead of loops of scalar multiplications and
+  // additions.
+  if (lowerMatmulToGemm) {
+    target.addDynamicallyLegalOp<FHELinalg::MatMulEintIntOp>(
+        isMatrixProduct);
+    target.addDynamicallyLegalOp<FHELinalg::Conv2dOp>(isConv2dWithoutBias);
+    patterns.insert<DotToMatmul>(&getContext());
+    patterns.insert<SplitConv2dBias>(&getContext());
+  }
+
   patterns.insert<DotToLinalgGeneric<mlir::concretelang::FHELinalg::Dot,
                                      mlir::concretelang::FHE::MulEintIntOp>>(
       &getContext(),
@@ -2120,8 +2271,8 @@ void FHETensorOpsToLinalg::runOnOperation() {
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
-createConvertFHETensorOpsToLinalg() {
-  return std::make_unique<FHETensorOpsToLinalg>();
+createConvertFHETensorOpsToLinalg(bool lowerMatmulToGemm) {
+  return std::make_unique<FHETensorOpsToLinalg>(lowerMatmulToGemm);
 }
 } // namespace concretelang
 } // namespace mlir
@@ -23,6 +23,7 @@
 #include "concretelang/Dialect/FHE/IR/FHEDialect.h"
 #include "concretelang/Dialect/FHE/IR/FHEOps.h"
 #include "concretelang/Dialect/FHE/IR/FHETypes.h"
+#include "concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h"
 #include "concretelang/Dialect/RT/IR/RTDialect.h"
 #include "concretelang/Dialect/RT/IR/RTOps.h"
 #include "concretelang/Dialect/RT/IR/RTTypes.h"
@@ -34,6 +35,7 @@
 #include "concretelang/Support/logging.h"
 
 namespace FHE = mlir::concretelang::FHE;
+namespace FHELinalg = mlir::concretelang::FHELinalg;
 namespace TFHE = mlir::concretelang::TFHE;
 namespace Tracing = mlir::concretelang::Tracing;
 
@@ -321,6 +323,85 @@ struct MulEintIntOpPattern : public ScalarOpPattern<FHE::MulEintIntOp> {
   }
 };
 
+/// Rewriter for the `FHELinalg::matmul_eint_int` operations kept by the
+/// lowering of `FHELinalg` to be computed by a single kernel.
+struct MatMulEintIntOpPattern
+    : public ScalarOpPattern<FHELinalg::MatMulEintIntOp> {
+  MatMulEintIntOpPattern(mlir::TypeConverter &converter,
+                         mlir::MLIRContext *context,
+                         mlir::PatternBenefit benefit = 1)
+      : ScalarOpPattern<FHELinalg::MatMulEintIntOp>(converter, context,
+                                                    benefit) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(FHELinalg::MatMulEintIntOp op,
+                  FHELinalg::MatMulEintIntOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    mlir::Location location = op.getLoc();
+    mlir::Value intOperand = adaptor.getRhs();
+    auto intType = intOperand.getType().cast<mlir::RankedTensorType>();
+
+    // Write the cleartexts "encoding"
+    if (intType.getElementTypeBitWidth() != 64) {
+      intOperand = rewriter.create<mlir::arith::ExtSIOp>(
+          location,
+          mlir::RankedTensorType::get(intType.getShape(),
+                                      rewriter.getIntegerType(64)),
+          intOperand);
+    }
+
+    // Write the new op.
+    auto newOp = rewriter.replaceOpWithNewOp<TFHE::MatMulGLWEIntOp>(
+        op, getTypeConverter()->convertType(op.getType()), adaptor.getLhs(),
+        intOperand);
+    forwardOptimizerID(op, newOp);
+
+    return mlir::success();
+  }
+};
+
+/// Rewriter for the `FHELinalg::conv2d` operations kept by the lowering of
+/// `FHELinalg` to be computed by a single kernel. The bias has been split
+/// into a separate addition beforehand.
+struct Conv2dEintIntOpPattern : public ScalarOpPattern<FHELinalg::Conv2dOp> {
+  Conv2dEintIntOpPattern(mlir::TypeConverter &converter,
+                         mlir::MLIRContext *context,
+                         mlir::PatternBenefit benefit = 1)
+      : ScalarOpPattern<FHELinalg::Conv2dOp>(converter, context, benefit) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(FHELinalg::Conv2dOp op, FHELinalg::Conv2dOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    if (op.getBias())
+      return rewriter.notifyMatchFailure(op, "bias should have been split");
+
+    mlir::Location location = op.getLoc();
+    mlir::Value weight = adaptor.getWeight();
+    auto weightType = weight.getType().cast<mlir::RankedTensorType>();
+
+    // Write the cleartexts "encoding"
+    if (weightType.getElementTypeBitWidth() != 64) {
+      weight = rewriter.create<mlir::arith::ExtSIOp>(
+          location,
+          mlir::RankedTensorType::get(weightType.getShape(),
+                                      rewriter.getIntegerType(64)),
+          weight);
+    }
+
+    // Write the new op.
+    auto newOp = rewriter.replaceOpWithNewOp<TFHE::Conv2dGLWEIntOp>(
+        op, getTypeConverter()->convertType(op.getType()), adaptor.getInput(),
+        weight,
+        rewriter.getDenseI64ArrayAttr(FHELinalg::getStridesFromConv2d(op)),
+        rewriter.getDenseI64ArrayAttr(FHELinalg::getDilationsFromConv2d(op)),
+        rewriter.getI64IntegerAttr(FHELinalg::getGroupFromConv2d(op)));
+    forwardOptimizerID(op, newOp);
+
+    return mlir::success();
+  }
+};
+
 /// Rewriter for the `FHE::apply_lookup_table` operation.
 struct ApplyLookupTableEintOpPattern
     : public ScalarOpPattern<FHE::ApplyLookupTableEintOp> {
@@ -771,6 +852,7 @@ struct FHEToTFHEScalarPass : public FHEToTFHEScalarBase<FHEToTFHEScalarPass> {
 
     //------------------------------------------- Marking legal/illegal dialects
     target.addIllegalDialect<FHE::FHEDialect>();
+    target.addIllegalOp<FHELinalg::MatMulEintIntOp, FHELinalg::Conv2dOp>();
     target.addLegalDialect<TFHE::TFHEDialect>();
     target.addLegalDialect<mlir::arith::ArithDialect>();
     target.addDynamicallyLegalOp<mlir::linalg::GenericOp,
@@ -823,6 +905,10 @@ struct FHEToTFHEScalarPass : public FHEToTFHEScalarBase<FHEToTFHEScalarPass> {
                  lowering::SubEintOpPattern,
                  //    |_ `FHE::mul_eint_int`
                  lowering::MulEintIntOpPattern,
+                 //    |_ `FHELinalg::matmul_eint_int`
+                 lowering::MatMulEintIntOpPattern,
+                 //    |_ `FHELinalg::conv2d`
+                 lowering::Conv2dEintIntOpPattern,
                  //    |_ `FHE::to_signed`
                  lowering::NoopScalarOpPattern<FHE::ToSignedOp,
                                                FHE::ToSignedOp::Adaptor>,
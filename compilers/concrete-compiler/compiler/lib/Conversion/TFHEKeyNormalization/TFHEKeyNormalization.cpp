@@ -280,6 +280,12 @@ void populateWithTFHEOpTypeConversionPatterns(
       patterns, target, typeConverter);
   populateWithTFHEOpTypeConversionPattern<
       mlir::concretelang::TFHE::MulGLWEIntOp>(patterns, target, typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::MatMulGLWEIntOp>(patterns, target,
+                                                 typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::Conv2dGLWEIntOp>(patterns, target,
+                                                 typeConverter);
 }
 } // namespace
 
@@ -143,17 +143,19 @@ struct BootstrapGLWEOpPattern
   }
 };
 
-struct WopPBSGLWEOpPattern
-    : public mlir::OpConversionPattern<TFHE::WopPBSGLWEOp> {
+/// Lowers a wop-pbs operation, or its batched version, to the Concrete
+/// operation `ConcreteOp`.
+template <typename TFHEOp, typename ConcreteOp>
+struct WopPBSGLWEOpPattern : public mlir::OpConversionPattern<TFHEOp> {
 
   WopPBSGLWEOpPattern(mlir::MLIRContext *context,
                       mlir::TypeConverter &typeConverter)
-      : mlir::OpConversionPattern<TFHE::WopPBSGLWEOp>(
+      : mlir::OpConversionPattern<TFHEOp>(
             typeConverter, context,
             mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
 
   ::mlir::LogicalResult
-  matchAndRewrite(TFHE::WopPBSGLWEOp op, TFHE::WopPBSGLWEOp::Adaptor adaptor,
+  matchAndRewrite(TFHEOp op, typename TFHEOp::Adaptor adaptor,
                   mlir::ConversionPatternRewriter &rewriter) const override {
 
     auto bsBaseLog = adaptor.getBsk().getBaseLog();
@@ -172,7 +174,7 @@ struct WopPBSGLWEOpPattern
     auto bskIndex = op.getBskAttr().getIndex();
     auto pkskIndex = op.getPkskAttr().getIndex();
 
-    rewriter.replaceOpWithNewOp<Concrete::WopPBSCRTLweTensorOp>(
+    rewriter.replaceOpWithNewOp<ConcreteOp>(
         op, this->getTypeConverter()->convertType(resultType),
         adaptor.getCiphertexts(), adaptor.getLookupTable(), bsLevels, bsBaseLog,
         ksLevels, ksBaseLog, pksInnerLweDim, pksOutputPolySize, pksLevels,
@@ -813,6 +815,12 @@ void TFHEToConcretePass::runOnOperation() {
       mlir::concretelang::GenericOneToOneOpConversionPattern<
           mlir::concretelang::TFHE::NegGLWEOp,
           mlir::concretelang::Concrete::NegateLweTensorOp>,
+      mlir::concretelang::GenericOneToOneOpConversionPattern<
+          mlir::concretelang::TFHE::MatMulGLWEIntOp,
+          mlir::concretelang::Concrete::MatMulCleartextLweTensorOp>,
+      mlir::concretelang::GenericOneToOneOpConversionPattern<
+          mlir::concretelang::TFHE::Conv2dGLWEIntOp,
+          mlir::concretelang::Concrete::Conv2dCleartextLweTensorOp, true>,
       mlir::concretelang::GenericOneToOneOpConversionPattern<
           mlir::concretelang::TFHE::EncodeExpandLutForBootstrapOp,
           mlir::concretelang::Concrete::EncodeExpandLutForBootstrapTensorOp,
@@ -851,8 +859,13 @@ void TFHEToConcretePass::runOnOperation() {
                   SubIntGLWEOpPattern, BootstrapGLWEOpPattern,
                   BatchedBootstrapGLWEOpPattern,
                   BatchedMappedBootstrapGLWEOpPattern, KeySwitchGLWEOpPattern,
-                  BatchedKeySwitchGLWEOpPattern, WopPBSGLWEOpPattern>(
-      &getContext(), converter);
+                  BatchedKeySwitchGLWEOpPattern,
+                  WopPBSGLWEOpPattern<mlir::concretelang::TFHE::WopPBSGLWEOp,
+                                      Concrete::WopPBSCRTLweTensorOp>,
+                  WopPBSGLWEOpPattern<
+                      mlir::concretelang::TFHE::BatchedWopPBSGLWEOp,
+                      Concrete::BatchedWopPBSCRTLweTensorOp>>(&getContext(),
+                                                              converter);
 
   // Add patterns to rewrite tensor operators that works on tensors of TFHE GLWE
   // types
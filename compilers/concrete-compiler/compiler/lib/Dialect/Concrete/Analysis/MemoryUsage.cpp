@@ -3,8 +3,10 @@
 #include <concretelang/Dialect/Concrete/IR/ConcreteOps.h>
 #include <concretelang/Support/logging.h>
 #include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/MemRef/IR/MemRef.h>
 #include <mlir/Dialect/SCF/IR/SCF.h>
+#include <mlir/Dialect/Utils/StaticValueUtils.h>
 #include <mlir/IR/BuiltinOps.h>
 #include <mlir/IR/Operation.h>
 #include <mlir/Interfaces/ViewLikeInterface.h>
@@ -57,6 +59,89 @@ bool isBufferDeallocated(mlir::Value buffer) {
   return false;
 }
 
+/// The memory held by the buffers allocated while executing some IR: the
+/// peak number of live bytes reached, and the number of bytes still live at
+/// the end, both relative to the live bytes at the beginning.
+struct LiveMemory {
+  int64_t peak = 0;
+  int64_t residual = 0;
+};
+
+LiveMemory getLiveMemory(mlir::Block &block);
+
+/// Returns the number of bytes of a buffer, or 0 if its size is unknown.
+int64_t getKnownBufferSize(mlir::Value buffer) {
+  auto bufferType = buffer.getType().dyn_cast<mlir::MemRefType>();
+  if (!bufferType)
+    return 0;
+  auto maybeBufferSize = getBufferSize(bufferType);
+  return maybeBufferSize ? maybeBufferSize.value() : 0;
+}
+
+/// Returns the number of iterations of a parallel loop, or 1 if it is not
+/// statically known.
+int64_t getNumberOfIterations(scf::ParallelOp op) {
+  int64_t iterations = 1;
+  for (auto [lb, ub, step] :
+       llvm::zip(op.getLowerBound(), op.getUpperBound(), op.getStep())) {
+    auto lbCst = mlir::getConstantIntValue(lb);
+    auto ubCst = mlir::getConstantIntValue(ub);
+    auto stepCst = mlir::getConstantIntValue(step);
+    if (!lbCst || !ubCst || !stepCst)
+      return 1;
+    iterations *= calculateNumberOfIterations(*lbCst, *ubCst, *stepCst);
+  }
+  return iterations;
+}
+
+LiveMemory getLiveMemory(mlir::Operation *op) {
+  if (auto allocOp = llvm::dyn_cast<memref::AllocOp>(op)) {
+    auto size = getKnownBufferSize(allocOp.getResult());
+    return {size, size};
+  }
+  if (auto deallocOp = llvm::dyn_cast<memref::DeallocOp>(op)) {
+    return {0, -getKnownBufferSize(deallocOp.getMemref())};
+  }
+  // Buffers allocated and not deallocated by an iteration accumulate over the
+  // next ones, the peak being reached during the last one.
+  if (auto forOp = llvm::dyn_cast<scf::ForOp>(op)) {
+    auto body = getLiveMemory(*forOp.getBody());
+    auto maybeIterations = calculateNumberOfIterations(forOp);
+    int64_t iterations = maybeIterations ? maybeIterations.value() : 1;
+    if (iterations <= 0)
+      return {};
+    int64_t residual = std::max<int64_t>(body.residual, 0);
+    return {body.peak + (iterations - 1) * residual, iterations * residual};
+  }
+  // Iterations of parallel loops may all be live at the same time.
+  if (auto parallelOp = llvm::dyn_cast<scf::ParallelOp>(op)) {
+    auto body = getLiveMemory(*parallelOp.getBody());
+    int64_t iterations = getNumberOfIterations(parallelOp);
+    return {iterations * body.peak,
+            iterations * std::max<int64_t>(body.residual, 0)};
+  }
+  // Only one of the regions of other operations is assumed to be executed.
+  LiveMemory live;
+  for (auto &region : op->getRegions()) {
+    for (auto &block : region) {
+      auto blockLive = getLiveMemory(block);
+      live.peak = std::max(live.peak, blockLive.peak);
+      live.residual = std::max(live.residual, blockLive.residual);
+    }
+  }
+  return live;
+}
+
+LiveMemory getLiveMemory(mlir::Block &block) {
+  LiveMemory live;
+  for (auto &op : block) {
+    auto opLive = getLiveMemory(&op);
+    live.peak = std::max(live.peak, live.residual + opLive.peak);
+    live.residual += opLive.residual;
+  }
+  return live;
+}
+
 } // namespace
 
 namespace mlir {
@@ -94,7 +179,17 @@ struct MemoryUsagePass
 
     if (walk.wasInterrupted()) {
       signalPassFailure();
+      return;
     }
+
+    // Functions are executed one at a time, so the peak memory usage is the
+    // one of the most demanding function.
+    getOperation()->walk([&](func::FuncOp func) {
+      if (func.isExternal())
+        return;
+      auto live = getLiveMemory(func.getBody().front());
+      feedback.peakMemoryUsage = std::max(feedback.peakMemoryUsage, live.peak);
+    });
   }
 
   std::optional<StringError> enter(mlir::Operation *op) {
@@ -93,6 +93,100 @@ struct TensorToMemrefOp : public BufferizableOpInterface::ExternalModel<
   }
 };
 
+/// Name of the attribute marking the leveled operations whose first operand
+/// cannot be overwritten, set while resolving the bufferization conflicts.
+constexpr llvm::StringLiteral outOfPlaceAttrName = "concrete.out_of_place";
+
+/// Bufferization of the leveled operations whose result has the shape of
+/// their first operand. When that operand is not read afterwards, the result
+/// is written in place of it, which saves the allocation of a temporary
+/// ciphertext buffer. Otherwise, the result is written to a new buffer
+/// rather than to a copy of the operand.
+template <typename TensorOp, typename MemrefOp>
+struct InPlaceTensorToMemrefOp
+    : public BufferizableOpInterface::ExternalModel<
+          InPlaceTensorToMemrefOp<TensorOp, MemrefOp>, TensorOp> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
+                              const AnalysisState &state) const {
+    return true;
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
+                               const AnalysisState &state) const {
+    return opOperand.getOperandNumber() == 0;
+  }
+
+  AliasingOpResultList getAliasingOpResults(Operation *op, OpOperand &opOperand,
+                                            const AnalysisState &state) const {
+    if (opOperand.getOperandNumber() != 0)
+      return {};
+    return {{op->getOpResult(0), BufferRelation::Equivalent}};
+  }
+
+  BufferRelation bufferRelation(Operation *op, OpResult opResult,
+                                const AnalysisState &state) const {
+    return BufferRelation::Equivalent;
+  }
+
+  LogicalResult resolveConflicts(Operation *op, RewriterBase &rewriter,
+                                 const AnalysisState &state) const {
+    if (!state.isInPlace(op->getOpOperand(0))) {
+      rewriter.updateRootInPlace(op, [&]() {
+        op->setAttr(outOfPlaceAttrName, rewriter.getUnitAttr());
+      });
+    }
+    return success();
+  }
+
+  LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
+                          const BufferizationOptions &options) const {
+    auto loc = op->getLoc();
+    auto castOp = cast<TensorOp>(op);
+
+    mlir::Value outMemref;
+    if (op->hasAttr(outOfPlaceAttrName)) {
+      auto resTensorType =
+          castOp.getResult().getType().template cast<mlir::TensorType>();
+      auto outMemrefType = MemRefType::get(resTensorType.getShape(),
+                                           resTensorType.getElementType());
+      auto alloc = options.createAlloc(rewriter, loc, outMemrefType, {});
+      if (mlir::failed(alloc)) {
+        return mlir::failure();
+      }
+      outMemref = *alloc;
+    } else {
+      auto buffer =
+          bufferization::getBuffer(rewriter, op->getOperand(0), options);
+      if (mlir::failed(buffer)) {
+        return mlir::failure();
+      }
+      outMemref = *buffer;
+    }
+
+    // The first operand is the result
+    mlir::SmallVector<mlir::Value, 4> operands{outMemref};
+    for (auto &operand : op->getOpOperands()) {
+      if (!operand.get().getType().isa<mlir::RankedTensorType>()) {
+        operands.push_back(operand.get());
+      } else {
+        operands.push_back(
+            *bufferization::getBuffer(rewriter, operand.get(), options));
+      }
+    }
+
+    mlir::SmallVector<mlir::NamedAttribute> attrs;
+    for (auto attr : op->getAttrs())
+      if (attr.getName() != outOfPlaceAttrName)
+        attrs.push_back(attr);
+
+    rewriter.create<MemrefOp>(loc, mlir::TypeRange{}, operands, attrs);
+
+    replaceOpWithBufferizedValues(rewriter, op, outMemref);
+
+    return success();
+  }
+};
+
 } // namespace
 
 void mlir::concretelang::Concrete::
@@ -100,22 +194,22 @@ void mlir::concretelang::Concrete::
   registry.addExtension(+[](MLIRContext *ctx,
                             Concrete::ConcreteDialect *dialect) {
     // add_lwe_tensor => add_lwe_buffer
-    Concrete::AddLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::AddLweTensorOp, Concrete::AddLweBufferOp>>(
-        *ctx);
+    Concrete::AddLweTensorOp::attachInterface<InPlaceTensorToMemrefOp<
+        Concrete::AddLweTensorOp, Concrete::AddLweBufferOp>>(*ctx);
     // add_plaintext_lwe_tensor => add_plaintext_lwe_buffer
-    Concrete::AddPlaintextLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::AddPlaintextLweTensorOp, Concrete::AddPlaintextLweBufferOp>>(
-        *ctx);
+    Concrete::AddPlaintextLweTensorOp::attachInterface<
+        InPlaceTensorToMemrefOp<Concrete::AddPlaintextLweTensorOp,
+                                Concrete::AddPlaintextLweBufferOp>>(*ctx);
     // mul_cleartext_lwe_tensor => mul_cleartext_lwe_buffer
-    Concrete::MulCleartextLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::MulCleartextLweTensorOp, Concrete::MulCleartextLweBufferOp>>(
-        *ctx);
+    Concrete::MulCleartextLweTensorOp::attachInterface<
+        InPlaceTensorToMemrefOp<Concrete::MulCleartextLweTensorOp,
+                                Concrete::MulCleartextLweBufferOp>>(*ctx);
+    // mul_cleartext_add_lwe_tensor => mul_cleartext_add_lwe_buffer
+    Concrete::MulCleartextAddLweTensorOp::attachInterface<
+        InPlaceTensorToMemrefOp<Concrete::MulCleartextAddLweTensorOp,
+                                Concrete::MulCleartextAddLweBufferOp>>(*ctx);
     // negate_cleartext_lwe_tensor => negate_cleartext_lwe_buffer
-    Concrete::NegateLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::NegateLweTensorOp, Concrete::NegateLweBufferOp>>(*ctx);
-    // negate_cleartext_lwe_tensor => negate_cleartext_lwe_buffer
-    Concrete::NegateLweTensorOp::attachInterface<TensorToMemrefOp<
+    Concrete::NegateLweTensorOp::attachInterface<InPlaceTensorToMemrefOp<
         Concrete::NegateLweTensorOp, Concrete::NegateLweBufferOp>>(*ctx);
     // keyswitch_lwe_tensor => keyswitch_lwe_buffer
     Concrete::KeySwitchLweTensorOp::attachInterface<TensorToMemrefOp<
@@ -125,32 +219,44 @@ void mlir::concretelang::Concrete::
         Concrete::BootstrapLweTensorOp, Concrete::BootstrapLweBufferOp>>(*ctx);
 
     // batched_add_lwe_tensor => batched_add_lwe_buffer
-    Concrete::BatchedAddLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::BatchedAddLweTensorOp, Concrete::BatchedAddLweBufferOp>>(
-        *ctx);
+    Concrete::BatchedAddLweTensorOp::attachInterface<
+        InPlaceTensorToMemrefOp<Concrete::BatchedAddLweTensorOp,
+                                Concrete::BatchedAddLweBufferOp>>(*ctx);
     // batched_add_plaintext_lwe_tensor => batched_add_plaintext_lwe_buffer
     Concrete::BatchedAddPlaintextLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedAddPlaintextLweTensorOp,
-                         Concrete::BatchedAddPlaintextLweBufferOp>>(*ctx);
+        InPlaceTensorToMemrefOp<Concrete::BatchedAddPlaintextLweTensorOp,
+                                Concrete::BatchedAddPlaintextLweBufferOp>>(
+        *ctx);
     // batched_add_plaintext_cst_lwe_tensor =>
     // batched_add_plaintext_cst_lwe_buffer
     Concrete::BatchedAddPlaintextCstLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedAddPlaintextCstLweTensorOp,
-                         Concrete::BatchedAddPlaintextCstLweBufferOp>>(*ctx);
+        InPlaceTensorToMemrefOp<Concrete::BatchedAddPlaintextCstLweTensorOp,
+                                Concrete::BatchedAddPlaintextCstLweBufferOp>>(
+        *ctx);
     // batched_mul_cleartext_lwe_tensor => batched_mul_cleartext_lwe_buffer
     Concrete::BatchedMulCleartextLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedMulCleartextLweTensorOp,
-                         Concrete::BatchedMulCleartextLweBufferOp>>(*ctx);
+        InPlaceTensorToMemrefOp<Concrete::BatchedMulCleartextLweTensorOp,
+                                Concrete::BatchedMulCleartextLweBufferOp>>(
+        *ctx);
     // batched_mul_cleartext_cst_lwe_tensor =>
     // batched_mul_cleartext_cst_lwe_buffer
     Concrete::BatchedMulCleartextCstLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedMulCleartextCstLweTensorOp,
-                         Concrete::BatchedMulCleartextCstLweBufferOp>>(*ctx);
+        InPlaceTensorToMemrefOp<Concrete::BatchedMulCleartextCstLweTensorOp,
+                                Concrete::BatchedMulCleartextCstLweBufferOp>>(
+        *ctx);
     // batched_negate_lwe_tensor => batched_negate_lwe_buffer
     Concrete::BatchedNegateLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::BatchedNegateLweTensorOp,
-                         Concrete::BatchedNegateLweBufferOp>>(*ctx);
+        InPlaceTensorToMemrefOp<Concrete::BatchedNegateLweTensorOp,
+                                Concrete::BatchedNegateLweBufferOp>>(*ctx);
 
+    // matmul_cleartext_lwe_tensor => matmul_cleartext_lwe_buffer
+    Concrete::MatMulCleartextLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::MatMulCleartextLweTensorOp,
+                         Concrete::MatMulCleartextLweBufferOp>>(*ctx);
+    // conv2d_cleartext_lwe_tensor => conv2d_cleartext_lwe_buffer
+    Concrete::Conv2dCleartextLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::Conv2dCleartextLweTensorOp,
+                         Concrete::Conv2dCleartextLweBufferOp>>(*ctx);
     // batched_keyswitch_lwe_tensor => batched_keyswitch_lwe_buffer
     Concrete::BatchedKeySwitchLweTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::BatchedKeySwitchLweTensorOp,
@@ -167,6 +273,10 @@ void mlir::concretelang::Concrete::
     // wop_pbs_crt_lwe_tensor => wop_pbs_crt_lwe_buffer
     Concrete::WopPBSCRTLweTensorOp::attachInterface<TensorToMemrefOp<
         Concrete::WopPBSCRTLweTensorOp, Concrete::WopPBSCRTLweBufferOp>>(*ctx);
+    // batched_wop_pbs_crt_lwe_tensor => batched_wop_pbs_crt_lwe_buffer
+    Concrete::BatchedWopPBSCRTLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::BatchedWopPBSCRTLweTensorOp,
+                         Concrete::BatchedWopPBSCRTLweBufferOp>>(*ctx);
     // encode_plaintext_with_crt_tensor => encode_plaintext_with_crt_buffer
     Concrete::EncodePlaintextWithCrtTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::EncodePlaintextWithCrtTensorOp,
@@ -0,0 +1,287 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/IRMapping.h"
+#include "llvm/ADT/SetVector.h"
+
+#include "concretelang/Dialect/Concrete/IR/ConcreteDialect.h"
+#include "concretelang/Dialect/Concrete/IR/ConcreteOps.h"
+#include "concretelang/Dialect/Concrete/Transforms/Passes.h"
+
+namespace {
+
+namespace Concrete = mlir::concretelang::Concrete;
+
+/// Returns true if `op` is a batched leveled operation, whose tensor
+/// operands and result all have one row per element of the batch.
+bool isBatchedLeveledOp(mlir::Operation *op) {
+  return llvm::isa<Concrete::BatchedAddLweTensorOp,
+                   Concrete::BatchedAddPlaintextLweTensorOp,
+                   Concrete::BatchedAddPlaintextCstLweTensorOp,
+                   Concrete::BatchedMulCleartextLweTensorOp,
+                   Concrete::BatchedMulCleartextCstLweTensorOp,
+                   Concrete::BatchedNegateLweTensorOp>(op);
+}
+
+/// Returns true if `operand` holds one row per element of the batch, i.e.
+/// anything but the lookup table shared by a batched bootstrap.
+bool isBatchedOperand(mlir::OpOperand &operand) {
+  if (!operand.get().getType().isa<mlir::RankedTensorType>())
+    return false;
+  return !llvm::isa<Concrete::BatchedBootstrapLweTensorOp>(
+             operand.getOwner()) ||
+         operand.getOperandNumber() == 0;
+}
+
+/// Returns the type of the chunk of `size` rows of the batched `type`.
+mlir::RankedTensorType getChunkType(mlir::Type type, int64_t size) {
+  auto tensorType = type.cast<mlir::RankedTensorType>();
+  llvm::SmallVector<int64_t> shape(tensorType.getShape());
+  shape[0] = size;
+  return mlir::RankedTensorType::get(shape, tensorType.getElementType());
+}
+
+/// Returns the number of 64 bits words of a row of the batched `type`.
+int64_t getRowSize(mlir::Type type) {
+  auto tensorType = type.cast<mlir::RankedTensorType>();
+  return tensorType.getRank() == 1 ? 1 : tensorType.getDimSize(1);
+}
+
+/// A batched bootstrap together with the batched keyswitch computing its
+/// input and the batched leveled operations computing the input of the
+/// keyswitch, whose results are only used within the chain.
+struct BatchedChain {
+  /// The operations of the chain, in the order of the block.
+  llvm::SmallVector<mlir::Operation *> ops;
+  /// The operands of the chain sliced along the batch.
+  llvm::SmallVector<mlir::Value> batchedInputs;
+  /// The number of rows of the chunks streamed through the chain.
+  int64_t chunkSize = 0;
+};
+
+/// Returns the chain ending with the batched bootstrap `bootstrap`, if the
+/// latter is fed by a batched keyswitch.
+std::optional<BatchedChain> getBatchedChain(mlir::Operation *bootstrap) {
+  auto keyswitch = bootstrap->getOperand(0)
+                       .getDefiningOp<Concrete::BatchedKeySwitchLweTensorOp>();
+  if (!keyswitch || !keyswitch->hasOneUse() ||
+      keyswitch->getBlock() != bootstrap->getBlock())
+    return std::nullopt;
+
+  llvm::SetVector<mlir::Operation *> ops;
+  ops.insert(bootstrap);
+  ops.insert(keyswitch);
+  llvm::SmallVector<mlir::Operation *> worklist{keyswitch};
+  while (!worklist.empty()) {
+    auto op = worklist.pop_back_val();
+    for (auto operand : op->getOperands()) {
+      auto producer = operand.getDefiningOp();
+      if (producer && isBatchedLeveledOp(producer) && producer->hasOneUse() &&
+          producer->getBlock() == bootstrap->getBlock() &&
+          ops.insert(producer))
+        worklist.push_back(producer);
+    }
+  }
+
+  BatchedChain chain;
+  chain.ops.assign(ops.begin(), ops.end());
+  llvm::sort(chain.ops, [](mlir::Operation *a, mlir::Operation *b) {
+    return a->isBeforeInBlock(b);
+  });
+  llvm::SetVector<mlir::Value> batchedInputs;
+  for (auto op : chain.ops)
+    for (auto &operand : op->getOpOperands())
+      if (isBatchedOperand(operand) &&
+          !ops.contains(operand.get().getDefiningOp()))
+        batchedInputs.insert(operand.get());
+  chain.batchedInputs.assign(batchedInputs.begin(), batchedInputs.end());
+  return chain;
+}
+
+/// Returns true if the operands and results of `chain` have static shapes.
+bool hasStaticShapes(const BatchedChain &chain) {
+  auto isStatic = [](mlir::Value value) {
+    auto type = value.getType().dyn_cast<mlir::RankedTensorType>();
+    return !type || type.hasStaticShape();
+  };
+  return llvm::all_of(chain.ops, [&](mlir::Operation *op) {
+    return llvm::all_of(op->getOperands(), isStatic) &&
+           llvm::all_of(op->getResults(), isStatic);
+  });
+}
+
+/// Returns the number of rows of the chunks streamed through `chain` so that
+/// the rows of its inputs, intermediate results and result fit in
+/// `cacheSize` bytes.
+int64_t getChunkSize(const BatchedChain &chain, uint64_t cacheSize) {
+  int64_t rowSize = 0;
+  for (auto input : chain.batchedInputs)
+    rowSize += getRowSize(input.getType());
+  for (auto op : chain.ops)
+    rowSize += getRowSize(op->getResult(0).getType());
+  return std::max<int64_t>(1, cacheSize / (rowSize * sizeof(uint64_t)));
+}
+
+/// Creates the operations of `chain` on the `size` rows starting at
+/// `offset` and returns the chunk of the result of the bootstrap.
+mlir::Value createChunk(mlir::OpBuilder &builder, const BatchedChain &chain,
+                        mlir::OpFoldResult offset, int64_t size) {
+  mlir::IRMapping mapping;
+  for (auto op : chain.ops) {
+    llvm::SmallVector<mlir::Value> operands;
+    for (auto &operand : op->getOpOperands()) {
+      mlir::Value value = operand.get();
+      if (mapping.contains(value)) {
+        operands.push_back(mapping.lookup(value));
+      } else if (isBatchedOperand(operand)) {
+        auto type = value.getType().cast<mlir::RankedTensorType>();
+        llvm::SmallVector<mlir::OpFoldResult> offsets(
+            type.getRank(), builder.getIndexAttr(0));
+        llvm::SmallVector<mlir::OpFoldResult> sizes;
+        for (auto dim : type.getShape())
+          sizes.push_back(builder.getIndexAttr(dim));
+        llvm::SmallVector<mlir::OpFoldResult> strides(
+            type.getRank(), builder.getIndexAttr(1));
+        offsets[0] = offset;
+        sizes[0] = builder.getIndexAttr(size);
+        operands.push_back(builder.create<mlir::tensor::ExtractSliceOp>(
+            op->getLoc(), getChunkType(type, size), value, offsets, sizes,
+            strides));
+      } else {
+        operands.push_back(value);
+      }
+    }
+    llvm::SmallVector<mlir::Type, 1> types{
+        getChunkType(op->getResult(0).getType(), size)};
+    auto chunkOp = builder.create(op->getLoc(), op->getName().getIdentifier(),
+                                  operands, types, op->getAttrs());
+    mapping.map(op->getResult(0), chunkOp->getResult(0));
+  }
+  return mapping.lookup(chain.ops.back()->getResult(0));
+}
+
+/// Inserts the chunk `chunk` of the batched result `dest` at the row
+/// `offset`.
+mlir::Value insertChunk(mlir::OpBuilder &builder, mlir::Location loc,
+                        mlir::Value chunk, mlir::Value dest,
+                        mlir::OpFoldResult offset) {
+  auto type = chunk.getType().cast<mlir::RankedTensorType>();
+  llvm::SmallVector<mlir::OpFoldResult> offsets{offset,
+                                                builder.getIndexAttr(0)};
+  llvm::SmallVector<mlir::OpFoldResult> sizes{
+      builder.getIndexAttr(type.getDimSize(0)),
+      builder.getIndexAttr(type.getDimSize(1))};
+  llvm::SmallVector<mlir::OpFoldResult> strides(2, builder.getIndexAttr(1));
+  return builder.create<mlir::tensor::InsertSliceOp>(loc, chunk, dest, offsets,
+                                                     sizes, strides);
+}
+
+/// Streams the batch of `chain` through chunks of `chunkSize` rows, e.g.
+/// with chunks of 2 rows:
+///
+/// ```mlir
+/// %0 = "Concrete.batched_mul_cleartext_lwe_tensor"(%cts, %cs)
+///   : (tensor<5x2049xi64>, tensor<5xi64>) -> tensor<5x2049xi64>
+/// %1 = "Concrete.batched_keyswitch_lwe_tensor"(%0)
+///   : (tensor<5x2049xi64>) -> tensor<5x751xi64>
+/// %2 = "Concrete.batched_bootstrap_lwe_tensor"(%1, %lut)
+///   : (tensor<5x751xi64>, tensor<1024xi64>) -> tensor<5x2049xi64>
+/// ```
+///
+/// becomes:
+///
+/// ```mlir
+/// %init = tensor.empty() : tensor<5x2049xi64>
+/// %loop = scf.for %i = %c0 to %c4 step %c2 iter_args(%acc = %init) {
+///   %cts_i = tensor.extract_slice %cts[%i, 0] [2, 2049] [1, 1]
+///   %cs_i = tensor.extract_slice %cs[%i] [2] [1]
+///   %0 = "Concrete.batched_mul_cleartext_lwe_tensor"(%cts_i, %cs_i)
+///   %1 = "Concrete.batched_keyswitch_lwe_tensor"(%0)
+///   %2 = "Concrete.batched_bootstrap_lwe_tensor"(%1, %lut)
+///   %acc_i = tensor.insert_slice %2 into %acc[%i, 0] [2, 2049] [1, 1]
+///   scf.yield %acc_i
+/// }
+/// // Same as the body of the loop for the last row
+/// ...
+/// %2 = tensor.insert_slice %last into %loop[4, 0] [1, 2049] [1, 1]
+/// ```
+void streamBatchedChain(const BatchedChain &chain) {
+  auto bootstrap = chain.ops.back();
+  auto loc = bootstrap->getLoc();
+  auto resultType =
+      bootstrap->getResult(0).getType().cast<mlir::RankedTensorType>();
+  int64_t batchSize = resultType.getDimSize(0);
+  int64_t chunkSize = chain.chunkSize;
+  int64_t loopEnd = batchSize - batchSize % chunkSize;
+
+  mlir::OpBuilder builder(bootstrap);
+  mlir::Value result = builder.create<mlir::tensor::EmptyOp>(
+      loc, resultType.getShape(), resultType.getElementType());
+  auto lb = builder.create<mlir::arith::ConstantIndexOp>(loc, 0);
+  auto ub = builder.create<mlir::arith::ConstantIndexOp>(loc, loopEnd);
+  auto step = builder.create<mlir::arith::ConstantIndexOp>(loc, chunkSize);
+  auto forOp = builder.create<mlir::scf::ForOp>(
+      loc, lb, ub, step, result,
+      [&](mlir::OpBuilder &b, mlir::Location loc, mlir::Value iv,
+          mlir::ValueRange iterArgs) {
+        auto chunk = createChunk(b, chain, iv, chunkSize);
+        b.create<mlir::scf::YieldOp>(
+            loc, insertChunk(b, loc, chunk, iterArgs[0], iv));
+      });
+  result = forOp.getResult(0);
+
+  if (loopEnd != batchSize) {
+    auto offset = builder.getIndexAttr(loopEnd);
+    auto chunk = createChunk(builder, chain, offset, batchSize - loopEnd);
+    result = insertChunk(builder, loc, chunk, result, offset);
+  }
+
+  bootstrap->getResult(0).replaceAllUsesWith(result);
+  for (auto op : llvm::reverse(chain.ops))
+    op->erase();
+}
+
+struct FuseBatchedOpsPass : public FuseBatchedOpsBase<FuseBatchedOpsPass> {
+  FuseBatchedOpsPass(uint64_t cacheSize) : cacheSize(cacheSize) {}
+
+  void runOnOperation() final {
+    // The chains are collected before rewriting any of them, as a chain
+    // may take the result of another one as input.
+    llvm::SmallVector<BatchedChain> chains;
+    getOperation()->walk([&](mlir::Operation *op) {
+      if (!llvm::isa<Concrete::BatchedBootstrapLweTensorOp,
+                     Concrete::BatchedMappedBootstrapLweTensorOp>(op))
+        return;
+      auto chain = getBatchedChain(op);
+      if (!chain.has_value() || !hasStaticShapes(*chain))
+        return;
+      chain->chunkSize = getChunkSize(*chain, cacheSize);
+      auto resultType =
+          op->getResult(0).getType().cast<mlir::RankedTensorType>();
+      if (chain->chunkSize < resultType.getDimSize(0))
+        chains.push_back(*chain);
+    });
+
+    for (auto &chain : chains)
+      streamBatchedChain(chain);
+  }
+
+private:
+  uint64_t cacheSize;
+};
+} // namespace
+
+namespace mlir {
+namespace concretelang {
+std::unique_ptr<OperationPass<ModuleOp>>
+createFuseBatchedOpsPass(uint64_t cacheSize) {
+  return std::make_unique<FuseBatchedOpsPass>(cacheSize);
+}
+} // namespace concretelang
+} // namespace mlir
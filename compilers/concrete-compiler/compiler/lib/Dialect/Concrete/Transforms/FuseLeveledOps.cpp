@@ -0,0 +1,72 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#include "concretelang/Dialect/Concrete/IR/ConcreteDialect.h"
+#include "concretelang/Dialect/Concrete/IR/ConcreteOps.h"
+#include "concretelang/Dialect/Concrete/Transforms/Passes.h"
+
+namespace {
+
+namespace Concrete = mlir::concretelang::Concrete;
+
+/// Fuses the addition of a product of a ciphertext by a cleartext into a
+/// single multiply-accumulate, e.g. for the steps of a dot product:
+///
+/// ```mlir
+/// %0 = "Concrete.mul_cleartext_lwe_tensor"(%ct, %c)
+/// %1 = "Concrete.add_lwe_tensor"(%acc, %0)
+/// ```
+///
+/// becomes:
+///
+/// ```mlir
+/// %1 = "Concrete.mul_cleartext_add_lwe_tensor"(%acc, %ct, %c)
+/// ```
+struct MulCleartextAddLwePattern
+    : public mlir::OpRewritePattern<Concrete::AddLweTensorOp> {
+  MulCleartextAddLwePattern(mlir::MLIRContext *context,
+                            mlir::PatternBenefit benefit = 1)
+      : mlir::OpRewritePattern<Concrete::AddLweTensorOp>(context, benefit) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(Concrete::AddLweTensorOp addOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    std::pair<mlir::Value, mlir::Value> candidates[] = {
+        {addOp.getLhs(), addOp.getRhs()}, {addOp.getRhs(), addOp.getLhs()}};
+    for (auto [acc, product] : candidates) {
+      auto mulOp = product.getDefiningOp<Concrete::MulCleartextLweTensorOp>();
+      if (!mulOp || !mulOp->hasOneUse())
+        continue;
+      rewriter.replaceOpWithNewOp<Concrete::MulCleartextAddLweTensorOp>(
+          addOp, addOp.getType(), acc, mulOp.getLhs(), mulOp.getRhs());
+      rewriter.eraseOp(mulOp);
+      return mlir::success();
+    }
+    return mlir::failure();
+  }
+};
+
+struct FuseLeveledOpsPass : public FuseLeveledOpsBase<FuseLeveledOpsPass> {
+  void runOnOperation() final {
+    mlir::RewritePatternSet patterns(&getContext());
+    patterns.add<MulCleartextAddLwePattern>(&getContext());
+    if (mlir::applyPatternsAndFoldGreedily(getOperation(), std::move(patterns))
+            .failed()) {
+      this->signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+namespace mlir {
+namespace concretelang {
+std::unique_ptr<OperationPass<ModuleOp>> createFuseLeveledOpsPass() {
+  return std::make_unique<FuseLeveledOpsPass>();
+}
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,115 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
+
+#include "concretelang/Dialect/Concrete/IR/ConcreteTypes.h"
+#include "concretelang/Dialect/Concrete/Transforms/Passes.h"
+#include "concretelang/Dialect/RT/IR/RTOps.h"
+#include "concretelang/Runtime/buffer_pool.h"
+
+namespace {
+
+/// Returns the Concrete.context argument of the function enclosing `op`, or
+/// a null value if the function has none.
+mlir::Value lookupContextArgument(mlir::Operation *op) {
+  auto funcOp = op->getParentOfType<mlir::func::FuncOp>();
+  if (!funcOp || funcOp.isExternal())
+    return nullptr;
+  for (auto arg : llvm::reverse(funcOp.getArguments()))
+    if (arg.getType().isa<mlir::concretelang::Concrete::ContextType>())
+      return arg;
+  return nullptr;
+}
+
+/// Returns true if `buffer` or one of its aliases is deallocated with
+/// `memref.dealloc`.
+bool isAliasDeallocated(mlir::Value buffer) {
+  for (auto user : buffer.getUsers()) {
+    if (llvm::isa<mlir::memref::DeallocOp>(user))
+      return true;
+    auto viewOp = llvm::dyn_cast<mlir::ViewLikeOpInterface>(user);
+    if (viewOp && viewOp.getViewSource() == buffer &&
+        llvm::any_of(user->getResults(), isAliasDeallocated))
+      return true;
+  }
+  return false;
+}
+
+/// Returns the deallocations of a ciphertext buffer allocated by `alloc`
+/// that can be served by the pool: the buffer must have a static shape of
+/// 64 bits words and be deallocated directly, in the function allocating
+/// it. Buffers returned to the caller are left to `malloc` since they are
+/// released with `free` by the client.
+std::optional<llvm::SmallVector<mlir::memref::DeallocOp>>
+getPoolableDeallocs(mlir::memref::AllocOp alloc) {
+  auto type = alloc.getType();
+  if (!type.hasStaticShape() || !type.getLayout().isIdentity() ||
+      !type.getElementType().isInteger(64) ||
+      !alloc.getDynamicSizes().empty() ||
+      !alloc.getSymbolOperands().empty())
+    return std::nullopt;
+  if (alloc.getAlignment().has_value() &&
+      alloc.getAlignment().value() > mlir::concretelang::BufferPool::alignment)
+    return std::nullopt;
+
+  llvm::SmallVector<mlir::memref::DeallocOp> deallocs;
+  for (auto user : alloc.getResult().getUsers()) {
+    if (auto dealloc = llvm::dyn_cast<mlir::memref::DeallocOp>(user)) {
+      deallocs.push_back(dealloc);
+      continue;
+    }
+    auto viewOp = llvm::dyn_cast<mlir::ViewLikeOpInterface>(user);
+    if (viewOp && viewOp.getViewSource() == alloc.getResult() &&
+        llvm::any_of(user->getResults(), isAliasDeallocated))
+      return std::nullopt;
+  }
+  if (deallocs.empty())
+    return std::nullopt;
+  return deallocs;
+}
+
+struct PoolCiphertextBuffersPass
+    : public PoolCiphertextBuffersBase<PoolCiphertextBuffersPass> {
+  void runOnOperation() final {
+    llvm::SmallVector<mlir::memref::AllocOp> allocs;
+    getOperation()->walk(
+        [&](mlir::memref::AllocOp alloc) { allocs.push_back(alloc); });
+
+    mlir::OpBuilder builder(&getContext());
+    for (auto alloc : allocs) {
+      auto context = lookupContextArgument(alloc);
+      if (!context)
+        continue;
+      auto deallocs = getPoolableDeallocs(alloc);
+      if (!deallocs.has_value())
+        continue;
+
+      builder.setInsertionPoint(alloc);
+      auto poolAlloc = builder.create<mlir::concretelang::RT::PoolAllocOp>(
+          alloc.getLoc(), alloc.getType(), context);
+      for (auto dealloc : *deallocs) {
+        builder.setInsertionPoint(dealloc);
+        builder.create<mlir::concretelang::RT::PoolDeallocOp>(
+            dealloc.getLoc(), poolAlloc.getOutput(), context);
+        dealloc.erase();
+      }
+      alloc.getResult().replaceAllUsesWith(poolAlloc.getOutput());
+      alloc.erase();
+    }
+  }
+};
+} // namespace
+
+namespace mlir {
+namespace concretelang {
+std::unique_ptr<OperationPass<ModuleOp>> createPoolCiphertextBuffersPass() {
+  return std::make_unique<PoolCiphertextBuffersPass>();
+}
+} // namespace concretelang
+} // namespace mlir
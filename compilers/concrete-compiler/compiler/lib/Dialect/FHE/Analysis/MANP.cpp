@@ -14,6 +14,7 @@
 #include <mlir/IR/BuiltinOps.h>
 
 #include <limits>
+#include <map>
 #include <llvm/ADT/APInt.h>
 #include <llvm/ADT/Optional.h>
 #include <llvm/ADT/SmallString.h>
@@ -1015,6 +1016,7 @@ public:
     // clone the genricOp to replace block arguments with constant values when
     // needed. The clone op must be destroyed at the end of the function
     auto genericOpClone = genericOp.clone();
+    auto indexingMaps = genericOpClone.getIndexingMapsArray();
 
     // init block arguments' MANP: map block arguments with op operands
     for (auto arg : genericOpClone.getBlock()->getArguments()) {
@@ -1027,80 +1029,63 @@ public:
       valueToManp[arg] = getLatticeElement(operandRange[argIndex])->getValue();
     }
 
-    // keep track of the MANP of different elements in the output tensor
-    // (initialized to the initial output MANP value)
+    // if a linalg genric input is constant, replace the uses of its
+    // respective block argument with a constant op, whose value is set to the
+    // accessed element before each evaluation of the body. This avoids the
+    // computation of the MANP to use conservative values.
+    struct ConstantInput {
+      mlir::DenseIntElementsAttr values;
+      mlir::AffineMap map;
+      arith::ConstantOp replacement;
+    };
+    llvm::SmallVector<ConstantInput> constantInputs;
+    for (auto arg : genericOpClone.getBlock()->getArguments()) {
+      auto argIndex = arg.getArgNumber();
+      auto inputs = genericOpClone.getInputs();
+      // don't consider outputs
+      if (argIndex >= inputs.size())
+        continue;
+      auto constantOp = llvm::dyn_cast_or_null<mlir::arith::ConstantOp>(
+          inputs[argIndex].getDefiningOp());
+      if (!constantOp)
+        continue;
+      mlir::DenseIntElementsAttr denseAttr =
+          constantOp.getValueAttr().dyn_cast<mlir::DenseIntElementsAttr>();
+      auto context = genericOpClone.getContext();
+      auto opBuilder = mlir::OpBuilder(context);
+      auto opState =
+          mlir::OperationState(mlir::UnknownLoc::get(context),
+                               arith::ConstantOp::getOperationName());
+      arith::ConstantOp::build(
+          opBuilder, opState,
+          mlir::IntegerAttr::get(denseAttr.getType().getElementType(),
+                                 *denseAttr.getValues<APInt>().begin()));
+      auto replacement = arith::ConstantOp(mlir::Operation::create(opState));
+      genericOpClone.getBlock()->push_front(replacement);
+      arg.replaceAllUsesWith(replacement.getResult());
+      constantInputs.push_back(
+          {denseAttr, indexingMaps[argIndex], replacement});
+    }
+
     auto outputArg = genericOpClone.getBlock()->getArguments().back();
     auto outputType =
         genericOpClone.getOutputs().front().getType().cast<RankedTensorType>();
     auto outputSize = std::accumulate(outputType.getShape().begin(),
                                       outputType.getShape().end(), 1,
                                       std::multiplies<int64_t>());
-    std::vector<llvm::APInt> outputMANPs(
-        outputSize, fetchOrFallbackToAnalysis(outputArg)->getMANP().value());
-
-    // indices at a specific iteration
-    llvm::SmallVector<int64_t> indices(loopRange.size(), 0);
-    for (auto i = 0; i < iterCount; i++) {
-      for (size_t iterPos = 0; iterPos < indices.size(); iterPos++) {
-        indices[iterPos] = (i / strides[iterPos]) % loopRange[iterPos];
-      }
-
-      // if a linalg genric input is constant, replace the uses of its
-      // respective block argument with a constant value. This avoids the
-      // computation of the MANP to use conservative values.
-      // we also have to replace them back for the next iteration to be able to
-      // update them again with new values
-      mlir::DenseMap<mlir::BlockArgument, arith::ConstantOp> toReplaceBack;
-      for (auto arg : genericOpClone.getBlock()->getArguments()) {
-        auto argIndex = arg.getArgNumber();
-        auto inputs = genericOpClone.getInputs();
-        // don't consider outputs
-        if (argIndex >= inputs.size())
-          continue;
-        auto input = inputs[argIndex];
-        auto definingOp = input.getDefiningOp();
-        if (definingOp && mlir::isa<mlir::arith::ConstantOp>(definingOp)) {
-          // fetch constant value
-          auto constantOp = mlir::dyn_cast<mlir::arith::ConstantOp>(definingOp);
-          mlir::DenseIntElementsAttr denseAttr =
-              constantOp.getValueAttr().dyn_cast<mlir::DenseIntElementsAttr>();
-          auto constantTensor = denseAttr.getValues<APInt>();
-          auto constantIndex = indexFromLoopRange(
-              indices, genericOpClone.getIndexingMapsArray()[argIndex],
-              denseAttr.getType().getShape());
-          APInt constantValue = constantTensor[constantIndex];
-          // create new constant op with constant value
-          auto opBuilder = mlir::OpBuilder(genericOpClone.getContext());
-          auto opState = mlir::OperationState(
-              mlir::UnknownLoc::get(genericOpClone.getContext()),
-              arith::ConstantOp::getOperationName());
-          arith::ConstantOp::build(
-              opBuilder, opState,
-              mlir::IntegerAttr::get(denseAttr.getType().getElementType(),
-                                     constantValue));
-          auto newConstantOp =
-              arith::ConstantOp(mlir::Operation::create(opState));
-          genericOpClone.getBlock()->push_front(newConstantOp);
-          // replace uses of the block argument with the constant value
-          arg.replaceAllUsesWith(newConstantOp.getResult());
-          toReplaceBack[arg] = newConstantOp;
-        }
-      }
-
-      // we want to replace the MANP of the block argument corresponding to the
-      // output with the MANP value corresponding to the currently accessed
-      // tensor element
-      size_t outputIndex = indexFromLoopRange(
-          indices,
-          genericOpClone.getIndexingMapsArray()[outputArg.getArgNumber()],
-          outputType.getShape());
-      valueToManp[outputArg] = MANPLatticeValue(outputMANPs[outputIndex]);
+    auto outputMap = indexingMaps[outputArg.getArgNumber()];
+    auto initialMANP = fetchOrFallbackToAnalysis(outputArg)->getMANP().value();
+
+    // Evaluate the body once with the current values of the constant
+    // replacements and `outputMANP` as MANP of the accessed output element,
+    // and return the MANP of the yielded value
+    auto evaluateBody = [&](llvm::APInt outputMANP) {
+      valueToManp[outputArg] = MANPLatticeValue(outputMANP);
+      llvm::APInt yielded = outputMANP;
       genericOpClone.getBody()->walk([&](mlir::Operation *op) {
-        // we update the appropriate element's MANP value using the index of the
-        // currently accessed output element
         if (auto yieldOp = mlir::dyn_cast<mlir::linalg::YieldOp>(op)) {
           auto manp = fetchOrFallbackToAnalysis(yieldOp->getOperand(0));
-          outputMANPs[outputIndex] = manp->getMANP().value();
+          yielded = manp->getMANP().value();
           return;
         }
         // compute using the op and operand manp values
@@ -1122,21 +1107,100 @@ public:
           delete toFree;
         }
       });
+      return yielded;
+    };
 
-      // replace back the uses of block arguments which were replaced by
-      // constant values
-      for (auto replacement : toReplaceBack) {
-        auto blockArg = replacement.first;
-        auto constantOp = replacement.second;
-        auto constantValue = constantOp.getResult();
-        constantValue.replaceAllUsesWith(blockArg);
-        constantOp->remove();
-        constantOp->destroy();
+    llvm::APInt result = initialMANP;
+    // The output map of a full reduction has zero results, e.g.
+    // `(d0, d1) -> (0)`
+    if (constantInputs.empty() &&
+        outputMap.isProjectedPermutation(/*allowZeroInResults=*/true) &&
+        outputSize > 0 && iterCount % outputSize == 0) {
+      // Without constant inputs, the iterations only differ by the output
+      // element they update, and each output element is updated by the same
+      // number of iterations, from the same initial MANP. All the elements
+      // thus end up with the same MANP, which is computed on a single element
+      // instead of on the whole iteration space.
+      for (int64_t i = 0; i < iterCount / outputSize; i++) {
+        auto next = evaluateBody(result);
+        // stop as soon as the reduction reaches a fixed point, e.g. when the
+        // accumulator goes through a lookup table
+        if (llvm::APInt::isSameValue(next, result))
+          break;
+        result = next;
+      }
+      genericOpClone->destroy();
+      return result;
+    }
+
+    // The MANP of an iteration only depends on the values of the constant
+    // elements it accesses and on the MANP of the output element it updates.
+    // When each output element is updated once, the latter is the initial
+    // MANP, and the evaluations of the body are memoized on the constant
+    // values, as constant tensors usually hold few distinct values. The MANP
+    // of the accumulator of a reduction never repeats, so the evaluations of
+    // reductions are not memoized.
+    bool memoize = iterCount == outputSize;
+    struct APIntsLess {
+      bool operator()(const llvm::SmallVector<llvm::APInt> &lhs,
+                      const llvm::SmallVector<llvm::APInt> &rhs) const {
+        if (lhs.size() != rhs.size())
+          return lhs.size() < rhs.size();
+        for (size_t i = 0; i < lhs.size(); i++) {
+          if (lhs[i].getBitWidth() != rhs[i].getBitWidth())
+            return lhs[i].getBitWidth() < rhs[i].getBitWidth();
+          if (lhs[i] != rhs[i])
+            return lhs[i].ult(rhs[i]);
+        }
+        return false;
+      }
+    };
+    std::map<llvm::SmallVector<llvm::APInt>, llvm::APInt, APIntsLess>
+        evaluations;
+
+    // keep track of the MANP of different elements in the output tensor
+    // (initialized to the initial output MANP value)
+    std::vector<llvm::APInt> outputMANPs(outputSize, initialMANP);
+
+    // indices at a specific iteration
+    llvm::SmallVector<int64_t> indices(loopRange.size(), 0);
+    llvm::SmallVector<llvm::APInt> key;
+    for (auto i = 0; i < iterCount; i++) {
+      for (size_t iterPos = 0; iterPos < indices.size(); iterPos++) {
+        indices[iterPos] = (i / strides[iterPos]) % loopRange[iterPos];
+      }
+
+      key.clear();
+      for (auto &constantInput : constantInputs) {
+        auto constantIndex =
+            indexFromLoopRange(indices, constantInput.map,
+                               constantInput.values.getType().getShape());
+        key.push_back(constantInput.values.getValues<APInt>()[constantIndex]);
+      }
+      size_t outputIndex =
+          indexFromLoopRange(indices, outputMap, outputType.getShape());
+      key.push_back(outputMANPs[outputIndex]);
+
+      auto evaluation = evaluations.end();
+      if (memoize)
+        evaluation = evaluations.find(key);
+      if (evaluation != evaluations.end()) {
+        outputMANPs[outputIndex] = evaluation->second;
+        continue;
+      }
+      for (size_t c = 0; c < constantInputs.size(); c++) {
+        auto replacement = constantInputs[c].replacement;
+        replacement.setValueAttr(mlir::IntegerAttr::get(
+            constantInputs[c].values.getType().getElementType(), key[c]));
       }
+      auto manp = evaluateBody(outputMANPs[outputIndex]);
+      if (memoize)
+        evaluations.insert({key, manp});
+      outputMANPs[outputIndex] = manp;
     }
     genericOpClone->destroy();
     // final result MANP is the max of output
-    llvm::APInt result = outputMANPs[0];
+    result = outputMANPs[0];
     for (auto manp : outputMANPs) {
       result = APIntUMax(result, manp);
     }
@@ -17,6 +17,10 @@
 #include <concretelang/Dialect/FHELinalg/Transforms/Tiling.h>
 #include <concretelang/Support/Constants.h>
 
+#include <algorithm>
+#include <optional>
+#include <tuple>
+
 namespace mlir {
 namespace concretelang {
 
@@ -354,6 +358,104 @@ public:
 protected:
   std::vector<int64_t> tileSizes;
 };
+
+/// Returns the divisors of `n` in increasing order.
+llvm::SmallVector<int64_t> getDivisors(int64_t n) {
+  llvm::SmallVector<int64_t> low, high;
+  for (int64_t d = 1; d * d <= n; d++) {
+    if (n % d != 0)
+      continue;
+    low.push_back(d);
+    if (d * d != n)
+      high.push_back(n / d);
+  }
+  low.append(high.rbegin(), high.rend());
+  return low;
+}
+
+/// Chooses the tile sizes `TxUxV` of the multiplication of a `NxM`
+/// matrix of encrypted integers with a `MxK` matrix of plaintext
+/// integers (see `MatMulTilingPattern`).
+///
+/// Since partial tiles are not supported, the tile sizes are divisors
+/// of the dimensions. Candidates are ranked by:
+///
+///   1. whether the ciphertexts of the tiles of A and C, plus the tile
+///      of B, fit in the cache of the target,
+///   2. whether there are at least as many tiles of C as threads, so
+///      that each thread gets a tile,
+///   3. the volume `T*U*V` of the tile, to amortize the overhead of the
+///      loop nest, or the inverse of the volume if nothing fits in the
+///      cache.
+///
+/// Returns `std::nullopt` if the best tile covers the whole
+/// multiplication, in which case tiling would be pointless.
+std::optional<llvm::SmallVector<int64_t, 3>>
+chooseMatMulTileSizes(int64_t N, int64_t M, int64_t K,
+                      const FHELinalgTilingTarget &target) {
+  uint64_t minTiles =
+      std::min<uint64_t>(std::max<uint64_t>(target.numThreads, 1), N * K);
+
+  llvm::SmallVector<int64_t, 3> best;
+  std::tuple<bool, bool, int64_t> bestScore;
+
+  for (int64_t T : getDivisors(N)) {
+    for (int64_t V : getDivisors(K)) {
+      bool parallel = (uint64_t)((N / T) * (K / V)) >= minTiles;
+      for (int64_t U : getDivisors(M)) {
+        uint64_t workingSet = (T * U + T * V) * target.ciphertextSize +
+                              U * V * sizeof(int64_t);
+        bool fits = workingSet <= target.cacheSize;
+        int64_t volume = T * U * V;
+        std::tuple<bool, bool, int64_t> score{fits, parallel,
+                                              fits ? volume : -volume};
+        if (best.empty() || score > bestScore) {
+          best = {T, U, V};
+          bestScore = score;
+        }
+      }
+    }
+  }
+
+  if (best[0] == N && best[1] == M && best[2] == K)
+    return std::nullopt;
+  return best;
+}
+
+/// Marks all `FHELinalg.matmul_eint_int` operations on statically
+/// shaped tensors that are not yet marked with a "tile-sizes" attribute
+/// containing tile sizes chosen for the target.
+class FHELinalgAutoTilingMarkerPass
+    : public FHELinalgAutoTilingMarkerBase<FHELinalgAutoTilingMarkerPass> {
+public:
+  FHELinalgAutoTilingMarkerPass(FHELinalgTilingTarget target)
+      : target(target) {}
+
+  void runOnOperation() override {
+    mlir::Operation *op = getOperation();
+    mlir::Builder builder(&this->getContext());
+
+    op->walk([&](mlir::concretelang::FHELinalg::MatMulEintIntOp matmulOp) {
+      if (matmulOp->hasAttr("tile-sizes"))
+        return;
+
+      auto lhsTy = matmulOp.getLhs().getType().cast<mlir::TensorType>();
+      auto rhsTy = matmulOp.getRhs().getType().cast<mlir::TensorType>();
+      if (lhsTy.getRank() != 2 || rhsTy.getRank() != 2 ||
+          !lhsTy.hasStaticShape() || !rhsTy.hasStaticShape())
+        return;
+
+      auto tileSizes =
+          chooseMatMulTileSizes(lhsTy.getDimSize(0), lhsTy.getDimSize(1),
+                                rhsTy.getDimSize(1), target);
+      if (tileSizes.has_value())
+        matmulOp->setAttr("tile-sizes", builder.getI64ArrayAttr(*tileSizes));
+    });
+  }
+
+protected:
+  FHELinalgTilingTarget target;
+};
 } // end anonymous namespace
 
 std::unique_ptr<mlir::OperationPass<>> createFHELinalgTilingPass() {
@@ -364,5 +466,10 @@ std::unique_ptr<mlir::OperationPass<>>
 createFHELinalgTilingMarkerPass(llvm::ArrayRef<int64_t> tileSizes) {
   return std::make_unique<FHELinalgTilingMarkerPass>(tileSizes);
 }
+
+std::unique_ptr<mlir::OperationPass<>>
+createFHELinalgAutoTilingMarkerPass(FHELinalgTilingTarget target) {
+  return std::make_unique<FHELinalgAutoTilingMarkerPass>(target);
+}
 } // namespace concretelang
 } // namespace mlir
@@ -19,6 +19,8 @@
 
 #include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Linalg/IR/Linalg.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
 #include <mlir/IR/Attributes.h>
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/BuiltinAttributes.h>
@@ -42,8 +44,69 @@ namespace concretelang {
 
 namespace {
 
-// TODO: adjust these two functions based on cost model
-static bool isCandidateForTask(Operation *op) {
+/// Returns the number of iterations of the iteration space of
+/// `genericOp` or `std::nullopt` if any of the loop ranges is not
+/// statically known.
+static std::optional<uint64_t> getStaticTripCount(linalg::GenericOp genericOp) {
+  uint64_t tripCount = 1;
+  for (int64_t range : genericOp.getStaticLoopRanges()) {
+    if (ShapedType::isDynamic(range))
+      return std::nullopt;
+    tripCount *= (uint64_t)range;
+  }
+  return tripCount;
+}
+
+/// Estimates the number of programmable bootstraps performed by `op`
+/// once lowered to TFHE. Each of these bootstraps is preceded by
+/// exactly one keyswitch, such that this count matches both the
+/// `PBS` and the `KEY_SWITCH` statistics reported by
+/// `ExtractStatistics` for the lowered operation. Leveled operations
+/// have a cost of zero. Returns `std::nullopt` if the cost cannot be
+/// determined statically (e.g., dynamically shaped iteration space).
+static std::optional<uint64_t> estimateBootstrapCount(Operation *op) {
+  if (isa<FHE::ApplyLookupTableEintOp, FHE::LsbEintOp, FHE::GenGateOp>(op))
+    return 1;
+
+  if (auto roundOp = dyn_cast<FHE::RoundEintOp>(op)) {
+    // One bootstrap for each truncated bit (see the scalar lowering
+    // of `FHE.round`)
+    auto inputWidth = roundOp.getInput()
+                          .getType()
+                          .cast<FHE::FheIntegerInterface>()
+                          .getWidth();
+    auto outputWidth = roundOp.getResult()
+                           .getType()
+                           .cast<FHE::FheIntegerInterface>()
+                           .getWidth();
+    return inputWidth - outputWidth;
+  }
+
+  if (auto genericOp = dyn_cast<linalg::GenericOp>(op)) {
+    uint64_t bodyCost = 0;
+    for (Operation &bodyOp : genericOp.getBody()->without_terminator()) {
+      std::optional<uint64_t> cost = estimateBootstrapCount(&bodyOp);
+      if (!cost)
+        return std::nullopt;
+      bodyCost += *cost;
+    }
+
+    if (bodyCost == 0)
+      return 0;
+
+    std::optional<uint64_t> tripCount = getStaticTripCount(genericOp);
+    if (!tripCount)
+      return std::nullopt;
+
+    return bodyCost * *tripCount;
+  }
+
+  return 0;
+}
+
+/// Structural rule identifying operations executed in a task of their
+/// own if no cost-based granularity is requested.
+static bool isStructuralCandidateForTask(Operation *op) {
   // if it's a linalg.genric operation with encrypted inputs
   if (auto genericOp = mlir::dyn_cast<mlir::linalg::GenericOp>(op)) {
     for (auto input : genericOp.getInputs()) {
@@ -59,6 +122,23 @@ static bool isCandidateForTask(Operation *op) {
   return isa<FHE::ApplyLookupTableEintOp>(op);
 }
 
+/// Identify operations that should be executed in a dataflow task. If
+/// `granularity` is zero, the structural rules are applied. Otherwise,
+/// any operation performing at least one bootstrap or whose cost
+/// cannot be estimated is a candidate; small candidates are merged
+/// into larger tasks afterwards.
+static bool isCandidateForTask(Operation *op, uint64_t granularity) {
+  if (granularity == 0)
+    return isStructuralCandidateForTask(op);
+
+  if (!isStructuralCandidateForTask(op) &&
+      !isa<FHE::RoundEintOp, FHE::LsbEintOp, FHE::GenGateOp>(op))
+    return false;
+
+  std::optional<uint64_t> cost = estimateBootstrapCount(op);
+  return !cost || *cost > 0;
+}
+
 /// Identify operations that are beneficial to aggregate into tasks.  These
 /// operations must not have side-effects and not be `isCandidateForTask`
 static bool isAggregatingBeneficiary(Operation *op) {
@@ -133,6 +213,232 @@ LogicalResult coarsenDFTask(RT::DataflowTaskOp taskOp) {
   return success();
 }
 
+/// Splits `genericOp` along its outermost parallel loop into chunks
+/// performing roughly `granularity` bootstraps each. Every chunk is a
+/// `linalg.generic` operating on a contiguous slice of the iteration
+/// space and thus becomes a separate task. All chunks are created
+/// before their results are inserted into the original output tensors
+/// in order to avoid serializing the tasks on the main thread.
+static void splitGenericOp(linalg::GenericOp genericOp, uint64_t granularity) {
+  std::optional<uint64_t> cost = estimateBootstrapCount(genericOp);
+
+  if (!cost || *cost < 2 * granularity || !genericOp.hasTensorSemantics() ||
+      genericOp.hasIndexSemantics())
+    return;
+
+  // Find the outermost parallel dimension
+  SmallVector<int64_t, 4> loopRanges = genericOp.getStaticLoopRanges();
+  SmallVector<utils::IteratorType> iteratorTypes =
+      genericOp.getIteratorTypesArray();
+  std::optional<unsigned> splitDim;
+
+  for (unsigned i = 0; i < iteratorTypes.size(); i++) {
+    if (linalg::isParallelIterator(iteratorTypes[i]) && loopRanges[i] > 1) {
+      splitDim = i;
+      break;
+    }
+  }
+
+  if (!splitDim)
+    return;
+
+  // For each operand, determine the dimension of the operand indexed
+  // by the split dimension. Only operands indexed directly by the
+  // split dimension or not depending on it at all are supported.
+  SmallVector<std::optional<unsigned>> operandDims;
+
+  for (OpOperand &operand : genericOp->getOpOperands()) {
+    AffineMap map = genericOp.getMatchingIndexingMap(&operand);
+    std::optional<unsigned> operandDim;
+
+    for (unsigned r = 0; r < map.getNumResults(); r++) {
+      AffineExpr expr = map.getResult(r);
+
+      if (!expr.isFunctionOfDim(*splitDim))
+        continue;
+
+      auto dimExpr = expr.dyn_cast<AffineDimExpr>();
+
+      if (!dimExpr || operandDim)
+        return;
+
+      operandDim = r;
+    }
+
+    if (!operandDim && genericOp.isDpsInit(&operand))
+      return;
+
+    operandDims.push_back(operandDim);
+  }
+
+  // Number of chunks: smallest divisor of the extent of the split
+  // dimension yielding chunks of at most `granularity` bootstraps
+  uint64_t extent = loopRanges[*splitDim];
+  uint64_t numChunks =
+      std::min(extent, (*cost + granularity - 1) / granularity);
+
+  while (extent % numChunks != 0)
+    numChunks++;
+
+  if (numChunks < 2)
+    return;
+
+  int64_t chunkSize = extent / numChunks;
+
+  OpBuilder builder(genericOp);
+  Location loc = genericOp.getLoc();
+
+  auto sliceParams = [&](Value v, unsigned dim, int64_t offset) {
+    ArrayRef<int64_t> shape = v.getType().cast<RankedTensorType>().getShape();
+    SmallVector<OpFoldResult> offsets(shape.size(), builder.getIndexAttr(0));
+    SmallVector<OpFoldResult> sizes;
+    SmallVector<OpFoldResult> strides(shape.size(), builder.getIndexAttr(1));
+
+    for (int64_t s : shape)
+      sizes.push_back(builder.getIndexAttr(s));
+
+    offsets[dim] = builder.getIndexAttr(offset);
+    sizes[dim] = builder.getIndexAttr(chunkSize);
+
+    return std::make_tuple(offsets, sizes, strides);
+  };
+
+  SmallVector<Operation *> chunks;
+
+  for (uint64_t chunk = 0; chunk < numChunks; chunk++) {
+    int64_t offset = chunk * chunkSize;
+    SmallVector<Value> chunkOperands;
+
+    for (auto it : llvm::zip(genericOp->getOperands(), operandDims)) {
+      Value operand = std::get<0>(it);
+
+      if (!std::get<1>(it)) {
+        chunkOperands.push_back(operand);
+        continue;
+      }
+
+      auto [offsets, sizes, strides] =
+          sliceParams(operand, *std::get<1>(it), offset);
+      chunkOperands.push_back(builder.create<tensor::ExtractSliceOp>(
+          loc, operand, offsets, sizes, strides));
+    }
+
+    Operation *chunkOp = builder.clone(*genericOp);
+    chunkOp->setOperands(chunkOperands);
+
+    for (auto it :
+         llvm::zip(chunkOp->getResults(),
+                   cast<linalg::GenericOp>(chunkOp).getDpsInitOperands())) {
+      std::get<0>(it).setType(std::get<1>(it)->get().getType());
+    }
+
+    chunks.push_back(chunkOp);
+  }
+
+  // Assemble the results from the chunks
+  SmallVector<Value> results;
+
+  for (OpOperand *init : genericOp.getDpsInitOperands()) {
+    unsigned resultIdx = genericOp.getTiedOpResult(init).getResultNumber();
+    Value result = init->get();
+    unsigned dim = *operandDims[init->getOperandNumber()];
+
+    for (auto chunk : llvm::enumerate(chunks)) {
+      auto [offsets, sizes, strides] =
+          sliceParams(result, dim, chunk.index() * chunkSize);
+      result = builder.create<tensor::InsertSliceOp>(
+          loc, chunk.value()->getResult(resultIdx), result, offsets, sizes,
+          strides);
+    }
+
+    results.push_back(result);
+  }
+
+  genericOp->replaceAllUsesWith(results);
+  genericOp->erase();
+}
+
+/// Splits all `linalg.generic` operations of `func` whose estimated
+/// cost exceeds the task granularity
+static void splitLargeGenericOps(func::FuncOp func, uint64_t granularity) {
+  SmallVector<linalg::GenericOp> genericOps;
+  func.walk([&](linalg::GenericOp op) { genericOps.push_back(op); });
+
+  for (linalg::GenericOp op : genericOps)
+    splitGenericOp(op, granularity);
+}
+
+/// Partitions the candidates for tasks of `func` into groups of
+/// operations that are executed in the same task. Without cost-based
+/// granularity, each candidate forms a group of its own. Otherwise,
+/// consecutive operations of a block are merged into the group of a
+/// candidate until the accumulated number of bootstraps reaches
+/// `granularity`.
+static SmallVector<SmallVector<Operation *>>
+collectTaskGroups(func::FuncOp func, uint64_t granularity) {
+  SmallVector<Operation *> candidates;
+
+  func.walk<WalkOrder::PreOrder>([&](Operation *op) {
+    if (isCandidateForTask(op, granularity)) {
+      candidates.push_back(op);
+      return WalkResult::skip();
+    }
+
+    return WalkResult::advance();
+  });
+
+  SmallVector<SmallVector<Operation *>> groups;
+  llvm::SmallPtrSet<Operation *, 16> grouped;
+
+  for (Operation *candidate : candidates) {
+    if (grouped.count(candidate))
+      continue;
+
+    SmallVector<Operation *> group{candidate};
+    grouped.insert(candidate);
+
+    if (granularity == 0) {
+      groups.push_back(group);
+      continue;
+    }
+
+    std::optional<uint64_t> cost = estimateBootstrapCount(candidate);
+    uint64_t accumulated = cost.value_or(granularity);
+    size_t lastCandidate = 0;
+
+    for (Operation *next = candidate->getNextNode();
+         next && accumulated < granularity; next = next->getNextNode()) {
+      if (isCandidateForTask(next, granularity)) {
+        std::optional<uint64_t> nextCost = estimateBootstrapCount(next);
+
+        if (!nextCost)
+          break;
+
+        accumulated += *nextCost;
+        group.push_back(next);
+        lastCandidate = group.size() - 1;
+      } else if (isAggregatingBeneficiary(next) ||
+                 isa<linalg::GenericOp>(next)) {
+        group.push_back(next);
+      } else {
+        break;
+      }
+    }
+
+    // Trailing operations without bootstraps are left out of the
+    // group; beneficiary operations are sunk into the consuming tasks
+    // during coarsening anyway.
+    group.resize(lastCandidate + 1);
+
+    for (Operation *op : group)
+      grouped.insert(op);
+
+    groups.push_back(group);
+  }
+
+  return groups;
+}
+
 /// For documentation see Autopar.td
 struct BuildDataflowTaskGraphPass
     : public BuildDataflowTaskGraphBase<BuildDataflowTaskGraphPass> {
@@ -141,10 +447,13 @@ struct BuildDataflowTaskGraphPass
     auto module = getOperation();
 
     module.walk([&](mlir::func::FuncOp func) {
-      if (!func->getAttr("_dfr_work_function_attribute"))
-        func.walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *childOp) {
-          return this->processOperation(childOp);
-        });
+      if (!func->getAttr("_dfr_work_function_attribute")) {
+        if (granularity != 0)
+          splitLargeGenericOps(func, granularity);
+
+        for (auto &group : collectTaskGroups(func, granularity))
+          this->buildTask(group);
+      }
 
       // Perform simplifications, in particular DCE here in case some
       // of the operations sunk in tasks are no longer needed in the
@@ -157,52 +466,68 @@ struct BuildDataflowTaskGraphPass
       (void)mlir::simplifyRegions(rewriter, func->getRegions());
     });
   }
-  BuildDataflowTaskGraphPass(bool debug) : debug(debug){};
+  BuildDataflowTaskGraphPass(bool debug, uint64_t granularity)
+      : debug(debug), granularity(granularity){};
 
 protected:
-  mlir::WalkResult processOperation(mlir::Operation *op) {
-    if (isCandidateForTask(op)) {
-      IRMapping map;
-      Region &opBody = getOperation().getBody();
-      OpBuilder builder(opBody);
-
-      // Create a DFTask for this operation
-      builder.setInsertionPointAfter(op);
-      auto dftop = builder.create<RT::DataflowTaskOp>(
-          op->getLoc(), op->getResultTypes(), op->getOperands());
-
-      // Add the operation to the task
-      OpBuilder tbbuilder(dftop.getBody());
-      Operation *clonedOp = tbbuilder.clone(*op, map);
-
-      // Coarsen granularity by aggregating all dependence related
-      // lower-weight operations.
-      assert(!failed(coarsenDFTask(dftop)) &&
-             "Failing to sink operations into DFT");
-
-      // Add terminator
-      tbbuilder.create<RT::DataflowYieldOp>(dftop.getLoc(), mlir::TypeRange(),
-                                            op->getResults());
-      // Replace the uses of defined values
-      for (auto pair : llvm::zip(op->getResults(), clonedOp->getResults()))
-        replaceAllUsesInRegionWith(std::get<0>(pair), std::get<1>(pair),
-                                   dftop.getBody());
-      // Replace uses of the values defined by the task
-      for (auto pair : llvm::zip(op->getResults(), dftop->getResults()))
-        replaceAllUsesInRegionWith(std::get<0>(pair), std::get<1>(pair),
-                                   opBody);
-      // Once uses are re-targeted to the task, delete the operation
+  /// Moves the consecutive operations of `group` into a new
+  /// `RT::DataflowTaskOp`, which yields all values defined in the
+  /// group that are used outside of the group.
+  void buildTask(ArrayRef<Operation *> group) {
+    llvm::SmallPtrSet<Operation *, 8> groupSet(group.begin(), group.end());
+    SmallVector<Value> escapingValues;
+
+    for (Operation *op : group)
+      for (Value result : op->getResults())
+        if (llvm::any_of(result.getUsers(), [&](Operation *user) {
+              return !groupSet.count(user);
+            }))
+          escapingValues.push_back(result);
+
+    // Create a DFTask for the operations of the group
+    OpBuilder builder(group.back()->getContext());
+    builder.setInsertionPointAfter(group.back());
+    auto dftop = builder.create<RT::DataflowTaskOp>(
+        group.front()->getLoc(), ValueRange(escapingValues).getTypes(),
+        group.front()->getOperands());
+
+    // Add the operations to the task
+    IRMapping map;
+    OpBuilder tbbuilder(dftop.getBody());
+    for (Operation *op : group)
+      tbbuilder.clone(*op, map);
+
+    // Coarsen granularity by aggregating all dependence related
+    // lower-weight operations.
+    LogicalResult coarsened = coarsenDFTask(dftop);
+    assert(succeeded(coarsened) && "Failing to sink operations into DFT");
+    (void)coarsened;
+
+    // Add terminator
+    SmallVector<Value> yieldedValues;
+    for (Value v : escapingValues)
+      yieldedValues.push_back(map.lookup(v));
+
+    tbbuilder.create<RT::DataflowYieldOp>(dftop.getLoc(), mlir::TypeRange(),
+                                          yieldedValues);
+
+    // Replace uses of the values defined by the task
+    for (auto pair : llvm::zip(escapingValues, dftop->getResults()))
+      std::get<0>(pair).replaceAllUsesWith(std::get<1>(pair));
+
+    // Once uses are re-targeted to the task, delete the operations
+    for (Operation *op : llvm::reverse(group))
       op->erase();
-    }
-    return mlir::WalkResult::advance();
   }
 
   bool debug;
+  uint64_t granularity;
 };
 } // end anonymous namespace
 
-std::unique_ptr<mlir::Pass> createBuildDataflowTaskGraphPass(bool debug) {
-  return std::make_unique<BuildDataflowTaskGraphPass>(debug);
+std::unique_ptr<mlir::Pass>
+createBuildDataflowTaskGraphPass(bool debug, uint64_t granularity) {
+  return std::make_unique<BuildDataflowTaskGraphPass>(debug, granularity);
 }
 
 } // end namespace concretelang
@@ -303,6 +303,68 @@ struct WorkFunctionReturnOpInterfaceLowering
     return success();
   }
 };
+struct PoolAllocOpInterfaceLowering
+    : public ConvertOpToLLVMPattern<RT::PoolAllocOp> {
+  using ConvertOpToLLVMPattern<RT::PoolAllocOp>::ConvertOpToLLVMPattern;
+
+  mlir::LogicalResult
+  matchAndRewrite(RT::PoolAllocOp paOp, RT::PoolAllocOp::Adaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto memRefType = paOp.getOutput().getType().cast<MemRefType>();
+    SmallVector<Value, 4> sizes;
+    SmallVector<Value, 4> strides;
+    Value sizeBytes;
+    getMemRefDescriptorSizes(paOp.getLoc(), memRefType, {}, rewriter, sizes,
+                             strides, sizeBytes);
+
+    auto paFuncType = LLVM::LLVMFunctionType::get(
+        getVoidPtrI64Type(rewriter),
+        {getIndexType(), getVoidPtrI64Type(rewriter)});
+    auto paFuncOp = getOrInsertFuncOpDecl(paOp, "memref_pool_alloc_u64",
+                                          paFuncType, rewriter);
+    auto paCallOp = rewriter.create<LLVM::CallOp>(
+        paOp.getLoc(), paFuncOp,
+        ValueRange{sizeBytes, adaptor.getRuntimeContext()});
+
+    // Pool buffers are aligned, so the allocated and aligned pointers of the
+    // descriptor are the same.
+    Value ptr = rewriter.create<LLVM::BitcastOp>(
+        paOp.getLoc(), getElementPtrType(memRefType), paCallOp.getResult());
+    auto descriptor = createMemRefDescriptor(paOp.getLoc(), memRefType, ptr,
+                                             ptr, sizes, strides, rewriter);
+    rewriter.replaceOp(paOp, {descriptor});
+    return success();
+  }
+};
+struct PoolDeallocOpInterfaceLowering
+    : public ConvertOpToLLVMPattern<RT::PoolDeallocOp> {
+  using ConvertOpToLLVMPattern<RT::PoolDeallocOp>::ConvertOpToLLVMPattern;
+
+  mlir::LogicalResult
+  matchAndRewrite(RT::PoolDeallocOp pdOp, RT::PoolDeallocOp::Adaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto memRefType = pdOp.getInput().getType().cast<MemRefType>();
+    SmallVector<Value, 4> sizes;
+    SmallVector<Value, 4> strides;
+    Value sizeBytes;
+    getMemRefDescriptorSizes(pdOp.getLoc(), memRefType, {}, rewriter, sizes,
+                             strides, sizeBytes);
+
+    auto pdFuncType = LLVM::LLVMFunctionType::get(
+        getVoidType(), {getVoidPtrI64Type(rewriter), getIndexType(),
+                        getVoidPtrI64Type(rewriter)});
+    auto pdFuncOp = getOrInsertFuncOpDecl(pdOp, "memref_pool_free_u64",
+                                          pdFuncType, rewriter);
+    MemRefDescriptor descriptor(adaptor.getInput());
+    Value ptr = rewriter.create<LLVM::BitcastOp>(
+        pdOp.getLoc(), getVoidPtrI64Type(rewriter),
+        descriptor.allocatedPtr(rewriter, pdOp.getLoc()));
+    rewriter.replaceOpWithNewOp<LLVM::CallOp>(
+        pdOp, pdFuncOp,
+        ValueRange{ptr, sizeBytes, adaptor.getRuntimeContext()});
+    return success();
+  }
+};
 } // end anonymous namespace
 } // namespace concretelang
 } // namespace mlir
@@ -320,6 +382,8 @@ void mlir::concretelang::populateRTToLLVMConversionPatterns(
     RegisterTaskWorkFunctionOpInterfaceLowering,
     DeallocateFutureOpInterfaceLowering,
     DeallocateFutureDataOpInterfaceLowering,
-    WorkFunctionReturnOpInterfaceLowering>(converter);
+    WorkFunctionReturnOpInterfaceLowering,
+    PoolAllocOpInterfaceLowering,
+    PoolDeallocOpInterfaceLowering>(converter);
   // clang-format on
 }
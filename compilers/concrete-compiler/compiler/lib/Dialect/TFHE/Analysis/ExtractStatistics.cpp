@@ -1,8 +1,11 @@
 #include <concretelang/Analysis/Utils.h>
 #include <concretelang/Dialect/TFHE/Analysis/ExtractStatistics.h>
 
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/STLExtras.h>
 #include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/Dialect/SCF/IR/SCF.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
 #include <mlir/IR/BuiltinOps.h>
 #include <mlir/IR/Operation.h>
 
@@ -31,6 +34,250 @@ namespace TFHE {
     }                                                                          \
   }
 
+/// Computes the parallelism of the bootstraps from the data flow. The depth
+/// of a value is the number of bootstraps of the longest chain of bootstraps
+/// it depends on, the bootstraps of the same depth being independent.
+/// Tensors are tracked as a whole, their depth is the one of their deepest
+/// element, except for the loop carried tensors updated elementwise (see
+/// `elementwiseIndices`).
+struct PbsParallelismAnalysis {
+  /// Number of bootstraps at each depth, starting at depth 1
+  std::vector<uint64_t> widths;
+
+  llvm::DenseMap<mlir::Value, uint64_t> depths;
+
+  /// Depth of the elements extracted from the loop carried tensors updated
+  /// elementwise, which are the ones of the tensors entering the outermost
+  /// loops
+  llvm::DenseMap<mlir::Value, uint64_t> elementDepths;
+
+  uint64_t depthOf(mlir::Value value) {
+    auto it = depths.find(value);
+    return it == depths.end() ? 0 : it->second;
+  }
+
+  /// Returns the indices of the elements of the loop carried tensor `arg`
+  /// accessed by each iteration of `op`, if they are all at the same indices,
+  /// which include the induction variable: `arg` is only read by
+  /// tensor.extract and updated by a chain of tensor.insert, or of nested
+  /// loops updating it elementwise, yielding `yielded`. The iterations then
+  /// access distinct elements, e.g. an extract, a bootstrap and an insert, and
+  /// do not depend on each other through `arg`. The nested loops are the ones
+  /// of the lowering of the multi-dimensional elementwise operations.
+  static std::optional<mlir::ValueRange>
+  elementwiseIndices(scf::ForOp op, mlir::Value arg, mlir::Value yielded) {
+    std::optional<mlir::ValueRange> indices;
+    auto sameIndices = [&](mlir::ValueRange accessIndices) {
+      if (!indices.has_value())
+        indices = accessIndices;
+      return llvm::equal(*indices, accessIndices);
+    };
+    mlir::Value current = arg;
+    while (current != yielded) {
+      mlir::Value next;
+      for (auto &use : current.getUses()) {
+        auto extractOp = llvm::dyn_cast<tensor::ExtractOp>(use.getOwner());
+        auto insertOp = llvm::dyn_cast<tensor::InsertOp>(use.getOwner());
+        auto forOp = llvm::dyn_cast<scf::ForOp>(use.getOwner());
+        if (extractOp && current == arg) {
+          if (!sameIndices(extractOp.getIndices()))
+            return std::nullopt;
+        } else if (insertOp && insertOp.getDest() == current && !next) {
+          if (!sameIndices(insertOp.getIndices()))
+            return std::nullopt;
+          next = insertOp.getResult();
+        } else if (forOp && !next &&
+                   use.getOperandNumber() >=
+                       forOp.getInitArgs().getBeginOperandIndex()) {
+          unsigned i = use.getOperandNumber() -
+                       forOp.getInitArgs().getBeginOperandIndex();
+          auto nestedIndices = elementwiseIndices(
+              forOp, forOp.getRegionIterArgs()[i],
+              forOp.getBody()->getTerminator()->getOperand(i));
+          if (!nestedIndices.has_value() || !sameIndices(*nestedIndices))
+            return std::nullopt;
+          next = forOp.getResult(i);
+        } else {
+          return std::nullopt;
+        }
+      }
+      if (!next)
+        return std::nullopt;
+      current = next;
+    }
+    Operation *terminator = op.getBody()->getTerminator();
+    if (!indices.has_value() ||
+        !llvm::is_contained(*indices, op.getInductionVar()) ||
+        !llvm::all_of(yielded.getUsers(), [&](Operation *user) {
+          return user == terminator;
+        }))
+      return std::nullopt;
+    return indices;
+  }
+
+  /// Visits the operations of `block`, executed `multiplicity` times, the
+  /// bootstraps being counted in the widths if `record`.
+  std::optional<StringError> visit(mlir::Block &block, uint64_t multiplicity,
+                                   bool record) {
+    for (auto &op : block) {
+      if (op.hasTrait<OpTrait::IsTerminator>())
+        continue;
+      std::optional<StringError> error = visit(&op, multiplicity, record);
+      if (error.has_value())
+        return error;
+    }
+    return std::nullopt;
+  }
+
+  std::optional<StringError> visit(mlir::Operation *op, uint64_t multiplicity,
+                                   bool record) {
+    if (auto forOp = llvm::dyn_cast<scf::ForOp>(op))
+      return visit(forOp, multiplicity, record);
+
+    // The element has not been written by the previous iterations
+    if (auto extractOp = llvm::dyn_cast<tensor::ExtractOp>(op)) {
+      auto element = elementDepths.find(extractOp.getTensor());
+      if (element != elementDepths.end()) {
+        depths[extractOp.getResult()] = element->second;
+        return std::nullopt;
+      }
+    }
+
+    uint64_t depth = 0;
+    for (auto operand : op->getOperands())
+      depth = std::max(depth, depthOf(operand));
+
+    // The other regions, e.g. the branches of a scf.if, run at most once
+    for (auto &region : op->getRegions()) {
+      for (auto &block : region) {
+        for (auto arg : block.getArguments())
+          depths[arg] = depth;
+        std::optional<StringError> error = visit(block, multiplicity, record);
+        if (error.has_value())
+          return error;
+        if (!block.empty() &&
+            block.back().hasTrait<OpTrait::IsTerminator>()) {
+          for (auto operand : block.back().getOperands())
+            depth = std::max(depth, depthOf(operand));
+        }
+      }
+    }
+
+    if (llvm::isa<TFHE::BootstrapGLWEOp, TFHE::WopPBSGLWEOp>(op)) {
+      depth++;
+      if (record) {
+        if (widths.size() < depth)
+          widths.resize(depth, 0);
+        widths[depth - 1] += multiplicity;
+      }
+    }
+    for (auto result : op->getResults())
+      depths[result] = depth;
+    return std::nullopt;
+  }
+
+  std::optional<StringError> visit(scf::ForOp op, uint64_t multiplicity,
+                                   bool record) {
+    auto numberOfIterations = calculateNumberOfIterations(op);
+    if (!numberOfIterations) {
+      return numberOfIterations.error();
+    }
+    uint64_t iterations = (uint64_t)numberOfIterations.value();
+
+    // Runs one iteration on loop carried values of depths `carried`, and
+    // updates them to the depths of the yielded values
+    auto iterate = [&](std::vector<uint64_t> &carried, uint64_t times,
+                       bool recordIteration) -> std::optional<StringError> {
+      depths[op.getInductionVar()] = 0;
+      for (auto [arg, depth] : llvm::zip(op.getRegionIterArgs(), carried))
+        depths[arg] = depth;
+      std::optional<StringError> error =
+          visit(*op.getBody(), times, recordIteration);
+      if (error.has_value())
+        return error;
+      for (auto [i, yielded] :
+           llvm::enumerate(op.getBody()->getTerminator()->getOperands()))
+        carried[i] = depthOf(yielded);
+      return std::nullopt;
+    };
+
+    std::vector<uint64_t> carried;
+    for (auto [arg, init, yielded] :
+         llvm::zip(op.getRegionIterArgs(), op.getInitArgs(),
+                   op.getBody()->getTerminator()->getOperands())) {
+      carried.push_back(depthOf(init));
+      if (elementwiseIndices(op, arg, yielded).has_value()) {
+        // The nested loops update the elements of the tensor of the outer one
+        auto element = elementDepths.find(init);
+        elementDepths[arg] =
+            element != elementDepths.end() ? element->second : depthOf(init);
+      }
+    }
+    if (iterations == 0) {
+      for (auto [result, depth] : llvm::zip(op.getResults(), carried))
+        depths[result] = depth;
+      return std::nullopt;
+    }
+
+    // The iterations are independent if the loop carried values don't get
+    // deeper from one iteration to the next one, e.g. the insertions of the
+    // results of an elementwise lookup table, and sequential otherwise,
+    // e.g. an accumulation through bootstraps.
+    std::vector<uint64_t> first = carried;
+    std::optional<StringError> error = iterate(first, multiplicity, false);
+    if (error.has_value())
+      return error;
+    std::vector<uint64_t> second = first;
+    error = iterate(second, multiplicity, false);
+    if (error.has_value())
+      return error;
+
+    if (first == second) {
+      if (record) {
+        error = iterate(carried, multiplicity * iterations, true);
+        if (error.has_value())
+          return error;
+      }
+      carried = first;
+    } else {
+      // The loop carried values get deeper by the same amount at each
+      // iteration, the one between the first two iterations, and so do the
+      // bootstraps of the body, which are recorded for the first iteration
+      // and shifted by the deepening of the deepest loop carried value.
+      uint64_t shift = 0;
+      for (auto [depthAfterFirst, depthAfterSecond] : llvm::zip(first, second))
+        if (depthAfterSecond > depthAfterFirst)
+          shift = std::max(shift, depthAfterSecond - depthAfterFirst);
+      if (record) {
+        std::vector<uint64_t> bodyWidths;
+        std::swap(widths, bodyWidths);
+        error = iterate(carried, multiplicity, true);
+        std::swap(widths, bodyWidths);
+        if (error.has_value())
+          return error;
+        for (uint64_t i = 0; i < iterations; i++) {
+          for (auto [depth, width] : llvm::enumerate(bodyWidths)) {
+            if (width == 0)
+              continue;
+            uint64_t shifted = depth + i * shift;
+            if (widths.size() <= shifted)
+              widths.resize(shifted + 1, 0);
+            widths[shifted] += width;
+          }
+        }
+      }
+      carried = iterations == 1 ? first : second;
+      for (auto [depth, depthAfterFirst] : llvm::zip(carried, first))
+        if (depth > depthAfterFirst)
+          depth += (iterations - 2) * (depth - depthAfterFirst);
+    }
+
+    for (auto [result, depth] : llvm::zip(op.getResults(), carried))
+      depths[result] = depth;
+    return std::nullopt;
+  }
+};
+
 struct ExtractTFHEStatisticsPass
     : public PassWrapper<ExtractTFHEStatisticsPass, OperationPass<ModuleOp>> {
 
@@ -63,7 +310,26 @@ struct ExtractTFHEStatisticsPass
 
     if (walk.wasInterrupted()) {
       signalPassFailure();
+      return;
+    }
+
+    // Each function, e.g. each circuit, starts from its inputs
+    PbsParallelismAnalysis parallelism;
+    for (auto &op : getOperation().getBody()->getOperations()) {
+      for (auto &region : op.getRegions()) {
+        for (auto &block : region) {
+          std::optional<StringError> error =
+              parallelism.visit(block, 1, true);
+          if (error.has_value()) {
+            op.emitError() << error->mesg;
+            signalPassFailure();
+            return;
+          }
+        }
+      }
     }
+    feedback.pbsWidthProfile = parallelism.widths;
+    feedback.pbsCriticalPath = parallelism.widths.size();
   }
 
   std::optional<StringError> enter(mlir::Operation *op) {
@@ -71,7 +337,9 @@ struct ExtractTFHEStatisticsPass
     DISPATCH_ENTER(TFHE::AddGLWEOp)
     DISPATCH_ENTER(TFHE::AddGLWEIntOp)
     DISPATCH_ENTER(TFHE::BootstrapGLWEOp)
+    DISPATCH_ENTER(TFHE::Conv2dGLWEIntOp)
     DISPATCH_ENTER(TFHE::KeySwitchGLWEOp)
+    DISPATCH_ENTER(TFHE::MatMulGLWEIntOp)
     DISPATCH_ENTER(TFHE::MulGLWEIntOp)
     DISPATCH_ENTER(TFHE::NegGLWEOp)
     DISPATCH_ENTER(TFHE::SubGLWEIntOp)
@@ -216,6 +484,92 @@ struct ExtractTFHEStatisticsPass
     return std::nullopt;
   }
 
+  // ####################
+  // TFHE.conv2d_glwe_int
+  // ####################
+
+  static std::optional<StringError> on_enter(TFHE::Conv2dGLWEIntOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    auto weightType = op.getWeight().getType().cast<mlir::RankedTensorType>();
+    auto resultType = op.getResult().getType().cast<mlir::RankedTensorType>();
+    auto resultingKey = resultType.getElementType()
+                            .cast<TFHE::GLWECipherTextType>()
+                            .getKey()
+                            .getNormalized();
+
+    auto location = locationString(op.getLoc());
+    auto keys = std::vector<std::pair<KeyType, size_t>>();
+    // Each output ciphertext is the sum of the products of a filter.
+    auto count = pass.iterations * (uint64_t)resultType.getNumElements() *
+                 (uint64_t)(weightType.getDimSize(1) *
+                            weightType.getDimSize(2) *
+                            weightType.getDimSize(3));
+
+    std::pair<KeyType, size_t> key =
+        std::make_pair(KeyType::SECRET, (size_t)resultingKey->index);
+    keys.push_back(key);
+
+    auto operation = PrimitiveOperation::CLEAR_MULTIPLICATION;
+    pass.feedback.statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    operation = PrimitiveOperation::ENCRYPTED_ADDITION;
+    pass.feedback.statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    return std::nullopt;
+  }
+
+  // ####################
+  // TFHE.matmul_glwe_int
+  // ####################
+
+  static std::optional<StringError> on_enter(TFHE::MatMulGLWEIntOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    auto lhsType = op.getLhs().getType().cast<mlir::RankedTensorType>();
+    auto resultType = op.getResult().getType().cast<mlir::RankedTensorType>();
+    auto resultingKey = resultType.getElementType()
+                            .cast<TFHE::GLWECipherTextType>()
+                            .getKey()
+                            .getNormalized();
+
+    auto location = locationString(op.getLoc());
+    auto keys = std::vector<std::pair<KeyType, size_t>>();
+    // Each output ciphertext is the sum of the products of a row of `lhs`.
+    auto count = pass.iterations * (uint64_t)resultType.getNumElements() *
+                 (uint64_t)lhsType.getDimSize(1);
+
+    std::pair<KeyType, size_t> key =
+        std::make_pair(KeyType::SECRET, (size_t)resultingKey->index);
+    keys.push_back(key);
+
+    auto operation = PrimitiveOperation::CLEAR_MULTIPLICATION;
+    pass.feedback.statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    operation = PrimitiveOperation::ENCRYPTED_ADDITION;
+    pass.feedback.statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    return std::nullopt;
+  }
+
   // #################
   // TFHE.mul_glwe_int
   // #################
@@ -117,6 +117,91 @@ mlir::LogicalResult MulGLWEIntOp::verify() {
       *this);
 }
 
+mlir::LogicalResult MatMulGLWEIntOp::verify() {
+  auto lhsType = this->getLhs().getType().cast<mlir::RankedTensorType>();
+  auto rhsType = this->getRhs().getType().cast<mlir::RankedTensorType>();
+  auto resultType = this->getResult().getType().cast<mlir::RankedTensorType>();
+
+  if (lhsType.getElementType() != resultType.getElementType()) {
+    emitOpErrorForKeyMismatch(*this);
+    return mlir::failure();
+  }
+
+  if ((int)rhsType.getElementTypeBitWidth() != 64) {
+    this->emitOpError() << "should have the width of `rhs` equals 64 : "
+                        << rhsType.getElementTypeBitWidth() << " != 64";
+    return mlir::failure();
+  }
+
+  if (lhsType.getDimSize(1) != rhsType.getDimSize(0) ||
+      resultType.getDimSize(0) != lhsType.getDimSize(0) ||
+      resultType.getDimSize(1) != rhsType.getDimSize(1)) {
+    this->emitOpError() << "should have a result of shape "
+                        << "(lhs.shape[0], rhs.shape[1]) and "
+                        << "lhs.shape[1] == rhs.shape[0]";
+    return mlir::failure();
+  }
+
+  return mlir::success();
+}
+
+mlir::LogicalResult Conv2dGLWEIntOp::verify() {
+  auto inputType = this->getInput().getType().cast<mlir::RankedTensorType>();
+  auto weightType = this->getWeight().getType().cast<mlir::RankedTensorType>();
+  auto resultType = this->getResult().getType().cast<mlir::RankedTensorType>();
+
+  if (inputType.getElementType() != resultType.getElementType()) {
+    emitOpErrorForKeyMismatch(*this);
+    return mlir::failure();
+  }
+
+  if ((int)weightType.getElementTypeBitWidth() != 64) {
+    this->emitOpError() << "should have the width of `weight` equals 64 : "
+                        << weightType.getElementTypeBitWidth() << " != 64";
+    return mlir::failure();
+  }
+
+  auto strides = this->getStrides();
+  auto dilations = this->getDilations();
+  if (strides.size() != 2 || dilations.size() != 2) {
+    this->emitOpError() << "should have 2 strides and 2 dilations";
+    return mlir::failure();
+  }
+  if (strides[0] < 1 || strides[1] < 1 || dilations[0] < 1 ||
+      dilations[1] < 1) {
+    this->emitOpError() << "should have strictly positive strides and "
+                        << "dilations";
+    return mlir::failure();
+  }
+
+  int64_t group = this->getGroup();
+  auto inputShape = inputType.getShape();
+  auto weightShape = weightType.getShape();
+  auto resultShape = resultType.getShape();
+  if (group < 1 || weightShape[0] % group != 0 ||
+      inputShape[1] != weightShape[1] * group) {
+    this->emitOpError() << "should have input.shape[1] == weight.shape[1] * "
+                        << "group and weight.shape[0] multiple of group";
+    return mlir::failure();
+  }
+
+  int64_t expectedHeight =
+      (inputShape[2] - dilations[0] * (weightShape[2] - 1) - 1) / strides[0] +
+      1;
+  int64_t expectedWidth =
+      (inputShape[3] - dilations[1] * (weightShape[3] - 1) - 1) / strides[1] +
+      1;
+  if (resultShape[0] != inputShape[0] || resultShape[1] != weightShape[0] ||
+      resultShape[2] != expectedHeight || resultShape[3] != expectedWidth) {
+    this->emitOpError() << "should have a result of shape ["
+                        << inputShape[0] << ", " << weightShape[0] << ", "
+                        << expectedHeight << ", " << expectedWidth << "]";
+    return mlir::failure();
+  }
+
+  return mlir::success();
+}
+
 mlir::LogicalResult EncodeExpandLutForBootstrapOp::verify() {
   mlir::IntegerAttr polySizeAttr = this->getPolySizeAttr();
 
@@ -226,8 +226,8 @@ public:
               TFHE::BootstrapGLWEOp, TFHE::BatchedKeySwitchGLWEOp,
               TFHE::BatchedBootstrapGLWEOp, TFHE::EncodeExpandLutForBootstrapOp,
               TFHE::EncodeLutForCrtWopPBSOp, TFHE::EncodePlaintextWithCrtOp,
-              TFHE::WopPBSGLWEOp, mlir::func::ReturnOp,
-              Tracing::TraceCiphertextOp>([&](auto op) {
+              TFHE::WopPBSGLWEOp, TFHE::BatchedWopPBSGLWEOp,
+              mlir::func::ReturnOp, Tracing::TraceCiphertextOp>([&](auto op) {
           converge<NoTypeConstraint>(op, state, inferredTypes);
         })
 
@@ -247,11 +247,11 @@ public:
           converge<SameOperandAndResultTypeConstraint<1, 0>>(op, state,
                                                              inferredTypes);
         })
-        .Case<TFHE::BatchedMulGLWECstIntOp, mlir::tensor::ExpandShapeOp>(
-            [&](auto op) {
-              converge<SameOperandAndResultElementTypeConstraint<0, 0>>(
-                  op, state, inferredTypes);
-            })
+        .Case<TFHE::BatchedMulGLWECstIntOp, TFHE::MatMulGLWEIntOp,
+              TFHE::Conv2dGLWEIntOp, mlir::tensor::ExpandShapeOp>([&](auto op) {
+          converge<SameOperandAndResultElementTypeConstraint<0, 0>>(
+              op, state, inferredTypes);
+        })
 
         .Case<mlir::tensor::FromElementsOp>([&](auto op) {
           TypeConstraintSet<> cs;
@@ -5,14 +5,20 @@
 
 #include "concretelang/Runtime/stream_emulator_api.h"
 #include "concretelang/Runtime/wrappers.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstring>
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <numeric>
-#include <queue>
-#include <sched.h>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -21,26 +27,204 @@ namespace concretelang {
 namespace stream_emulator {
 namespace {
 
-template <typename T> struct StreamBase {
-  void put(T e) { q.push(e); }
+/// Number of spin iterations performed by a blocked stream endpoint before
+/// going to sleep.
+static constexpr unsigned streamSpinCount = 1024;
+
+/// Number of elements held by each segment of the streams.
+static constexpr size_t streamSegmentSize = 64;
+
+/// Number of elements a process may queue in its output streams before
+/// waiting for their consumers, which bounds the memory held by in-flight
+/// ciphertexts. It is set by `SDFG_STREAM_CAPACITY`, and defaults to 16.
+/// Streams grow beyond it when the host puts more elements, so that the host
+/// never blocks on a put.
+static size_t streamCapacity() {
+  static const size_t capacity = []() -> size_t {
+    char *env = getenv("SDFG_STREAM_CAPACITY");
+    if (env != nullptr && strtoul(env, NULL, 10) != 0)
+      return strtoul(env, NULL, 10);
+    return 16;
+  }();
+  return capacity;
+}
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+struct DFGraph;
+struct Process;
+void scheduleProcess(Process *p);
+
+/// Blocks a stream endpoint until a condition holds, spinning for a while
+/// before sleeping on a condition variable. The sleeping flag and the
+/// stream indices are ordered by sequentially consistent fences on both
+/// sides, so that a notifier either observes the sleeping flag or the
+/// waiter observes the updated index.
+struct StreamWaiter {
+  template <typename Pred> void wait(Pred ready) {
+    for (unsigned i = 0; i < streamSpinCount; i++) {
+      if (ready())
+        return;
+      cpuRelax();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cv.wait(lock, ready);
+    sleeping.store(false, std::memory_order_relaxed);
+  }
+  void notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(mutex);
+      cv.notify_one();
+    }
+  }
+
+private:
+  std::atomic<bool> sleeping{false};
+  std::mutex mutex;
+  std::condition_variable cv;
+};
+
+/// Type-independent part of the streams, linking them to the graph and to
+/// the processes at their endpoints (if any, the host being the other
+/// possible endpoint).
+struct StreamNode {
+  virtual ~StreamNode() {}
+  /// Number of elements currently in the stream.
+  virtual size_t size() = 0;
+  /// Number of elements a process can put in the stream before reaching its
+  /// capacity.
+  size_t space() {
+    size_t n = size();
+    return n < streamCapacity() ? streamCapacity() - n : 0;
+  }
+
+  DFGraph *dfg = nullptr;
+  Process *producer = nullptr;
+  Process *consumer = nullptr;
+};
+
+/// Unbounded lock-free single-producer/single-consumer stream, made of a
+/// linked list of fixed-size segments. Each stream connects exactly one
+/// producer (a process or the host) to one consumer. Processes at the
+/// endpoints are scheduled whenever an element or some space becomes
+/// available, and only the consumer blocks, on an empty stream.
+template <typename T> struct StreamBase : StreamNode {
+  StreamBase() { headSegment = tailSegment = new Segment; }
+  ~StreamBase() {
+    while (headSegment != nullptr) {
+      Segment *next = headSegment->next.load(std::memory_order_relaxed);
+      delete headSegment;
+      headSegment = next;
+    }
+  }
+  void put(T e) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t != 0 && t % streamSegmentSize == 0) {
+      // The segment is full, the next one is published with the element
+      Segment *segment = new Segment;
+      tailSegment->next.store(segment, std::memory_order_relaxed);
+      tailSegment = segment;
+    }
+    tailSegment->elements[t % streamSegmentSize] = e;
+    tail.store(t + 1, std::memory_order_release);
+    consumerWaiter.notify();
+    if (consumer)
+      scheduleProcess(consumer);
+  }
   T get() {
-    while (q.empty())
-      sched_yield();
-    T ret = q.front();
-    q.pop();
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == cachedTail) {
+      consumerWaiter.wait([&]() {
+        cachedTail = tail.load(std::memory_order_acquire);
+        return h != cachedTail;
+      });
+    }
+    if (h != 0 && h % streamSegmentSize == 0) {
+      // The producer has moved to the next segment before publishing the
+      // element at `h`
+      Segment *segment = headSegment->next.load(std::memory_order_relaxed);
+      delete headSegment;
+      headSegment = segment;
+    }
+    T ret = headSegment->elements[h % streamSegmentSize];
+    head.store(h + 1, std::memory_order_release);
+    if (producer)
+      scheduleProcess(producer);
     return ret;
   }
-  bool empty() { return q.empty(); }
+  size_t size() override {
+    size_t h = head.load(std::memory_order_acquire);
+    return tail.load(std::memory_order_acquire) - h;
+  }
+  bool empty() { return size() == 0; }
 
 private:
-  std::queue<T> q;
+  struct Segment {
+    T elements[streamSegmentSize];
+    std::atomic<Segment *> next{nullptr};
+  };
+
+  // Consumer side: index of the next element to read, last tail seen, and
+  // segment of the next element.
+  alignas(64) std::atomic<size_t> head{0};
+  size_t cachedTail = 0;
+  Segment *headSegment;
+  StreamWaiter consumerWaiter;
+  // Producer side: index of the next slot to write, and its segment.
+  alignas(64) std::atomic<size_t> tail{0};
+  Segment *tailSegment;
 };
-union Stream {
-  StreamBase<uint64_t> *uint64_stream;
-  StreamBase<MemRefDescriptor<1>> *memref_stream;
 
-  Stream(StreamBase<uint64_t> *s) : uint64_stream(s) {}
-  Stream(StreamBase<MemRefDescriptor<1>> *s) : memref_stream(s) {}
+struct Stream {
+  StreamNode *node;
+
+  Stream(StreamBase<uint64_t> *s) : node(s) {}
+  Stream(StreamBase<MemRefDescriptor<1>> *s) : node(s) {}
+
+  StreamBase<uint64_t> *uint64_stream() {
+    return static_cast<StreamBase<uint64_t> *>(node);
+  }
+  StreamBase<MemRefDescriptor<1>> *memref_stream() {
+    return static_cast<StreamBase<MemRefDescriptor<1>> *>(node);
+  }
+};
+
+/// Recycles the ciphertext buffers flowing through the streams of a graph,
+/// so that processes do not allocate their outputs for each item. All
+/// buffers remain owned by the pool and are released with the graph.
+struct BufferPool {
+  ~BufferPool() {
+    for (auto buffer : buffers)
+      free(buffer);
+  }
+  uint64_t *acquire(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &available = freeBuffers[size];
+    if (!available.empty()) {
+      uint64_t *buffer = available.back();
+      available.pop_back();
+      return buffer;
+    }
+    uint64_t *buffer = (uint64_t *)malloc(size * sizeof(uint64_t));
+    buffers.push_back(buffer);
+    return buffer;
+  }
+  void release(uint64_t *buffer, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    freeBuffers[size].push_back(buffer);
+  }
+
+private:
+  std::mutex mutex;
+  std::unordered_map<size_t, std::vector<uint64_t *>> freeBuffers;
+  std::vector<uint64_t *> buffers;
 };
 
 struct Void {};
@@ -53,8 +237,6 @@ union Context {
   mlir::concretelang::RuntimeContext *val;
 };
 struct Process {
-  void terminate() { terminate_p = true; }
-  bool terminate_p = false;
   std::vector<Stream> input_streams;
   std::vector<Stream> output_streams;
   Param level;
@@ -68,128 +250,280 @@ struct Process {
   Param ksk_index;
   Param bsk_index;
   Context ctx;
-  void (*fun)(Process *);
+  DFGraph *dfg;
+  /// Consumes `n` elements from each input stream and produces `n` elements
+  /// on each output stream.
+  void (*fun)(Process *, size_t n);
+
+  /// Returns the number of elements the process can handle without
+  /// blocking on any of its streams.
+  size_t readyElements() {
+    size_t n = streamCapacity();
+    for (auto s : input_streams)
+      n = std::min(n, s.node->size());
+    for (auto s : output_streams)
+      n = std::min(n, s.node->space());
+    return n;
+  }
+
+  /// Scheduling state, protected by the scheduler mutex of the graph. A
+  /// process scheduled while running is marked dirty and rescheduled once
+  /// done, so that no wake-up is lost.
+  enum { IDLE, QUEUED, RUNNING, RUNNING_DIRTY } state = IDLE;
 };
 
+/// Executes the processes of a graph on a fixed pool of worker threads.
+/// Processes never block: they are queued whenever one of their streams
+/// gets an element or some space, and run by a worker on all the elements
+/// available at once. The number of workers is set by `SDFG_NUM_THREADS`,
+/// and defaults to the number of hardware threads.
 struct DFGraph {
   ~DFGraph() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    cv.notify_all();
+    for (auto &worker : workers)
+      worker.join();
     for (auto p : dfg_processes)
-      p->terminate();
+      delete p;
+    for (auto s : streams)
+      delete s;
+  }
+  void addProcess(Process *p) {
+    p->dfg = this;
+    for (auto s : p->input_streams) {
+      s.node->dfg = this;
+      s.node->consumer = p;
+      streams.insert(s.node);
+    }
+    for (auto s : p->output_streams) {
+      s.node->dfg = this;
+      s.node->producer = p;
+      streams.insert(s.node);
+    }
+    dfg_processes.push_back(p);
   }
   void run() {
-    for (auto p : dfg_processes) {
-      std::thread process_thread(p->fun, p);
-      process_thread.detach();
+    size_t numWorkers = std::thread::hardware_concurrency();
+    char *env = getenv("SDFG_NUM_THREADS");
+    if (env != nullptr && strtoul(env, NULL, 10) != 0)
+      numWorkers = strtoul(env, NULL, 10);
+    numWorkers = std::min(numWorkers, dfg_processes.size());
+    for (size_t i = 0; i < std::max<size_t>(numWorkers, 1); i++)
+      workers.emplace_back([this]() { work(); });
+  }
+  void schedule(Process *p) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (p->state == Process::IDLE) {
+      p->state = Process::QUEUED;
+      readyQueue.push_back(p);
+      cv.notify_one();
+    } else if (p->state == Process::RUNNING) {
+      p->state = Process::RUNNING_DIRTY;
     }
   }
+
+  BufferPool pool;
   std::vector<Process *> dfg_processes;
+
+private:
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [&]() { return stopping || !readyQueue.empty(); });
+      if (stopping)
+        return;
+      Process *p = readyQueue.front();
+      readyQueue.pop_front();
+      p->state = Process::RUNNING;
+      lock.unlock();
+      for (size_t n = p->readyElements(); n > 0; n = p->readyElements())
+        p->fun(p, n);
+      lock.lock();
+      if (p->state == Process::RUNNING_DIRTY) {
+        p->state = Process::QUEUED;
+        readyQueue.push_back(p);
+      } else {
+        p->state = Process::IDLE;
+      }
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::unordered_set<StreamNode *> streams;
+  std::deque<Process *> readyQueue;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stopping = false;
 };
 
-// Stream emulator processes
-void memref_keyswitch_lwe_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> out;
-    out.sizes[0] = p->output_size.val;
-    out.strides[0] = 1;
-    out.offset = 0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(out.sizes[0] * sizeof(uint64_t));
-    memref_keyswitch_lwe_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        p->level.val, p->base_log.val, p->input_lwe_dim.val,
-        p->output_lwe_dim.val, p->ksk_index.val, p->ctx.val);
-    (p->output_streams[0]).memref_stream->put(out);
+void scheduleProcess(Process *p) { p->dfg->schedule(p); }
+
+/// A batch of `n` ciphertexts taken from a stream, viewed as a rank 2 memref.
+/// A single ciphertext is used in place, while larger batches are gathered
+/// in a pooled buffer. All the buffers go back to the pool with the batch.
+struct InputBatch {
+  InputBatch(DFGraph *dfg, StreamBase<MemRefDescriptor<1>> *s, size_t n)
+      : dfg(dfg) {
+    for (size_t i = 0; i < n; i++)
+      elements.push_back(s->get());
+    size_t size = elements[0].sizes[0];
+    if (n == 1) {
+      mref = {elements[0].allocated,
+              elements[0].aligned,
+              elements[0].offset,
+              {1, size},
+              {size, 1}};
+      return;
+    }
+    gathered = dfg->pool.acquire(n * size);
+    for (size_t i = 0; i < n; i++)
+      memcpy(gathered + i * size, elements[i].aligned + elements[i].offset,
+             size * sizeof(uint64_t));
+    mref = {gathered, gathered, 0, {n, size}, {size, 1}};
   }
-  delete p;
-}
+  ~InputBatch() {
+    for (auto e : elements)
+      dfg->pool.release(e.allocated, e.sizes[0]);
+    if (gathered)
+      dfg->pool.release(gathered, mref.sizes[0] * mref.sizes[1]);
+  }
+  size_t elementSize() { return mref.sizes[1]; }
+
+  MemRefDescriptor<2> mref;
+
+private:
+  DFGraph *dfg;
+  std::vector<MemRefDescriptor<1>> elements;
+  uint64_t *gathered = nullptr;
+};
 
-void memref_bootstrap_lwe_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> tlu = (p->input_streams[1]).memref_stream->get();
-    MemRefDescriptor<1> out;
-    out.sizes[0] = p->output_size.val;
-    out.strides[0] = 1;
-    out.offset = 0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(out.sizes[0] * sizeof(uint64_t));
-    memref_bootstrap_lwe_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        tlu.allocated, tlu.aligned, tlu.offset, tlu.sizes[0], tlu.strides[0],
-        p->input_lwe_dim.val, p->poly_size.val, p->level.val, p->base_log.val,
-        p->glwe_dim.val, p->bsk_index.val, p->ctx.val);
-    (p->output_streams[0]).memref_stream->put(out);
+/// A batch of `n` output ciphertexts of the given size, viewed as a rank 2
+/// memref and scattered to a stream once computed.
+struct OutputBatch {
+  OutputBatch(DFGraph *dfg, size_t n, size_t size) : dfg(dfg) {
+    uint64_t *buffer = dfg->pool.acquire(n * size);
+    mref = {buffer, buffer, 0, {n, size}, {size, 1}};
   }
-  delete p;
-}
+  void put(StreamBase<MemRefDescriptor<1>> *s) {
+    size_t n = mref.sizes[0], size = mref.sizes[1];
+    if (n == 1) {
+      s->put({mref.allocated, mref.aligned, 0, {size}, {1}});
+      return;
+    }
+    for (size_t i = 0; i < n; i++) {
+      uint64_t *buffer = dfg->pool.acquire(size);
+      memcpy(buffer, mref.aligned + i * size, size * sizeof(uint64_t));
+      s->put({buffer, buffer, 0, {size}, {1}});
+    }
+    dfg->pool.release(mref.allocated, n * size);
+  }
+
+  MemRefDescriptor<2> mref;
 
-void memref_add_lwe_ciphertexts_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> ct1 = (p->input_streams[1]).memref_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_add_lwe_ciphertexts_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        ct1.allocated, ct1.aligned, ct1.offset, ct1.sizes[0], ct1.strides[0]);
-    (p->output_streams[0]).memref_stream->put(out);
+private:
+  DFGraph *dfg;
+};
+
+/// Takes `n` scalars from a stream, viewed as a rank 1 memref.
+struct ScalarBatch {
+  ScalarBatch(StreamBase<uint64_t> *s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+      values.push_back(s->get());
+    mref = {values.data(), values.data(), 0, {n}, {1}};
   }
-  delete p;
+
+  MemRefDescriptor<1> mref;
+
+private:
+  std::vector<uint64_t> values;
+};
+
+// Stream emulator processes
+void memref_keyswitch_lwe_u64_process(Process *p, size_t n) {
+  InputBatch ct0(p->dfg, p->input_streams[0].memref_stream(), n);
+  OutputBatch out(p->dfg, n, p->output_size.val);
+  memref_batched_keyswitch_lwe_u64(
+      out.mref.allocated, out.mref.aligned, out.mref.offset, out.mref.sizes[0],
+      out.mref.sizes[1], out.mref.strides[0], out.mref.strides[1],
+      ct0.mref.allocated, ct0.mref.aligned, ct0.mref.offset, ct0.mref.sizes[0],
+      ct0.mref.sizes[1], ct0.mref.strides[0], ct0.mref.strides[1],
+      p->level.val, p->base_log.val, p->input_lwe_dim.val,
+      p->output_lwe_dim.val, p->ksk_index.val, p->ctx.val);
+  out.put(p->output_streams[0].memref_stream());
 }
 
-void memref_add_plaintext_lwe_ciphertext_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    uint64_t plaintext = (p->input_streams[1]).uint64_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_add_plaintext_lwe_ciphertext_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        plaintext);
-    (p->output_streams[0]).memref_stream->put(out);
-  }
-  delete p;
+void memref_bootstrap_lwe_u64_process(Process *p, size_t n) {
+  InputBatch ct0(p->dfg, p->input_streams[0].memref_stream(), n);
+  InputBatch tlu(p->dfg, p->input_streams[1].memref_stream(), n);
+  OutputBatch out(p->dfg, n, p->output_size.val);
+  memref_batched_mapped_bootstrap_lwe_u64(
+      out.mref.allocated, out.mref.aligned, out.mref.offset, out.mref.sizes[0],
+      out.mref.sizes[1], out.mref.strides[0], out.mref.strides[1],
+      ct0.mref.allocated, ct0.mref.aligned, ct0.mref.offset, ct0.mref.sizes[0],
+      ct0.mref.sizes[1], ct0.mref.strides[0], ct0.mref.strides[1],
+      tlu.mref.allocated, tlu.mref.aligned, tlu.mref.offset, tlu.mref.sizes[0],
+      tlu.mref.sizes[1], tlu.mref.strides[0], tlu.mref.strides[1],
+      p->input_lwe_dim.val, p->poly_size.val, p->level.val, p->base_log.val,
+      p->glwe_dim.val, p->bsk_index.val, p->ctx.val);
+  out.put(p->output_streams[0].memref_stream());
 }
 
-void memref_mul_cleartext_lwe_ciphertext_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    uint64_t cleartext = (p->input_streams[1]).uint64_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        cleartext);
-    (p->output_streams[0]).memref_stream->put(out);
-  }
-  delete p;
+void memref_add_lwe_ciphertexts_u64_process(Process *p, size_t n) {
+  InputBatch ct0(p->dfg, p->input_streams[0].memref_stream(), n);
+  InputBatch ct1(p->dfg, p->input_streams[1].memref_stream(), n);
+  OutputBatch out(p->dfg, n, ct0.elementSize());
+  memref_batched_add_lwe_ciphertexts_u64(
+      out.mref.allocated, out.mref.aligned, out.mref.offset, out.mref.sizes[0],
+      out.mref.sizes[1], out.mref.strides[0], out.mref.strides[1],
+      ct0.mref.allocated, ct0.mref.aligned, ct0.mref.offset, ct0.mref.sizes[0],
+      ct0.mref.sizes[1], ct0.mref.strides[0], ct0.mref.strides[1],
+      ct1.mref.allocated, ct1.mref.aligned, ct1.mref.offset, ct1.mref.sizes[0],
+      ct1.mref.sizes[1], ct1.mref.strides[0], ct1.mref.strides[1]);
+  out.put(p->output_streams[0].memref_stream());
 }
 
-void memref_negate_lwe_ciphertext_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_negate_lwe_ciphertext_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0]);
-    (p->output_streams[0]).memref_stream->put(out);
-  }
-  delete p;
+void memref_add_plaintext_lwe_ciphertext_u64_process(Process *p, size_t n) {
+  InputBatch ct0(p->dfg, p->input_streams[0].memref_stream(), n);
+  ScalarBatch plaintexts(p->input_streams[1].uint64_stream(), n);
+  OutputBatch out(p->dfg, n, ct0.elementSize());
+  memref_batched_add_plaintext_lwe_ciphertext_u64(
+      out.mref.allocated, out.mref.aligned, out.mref.offset, out.mref.sizes[0],
+      out.mref.sizes[1], out.mref.strides[0], out.mref.strides[1],
+      ct0.mref.allocated, ct0.mref.aligned, ct0.mref.offset, ct0.mref.sizes[0],
+      ct0.mref.sizes[1], ct0.mref.strides[0], ct0.mref.strides[1],
+      plaintexts.mref.allocated, plaintexts.mref.aligned,
+      plaintexts.mref.offset, plaintexts.mref.sizes[0],
+      plaintexts.mref.strides[0]);
+  out.put(p->output_streams[0].memref_stream());
+}
+
+void memref_mul_cleartext_lwe_ciphertext_u64_process(Process *p, size_t n) {
+  InputBatch ct0(p->dfg, p->input_streams[0].memref_stream(), n);
+  ScalarBatch cleartexts(p->input_streams[1].uint64_stream(), n);
+  OutputBatch out(p->dfg, n, ct0.elementSize());
+  memref_batched_mul_cleartext_lwe_ciphertext_u64(
+      out.mref.allocated, out.mref.aligned, out.mref.offset, out.mref.sizes[0],
+      out.mref.sizes[1], out.mref.strides[0], out.mref.strides[1],
+      ct0.mref.allocated, ct0.mref.aligned, ct0.mref.offset, ct0.mref.sizes[0],
+      ct0.mref.sizes[1], ct0.mref.strides[0], ct0.mref.strides[1],
+      cleartexts.mref.allocated, cleartexts.mref.aligned,
+      cleartexts.mref.offset, cleartexts.mref.sizes[0],
+      cleartexts.mref.strides[0]);
+  out.put(p->output_streams[0].memref_stream());
+}
+
+void memref_negate_lwe_ciphertext_u64_process(Process *p, size_t n) {
+  InputBatch ct0(p->dfg, p->input_streams[0].memref_stream(), n);
+  OutputBatch out(p->dfg, n, ct0.elementSize());
+  memref_batched_negate_lwe_ciphertext_u64(
+      out.mref.allocated, out.mref.aligned, out.mref.offset, out.mref.sizes[0],
+      out.mref.sizes[1], out.mref.strides[0], out.mref.strides[1],
+      ct0.mref.allocated, ct0.mref.aligned, ct0.mref.offset, ct0.mref.sizes[0],
+      ct0.mref.sizes[1], ct0.mref.strides[0], ct0.mref.strides[1]);
+  out.put(p->output_streams[0].memref_stream());
 }
 
 } // namespace
@@ -215,8 +549,7 @@ void stream_emulator_make_memref_add_lwe_ciphertexts_u64_process(void *dfg,
           sout);
   p->fun = mlir::concretelang::stream_emulator::
       memref_add_lwe_ciphertexts_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)->addProcess(p);
 }
 
 void stream_emulator_make_memref_add_plaintext_lwe_ciphertext_u64_process(
@@ -233,8 +566,7 @@ void stream_emulator_make_memref_add_plaintext_lwe_ciphertext_u64_process(
           sout);
   p->fun = mlir::concretelang::stream_emulator::
       memref_add_plaintext_lwe_ciphertext_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)->addProcess(p);
 }
 
 void stream_emulator_make_memref_mul_cleartext_lwe_ciphertext_u64_process(
@@ -251,8 +583,7 @@ void stream_emulator_make_memref_mul_cleartext_lwe_ciphertext_u64_process(
           sout);
   p->fun = mlir::concretelang::stream_emulator::
       memref_mul_cleartext_lwe_ciphertext_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)->addProcess(p);
 }
 
 void stream_emulator_make_memref_negate_lwe_ciphertext_u64_process(void *dfg,
@@ -268,8 +599,7 @@ void stream_emulator_make_memref_negate_lwe_ciphertext_u64_process(void *dfg,
           sout);
   p->fun = mlir::concretelang::stream_emulator::
       memref_negate_lwe_ciphertext_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)->addProcess(p);
 }
 
 void stream_emulator_make_memref_keyswitch_lwe_u64_process(
@@ -293,8 +623,7 @@ void stream_emulator_make_memref_keyswitch_lwe_u64_process(
   p->ctx.val = (mlir::concretelang::RuntimeContext *)context;
   p->fun =
       mlir::concretelang::stream_emulator::memref_keyswitch_lwe_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)->addProcess(p);
 }
 
 void stream_emulator_make_memref_bootstrap_lwe_u64_process(
@@ -322,8 +651,7 @@ void stream_emulator_make_memref_bootstrap_lwe_u64_process(
   p->ctx.val = (mlir::concretelang::RuntimeContext *)context;
   p->fun =
       mlir::concretelang::stream_emulator::memref_bootstrap_lwe_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)->addProcess(p);
 }
 
 void *stream_emulator_make_uint64_stream(const char *name, stream_type stype) {
@@ -344,21 +672,25 @@ void *stream_emulator_make_memref_stream(const char *name, stream_type stype) {
 void stream_emulator_put_memref(void *stream, uint64_t *allocated,
                                 uint64_t *aligned, uint64_t offset,
                                 uint64_t size, uint64_t stride) {
-  ((mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-       stream)
-      ->put({allocated, aligned, offset, {size}, {stride}});
+  auto s = (mlir::concretelang::stream_emulator::StreamBase<
+            MemRefDescriptor<1>> *)stream;
+  assert(s->dfg && "Stream is not connected to any process.");
+  // The stream takes ownership of a pooled copy of the host buffer.
+  uint64_t *buffer = s->dfg->pool.acquire(size);
+  memref_copy_one_rank(allocated, aligned, offset, size, stride, buffer,
+                       buffer, 0, size, 1);
+  s->put({buffer, buffer, 0, {size}, {1}});
 }
 void stream_emulator_get_memref(void *stream, uint64_t *out_allocated,
                                 uint64_t *out_aligned, uint64_t out_offset,
                                 uint64_t out_size, uint64_t out_stride) {
-  MemRefDescriptor<1> mref =
-      ((mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-           stream)
-          ->get();
+  auto s = (mlir::concretelang::stream_emulator::StreamBase<
+            MemRefDescriptor<1>> *)stream;
+  MemRefDescriptor<1> mref = s->get();
   memref_copy_one_rank(mref.allocated, mref.aligned, mref.offset, mref.sizes[0],
                        mref.strides[0], out_allocated, out_aligned, out_offset,
                        out_size, out_stride);
-  free(mref.allocated);
+  s->dfg->pool.release(mref.allocated, mref.sizes[0]);
 }
 
 void *stream_emulator_make_memref_batch_stream(const char *name,
@@ -0,0 +1,96 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/buffer_pool.h"
+#include <cstdlib>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+std::atomic<uint64_t> nextPoolId{1};
+
+/// Rounds a requested size up to its size class.
+size_t getSizeClass(size_t size) {
+  if (size == 0)
+    size = 1;
+  return (size + BufferPool::alignment - 1) / BufferPool::alignment *
+         BufferPool::alignment;
+}
+} // namespace
+
+BufferPool::BufferPool() : id(nextPoolId++) {}
+
+BufferPool::~BufferPool() {
+  for (auto &threadCache : threadCaches)
+    for (auto &freeBuffers : threadCache.second->freeBuffers)
+      for (auto buffer : freeBuffers.second)
+        free(buffer);
+}
+
+BufferPool::ThreadCache &BufferPool::getThreadCache() {
+  // Most threads only ever execute one circuit at a time, so remembering the
+  // last pool used avoids locking on each allocation.
+  thread_local uint64_t lastPoolId = 0;
+  thread_local ThreadCache *lastCache = nullptr;
+  if (lastPoolId == id)
+    return *lastCache;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto &cache = threadCaches[std::this_thread::get_id()];
+  if (cache == nullptr)
+    cache = std::make_unique<ThreadCache>();
+  lastPoolId = id;
+  lastCache = cache.get();
+  return *cache;
+}
+
+void *BufferPool::allocate(size_t size) {
+  size_t sizeClass = getSizeClass(size);
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  uint64_t inUse =
+      bytesInUse.fetch_add(sizeClass, std::memory_order_relaxed) + sizeClass;
+  uint64_t peak = highWaterMark.load(std::memory_order_relaxed);
+  while (inUse > peak && !highWaterMark.compare_exchange_weak(
+                             peak, inUse, std::memory_order_relaxed))
+    ;
+
+  auto &freeBuffers = getThreadCache().freeBuffers[sizeClass];
+  if (!freeBuffers.empty()) {
+    void *buffer = freeBuffers.back();
+    freeBuffers.pop_back();
+    cacheHits.fetch_add(1, std::memory_order_relaxed);
+    bytesCached.fetch_sub(sizeClass, std::memory_order_relaxed);
+    return buffer;
+  }
+  return aligned_alloc(alignment, sizeClass);
+}
+
+void BufferPool::release(void *buffer, size_t size) {
+  if (buffer == nullptr)
+    return;
+  size_t sizeClass = getSizeClass(size);
+  bytesInUse.fetch_sub(sizeClass, std::memory_order_relaxed);
+
+  auto &freeBuffers = getThreadCache().freeBuffers[sizeClass];
+  if (freeBuffers.size() >= maxCachedBuffers) {
+    free(buffer);
+    return;
+  }
+  freeBuffers.push_back(buffer);
+  bytesCached.fetch_add(sizeClass, std::memory_order_relaxed);
+}
+
+BufferPoolStats BufferPool::getStats() const {
+  BufferPoolStats stats;
+  stats.allocations = allocations.load(std::memory_order_relaxed);
+  stats.cacheHits = cacheHits.load(std::memory_order_relaxed);
+  stats.bytesCached = bytesCached.load(std::memory_order_relaxed);
+  stats.highWaterMark = highWaterMark.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -29,60 +29,97 @@ FFT::~FFT() {
   }
 }
 
-RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
-    : serverKeyset(serverKeyset) {
-  {
-
-    // Initialize for each bootstrap key the fourier one
-    for (size_t i = 0; i < serverKeyset.lweBootstrapKeys.size(); i++) {
-
-      auto bsk = serverKeyset.lweBootstrapKeys[i];
-      auto info = bsk.getInfo().asReader();
-
-      size_t decomposition_level_count = info.getParams().getLevelCount();
-      size_t decomposition_base_log = info.getParams().getBaseLog();
-      size_t glwe_dimension = info.getParams().getGlweDimension();
-      size_t polynomial_size = info.getParams().getPolynomialSize();
-      size_t input_lwe_dimension = info.getParams().getInputLweDimension();
-
-      // Create the FFT
-      FFT fft(polynomial_size);
-
-      // Allocate scratch for key conversion
-      size_t scratch_size;
-      size_t scratch_align;
-      concrete_cpu_bootstrap_key_convert_u64_to_fourier_scratch(
-          &scratch_size, &scratch_align, fft.fft);
-      auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-      // Allocate the fourier_bootstrap_key
-      auto &bsk_buffer = bsk.getBuffer();
-      auto fourier_data = std::make_shared<std::vector<std::complex<double>>>();
-      fourier_data->resize(bsk_buffer.size() / 2);
-      auto bsk_data = bsk_buffer.data();
-
-      // Convert bootstrap_key to the fourier domain
-      concrete_cpu_bootstrap_key_convert_u64_to_fourier(
-          bsk_data, fourier_data->data(), decomposition_level_count,
-          decomposition_base_log, glwe_dimension, polynomial_size,
-          input_lwe_dimension, fft.fft, scratch, scratch_size);
-
-      // Store the fourier_bootstrap_key in the context
-      fourier_bootstrap_keys.push_back(fourier_data);
-      ffts.push_back(std::move(fft));
-      free(scratch);
+PreparedKeyset::PreparedKeyset(ServerKeyset serverKeyset) {
+  // Initialize for each bootstrap key the fourier one
+  for (size_t i = 0; i < serverKeyset.lweBootstrapKeys.size(); i++) {
+
+    auto &bsk = serverKeyset.lweBootstrapKeys[i];
+    auto info = bsk.getInfo().asReader();
+
+    size_t decomposition_level_count = info.getParams().getLevelCount();
+    size_t decomposition_base_log = info.getParams().getBaseLog();
+    size_t glwe_dimension = info.getParams().getGlweDimension();
+    size_t polynomial_size = info.getParams().getPolynomialSize();
+    size_t input_lwe_dimension = info.getParams().getInputLweDimension();
+
+    // Create the FFT
+    FFT fft(polynomial_size);
+
+    // Allocate scratch for key conversion
+    size_t scratch_size;
+    size_t scratch_align;
+    concrete_cpu_bootstrap_key_convert_u64_to_fourier_scratch(
+        &scratch_size, &scratch_align, fft.fft);
+    auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+
+    // Allocate the fourier_bootstrap_key
+    auto &bsk_buffer = bsk.getBuffer();
+    auto fourier_data = std::make_shared<std::vector<std::complex<double>>>();
+    fourier_data->resize(bsk_buffer.size() / 2);
+    auto bsk_data = bsk_buffer.data();
+
+    // Convert bootstrap_key to the fourier domain
+    concrete_cpu_bootstrap_key_convert_u64_to_fourier(
+        bsk_data, fourier_data->data(), decomposition_level_count,
+        decomposition_base_log, glwe_dimension, polynomial_size,
+        input_lwe_dimension, fft.fft, scratch, scratch_size);
+
+    // Size the scratch of the bootstraps using this key
+    BootstrapScratch bootstrap_scratch;
+    concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+        &bootstrap_scratch.size, &bootstrap_scratch.align, glwe_dimension,
+        polynomial_size, fft.fft);
+
+    // Store the fourier_bootstrap_key
+    fourier_bootstrap_keys.push_back(fourier_data);
+    ffts.push_back(std::move(fft));
+    bootstrap_scratches.push_back(bootstrap_scratch);
+    free(scratch);
+  }
+}
+
+std::shared_ptr<const PreparedKeyset>
+PreparedKeysetCache::get(const ServerKeyset &serverKeyset) {
+  const std::lock_guard<std::mutex> guard(mutex);
+
+  // The keys are shared by the copies of a keyset, so the same buffers
+  // mean the same keys
+  auto sameKeys = [&]() {
+    if (keyset.lweBootstrapKeys.size() != serverKeyset.lweBootstrapKeys.size())
+      return false;
+    for (size_t i = 0; i < keyset.lweBootstrapKeys.size(); i++) {
+      if (&keyset.lweBootstrapKeys[i].getTransportBuffer() !=
+          &serverKeyset.lweBootstrapKeys[i].getTransportBuffer())
+        return false;
     }
+    return true;
+  };
+
+  if (prepared == nullptr || !sameKeys()) {
+    keyset = serverKeyset;
+    prepared = std::make_shared<const PreparedKeyset>(serverKeyset);
+  }
+  return prepared;
+}
+
+RuntimeContext::RuntimeContext(
+    ServerKeyset serverKeyset, std::shared_ptr<BufferPool> bufferPool,
+    std::shared_ptr<const PreparedKeyset> preparedKeyset)
+    : serverKeyset(serverKeyset), bufferPool(bufferPool),
+      preparedKeyset(preparedKeyset) {
+  if (this->preparedKeyset == nullptr)
+    this->preparedKeyset =
+        std::make_shared<const PreparedKeyset>(serverKeyset);
 
 #ifdef CONCRETELANG_CUDA_SUPPORT
-    assert(cudaGetDeviceCount(&num_devices) == cudaSuccess);
-    bsk_gpu.resize(num_devices, nullptr);
-    ksk_gpu.resize(num_devices, nullptr);
-    for (int i = 0; i < num_devices; ++i) {
-      bsk_gpu_mutex.push_back(std::make_unique<std::mutex>());
-      ksk_gpu_mutex.push_back(std::make_unique<std::mutex>());
-    }
-#endif
+  assert(cudaGetDeviceCount(&num_devices) == cudaSuccess);
+  bsk_gpu.resize(num_devices, nullptr);
+  ksk_gpu.resize(num_devices, nullptr);
+  for (int i = 0; i < num_devices; ++i) {
+    bsk_gpu_mutex.push_back(std::make_unique<std::mutex>());
+    ksk_gpu_mutex.push_back(std::make_unique<std::mutex>());
   }
+#endif
 }
 
 } // namespace concretelang
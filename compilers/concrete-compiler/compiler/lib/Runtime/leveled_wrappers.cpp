@@ -0,0 +1,186 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "concretelang/Runtime/leveled_wrappers.h"
+
+// The leveled operations are plain loops over the words of the ciphertexts,
+// with a wrapping arithmetic on 64 bits. They don't call into concrete-cpu,
+// so that their bitcode is self-contained and can be inlined into the
+// compiled circuits.
+//
+// Each word of the output only depends on the words at the same index in the
+// inputs, which are read before it is written, so the output may be one of
+// the inputs when the operations are bufferized in place. The ciphertexts may
+// then be strided views of a larger buffer.
+
+void memref_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *ct1_allocated, uint64_t *ct1_aligned,
+    uint64_t ct1_offset, uint64_t ct1_size, uint64_t ct1_stride) {
+  assert(out_size == ct0_size && out_size == ct1_size &&
+         "size of lwe buffer are incompatible");
+  uint64_t *out = out_aligned + out_offset;
+  const uint64_t *ct0 = ct0_aligned + ct0_offset;
+  const uint64_t *ct1 = ct1_aligned + ct1_offset;
+  for (size_t i = 0; i < out_size; i++)
+    out[i * out_stride] = ct0[i * ct0_stride] + ct1[i * ct1_stride];
+}
+
+void memref_add_plaintext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t plaintext) {
+  assert(out_size == ct0_size && "size of lwe buffer are incompatible");
+  uint64_t *out = out_aligned + out_offset;
+  const uint64_t *ct0 = ct0_aligned + ct0_offset;
+  // The plaintext is only added to the body, i.e. the last word
+  size_t lwe_dimension = out_size - 1;
+  for (size_t i = 0; i < lwe_dimension; i++)
+    out[i * out_stride] = ct0[i * ct0_stride];
+  out[lwe_dimension * out_stride] = ct0[lwe_dimension * ct0_stride] + plaintext;
+}
+
+void memref_mul_cleartext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t cleartext) {
+  assert(out_size == ct0_size && "size of lwe buffer are incompatible");
+  uint64_t *out = out_aligned + out_offset;
+  const uint64_t *ct0 = ct0_aligned + ct0_offset;
+  for (size_t i = 0; i < out_size; i++)
+    out[i * out_stride] = ct0[i * ct0_stride] * cleartext;
+}
+
+void memref_negate_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride) {
+  assert(out_size == ct0_size && "size of lwe buffer are incompatible");
+  uint64_t *out = out_aligned + out_offset;
+  const uint64_t *ct0 = ct0_aligned + ct0_offset;
+  for (size_t i = 0; i < out_size; i++)
+    out[i * out_stride] = -ct0[i * ct0_stride];
+}
+
+void memref_mul_cleartext_add_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *acc_allocated,
+    uint64_t *acc_aligned, uint64_t acc_offset, uint64_t acc_size,
+    uint64_t acc_stride, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+    uint64_t cleartext) {
+  assert(out_size == acc_size && out_size == ct0_size &&
+         "size of lwe buffer are incompatible");
+  // Single pass over the ciphertexts, the output may be the accumulator
+  uint64_t *out = out_aligned + out_offset;
+  const uint64_t *acc = acc_aligned + acc_offset;
+  const uint64_t *ct0 = ct0_aligned + ct0_offset;
+  for (size_t i = 0; i < out_size; i++)
+    out[i * out_stride] = acc[i * acc_stride] + ct0[i * ct0_stride] * cleartext;
+}
+
+void memref_batched_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size0,
+    uint64_t ct1_size1, uint64_t ct1_stride0, uint64_t ct1_stride1) {
+  for (size_t i = 0; i < ct0_size0; i++) {
+    memref_add_lwe_ciphertexts_u64(
+        out_allocated + i * out_stride0, out_aligned + i * out_stride0,
+        out_offset, out_size1, out_stride1, ct0_allocated + i * ct0_stride0,
+        ct0_aligned + i * ct0_stride0, ct0_offset, ct0_size1, ct0_stride1,
+        ct1_allocated + i * ct1_stride0, ct1_aligned + i * ct1_stride0,
+        ct1_offset, ct1_size1, ct1_stride1);
+  }
+}
+
+void memref_batched_add_plaintext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
+    uint64_t ct1_stride) {
+  for (size_t i = 0; i < ct0_size0; i++) {
+    memref_add_plaintext_lwe_ciphertext_u64(
+        out_allocated + i * out_stride0, out_aligned + i * out_stride0,
+        out_offset, out_size1, out_stride1, ct0_allocated + i * ct0_stride0,
+        ct0_aligned + i * ct0_stride0, ct0_offset, ct0_size1, ct0_stride1,
+        *(ct1_aligned + ct1_offset + i * ct1_stride));
+  }
+}
+
+void memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t plaintext) {
+  for (size_t i = 0; i < ct0_size0; i++) {
+    memref_add_plaintext_lwe_ciphertext_u64(
+        out_allocated + i * out_stride0, out_aligned + i * out_stride0,
+        out_offset, out_size1, out_stride1, ct0_allocated + i * ct0_stride0,
+        ct0_aligned + i * ct0_stride0, ct0_offset, ct0_size1, ct0_stride1,
+        plaintext);
+  }
+}
+
+void memref_batched_mul_cleartext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
+    uint64_t ct1_stride) {
+  for (size_t i = 0; i < ct0_size0; i++) {
+    memref_mul_cleartext_lwe_ciphertext_u64(
+        out_allocated + i * out_stride0, out_aligned + i * out_stride0,
+        out_offset, out_size1, out_stride1, ct0_allocated + i * ct0_stride0,
+        ct0_aligned + i * ct0_stride0, ct0_offset, ct0_size1, ct0_stride1,
+        *(ct1_aligned + ct1_offset + i * ct1_stride));
+  }
+}
+
+void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext) {
+  for (size_t i = 0; i < ct0_size0; i++) {
+    memref_mul_cleartext_lwe_ciphertext_u64(
+        out_allocated + i * out_stride0, out_aligned + i * out_stride0,
+        out_offset, out_size1, out_stride1, ct0_allocated + i * ct0_stride0,
+        ct0_aligned + i * ct0_stride0, ct0_offset, ct0_size1, ct0_stride1,
+        cleartext);
+  }
+}
+
+void memref_batched_negate_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1) {
+  for (size_t i = 0; i < ct0_size0; i++) {
+    memref_negate_lwe_ciphertext_u64(
+        out_allocated + i * out_stride0, out_aligned + i * out_stride0,
+        out_offset, out_size1, out_stride1, ct0_allocated + i * ct0_stride0,
+        ct0_aligned + i * ct0_stride0, ct0_offset, ct0_size1, ct0_stride1);
+  }
+}
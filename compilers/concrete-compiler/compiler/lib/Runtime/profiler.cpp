@@ -0,0 +1,172 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "concretelang/Runtime/profiler.h"
+
+namespace {
+
+struct ProfiledCall {
+  uint64_t start;
+  uint64_t end;
+  const char *site;
+};
+
+/// The calls recorded by a thread, in the buffer pointed to by `active`. A
+/// dump swaps it with the other buffer, which it empties. The thread takes
+/// the active buffer for the time of a record by nulling the pointer, so
+/// that a dump waits for the record to end before swapping the buffers.
+struct ThreadCalls {
+  size_t threadId;
+  std::vector<ProfiledCall> buffers[2];
+  std::atomic<std::vector<ProfiledCall> *> active{&buffers[0]};
+};
+
+/// The buffers of all the threads, kept alive after their thread exits, and
+/// the output of the dumps.
+struct Registry {
+  ~Registry() {
+    if (trace.is_open())
+      trace << "\n]\n";
+  }
+
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadCalls>> threads;
+  std::string path;
+  // The events of all the dumps are appended to the trace, in the JSON array
+  // format whose closing bracket is optional, so that the trace stays valid
+  // when the process does not exit normally
+  std::ofstream trace;
+  bool firstEvent = true;
+  // Total time in nanoseconds per operation and call site
+  std::map<std::pair<std::string, std::string>, uint64_t> totals;
+};
+
+Registry &getRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+/// Returns the buffer of the current thread, registered on its first use.
+ThreadCalls &getThreadCalls() {
+  thread_local ThreadCalls *threadCalls = nullptr;
+  if (threadCalls == nullptr) {
+    auto &registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    registry.threads.push_back(std::make_unique<ThreadCalls>());
+    threadCalls = registry.threads.back().get();
+    threadCalls->threadId = registry.threads.size() - 1;
+    threadCalls->buffers[0].reserve(1 << 12);
+    threadCalls->buffers[1].reserve(1 << 12);
+  }
+  return *threadCalls;
+}
+
+uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// The timestamps of the trace are relative to the first profiled call.
+uint64_t origin() {
+  static const uint64_t origin = now();
+  return origin;
+}
+
+std::string escapeJSON(const char *str) {
+  std::string escaped;
+  for (; *str != '\0'; str++) {
+    unsigned char c = *str;
+    if (c < 0x20) {
+      char unicode[7];
+      snprintf(unicode, sizeof(unicode), "\\u%04x", c);
+      escaped += unicode;
+      continue;
+    }
+    if (c == '"' || c == '\\')
+      escaped.push_back('\\');
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+} // namespace
+
+uint64_t concrete_profile_start() {
+  origin();
+  return now();
+}
+
+void concrete_profile_record(uint64_t start, char *site) {
+  uint64_t end = now();
+  auto &threadCalls = getThreadCalls();
+  // Only a dump changes the pointer, never while it is null
+  auto *calls = threadCalls.active.exchange(nullptr, std::memory_order_acquire);
+  calls->push_back({start, end, site});
+  threadCalls.active.store(calls, std::memory_order_release);
+}
+
+void concrete_profile_dump() {
+  auto &registry = getRegistry();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+
+  if (!registry.trace.is_open()) {
+    const char *outputPath = std::getenv("CONCRETE_PROFILE_OUTPUT");
+    registry.path = outputPath ? outputPath : "concrete-profile.json";
+    registry.trace.open(registry.path);
+    registry.trace << "[";
+  }
+
+  for (auto &thread : registry.threads) {
+    // Take the calls of the thread, which keeps recording in the empty
+    // buffer, once its current record, if any, ends
+    std::vector<ProfiledCall> *calls;
+    do {
+      calls = thread->active.load(std::memory_order_relaxed);
+    } while (calls == nullptr ||
+             !thread->active.compare_exchange_weak(
+                 calls,
+                 calls == &thread->buffers[0] ? &thread->buffers[1]
+                                              : &thread->buffers[0],
+                 std::memory_order_acq_rel));
+    for (auto &call : *calls) {
+      const char *op = call.site;
+      const char *loc = op + std::strlen(op) + 1;
+      registry.trace << (registry.firstEvent ? "\n" : ",\n")
+                     << "{\"name\":\"" << escapeJSON(op)
+                     << "\",\"cat\":\"runtime\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+                     << thread->threadId
+                     << ",\"ts\":" << (call.start - origin()) / 1000.
+                     << ",\"dur\":" << (call.end - call.start) / 1000.
+                     << ",\"args\":{\"loc\":\"" << escapeJSON(loc) << "\"}}";
+      registry.firstEvent = false;
+      registry.totals[{op, loc}] += call.end - call.start;
+    }
+    calls->clear();
+  }
+  registry.trace.flush();
+
+  // The totals accumulate over the dumps. Semicolons separate the frames of
+  // the folded stacks.
+  std::ofstream folded(registry.path + ".folded");
+  for (auto &total : registry.totals) {
+    std::string loc = total.first.second;
+    std::replace(loc.begin(), loc.end(), ';', ',');
+    folded << loc << ";" << total.first.first << " " << total.second << "\n";
+  }
+}
@@ -0,0 +1,65 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/scratch_pool.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace mlir {
+namespace concretelang {
+
+ScratchPool &ScratchPool::instance() {
+  static ScratchPool pool([]() -> size_t {
+    char *env = getenv("CONCRETE_SCRATCH_POOL_MAX_BYTES");
+    if (env != nullptr)
+      return strtoull(env, NULL, 10);
+    return defaultMaxRetainedBytes;
+  }());
+  return pool;
+}
+
+ScratchPool::ScratchPool(size_t maxRetainedBytes)
+    : maxRetainedBytes(maxRetainedBytes) {}
+
+ScratchPool::~ScratchPool() {
+  for (auto scratch : available)
+    free(scratch.ptr);
+}
+
+ScratchPool::Scratch ScratchPool::acquire(size_t size, size_t align) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = available.begin(); it != available.end(); it++) {
+      if (it->size >= size && it->align % align == 0) {
+        Scratch scratch = *it;
+        available.erase(it);
+        retained -= scratch.size;
+        return scratch;
+      }
+    }
+  }
+  // `aligned_alloc` requires a size multiple of the alignment
+  size_t allocSize = std::max<size_t>(1, (size + align - 1) / align) * align;
+  return {(uint8_t *)aligned_alloc(align, allocSize), allocSize, align};
+}
+
+void ScratchPool::release(Scratch scratch) {
+  std::lock_guard<std::mutex> lock(mutex);
+  available.push_back(scratch);
+  retained += scratch.size;
+  while (retained > maxRetainedBytes) {
+    free(available.front().ptr);
+    retained -= available.front().size;
+    available.pop_front();
+  }
+}
+
+size_t ScratchPool::retainedBytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return retained;
+}
+
+} // namespace concretelang
+} // namespace mlir
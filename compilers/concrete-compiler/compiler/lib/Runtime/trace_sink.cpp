@@ -0,0 +1,246 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "concretelang/Runtime/trace_sink.h"
+
+namespace mlir {
+namespace concretelang {
+namespace trace {
+
+namespace {
+
+/// Size of the chunks of the threads, large enough for the writes to the
+/// file to be rare.
+constexpr size_t CHUNK_SIZE = 1 << 20;
+
+struct Chunk {
+  Chunk() : data(CHUNK_SIZE) {}
+  std::vector<char> data;
+  size_t size = 0;
+};
+
+struct ThreadState {
+  uint32_t id;
+  /// Chunk of the thread, owned by the state. The thread takes it for the
+  /// time of an append by nulling the pointer, so that `close` waits for the
+  /// append to end before taking the chunk.
+  std::atomic<Chunk *> chunk;
+  /// Identifiers of the messages already defined by this thread, by content
+  /// as the same address may hold another message once a circuit library is
+  /// unloaded. The keys refer to the copies of `messages`.
+  std::unordered_map<std::string_view, uint32_t> strings;
+  std::deque<std::string> messages;
+};
+
+class TraceSink {
+public:
+  /// Returns the sink, or nullptr if the binary trace is not enabled or
+  /// already closed.
+  static TraceSink *get() {
+    // Never destroyed, so that the threads still running at exit do not
+    // append to a destroyed sink
+    static TraceSink *sink = create();
+    if (sink == nullptr || sink->closed)
+      return nullptr;
+    return sink;
+  }
+
+  void append(RecordHeader header, const char *string) {
+    ThreadState &thread = getThreadState();
+    header.thread = thread.id;
+    header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - origin)
+                           .count();
+    // Records never span two chunks, long strings are truncated
+    header.length = std::min<size_t>(header.length,
+                                     CHUNK_SIZE - sizeof(RecordHeader));
+    size_t size = sizeof(RecordHeader) + header.length;
+    // Only `close` changes the pointer, never while it is null
+    Chunk *chunk = thread.chunk.exchange(nullptr, std::memory_order_acquire);
+    if (chunk->size + size > CHUNK_SIZE) {
+      submit(std::unique_ptr<Chunk>(chunk));
+      chunk = takeFreeChunk().release();
+    }
+    char *data = chunk->data.data() + chunk->size;
+    memcpy(data, &header, sizeof(RecordHeader));
+    if (header.length > 0)
+      memcpy(data + sizeof(RecordHeader), string, header.length);
+    chunk->size += size;
+    thread.chunk.store(chunk, std::memory_order_release);
+  }
+
+  /// Returns the identifier of `message` for the current thread, which is
+  /// defined by a `STRING` record on its first use.
+  uint32_t getStringId(const char *message, uint32_t length) {
+    ThreadState &thread = getThreadState();
+    auto it = thread.strings.find(std::string_view(message, length));
+    if (it != thread.strings.end())
+      return it->second;
+    uint32_t id = nextStringId++;
+    thread.messages.emplace_back(message, length);
+    thread.strings[thread.messages.back()] = id;
+    RecordHeader header{};
+    header.kind = (uint8_t)RecordKind::STRING;
+    header.stringId = id;
+    header.length = length;
+    append(header, message);
+    return id;
+  }
+
+private:
+  static TraceSink *create() {
+    const char *path = getenv("CONCRETE_TRACE_FILE");
+    if (path == nullptr)
+      return nullptr;
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+      fprintf(stderr, "Cannot open the trace file %s\n", path);
+      return nullptr;
+    }
+    fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), file);
+    TraceSink *sink = new TraceSink(file);
+    std::atexit([]() { get()->close(); });
+    return sink;
+  }
+
+  TraceSink(FILE *file)
+      : file(file), origin(std::chrono::steady_clock::now()),
+        writer([this]() { writeChunks(); }) {}
+
+  /// Writes the remaining records and closes the file. The threads then print
+  /// their values to the standard output. The chunks of the threads are
+  /// taken once their current append ends, and replaced by empty ones. The
+  /// records still appended by the threads which got the sink before it
+  /// closed are lost.
+  void close() {
+    std::vector<ThreadState *> states;
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      closed = true;
+      for (auto &thread : threads)
+        states.push_back(thread.get());
+    }
+    // The lock is released, as an append may submit a chunk
+    std::vector<std::unique_ptr<Chunk>> remaining;
+    for (auto *thread : states) {
+      auto *empty = new Chunk();
+      Chunk *chunk = nullptr;
+      while (chunk == nullptr ||
+             !thread->chunk.compare_exchange_weak(chunk, empty,
+                                                  std::memory_order_acq_rel))
+        chunk = thread->chunk.load(std::memory_order_relaxed);
+      remaining.emplace_back(chunk);
+    }
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      for (auto &chunk : remaining)
+        if (chunk->size > 0)
+          fullChunks.push_back(std::move(chunk));
+      stopping = true;
+    }
+    condition.notify_one();
+    writer.join();
+    fclose(file);
+  }
+
+  ThreadState &getThreadState() {
+    thread_local ThreadState *state = nullptr;
+    if (state == nullptr) {
+      std::lock_guard<std::mutex> guard(mutex);
+      threads.push_back(std::make_unique<ThreadState>());
+      state = threads.back().get();
+      state->id = threads.size() - 1;
+      state->chunk = new Chunk();
+    }
+    return *state;
+  }
+
+  /// Hands `chunk` to the writer, or drops it once the writer is stopping.
+  void submit(std::unique_ptr<Chunk> chunk) {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      if (stopping)
+        return;
+      fullChunks.push_back(std::move(chunk));
+    }
+    condition.notify_one();
+  }
+
+  std::unique_ptr<Chunk> takeFreeChunk() {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (freeChunks.empty())
+      return std::make_unique<Chunk>();
+    auto chunk = std::move(freeChunks.back());
+    freeChunks.pop_back();
+    return chunk;
+  }
+
+  /// Loop of the background thread, writing the full chunks to the file and
+  /// recycling them.
+  void writeChunks() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      condition.wait(lock, [&]() { return stopping || !fullChunks.empty(); });
+      if (fullChunks.empty() && stopping)
+        return;
+      auto chunk = std::move(fullChunks.front());
+      fullChunks.pop_front();
+      lock.unlock();
+      fwrite(chunk->data.data(), 1, chunk->size, file);
+      chunk->size = 0;
+      lock.lock();
+      freeChunks.push_back(std::move(chunk));
+    }
+  }
+
+  FILE *file;
+  std::chrono::steady_clock::time_point origin;
+  std::atomic<uint32_t> nextStringId{0};
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping = false;
+  std::atomic<bool> closed{false};
+  std::vector<std::unique_ptr<ThreadState>> threads;
+  std::deque<std::unique_ptr<Chunk>> fullChunks;
+  std::vector<std::unique_ptr<Chunk>> freeChunks;
+  std::thread writer;
+};
+
+} // namespace
+
+bool appendRecord(RecordKind kind, uint64_t value, uint8_t width, uint8_t msb,
+                  const char *message, uint32_t messageLength) {
+  TraceSink *sink = TraceSink::get();
+  if (sink == nullptr)
+    return false;
+  RecordHeader header{};
+  header.kind = (uint8_t)kind;
+  header.msb = msb;
+  header.width = width;
+  header.stringId = sink->getStringId(message, messageLength);
+  header.value = value;
+  sink->append(header, nullptr);
+  return true;
+}
+
+} // namespace trace
+} // namespace concretelang
+} // namespace mlir
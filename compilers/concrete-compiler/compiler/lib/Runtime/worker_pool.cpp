@@ -0,0 +1,126 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/worker_pool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace mlir {
+namespace concretelang {
+
+// Defined when the OpenMP runtime is loaded, e.g. to run the loops
+// parallelized by the compiler.
+extern "C" int omp_in_parallel(void) __attribute__((weak));
+
+namespace {
+/// Whether the current thread is running the tasks of a call.
+thread_local bool inParallelFor = false;
+
+/// Whether the current thread is already one of several running in parallel.
+bool inParallelRegion() {
+  return inParallelFor || (omp_in_parallel != nullptr && omp_in_parallel());
+}
+} // namespace
+
+/// The tasks of a call, claimed in order by the threads taking part in it.
+struct WorkerPool::Job {
+  const std::function<void(size_t)> *task;
+  size_t count;
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> remaining;
+  std::mutex mutex;
+  std::condition_variable done;
+
+  Job(const std::function<void(size_t)> *task, size_t count)
+      : task(task), count(count), remaining(count) {}
+
+  /// Runs the unclaimed tasks, and returns when there is none left.
+  void run() {
+    bool wasInParallelFor = inParallelFor;
+    inParallelFor = true;
+    for (size_t i = next++; i < count; i = next++) {
+      (*task)(i);
+      if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.notify_all();
+      }
+    }
+    inParallelFor = wasInParallelFor;
+  }
+};
+
+WorkerPool &WorkerPool::instance() {
+  static WorkerPool pool(
+      std::max<size_t>(1, std::thread::hardware_concurrency()) - 1);
+  return pool;
+}
+
+WorkerPool::WorkerPool(size_t numWorkers) {
+  for (size_t i = 0; i < numWorkers; i++)
+    workers.emplace_back([this]() { work(); });
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cv.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+size_t WorkerPool::concurrency() const {
+  return inParallelRegion() ? 1 : workers.size() + 1;
+}
+
+void WorkerPool::parallelFor(size_t count,
+                             const std::function<void(size_t)> &task) {
+  if (count == 0)
+    return;
+  if (count == 1 || concurrency() == 1) {
+    bool wasInParallelFor = inParallelFor;
+    inParallelFor = true;
+    for (size_t i = 0; i < count; i++)
+      task(i);
+    inParallelFor = wasInParallelFor;
+    return;
+  }
+
+  auto job = std::make_shared<Job>(&task, count);
+  size_t helpers = std::min(count - 1, workers.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < helpers; i++)
+      queue.push_back(job);
+  }
+  if (helpers == 1)
+    cv.notify_one();
+  else
+    cv.notify_all();
+
+  job->run();
+  std::unique_lock<std::mutex> lock(job->mutex);
+  job->done.wait(lock, [&]() {
+    return job->remaining.load(std::memory_order_acquire) == 0;
+  });
+}
+
+void WorkerPool::work() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    cv.wait(lock, [&]() { return stopping || !queue.empty(); });
+    if (stopping)
+      return;
+    std::shared_ptr<Job> job = queue.front();
+    queue.pop_front();
+    lock.unlock();
+    job->run();
+    lock.lock();
+  }
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -6,17 +6,23 @@
 #include "concretelang/Runtime/wrappers.h"
 #include "concrete-cpu.h"
 #include "concretelang/Common/Error.h"
+#include <algorithm>
 #include <assert.h>
 #include <bitset>
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
 #include <vector>
 
 #include "concretelang/Common/CRT.h"
+#include "concretelang/Runtime/scratch_pool.h"
+#include "concretelang/Runtime/trace_sink.h"
+#include "concretelang/Runtime/worker_pool.h"
 #include "concretelang/Runtime/wrappers.h"
 
 #ifdef CONCRETELANG_CUDA_SUPPORT
@@ -546,55 +552,6 @@ void memref_encode_lut_for_crt_woppbs(
   }
 }
 
-void memref_add_lwe_ciphertexts_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, uint64_t *ct1_allocated, uint64_t *ct1_aligned,
-    uint64_t ct1_offset, uint64_t ct1_size, uint64_t ct1_stride) {
-  assert(out_size == ct0_size && out_size == ct1_size &&
-         "size of lwe buffer are incompatible");
-  size_t lwe_dimension = out_size - 1;
-  concrete_cpu_add_lwe_ciphertext_u64(out_aligned + out_offset,
-                                      ct0_aligned + ct0_offset,
-                                      ct1_aligned + ct1_offset, lwe_dimension);
-}
-
-void memref_add_plaintext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, uint64_t plaintext) {
-  assert(out_size == ct0_size && "size of lwe buffer are incompatible");
-  size_t lwe_dimension = out_size - 1;
-  concrete_cpu_add_plaintext_lwe_ciphertext_u64(out_aligned + out_offset,
-                                                ct0_aligned + ct0_offset,
-                                                plaintext, lwe_dimension);
-}
-
-void memref_mul_cleartext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, uint64_t cleartext) {
-  assert(out_size == ct0_size && "size of lwe buffer are incompatible");
-  size_t lwe_dimension = out_size - 1;
-  concrete_cpu_mul_cleartext_lwe_ciphertext_u64(out_aligned + out_offset,
-                                                ct0_aligned + ct0_offset,
-                                                cleartext, lwe_dimension);
-}
-
-void memref_negate_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride) {
-  assert(out_size == ct0_size && "size of lwe buffer are incompatible");
-  size_t lwe_dimension = {out_size - 1};
-  concrete_cpu_negate_lwe_ciphertext_u64(
-      out_aligned + out_offset, ct0_aligned + ct0_offset, lwe_dimension);
-}
-
 void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
                               uint64_t out_offset, uint64_t out_size,
                               uint64_t out_stride, uint64_t *ct0_allocated,
@@ -615,99 +572,268 @@ void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
       output_dimension);
 }
 
-void memref_batched_add_lwe_ciphertexts_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
-    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size0,
-    uint64_t ct1_size1, uint64_t ct1_stride0, uint64_t ct1_stride1) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_add_lwe_ciphertexts_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        ct1_allocated + i * ct1_size1, ct1_aligned + i * ct1_size1, ct1_offset,
-        ct1_size1, ct1_stride1);
+namespace {
+
+/// Number of words of the ciphertexts processed at once by the matrix
+/// product, so that the slices of a block of input ciphertexts stay in cache
+/// while they are accumulated into each output ciphertext.
+constexpr size_t kMatmulLweChunk = 512;
+/// Number of input ciphertexts accumulated per block.
+constexpr size_t kMatmulInnerBlock = 64;
+/// Minimal number of multiply-additions of words worth a worker.
+constexpr size_t kMatmulMinWorkPerThread = 1 << 20;
+
+/// Accumulates the `n` slices `in[k]` of `size` words, multiplied by
+/// `weights[k]`, into `out`. Slices are accumulated four by four to divide
+/// the traffic on `out`, and the loops on contiguous slices are vectorized.
+void accumulateWeightedLweSlices(uint64_t *out, uint64_t out_stride,
+                                 const uint64_t *const *in, uint64_t in_stride,
+                                 const uint64_t *weights, size_t n,
+                                 size_t size) {
+  size_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    const uint64_t *in0 = in[k], *in1 = in[k + 1];
+    const uint64_t *in2 = in[k + 2], *in3 = in[k + 3];
+    uint64_t w0 = weights[k], w1 = weights[k + 1];
+    uint64_t w2 = weights[k + 2], w3 = weights[k + 3];
+    if (out_stride == 1 && in_stride == 1) {
+      for (size_t d = 0; d < size; d++)
+        out[d] += w0 * in0[d] + w1 * in1[d] + w2 * in2[d] + w3 * in3[d];
+    } else {
+      for (size_t d = 0; d < size; d++)
+        out[d * out_stride] +=
+            w0 * in0[d * in_stride] + w1 * in1[d * in_stride] +
+            w2 * in2[d * in_stride] + w3 * in3[d * in_stride];
+    }
+  }
+  for (; k < n; k++) {
+    const uint64_t *in0 = in[k];
+    uint64_t w0 = weights[k];
+    for (size_t d = 0; d < size; d++)
+      out[d * out_stride] += w0 * in0[d * in_stride];
   }
 }
 
-void memref_batched_add_plaintext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
-    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
-    uint64_t ct1_stride) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_add_plaintext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        *(ct1_aligned + ct1_offset + i * ct1_stride));
+/// Product of a matrix of lwe ciphertexts (rows x inner) by a matrix of
+/// cleartexts (inner x cols), computed with wrapping arithmetic on the whole
+/// ciphertexts (mask and body).
+///
+/// Operands are addressed through tables of offsets instead of strides: the
+/// ciphertext (i, k) of `lhs` starts at `lhsRowOffsets[i] +
+/// lhsInnerOffsets[k]`. This allows to multiply the im2col view of the input
+/// of a convolution without copying its ciphertexts.
+struct LweCleartextMatmul {
+  uint64_t *out;
+  std::vector<uint64_t> outRowOffsets, outColOffsets;
+  uint64_t outLweStride;
+  const uint64_t *lhs;
+  std::vector<uint64_t> lhsRowOffsets, lhsInnerOffsets;
+  uint64_t lhsLweStride;
+  const uint64_t *rhs;
+  std::vector<uint64_t> rhsInnerOffsets, rhsColOffsets;
+  size_t lweSize;
+
+  size_t rows() const { return lhsRowOffsets.size(); }
+  size_t inner() const { return lhsInnerOffsets.size(); }
+  size_t cols() const { return rhsColOffsets.size(); }
+
+  /// Computes the output ciphertexts in `[begin, end)`, in row-major order.
+  void compute(size_t begin, size_t end) const {
+    const uint64_t *slices[kMatmulInnerBlock];
+    uint64_t weights[kMatmulInnerBlock];
+
+    for (size_t flat = begin; flat < end;) {
+      size_t i = flat / cols();
+      size_t colBegin = flat % cols();
+      size_t colEnd = std::min(cols(), colBegin + (end - flat));
+
+      for (size_t d0 = 0; d0 < lweSize; d0 += kMatmulLweChunk) {
+        size_t chunk = std::min(kMatmulLweChunk, lweSize - d0);
+
+        for (size_t j = colBegin; j < colEnd; j++) {
+          uint64_t *o = output(i, j, d0);
+          for (size_t d = 0; d < chunk; d++)
+            o[d * outLweStride] = 0;
+        }
+
+        for (size_t k0 = 0; k0 < inner(); k0 += kMatmulInnerBlock) {
+          size_t kEnd = std::min(inner(), k0 + kMatmulInnerBlock);
+          for (size_t j = colBegin; j < colEnd; j++) {
+            // Null weights are common in quantized models, skip them.
+            size_t n = 0;
+            for (size_t k = k0; k < kEnd; k++) {
+              uint64_t weight = rhs[rhsInnerOffsets[k] + rhsColOffsets[j]];
+              if (weight == 0)
+                continue;
+              slices[n] = lhs + lhsRowOffsets[i] + lhsInnerOffsets[k] +
+                          d0 * lhsLweStride;
+              weights[n] = weight;
+              n++;
+            }
+            accumulateWeightedLweSlices(output(i, j, d0), outLweStride,
+                                        slices, lhsLweStride, weights, n,
+                                        chunk);
+          }
+        }
+      }
+      flat += colEnd - colBegin;
+    }
   }
-}
 
-void memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t plaintext) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_add_plaintext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        plaintext);
+  /// Computes all the output ciphertexts. They are independent, so they are
+  /// split among the workers of the runtime when the product is large enough
+  /// to amortize their synchronization. Inside the work of another call
+  /// (e.g. a batch of products), the product stays on the calling thread.
+  void run() const {
+    auto &workers = mlir::concretelang::WorkerPool::instance();
+    size_t outputs = rows() * cols();
+    size_t work = outputs * inner() * lweSize;
+    size_t chunks = std::min(
+        {workers.concurrency(), outputs, work / kMatmulMinWorkPerThread});
+    if (chunks <= 1) {
+      compute(0, outputs);
+      return;
+    }
+
+    size_t outputsPerChunk = (outputs + chunks - 1) / chunks;
+    workers.parallelFor(chunks, [&](size_t c) {
+      size_t begin = std::min(outputs, c * outputsPerChunk);
+      size_t end = std::min(outputs, begin + outputsPerChunk);
+      compute(begin, end);
+    });
   }
-}
 
-void memref_batched_mul_cleartext_lwe_ciphertext_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
-    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
-    uint64_t ct1_stride) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        *(ct1_aligned + ct1_offset + i * ct1_stride));
+private:
+  uint64_t *output(size_t i, size_t j, size_t d) const {
+    return out + outRowOffsets[i] + outColOffsets[j] + d * outLweStride;
   }
+};
+
+/// Returns the offsets of `n` elements separated by `stride`.
+std::vector<uint64_t> stridedOffsets(size_t n, uint64_t stride) {
+  std::vector<uint64_t> offsets(n);
+  for (size_t i = 0; i < n; i++)
+    offsets[i] = i * stride;
+  return offsets;
 }
 
-void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
+} // namespace
+
+void memref_matmul_cleartext_lwe_ciphertext_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
-    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        cleartext);
-  }
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_size2,
+    uint64_t out_stride0, uint64_t out_stride1, uint64_t out_stride2,
+    uint64_t *ct0_allocated, uint64_t *ct0_aligned, uint64_t ct0_offset,
+    uint64_t ct0_size0, uint64_t ct0_size1, uint64_t ct0_size2,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t ct0_stride2,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1) {
+  assert(out_size0 == ct0_size0 && "incompatible number of rows");
+  assert(out_size1 == ct1_size1 && "incompatible number of columns");
+  assert(ct0_size1 == ct1_size0 && "incompatible inner dimensions");
+  assert(out_size2 == ct0_size2 && "size of lwe buffer are incompatible");
+
+  LweCleartextMatmul matmul{
+      out_aligned + out_offset,
+      stridedOffsets(out_size0, out_stride0),
+      stridedOffsets(out_size1, out_stride1),
+      out_stride2,
+      ct0_aligned + ct0_offset,
+      stridedOffsets(ct0_size0, ct0_stride0),
+      stridedOffsets(ct0_size1, ct0_stride1),
+      ct0_stride2,
+      ct1_aligned + ct1_offset,
+      stridedOffsets(ct1_size0, ct1_stride0),
+      stridedOffsets(ct1_size1, ct1_stride1),
+      ct0_size2,
+  };
+  matmul.run();
 }
 
-void memref_batched_negate_lwe_ciphertext_u64(
+void memref_conv2d_cleartext_lwe_ciphertext_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_size2,
+    uint64_t out_size3, uint64_t out_size4, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t out_stride2, uint64_t out_stride3,
+    uint64_t out_stride4, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_negate_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1);
+    uint64_t ct0_size2, uint64_t ct0_size3, uint64_t ct0_size4,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t ct0_stride2,
+    uint64_t ct0_stride3, uint64_t ct0_stride4, uint64_t *weight_allocated,
+    uint64_t *weight_aligned, uint64_t weight_offset, uint64_t weight_size0,
+    uint64_t weight_size1, uint64_t weight_size2, uint64_t weight_size3,
+    uint64_t weight_stride0, uint64_t weight_stride1, uint64_t weight_stride2,
+    uint64_t weight_stride3, uint64_t stride_h, uint64_t stride_w,
+    uint64_t dilation_h, uint64_t dilation_w, uint64_t group) {
+  // Input is NxCxHxW, weight FxC/GxKHxKW and output NxFxOHxOW
+  uint64_t channelsPerGroup = weight_size1;
+  uint64_t filtersPerGroup = weight_size0 / group;
+  assert(out_size0 == ct0_size0 && "incompatible batch sizes");
+  assert(out_size1 == weight_size0 && "incompatible number of filters");
+  assert(ct0_size1 == channelsPerGroup * group &&
+         "incompatible number of channels");
+  assert(weight_size0 % group == 0 && "incompatible number of filters");
+  assert(out_size4 == ct0_size4 && "size of lwe buffer are incompatible");
+  assert((out_size2 - 1) * stride_h + (weight_size2 - 1) * dilation_h <
+             ct0_size2 &&
+         "incompatible heights");
+  assert((out_size3 - 1) * stride_w + (weight_size3 - 1) * dilation_w <
+             ct0_size3 &&
+         "incompatible widths");
+
+  // The convolution of each group is the product of the im2col view of the
+  // input, with one row per output position and one column per channel and
+  // position in the kernel, by the weights of the filters of the group.
+  // The view is built as offsets of the input ciphertexts.
+  std::vector<uint64_t> outRowOffsets, lhsRowOffsets;
+  for (uint64_t n = 0; n < out_size0; n++) {
+    for (uint64_t oh = 0; oh < out_size2; oh++) {
+      for (uint64_t ow = 0; ow < out_size3; ow++) {
+        outRowOffsets.push_back(n * out_stride0 + oh * out_stride2 +
+                                ow * out_stride3);
+        lhsRowOffsets.push_back(n * ct0_stride0 + oh * stride_h * ct0_stride2 +
+                                ow * stride_w * ct0_stride3);
+      }
+    }
+  }
+
+  for (uint64_t g = 0; g < group; g++) {
+    std::vector<uint64_t> lhsInnerOffsets, rhsInnerOffsets;
+    for (uint64_t c = 0; c < channelsPerGroup; c++) {
+      for (uint64_t kh = 0; kh < weight_size2; kh++) {
+        for (uint64_t kw = 0; kw < weight_size3; kw++) {
+          lhsInnerOffsets.push_back((g * channelsPerGroup + c) * ct0_stride1 +
+                                    kh * dilation_h * ct0_stride2 +
+                                    kw * dilation_w * ct0_stride3);
+          rhsInnerOffsets.push_back(c * weight_stride1 + kh * weight_stride2 +
+                                    kw * weight_stride3);
+        }
+      }
+    }
+
+    std::vector<uint64_t> outColOffsets, rhsColOffsets;
+    for (uint64_t f = g * filtersPerGroup; f < (g + 1) * filtersPerGroup;
+         f++) {
+      outColOffsets.push_back(f * out_stride1);
+      rhsColOffsets.push_back(f * weight_stride0);
+    }
+
+    LweCleartextMatmul matmul{
+        out_aligned + out_offset,
+        outRowOffsets,
+        std::move(outColOffsets),
+        out_stride4,
+        ct0_aligned + ct0_offset,
+        lhsRowOffsets,
+        std::move(lhsInnerOffsets),
+        ct0_stride4,
+        weight_aligned + weight_offset,
+        std::move(rhsInnerOffsets),
+        std::move(rhsColOffsets),
+        ct0_size4,
+    };
+    matmul.run();
   }
 }
 
@@ -719,15 +845,74 @@ void memref_batched_keyswitch_lwe_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint32_t level,
     uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
     uint32_t ksk_index, mlir::concretelang::RuntimeContext *context) {
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  // The key is looked up once for the whole batch
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
   for (size_t i = 0; i < ct0_size0; i++) {
-    memref_keyswitch_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1, level,
-        base_log, input_lwe_dim, output_lwe_dim, ksk_index, context);
+    concrete_cpu_keyswitch_lwe_ciphertext_u64(
+        out_aligned + out_offset + i * out_size1,
+        ct0_aligned + ct0_offset + i * ct0_size1, keyswitch_key, level,
+        base_log, input_lwe_dim, output_lwe_dim);
   }
 }
 
+namespace {
+
+using mlir::concretelang::ScratchPool;
+
+/// A bootstrap with a given bootstrap key. The fft, the key and the
+/// scratch requirements resolved when the runtime context was created are
+/// looked up once, so that a batch of bootstraps shares them along with the
+/// scratch and the accumulator.
+struct BootstrapLWE {
+  BootstrapLWE(uint32_t input_lwe_dimension, uint32_t polynomial_size,
+               uint32_t decomposition_level_count,
+               uint32_t decomposition_base_log, uint32_t glwe_dimension,
+               uint32_t bsk_index, mlir::concretelang::RuntimeContext *context)
+      : input_lwe_dimension(input_lwe_dimension),
+        polynomial_size(polynomial_size),
+        decomposition_level_count(decomposition_level_count),
+        decomposition_base_log(decomposition_base_log),
+        glwe_dimension(glwe_dimension), fft(context->fft(bsk_index)),
+        bootstrap_key(context->fourier_bootstrap_key_buffer(bsk_index)),
+        glwe_ct(polynomial_size * (glwe_dimension + 1), 0) {
+    const auto &scratch_params = context->bootstrap_scratch(bsk_index);
+    scratch = ScratchPool::instance().acquire(scratch_params.size,
+                                              scratch_params.align);
+  }
+
+  ~BootstrapLWE() { ScratchPool::instance().release(scratch); }
+
+  /// Bootstraps `in` into `out` with the lookup table `tlu` of
+  /// `polynomial_size` elements.
+  void run(uint64_t *out, const uint64_t *in, const uint64_t *tlu) {
+    // Glwe trivial encryption: the mask stays zero, only the body is set
+    if (tlu != last_tlu) {
+      std::copy(tlu, tlu + polynomial_size,
+                glwe_ct.begin() + polynomial_size * glwe_dimension);
+      last_tlu = tlu;
+    }
+
+    concrete_cpu_bootstrap_lwe_ciphertext_u64(
+        out, in, glwe_ct.data(), bootstrap_key, decomposition_level_count,
+        decomposition_base_log, glwe_dimension, polynomial_size,
+        input_lwe_dimension, fft, scratch.ptr, scratch.size);
+  }
+
+  uint32_t input_lwe_dimension;
+  uint32_t polynomial_size;
+  uint32_t decomposition_level_count;
+  uint32_t decomposition_base_log;
+  uint32_t glwe_dimension;
+  const struct Fft *fft;
+  const std::complex<double> *bootstrap_key;
+  ScratchPool::Scratch scratch;
+  std::vector<uint64_t> glwe_ct;
+  const uint64_t *last_tlu = nullptr;
+};
+
+} // namespace
+
 void memref_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
@@ -738,39 +923,11 @@ void memref_bootstrap_lwe_u64(
     uint32_t decomposition_level_count, uint32_t decomposition_base_log,
     uint32_t glwe_dimension, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
-
-  uint64_t glwe_ct_size = polynomial_size * (glwe_dimension + 1);
-  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
-  auto tlu = tlu_aligned + tlu_offset;
-
-  // Glwe trivial encryption
-  for (size_t i = 0; i < polynomial_size * glwe_dimension; i++) {
-    glwe_ct[i] = 0;
-  }
-  for (size_t i = 0; i < polynomial_size; i++) {
-    glwe_ct[polynomial_size * glwe_dimension + i] = tlu[i];
-  }
-
-  // Get fourrier bootstrap key
-  const auto &fft = context->fft(bsk_index);
-  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
-  // Get stack parameter
-  size_t scratch_size;
-  size_t scratch_align;
-  concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
-      &scratch_size, &scratch_align, glwe_dimension, polynomial_size, fft);
-  // Allocate scratch
-  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-  // Bootstrap
-  concrete_cpu_bootstrap_lwe_ciphertext_u64(
-      out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct,
-      bootstrap_key, decomposition_level_count, decomposition_base_log,
-      glwe_dimension, polynomial_size, input_lwe_dimension, fft, scratch,
-      scratch_size);
-
-  free(glwe_ct);
-  free(scratch);
+  BootstrapLWE bootstrap(input_lwe_dimension, polynomial_size,
+                         decomposition_level_count, decomposition_base_log,
+                         glwe_dimension, bsk_index, context);
+  bootstrap.run(out_aligned + out_offset, ct0_aligned + ct0_offset,
+                tlu_aligned + tlu_offset);
 }
 
 void memref_batched_bootstrap_lwe_u64(
@@ -783,14 +940,12 @@ void memref_batched_bootstrap_lwe_u64(
     uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size,
     uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
-
+  BootstrapLWE bootstrap(input_lwe_dim, poly_size, level, base_log, glwe_dim,
+                         bsk_index, context);
   for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated, tlu_aligned,
-        tlu_offset, tlu_size, tlu_stride, input_lwe_dim, poly_size, level,
-        base_log, glwe_dim, bsk_index, context);
+    bootstrap.run(out_aligned + out_offset + i * out_size1,
+                  ct0_aligned + ct0_offset + i * ct0_size1,
+                  tlu_aligned + tlu_offset);
   }
 }
 
@@ -806,14 +961,12 @@ void memref_batched_mapped_bootstrap_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
   assert(out_size0 == tlu_size0 && "Number of LUTs does not match batch size");
+  BootstrapLWE bootstrap(input_lwe_dim, poly_size, level, base_log, glwe_dim,
+                         bsk_index, context);
   for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated,
-        tlu_aligned + i * tlu_size1, tlu_offset, tlu_size1, tlu_stride1,
-        input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index,
-        context);
+    bootstrap.run(out_aligned + out_offset + i * out_size1,
+                  ct0_aligned + ct0_offset + i * ct0_size1,
+                  tlu_aligned + tlu_offset + i * tlu_size1);
   }
 }
 
@@ -821,6 +974,171 @@ uint64_t encode_crt(int64_t plaintext, uint64_t modulus, uint64_t product) {
   return concretelang::crt::encode(plaintext, modulus, product);
 }
 
+namespace {
+
+/// A wop-pbs of CRT encoded ciphertexts with a given set of crypto
+/// parameters. The keys and the fft are looked up once, so that a batch of
+/// wop-pbs shares them.
+struct WopPBSCRT {
+  // CRT decomposition
+  uint64_t crt_decomp_size;
+  std::vector<uint64_t> number_of_bits_per_block;
+  std::vector<uint64_t> extract_bits_output_offsets;
+  uint64_t total_number_of_bits_per_block;
+  // Crypto parameters
+  uint64_t lwe_small_dim;
+  uint64_t lwe_big_dim;
+  uint64_t glwe_dim;
+  uint64_t polynomial_size;
+  uint32_t cbs_level_count;
+  uint32_t cbs_base_log;
+  uint32_t ksk_level_count;
+  uint32_t ksk_base_log;
+  uint32_t bsk_level_count;
+  uint32_t bsk_base_log;
+  uint32_t fpksk_level_count;
+  uint32_t fpksk_base_log;
+  // Keys
+  const struct Fft *fft;
+  const std::complex<double> *bootstrap_key;
+  const uint64_t *keyswitch_key;
+  const uint64_t *fp_keyswitch_key;
+
+  WopPBSCRT(uint64_t *crt_decomp, uint64_t crt_decomp_size,
+            uint64_t crt_decomp_stride, uint64_t lwe_big_size,
+            uint32_t lwe_small_dim, uint32_t cbs_level_count,
+            uint32_t cbs_base_log, uint32_t ksk_level_count,
+            uint32_t ksk_base_log, uint32_t bsk_level_count,
+            uint32_t bsk_base_log, uint32_t fpksk_level_count,
+            uint32_t fpksk_base_log, uint32_t polynomial_size,
+            uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+            mlir::concretelang::RuntimeContext *context)
+      : crt_decomp_size(crt_decomp_size),
+        number_of_bits_per_block(crt_decomp_size),
+        extract_bits_output_offsets(crt_decomp_size),
+        total_number_of_bits_per_block(0), lwe_small_dim(lwe_small_dim),
+        lwe_big_dim(lwe_big_size - 1), polynomial_size(polynomial_size),
+        cbs_level_count(cbs_level_count), cbs_base_log(cbs_base_log),
+        ksk_level_count(ksk_level_count), ksk_base_log(ksk_base_log),
+        bsk_level_count(bsk_level_count), bsk_base_log(bsk_base_log),
+        fpksk_level_count(fpksk_level_count), fpksk_base_log(fpksk_base_log),
+        fft(context->fft(bsk_index)),
+        bootstrap_key(context->fourier_bootstrap_key_buffer(bsk_index)),
+        keyswitch_key(context->keyswitch_key_buffer(ksk_index)),
+        fp_keyswitch_key(context->fp_keyswitch_key_buffer(pksk_index)) {
+    assert(lwe_big_dim % polynomial_size == 0);
+    glwe_dim = lwe_big_dim / polynomial_size;
+
+    // Compute the numbers of bits to extract for each block and the total
+    // one, as well as the offset of the bits of each block in the extraction
+    // buffer.
+    for (int64_t i = crt_decomp_size - 1; i >= 0; i--) {
+      uint64_t modulus = crt_decomp[i * crt_decomp_stride];
+      uint64_t nb_bit_to_extract =
+          static_cast<uint64_t>(ceil(log2(static_cast<double>(modulus))));
+      number_of_bits_per_block[i] = nb_bit_to_extract;
+      extract_bits_output_offsets[i] = total_number_of_bits_per_block;
+
+      total_number_of_bits_per_block += nb_bit_to_extract;
+    }
+  }
+
+  uint64_t lweSmallSize() const { return lwe_small_dim + 1; }
+  uint64_t lweBigSize() const { return lwe_big_dim + 1; }
+
+  /// Computes the wop-pbs of the `crt_decomp_size` contiguous blocks of `in`
+  /// into the contiguous blocks of `out`, with the `lut_count` contiguous
+  /// tables of `lut`. The bits of the blocks are extracted concurrently if
+  /// `parallel_blocks` is set, which pays off for a lone wop-pbs but not
+  /// when the calls of a batch are already run concurrently.
+  void run(uint64_t *out, const uint64_t *in, const uint64_t *lut,
+           size_t lut_count, bool parallel_blocks) const {
+    // Create the buffer of ciphertexts for storing the total number of bits
+    // to extract.
+    // The extracted bit should be in the following order:
+    //
+    // [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where
+    // n is the size of the crt decomposition
+    std::vector<uint64_t> extract_bits_output_buffer(
+        lweSmallSize() * total_number_of_bits_per_block, 0);
+
+    // We make a private copy to apply a subtraction on the body
+    auto copy_size = crt_decomp_size * lweBigSize();
+    std::vector<uint64_t> in_copy(in, in + copy_size);
+
+    // Extraction of the bits of a block, which are independent from the ones
+    // of the other blocks.
+    std::function<void(size_t)> extract_block_bits = [&](size_t i) {
+      auto nb_bits_to_extract = number_of_bits_per_block[i];
+
+      size_t delta_log = 64 - nb_bits_to_extract;
+
+      auto in_block = &in_copy[lweBigSize() * i];
+
+      // trick ( ct - delta/2 + delta/2^4  )
+      uint64_t sub =
+          (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
+          (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
+      in_block[lweBigSize() - 1] -= sub;
+
+      size_t scratch_size;
+      size_t scratch_align;
+      concrete_cpu_extract_bit_lwe_ciphertext_u64_scratch(
+          &scratch_size, &scratch_align, lwe_small_dim, lwe_big_dim, glwe_dim,
+          polynomial_size, fft);
+      auto scratch =
+          ScratchPool::instance().acquire(scratch_size, scratch_align);
+
+      concrete_cpu_extract_bit_lwe_ciphertext_u64(
+          &extract_bits_output_buffer[lweSmallSize() *
+                                      extract_bits_output_offsets[i]],
+          in_block, bootstrap_key, keyswitch_key, lwe_small_dim,
+          nb_bits_to_extract, lwe_big_dim, nb_bits_to_extract, delta_log,
+          bsk_level_count, bsk_base_log, glwe_dim, polynomial_size,
+          lwe_small_dim, ksk_level_count, ksk_base_log, lwe_big_dim,
+          lwe_small_dim, fft, scratch.ptr, scratch_size);
+
+      ScratchPool::instance().release(scratch);
+    };
+
+    size_t ct_in_count = total_number_of_bits_per_block;
+    size_t lut_size = 1 << ct_in_count;
+    size_t ct_out_count = lut_count;
+
+    size_t scratch_size;
+    size_t scratch_align;
+    concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64_scratch(
+        &scratch_size, &scratch_align, ct_out_count, lwe_small_dim,
+        ct_in_count, lut_size, lut_count, glwe_dim, polynomial_size,
+        polynomial_size, cbs_level_count, fft);
+    auto scratch = ScratchPool::instance().acquire(scratch_size, scratch_align);
+
+    // Extract the bits of all the blocks, concurrently on the workers of the
+    // runtime if requested.
+    if (parallel_blocks) {
+      mlir::concretelang::WorkerPool::instance().parallelFor(
+          crt_decomp_size, extract_block_bits);
+    } else {
+      for (int64_t i = crt_decomp_size - 1; i >= 0; i--) {
+        extract_block_bits(i);
+      }
+    }
+
+    // Vertical packing
+    concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(
+        out, extract_bits_output_buffer.data(), lut, bootstrap_key,
+        fp_keyswitch_key, lwe_big_dim, ct_out_count, lwe_small_dim,
+        ct_in_count, lut_size, lut_count, bsk_level_count, bsk_base_log,
+        glwe_dim, polynomial_size, lwe_small_dim, fpksk_level_count,
+        fpksk_base_log, lwe_big_dim, glwe_dim, polynomial_size, glwe_dim + 1,
+        cbs_level_count, cbs_base_log, fft, scratch.ptr, scratch_size);
+
+    ScratchPool::instance().release(scratch);
+  }
+};
+
+} // namespace
+
 void memref_wop_pbs_crt_buffer(
     // Output 2D memref
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
@@ -851,118 +1169,91 @@ void memref_wop_pbs_crt_buffer(
   // The compiler should only generates 2D memref<BxS>, where B is the number of
   // ciphertext block and S the lweSize.
   // Check for the strides
-
   assert(out_stride_1 == 1);
-  assert(in_stride_0 == in_size_1 && in_stride_0 == in_size_1);
+  assert(in_stride_0 == in_size_1);
   // Check for the size B
   assert(out_size_0 == in_size_0 && out_size_0 == crt_decomp_size);
   // Check for the size S
   assert(out_size_1 == in_size_1);
 
-  uint64_t lwe_small_size = lwe_small_dim + 1;
-
-  assert(out_size_1 == in_size_1);
-  uint64_t lwe_big_size = in_size_1;
-  uint64_t lwe_big_dim = lwe_big_size - 1;
-  assert(lwe_big_dim % polynomial_size == 0);
-
-  assert(lwe_big_dim % polynomial_size == 0);
-  uint64_t glwe_dim = lwe_big_dim / polynomial_size;
-
-  // Compute the numbers of bits to extract for each block and the total one.
-  uint64_t total_number_of_bits_per_block = 0;
-  auto number_of_bits_per_block = new uint64_t[crt_decomp_size]();
-  for (uint64_t i = 0; i < crt_decomp_size; i++) {
-    uint64_t modulus = crt_decomp_aligned[i + crt_decomp_offset];
-    uint64_t nb_bit_to_extract =
-        static_cast<uint64_t>(ceil(log2(static_cast<double>(modulus))));
-    number_of_bits_per_block[i] = nb_bit_to_extract;
-
-    total_number_of_bits_per_block += nb_bit_to_extract;
-  }
-
-  // Create the buffer of ciphertexts for storing the total number of bits to
-  // extract.
-  // The extracted bit should be in the following order:
-  //
-  // [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
-  // is the size of the crt decomposition
-  auto extract_bits_output_buffer =
-      new uint64_t[lwe_small_size * total_number_of_bits_per_block]{0};
+  WopPBSCRT wop_pbs(crt_decomp_aligned + crt_decomp_offset, crt_decomp_size,
+                    crt_decomp_stride, in_size_1, lwe_small_dim,
+                    cbs_level_count, cbs_base_log, ksk_level_count,
+                    ksk_base_log, bsk_level_count, bsk_base_log,
+                    fpksk_level_count, fpksk_base_log, polynomial_size,
+                    ksk_index, bsk_index, pksk_index, context);
 
-  // We make a private copy to apply a subtraction on the body
-  auto first_ciphertext = in_aligned + in_offset;
-  auto copy_size = crt_decomp_size * lwe_big_size;
-  std::vector<uint64_t> in_copy(first_ciphertext, first_ciphertext + copy_size);
-  // Extraction of each bit for each block
-
-  const auto &fft = context->fft(bsk_index);
-  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
-  auto keyswicth_key = context->keyswitch_key_buffer(ksk_index);
-
-  for (int64_t i = crt_decomp_size - 1, extract_bits_output_offset = 0; i >= 0;
-       extract_bits_output_offset += number_of_bits_per_block[i--]) {
-    auto nb_bits_to_extract = number_of_bits_per_block[i];
-
-    size_t delta_log = 64 - nb_bits_to_extract;
-
-    auto in_block = &in_copy[lwe_big_size * i];
-
-    // trick ( ct - delta/2 + delta/2^4  )
-    uint64_t sub = (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
-                   (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
-    in_block[lwe_big_size - 1] -= sub;
+  size_t lut_count = out_size_0;
+  assert(lut_ct_size0 == lut_count);
+  assert(lut_ct_size1 == (size_t(1) << wop_pbs.total_number_of_bits_per_block));
 
-    size_t scratch_size;
-    size_t scratch_align;
-    concrete_cpu_extract_bit_lwe_ciphertext_u64_scratch(
-        &scratch_size, &scratch_align, lwe_small_dim, lwe_big_dim, glwe_dim,
-        polynomial_size, fft);
-    // Allocate scratch
-    auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-    concrete_cpu_extract_bit_lwe_ciphertext_u64(
-        &extract_bits_output_buffer[lwe_small_size *
-                                    extract_bits_output_offset],
-        in_block, bootstrap_key, keyswicth_key, lwe_small_dim,
-        nb_bits_to_extract, lwe_big_dim, nb_bits_to_extract, delta_log,
-        bsk_level_count, bsk_base_log, glwe_dim, polynomial_size, lwe_small_dim,
-        ksk_level_count, ksk_base_log, lwe_big_dim, lwe_small_dim, fft, scratch,
-        scratch_size);
-
-    free(scratch);
-  }
+  wop_pbs.run(out_aligned + out_offset, in_aligned + in_offset,
+              lut_ct_aligned + lut_ct_offset, lut_count, true);
+}
 
-  size_t ct_in_count = total_number_of_bits_per_block;
-  size_t lut_size = 1 << ct_in_count;
-  size_t ct_out_count = out_size_0;
-  size_t lut_count = ct_out_count;
+void memref_batched_wop_pbs_crt_buffer(
+    // Output 3D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_size_2,
+    uint64_t out_stride_0, uint64_t out_stride_1, uint64_t out_stride_2,
+    // Input 3D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_size_2,
+    uint64_t in_stride_0, uint64_t in_stride_1, uint64_t in_stride_2,
+    // clear text lut 2D memref
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition 1D memref
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key Indices,
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evluation keys
+    mlir::concretelang::RuntimeContext *context) {
 
+  // The compiler should only generates 3D memref<NxBxS>, where N is the size
+  // of the batch, B the number of ciphertext block and S the lweSize.
+  assert(out_stride_2 == 1 && out_stride_1 == out_size_2);
+  assert(in_stride_2 == 1 && in_stride_1 == in_size_2);
+  assert(out_size_0 == in_size_0);
+  assert(out_size_1 == in_size_1 && out_size_1 == crt_decomp_size);
+  assert(out_size_2 == in_size_2);
+
+  WopPBSCRT wop_pbs(crt_decomp_aligned + crt_decomp_offset, crt_decomp_size,
+                    crt_decomp_stride, in_size_2, lwe_small_dim,
+                    cbs_level_count, cbs_base_log, ksk_level_count,
+                    ksk_base_log, bsk_level_count, bsk_base_log,
+                    fpksk_level_count, fpksk_base_log, polynomial_size,
+                    ksk_index, bsk_index, pksk_index, context);
+
+  size_t lut_count = out_size_1;
   assert(lut_ct_size0 == lut_count);
-  assert(lut_ct_size1 == lut_size);
-
-  // Vertical packing
-  size_t scratch_size;
-  size_t scratch_align;
-  concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64_scratch(
-      &scratch_size, &scratch_align, ct_out_count, lwe_small_dim, ct_in_count,
-      lut_size, lut_count, glwe_dim, polynomial_size, polynomial_size,
-      cbs_level_count, fft);
-
-  auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-  auto fp_keyswicth_key = context->fp_keyswitch_key_buffer(pksk_index);
-
-  concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(
-      out_aligned + out_offset, extract_bits_output_buffer,
-      lut_ct_aligned + lut_ct_offset, bootstrap_key, fp_keyswicth_key,
-      lwe_big_dim, ct_out_count, lwe_small_dim, ct_in_count, lut_size,
-      lut_count, bsk_level_count, bsk_base_log, glwe_dim, polynomial_size,
-      lwe_small_dim, fpksk_level_count, fpksk_base_log, lwe_big_dim, glwe_dim,
-      polynomial_size, glwe_dim + 1, cbs_level_count, cbs_base_log, fft,
-      scratch, scratch_size);
-
-  free(scratch);
+  assert(lut_ct_size1 == (size_t(1) << wop_pbs.total_number_of_bits_per_block));
+
+  // The wop-pbs of the batch are independent, so they are run on the
+  // workers of the runtime. The bits of the blocks are then extracted
+  // sequentially, unless the batch is too small to occupy all the workers.
+  auto &workers = mlir::concretelang::WorkerPool::instance();
+  size_t batch_size = out_size_0;
+  bool parallel_blocks = batch_size < workers.concurrency();
+  auto compute = [&](size_t i) {
+    wop_pbs.run(out_aligned + out_offset + i * out_stride_0,
+                in_aligned + in_offset + i * in_stride_0,
+                lut_ct_aligned + lut_ct_offset, lut_count, parallel_blocks);
+  };
+  if (parallel_blocks) {
+    for (size_t i = 0; i < batch_size; i++)
+      compute(i);
+  } else {
+    workers.parallelFor(batch_size, compute);
+  }
 }
 
 void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
@@ -982,13 +1273,28 @@ void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
   }
 }
 
+uint64_t *memref_pool_alloc_u64(size_t size,
+                                mlir::concretelang::RuntimeContext *context) {
+  return (uint64_t *)context->buffer_pool().allocate(size);
+}
+
+void memref_pool_free_u64(uint64_t *buffer, size_t size,
+                          mlir::concretelang::RuntimeContext *context) {
+  context->buffer_pool().release(buffer, size);
+}
+
 void memref_trace_ciphertext(uint64_t *ct0_allocated, uint64_t *ct0_aligned,
                              uint64_t ct0_offset, uint64_t ct0_size,
                              uint64_t ct0_stride, char *message_ptr,
                              uint32_t message_len, uint32_t msb) {
+  uint64_t body = ct0_aligned[ct0_offset + ct0_size - 1];
+  if (mlir::concretelang::trace::appendRecord(
+          mlir::concretelang::trace::RecordKind::CIPHERTEXT, body, 64, msb,
+          message_ptr, message_len))
+    return;
   std::string message{message_ptr, (size_t)message_len};
   std::cout << message << " : ";
-  std::bitset<64> bits{ct0_aligned[ct0_offset + ct0_size - 1]};
+  std::bitset<64> bits{body};
   std::string bitstring = bits.to_string();
   bitstring.insert(msb, 1, ' ');
   std::cout << bitstring << std::endl;
@@ -997,6 +1303,10 @@ void memref_trace_ciphertext(uint64_t *ct0_allocated, uint64_t *ct0_aligned,
 void memref_trace_plaintext(uint64_t input, uint64_t input_width,
                             char *message_ptr, uint32_t message_len,
                             uint32_t msb) {
+  if (mlir::concretelang::trace::appendRecord(
+          mlir::concretelang::trace::RecordKind::PLAINTEXT, input,
+          input_width, msb, message_ptr, message_len))
+    return;
   std::string message{message_ptr, (size_t)message_len};
   std::cout << message << " : ";
   std::bitset<64> bits{input};
@@ -1007,6 +1317,10 @@ void memref_trace_plaintext(uint64_t input, uint64_t input_width,
 }
 
 void memref_trace_message(char *message_ptr, uint32_t message_len) {
+  if (mlir::concretelang::trace::appendRecord(
+          mlir::concretelang::trace::RecordKind::MESSAGE, 0, 0, 0,
+          message_ptr, message_len))
+    return;
   std::string message{message_ptr, (size_t)message_len};
   std::cout << message << std::flush;
 }
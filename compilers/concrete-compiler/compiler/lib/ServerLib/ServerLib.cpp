@@ -348,6 +348,29 @@ DynamicModule::open(const std::string &sharedLibPath) {
   return module;
 }
 
+std::shared_ptr<DynamicModule> DynamicModule::fromSymbolLookup(
+    std::function<void *(const std::string &)> lookup) {
+  std::shared_ptr<DynamicModule> module = std::make_shared<DynamicModule>();
+  module->lookup = lookup;
+  return module;
+}
+
+Result<void *> DynamicModule::getSymbol(const std::string &name) {
+  if (lookup) {
+    void *symbol = lookup(name);
+    if (symbol == nullptr) {
+      return StringError("Symbol not found in dynamic module: ") << name;
+    }
+    return symbol;
+  }
+  void *symbol = dlsym(libraryHandle, name.c_str());
+  if (auto err = dlerror()) {
+    return StringError("Symbol not found in dynamic module: ")
+           << std::string(err);
+  }
+  return symbol;
+}
+
 size_t
 getGateDescriptionSize(const Message<concreteprotocol::GateInfo> &gateInfo,
                        bool useSimulation) {
@@ -452,23 +475,28 @@ std::string ServerCircuit::getName() {
   return circuitInfo.asReader().getName();
 }
 
+mlir::concretelang::BufferPoolStats ServerCircuit::getBufferPoolStats() {
+  return bufferPool->getStats();
+}
+
 Result<ServerCircuit> ServerCircuit::fromDynamicModule(
     const Message<concreteprotocol::CircuitInfo> &circuitInfo,
-    std::shared_ptr<DynamicModule> dynamicModule, bool useSimulation = false) {
+    std::shared_ptr<DynamicModule> dynamicModule,
+    std::shared_ptr<mlir::concretelang::BufferPool> bufferPool,
+    std::shared_ptr<mlir::concretelang::PreparedKeysetCache> preparedKeysets,
+    bool useSimulation = false) {
 
   ServerCircuit output;
   output.circuitInfo = circuitInfo;
   output.useSimulation = useSimulation;
   output.dynamicModule = dynamicModule;
-  output.func = (void (*)(void *, ...))dlsym(
-      dynamicModule->libraryHandle,
-      (std::string("_mlir_concrete_") +
-       std::string(circuitInfo.asReader().getName().cStr()))
-          .c_str());
-  if (auto err = dlerror()) {
-    return StringError("Circuit symbol not found in dynamic module: ")
-           << std::string(err);
-  }
+  output.bufferPool = bufferPool;
+  output.preparedKeysets = preparedKeysets;
+  OUTCOME_TRY(auto func,
+              dynamicModule->getSymbol(
+                  std::string("_mlir_concrete_") +
+                  std::string(circuitInfo.asReader().getName().cStr())));
+  output.func = (void (*)(void *, ...))func;
 
   // We prepare the args transformers used to transform transport values into
   // arg values.
@@ -535,8 +563,10 @@ Result<ServerCircuit> ServerCircuit::fromDynamicModule(
 void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
 
   // We create a runtime context from the keyset, and place a pointer to it in
-  // the structure.
-  RuntimeContext runtimeContext = RuntimeContext(serverKeyset);
+  // the structure. The buffer pool and the prepared keys outlive the call, so
+  // that the buffers and the fourier keys serve the next calls of the program.
+  RuntimeContext runtimeContext = RuntimeContext(
+      serverKeyset, bufferPool, preparedKeysets->get(serverKeyset));
   RuntimeContext *_runtimeContextPtr = &runtimeContext;
 
   auto _argRaws = std::vector<void *>(this->argRawSize);
@@ -599,14 +629,25 @@ void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
 Result<ServerProgram>
 ServerProgram::load(const Message<concreteprotocol::ProgramInfo> &programInfo,
                     const std::string &sharedLibPath, bool useSimulation) {
-  ServerProgram output;
   OUTCOME_TRY(auto dynamicModule, DynamicModule::open(sharedLibPath));
-  auto sharedDynamicModule = std::shared_ptr<DynamicModule>(dynamicModule);
+  return load(programInfo, dynamicModule, useSimulation);
+}
+
+Result<ServerProgram>
+ServerProgram::load(const Message<concreteprotocol::ProgramInfo> &programInfo,
+                    std::shared_ptr<DynamicModule> dynamicModule,
+                    bool useSimulation) {
+  ServerProgram output;
   std::vector<ServerCircuit> serverCircuits;
+  // The circuits share the buffer pool and the prepared keys for as long as
+  // one of them is loaded
+  auto bufferPool = std::make_shared<mlir::concretelang::BufferPool>();
+  auto preparedKeysets =
+      std::make_shared<mlir::concretelang::PreparedKeysetCache>();
   for (auto circuitInfo : programInfo.asReader().getCircuits()) {
-    OUTCOME_TRY(auto serverCircuit,
-                ServerCircuit::fromDynamicModule(
-                    circuitInfo, sharedDynamicModule, useSimulation));
+    OUTCOME_TRY(auto serverCircuit, ServerCircuit::fromDynamicModule(
+                                        circuitInfo, dynamicModule, bufferPool,
+                                        preparedKeysets, useSimulation));
     serverCircuits.push_back(serverCircuit);
   }
   output.serverCircuits = serverCircuits;
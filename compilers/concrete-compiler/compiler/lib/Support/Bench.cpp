@@ -0,0 +1,295 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+#include "concretelang/ClientLib/ClientLib.h"
+#include "concretelang/Common/Csprng.h"
+#include "concretelang/Common/Keysets.h"
+#include "concretelang/Common/Values.h"
+#include "concretelang/ServerLib/ServerLib.h"
+#include "concretelang/Support/Bench.h"
+#include "concretelang/Support/Error.h"
+
+using concretelang::clientlib::ClientCircuit;
+using concretelang::clientlib::ClientProgram;
+using concretelang::csprng::EncryptionCSPRNG;
+using concretelang::csprng::SecretCSPRNG;
+using concretelang::error::Result;
+using concretelang::keysets::Keyset;
+using concretelang::keysets::KeysetCache;
+using concretelang::serverlib::ServerCircuit;
+using concretelang::serverlib::ServerProgram;
+using concretelang::values::Tensor;
+using concretelang::values::TransportValue;
+using concretelang::values::Value;
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+/// Returns a tensor of `dimensions` filled with random integers in
+/// [min, max].
+template <typename T>
+Value randomTensor(std::mt19937_64 &generator,
+                   const std::vector<size_t> &dimensions, int64_t min,
+                   int64_t max) {
+  std::uniform_int_distribution<int64_t> distribution(min, max);
+  size_t length = 1;
+  for (auto dimension : dimensions)
+    length *= dimension;
+  std::vector<T> values(length);
+  for (auto &value : values)
+    value = (T)distribution(generator);
+  return Value(Tensor<T>(values, dimensions));
+}
+
+/// Returns a random clear value accepted by the input gate `gateInfo`.
+Result<Value> randomInput(std::mt19937_64 &generator,
+                          concreteprotocol::GateInfo::Reader gateInfo) {
+  auto typeInfo = gateInfo.getTypeInfo();
+  std::vector<size_t> dimensions;
+
+  if (typeInfo.hasLweCiphertext()) {
+    auto type = typeInfo.getLweCiphertext();
+    for (auto dimension : type.getAbstractShape().getDimensions())
+      dimensions.push_back(dimension);
+    auto encoding = type.getEncoding();
+    if (encoding.hasBoolean())
+      return randomTensor<uint64_t>(generator, dimensions, 0, 1);
+    auto integer = encoding.getInteger();
+    // The bounds of the distribution must fit in an int64_t
+    int64_t width = std::min<int64_t>(integer.getWidth(), 62);
+    if (integer.getIsSigned())
+      return randomTensor<int64_t>(generator, dimensions,
+                                   -(int64_t(1) << (width - 1)),
+                                   (int64_t(1) << (width - 1)) - 1);
+    return randomTensor<uint64_t>(generator, dimensions, 0,
+                                  (int64_t(1) << width) - 1);
+  }
+
+  uint32_t precision;
+  bool isSigned;
+  if (typeInfo.hasPlaintext()) {
+    auto type = typeInfo.getPlaintext();
+    for (auto dimension : type.getShape().getDimensions())
+      dimensions.push_back(dimension);
+    precision = type.getIntegerPrecision();
+    isSigned = type.getIsSigned();
+  } else {
+    auto type = typeInfo.getIndex();
+    for (auto dimension : type.getShape().getDimensions())
+      dimensions.push_back(dimension);
+    precision = type.getIntegerPrecision();
+    isSigned = type.getIsSigned();
+  }
+  // Small clear values, that don't overflow the encrypted values they are
+  // combined with in most circuits
+  switch (precision) {
+  case 8:
+    return isSigned ? randomTensor<int8_t>(generator, dimensions, 0, 7)
+                    : randomTensor<uint8_t>(generator, dimensions, 0, 7);
+  case 16:
+    return isSigned ? randomTensor<int16_t>(generator, dimensions, 0, 7)
+                    : randomTensor<uint16_t>(generator, dimensions, 0, 7);
+  case 32:
+    return isSigned ? randomTensor<int32_t>(generator, dimensions, 0, 7)
+                    : randomTensor<uint32_t>(generator, dimensions, 0, 7);
+  case 64:
+    return isSigned ? randomTensor<int64_t>(generator, dimensions, 0, 7)
+                    : randomTensor<uint64_t>(generator, dimensions, 0, 7);
+  default:
+    return StringError("Unsupported precision of clear input: ")
+           << precision;
+  }
+}
+
+/// Returns the minimum, mean, 50th, 90th and 99th percentiles and maximum
+/// of `samples`.
+llvm::json::Object summarize(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&](double p) {
+    size_t rank = (size_t)std::ceil(p / 100. * samples.size());
+    return samples[std::max<size_t>(rank, 1) - 1];
+  };
+  double sum = 0.;
+  for (auto sample : samples)
+    sum += sample;
+  return llvm::json::Object{
+      {"min", samples.front()},
+      {"mean", sum / samples.size()},
+      {"p50", percentile(50)},
+      {"p90", percentile(90)},
+      {"p99", percentile(99)},
+      {"max", samples.back()},
+  };
+}
+
+/// Returns the peak resident set size of the process in bytes.
+int64_t peakRssBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return (int64_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+Result<llvm::json::Object> bench(const CompilerEngine::Library &library,
+                                 const BenchOptions &options) {
+  auto programInfo = library.getProgramInfo();
+  auto circuits = programInfo.asReader().getCircuits();
+  if (circuits.size() == 0)
+    return StringError("The program has no circuit");
+  std::string circuitName = options.circuitName.empty()
+                                ? circuits[0].getName().cStr()
+                                : options.circuitName;
+
+  // Keyset generation, or loading from the cache
+  Keyset keyset;
+  auto start = Clock::now();
+  if (!options.simulate) {
+    auto keysetInfo = Message<concreteprotocol::KeysetInfo>(
+        programInfo.asReader().getKeyset());
+    if (options.keysetCachePath.empty()) {
+      auto secretCsprng = SecretCSPRNG(0);
+      auto encryptionCsprng = EncryptionCSPRNG(0);
+      keyset = Keyset(keysetInfo, secretCsprng, encryptionCsprng);
+    } else {
+      auto cache = KeysetCache(options.keysetCachePath);
+      OUTCOME_TRY(keyset, cache.getKeyset(keysetInfo, 0, 0));
+    }
+  }
+  double keygenMs = elapsedMs(start);
+
+  auto encryptionCsprng = std::make_shared<EncryptionCSPRNG>(0);
+  OUTCOME_TRY(auto clientProgram,
+              ClientProgram::create(programInfo, keyset.client,
+                                    encryptionCsprng, options.simulate));
+  OUTCOME_TRY(auto clientCircuit,
+              clientProgram.getClientCircuit(circuitName));
+  OUTCOME_TRY(auto serverProgram,
+              ServerProgram::load(programInfo,
+                                  CompilerEngine::Library::getSharedLibraryPath(
+                                      library.getOutputDirPath()),
+                                  options.simulate));
+  OUTCOME_TRY(auto serverCircuit,
+              serverProgram.getServerCircuit(circuitName));
+
+  auto inputs = clientCircuit.getCircuitInfo().asReader().getInputs();
+  auto outputs = clientCircuit.getCircuitInfo().asReader().getOutputs();
+  auto call = [&](ServerCircuit &circuit, std::vector<TransportValue> &args) {
+    return options.simulate ? circuit.simulate(args)
+                            : circuit.call(keyset.server, args);
+  };
+
+  // Latency of each step of a call
+  std::mt19937_64 generator(options.seed);
+  std::vector<double> encryptMs, executeMs, decryptMs;
+  std::vector<TransportValue> lastArgs;
+  for (size_t iteration = 0; iteration < options.iterations; iteration++) {
+    std::vector<Value> clearArgs;
+    for (auto input : inputs) {
+      OUTCOME_TRY(auto clearArg, randomInput(generator, input));
+      clearArgs.push_back(clearArg);
+    }
+
+    start = Clock::now();
+    std::vector<TransportValue> args;
+    for (size_t i = 0; i < clearArgs.size(); i++) {
+      OUTCOME_TRY(auto arg, clientCircuit.prepareInput(clearArgs[i], i));
+      args.push_back(arg);
+    }
+    encryptMs.push_back(elapsedMs(start));
+    lastArgs = args;
+
+    start = Clock::now();
+    OUTCOME_TRY(auto results, call(serverCircuit, args));
+    executeMs.push_back(elapsedMs(start));
+
+    start = Clock::now();
+    for (size_t i = 0; i < outputs.size(); i++) {
+      OUTCOME_TRY(auto result, clientCircuit.processOutput(results[i], i));
+      (void)result;
+    }
+    decryptMs.push_back(elapsedMs(start));
+  }
+
+  // Throughput of the execution, each caller running its own copy of the
+  // circuit on the same arguments
+  std::vector<std::thread> callers;
+  std::vector<std::optional<StringError>> callerErrors(options.concurrency);
+  start = Clock::now();
+  for (size_t c = 0; c < options.concurrency; c++) {
+    callers.emplace_back([&, c]() {
+      ServerCircuit circuit = serverCircuit;
+      for (size_t iteration = 0; iteration < options.iterations;
+           iteration++) {
+        auto args = lastArgs;
+        auto results = call(circuit, args);
+        if (results.has_failure()) {
+          callerErrors[c] = results.error();
+          return;
+        }
+      }
+    });
+  }
+  for (auto &caller : callers)
+    caller.join();
+  double throughputMs = elapsedMs(start);
+  for (auto &error : callerErrors)
+    if (error.has_value())
+      return *error;
+
+  double calls = options.iterations * options.concurrency;
+  return llvm::json::Object{
+      {"circuit", circuitName},
+      {"simulate", options.simulate},
+      {"iterations", (int64_t)options.iterations},
+      {"concurrency", (int64_t)options.concurrency},
+      {"keygenMs", keygenMs},
+      {"keysetCached", !options.keysetCachePath.empty()},
+      {"encryptMs", summarize(encryptMs)},
+      {"executeMs", summarize(executeMs)},
+      {"decryptMs", summarize(decryptMs)},
+      {"callsPerSecond", calls * 1000. / throughputMs},
+      {"peakRssBytes", peakRssBytes()},
+  };
+}
+
+} // namespace
+
+llvm::Expected<llvm::json::Object>
+benchLibrary(const CompilerEngine::Library &library,
+             const BenchOptions &options) {
+  if (options.iterations == 0 || options.concurrency == 0)
+    return StreamStringError(
+        "The number of iterations and callers must be positive");
+  auto report = bench(library, options);
+  if (report.has_failure())
+    return StreamStringError(report.error().mesg);
+  return std::move(report.value());
+}
+
+} // namespace concretelang
+} // namespace mlir
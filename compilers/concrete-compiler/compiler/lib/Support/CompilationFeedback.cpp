@@ -106,6 +106,14 @@ void CompilationFeedback::fillFromProgramInfo(
   }
 }
 
+void CompilationFeedback::predictRuntime(uint64_t cores) {
+  assert(cores > 0);
+  predictionCores = cores;
+  predictedPbsRounds = 0;
+  for (auto width : pbsWidthProfile)
+    predictedPbsRounds += (width + cores - 1) / cores;
+}
+
 outcome::checked<CompilationFeedback, StringError>
 CompilationFeedback::load(std::string jsonPath) {
   std::ifstream file(jsonPath);
@@ -126,6 +134,8 @@ CompilationFeedback::load(std::string jsonPath) {
 llvm::json::Value toJSON(const mlir::concretelang::CompilationFeedback &v) {
   llvm::json::Object object{
       {"complexity", v.complexity},
+      {"optimizerObjective", v.optimizerObjective},
+      {"optimizerCores", v.optimizerCores},
       {"pError", v.pError},
       {"globalPError", v.globalPError},
       {"totalSecretKeysSize", v.totalSecretKeysSize},
@@ -134,6 +144,11 @@ llvm::json::Value toJSON(const mlir::concretelang::CompilationFeedback &v) {
       {"totalInputsSize", v.totalInputsSize},
       {"totalOutputsSize", v.totalOutputsSize},
       {"crtDecompositionsOfOutputs", v.crtDecompositionsOfOutputs},
+      {"peakMemoryUsage", v.peakMemoryUsage},
+      {"pbsCriticalPath", v.pbsCriticalPath},
+      {"pbsWidthProfile", v.pbsWidthProfile},
+      {"predictionCores", v.predictionCores},
+      {"predictedPbsRounds", v.predictedPbsRounds},
   };
 
   auto memoryUsageObject = llvm::json::Object();
@@ -215,7 +230,14 @@ bool fromJSON(const llvm::json::Value j,
       O.map("totalKeyswitchKeysSize", v.totalKeyswitchKeysSize) &&
       O.map("totalInputsSize", v.totalInputsSize) &&
       O.map("totalOutputsSize", v.totalOutputsSize) &&
-      O.map("crtDecompositionsOfOutputs", v.crtDecompositionsOfOutputs);
+      O.map("crtDecompositionsOfOutputs", v.crtDecompositionsOfOutputs) &&
+      O.map("peakMemoryUsage", v.peakMemoryUsage) &&
+      O.mapOptional("optimizerObjective", v.optimizerObjective) &&
+      O.mapOptional("optimizerCores", v.optimizerCores) &&
+      O.mapOptional("pbsCriticalPath", v.pbsCriticalPath) &&
+      O.mapOptional("pbsWidthProfile", v.pbsWidthProfile) &&
+      O.mapOptional("predictionCores", v.predictionCores) &&
+      O.mapOptional("predictedPbsRounds", v.predictedPbsRounds);
 
   if (!is_success) {
     return false;
@@ -9,6 +9,7 @@
 #include "mlir/Dialect/SCF/Transforms/BufferizableOpInterfaceImpl.h"
 #include "mlir/Dialect/Tensor/Transforms/BufferizableOpInterfaceImpl.h"
 #include "llvm/Support/Debug.h"
+#include <algorithm>
 #include <err.h>
 #include <fstream>
 #include <iostream>
@@ -16,6 +17,8 @@
 #include <optional>
 #include <stdio.h>
 #include <string>
+#include <thread>
+#include <unistd.h>
 
 #include "mlir/Dialect/Bufferization/Transforms/FuncBufferizableOpInterfaceImpl.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
@@ -62,6 +65,35 @@ namespace concretelang {
 static bool EMIT_GPU_OPS;
 bool getEmitGPUOption() { return EMIT_GPU_OPS; }
 
+/// Returns the size in bytes of the largest ciphertexts encrypted with
+/// the parameters of `solution`.
+static uint64_t getLargestCiphertextSize(const optimizer::Solution &solution) {
+  uint64_t lweDimension = 0;
+  if (auto mono = std::get_if<V0Parameter>(&solution); mono != nullptr) {
+    lweDimension = mono->getNBigLweDimension();
+  } else {
+    auto &circuit = std::get<optimizer::CircuitSolution>(solution);
+    for (auto &key : circuit.circuit_keys.secret_keys)
+      lweDimension = std::max<uint64_t>(
+          lweDimension, key.glwe_dimension * key.polynomial_size);
+  }
+  return (lweDimension + 1) * sizeof(uint64_t);
+}
+
+/// Returns the size in bytes of the cache of the host available to each
+/// of `numThreads` threads: the private L2 cache or a share of the L3
+/// cache, whichever is larger.
+static uint64_t getHostCacheSizePerThread(uint64_t numThreads) {
+  int64_t l2 = 0, l3 = 0;
+#if defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+  l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+  uint64_t size = std::max<int64_t>({l2, l3 / (int64_t)numThreads, 0});
+  // Assume a common L2 cache size if the host does not report it
+  return size != 0 ? size : 1024 * 1024;
+}
+
 /// Creates a new compilation context that can be shared across
 /// compilation engines and results
 std::shared_ptr<CompilationContext> CompilationContext::createShared() {
@@ -218,8 +250,11 @@ llvm::Error CompilerEngine::determineFHEParameters(CompilationResult &res) {
     // backend.
     compilerOptions.optimizerConfig.use_gpu_constraints =
         compilerOptions.emitGPUOps;
-    auto expectedSolution = getSolution(descr.get().value(), feedback,
-                                        compilerOptions.optimizerConfig);
+    auto expectedSolution =
+        getSolution(descr.get().value(), feedback,
+                    compilerOptions.optimizerConfig,
+                    compilerOptions.optimizerSolutionCachePath,
+                    compilerOptions.optimizerCostProfilePath);
     if (auto err = expectedSolution.takeError()) {
       return err;
     }
@@ -374,6 +409,24 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
             .failed())
       return StreamStringError(
           "Marking of FHELinalg operations for tiling failed");
+  } else if (options.fhelinalgAutoTiling && res.fheContext.has_value()) {
+    FHELinalgTilingTarget tilingTarget;
+    tilingTarget.ciphertextSize =
+        getLargestCiphertextSize(res.fheContext->solution);
+    tilingTarget.numThreads =
+        (loopParallelize || dataflowParallelize)
+            ? std::max<uint64_t>(1, std::thread::hardware_concurrency())
+            : 1;
+    tilingTarget.cacheSize =
+        options.fhelinalgTilingCacheSize != 0
+            ? options.fhelinalgTilingCacheSize
+            : getHostCacheSizePerThread(tilingTarget.numThreads);
+
+    if (mlir::concretelang::pipeline::markFHELinalgForAutoTiling(
+            mlirContext, module, tilingTarget, enablePass)
+            .failed())
+      return StreamStringError(
+          "Marking of FHELinalg operations for tiling failed");
   }
 
   if (mlir::concretelang::pipeline::tileMarkedFHELinalg(mlirContext, module,
@@ -386,8 +439,14 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     return std::move(res);
 
   // FHELinalg -> FHE
-  if (mlir::concretelang::pipeline::lowerFHELinalgToFHE(mlirContext, module,
-                                                        enablePass)
+  // Matrix products are only kept for the gemm kernel if the scalar lowering
+  // will be used: neither the crt lowering nor the simulation handle them.
+  bool lowerMatmulToGemm =
+      options.lowerMatmulToGemm && !options.simulate &&
+      !(res.fheContext.has_value() &&
+        getCrtDecompositionFromSolution(res.fheContext->solution).has_value());
+  if (mlir::concretelang::pipeline::lowerFHELinalgToFHE(
+          mlirContext, module, enablePass, lowerMatmulToGemm)
           .failed()) {
     return StreamStringError("Lowering from FHELinalg to FHE failed");
   }
@@ -410,7 +469,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
 
   // Dataflow parallelization
   if (dataflowParallelize &&
-      mlir::concretelang::pipeline::autopar(mlirContext, module, enablePass)
+      mlir::concretelang::pipeline::autopar(mlirContext, module, enablePass,
+                                            options.dataflowTaskGranularity)
           .failed()) {
     return StreamStringError("Dataflow parallelization failed");
   }
@@ -505,6 +565,11 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
             .failed()) {
       return StreamStringError("Extracting TFHE statistics failed");
     }
+    // Predict on the cores given to the optimizer, or on the host cores
+    res.feedback->predictRuntime(
+        options.optimizerConfig.cores != 0
+            ? options.optimizerConfig.cores
+            : std::max<uint64_t>(1, std::thread::hardware_concurrency()));
   }
 
   if (options.simulate) {
@@ -520,7 +585,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
 
   if (options.batchTFHEOps) {
     if (mlir::concretelang::pipeline::batchTFHE(mlirContext, module, enablePass,
-                                                options.maxBatchSize)
+                                                options.maxBatchSize,
+                                                options.batchingReport)
             .failed()) {
       return StreamStringError("Batching of TFHE operations");
     }
@@ -530,12 +596,33 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     return std::move(res);
 
   // TFHE -> Concrete
-  if (mlir::concretelang::pipeline::lowerTFHEToConcrete(mlirContext, module,
-                                                        this->enablePass)
+  //
+  // Leveled operations are not fused when emitting SDFG operations, as the
+  // extraction of the data flow graph only knows about the unfused ones.
+  if (mlir::concretelang::pipeline::lowerTFHEToConcrete(
+          mlirContext, module, this->enablePass, !options.emitSDFGOps)
           .failed()) {
     return StreamStringError("Lowering from TFHE to Concrete failed");
   }
 
+  // Stream the batches through chunks fitting in the cache. The GPU kernels
+  // and the SDFG operations process whole batches instead.
+  if (options.batchTFHEOps && options.fuseBatchedOps && !options.emitGPUOps &&
+      !options.emitSDFGOps) {
+    uint64_t numThreads =
+        (loopParallelize || dataflowParallelize)
+            ? std::max<uint64_t>(1, std::thread::hardware_concurrency())
+            : 1;
+    uint64_t cacheSize = options.fusedBatchCacheSize != 0
+                             ? options.fusedBatchCacheSize
+                             : getHostCacheSizePerThread(numThreads);
+    if (mlir::concretelang::pipeline::fuseBatchedOps(mlirContext, module,
+                                                     enablePass, cacheSize)
+            .failed()) {
+      return StreamStringError("Fusion of batched operations failed");
+    }
+  }
+
   if (target == Target::CONCRETE)
     return std::move(res);
 
@@ -577,6 +664,17 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     return StreamStringError("Failed to lower to std");
   }
 
+  // Buffers managed by the dataflow runtime or by the stream emulator
+  // have lifetimes that are not visible in the IR
+  if (options.staticMemoryPlanning && !dataflowParallelize &&
+      !options.emitSDFGOps) {
+    if (mlir::concretelang::pipeline::planStaticMemory(mlirContext, module,
+                                                       enablePass)
+            .failed()) {
+      return StreamStringError("Static memory planning failed");
+    }
+  }
+
   if (target == Target::STD)
     return std::move(res);
 
@@ -588,12 +686,30 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     }
   }
 
+  // Buffers passed to dataflow tasks may be released by the runtime on
+  // another node, outside of the pool of the runtime context
+  if (options.poolCiphertextBuffers && !dataflowParallelize) {
+    if (mlir::concretelang::pipeline::poolCiphertextBuffers(mlirContext, module,
+                                                            enablePass)
+            .failed()) {
+      return StreamStringError("Pooling of ciphertext buffers failed");
+    }
+  }
+
   if (mlir::concretelang::pipeline::lowerToCAPI(mlirContext, module, enablePass,
                                                 options.emitGPUOps)
           .failed()) {
     return StreamStringError("Failed to lower to CAPI");
   }
 
+  if (options.profileRuntimeCalls) {
+    if (mlir::concretelang::pipeline::profileRuntimeCalls(mlirContext, module,
+                                                          enablePass)
+            .failed()) {
+      return StreamStringError("Failed to profile the runtime calls");
+    }
+  }
+
   // MLIR canonical dialects -> LLVM Dialect
   if (mlir::concretelang::pipeline::lowerStdToLLVMDialect(mlirContext, module,
                                                           enablePass)
@@ -616,8 +732,21 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   if (target == Target::LLVM_IR)
     return std::move(res);
 
-  if (mlir::concretelang::pipeline::optimizeLLVMModule(llvmContext,
-                                                       *res.llvmModule)
+  // The leveled runtime operations are inlined and optimized at -O3 with
+  // the circuits if their bitcode is provided
+  unsigned optLevel = 0;
+  if (!options.runtimeBitcodePath.empty()) {
+    if (mlir::concretelang::pipeline::linkRuntimeBitcode(
+            llvmContext, *res.llvmModule, options.runtimeBitcodePath)
+            .failed()) {
+      return StreamStringError("Failed to link the runtime bitcode ")
+             << options.runtimeBitcodePath;
+    }
+    optLevel = 3;
+  }
+
+  if (mlir::concretelang::pipeline::optimizeLLVMModule(
+          llvmContext, *res.llvmModule, optLevel)
           .failed()) {
     return StreamStringError("Failed to optimize LLVM IR");
   }
@@ -0,0 +1,92 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "concretelang/Support/Error.h"
+#include "concretelang/Support/JIT.h"
+#include "concretelang/Support/LLVMEmitFile.h"
+
+namespace mlir {
+namespace concretelang {
+
+llvm::Expected<std::shared_ptr<::concretelang::serverlib::DynamicModule>>
+jitCompile(const llvm::Module &module, std::string runtimeLibraryPath) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  // The JIT owns the context of the modules it compiles, while the module
+  // of a compilation result belongs to the context of the compilation. The
+  // module is thus copied to a new context through its bitcode.
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream bitcodeStream(bitcode);
+  llvm::WriteBitcodeToFile(module, bitcodeStream);
+
+  llvm::orc::ThreadSafeContext context(std::make_unique<llvm::LLVMContext>());
+  auto jitModule = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()),
+                            module.getModuleIdentifier()),
+      *context.getContext());
+  if (!jitModule)
+    return jitModule.takeError();
+
+  packFunctionArguments(jitModule->get());
+
+  auto targetMachineBuilder = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!targetMachineBuilder)
+    return targetMachineBuilder.takeError();
+  targetMachineBuilder->setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+
+  auto dataLayout = targetMachineBuilder->getDefaultDataLayoutForTarget();
+  if (!dataLayout)
+    return dataLayout.takeError();
+  (*jitModule)->setDataLayout(*dataLayout);
+  (*jitModule)->setTargetTriple(
+      targetMachineBuilder->getTargetTriple().getTriple());
+
+  auto jit = llvm::orc::LLJITBuilder()
+                 .setJITTargetMachineBuilder(std::move(*targetMachineBuilder))
+                 .create();
+  if (!jit)
+    return jit.takeError();
+
+  // Resolve the calls to the runtime
+  char globalPrefix = (*jit)->getDataLayout().getGlobalPrefix();
+  auto runtimeGenerator =
+      runtimeLibraryPath.empty()
+          ? llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+                globalPrefix)
+          : llvm::orc::DynamicLibrarySearchGenerator::Load(
+                runtimeLibraryPath.c_str(), globalPrefix);
+  if (!runtimeGenerator)
+    return runtimeGenerator.takeError();
+  (*jit)->getMainJITDylib().addGenerator(std::move(*runtimeGenerator));
+
+  if (auto err = (*jit)->addIRModule(
+          llvm::orc::ThreadSafeModule(std::move(*jitModule), context)))
+    return std::move(err);
+
+  std::shared_ptr<llvm::orc::LLJIT> sharedJit = std::move(*jit);
+
+  return ::concretelang::serverlib::DynamicModule::fromSymbolLookup(
+      [sharedJit](const std::string &name) -> void * {
+        auto symbol = sharedJit->lookup(name);
+        if (!symbol) {
+          llvm::consumeError(symbol.takeError());
+          return nullptr;
+        }
+        return symbol->toPtr<void *>();
+      });
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -62,7 +62,7 @@ getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
 // For each function in the LLVM module, define an interface function that wraps
 // all the arguments of the original function and all its results into an i8**
 // pointer to provide a unified invocation interface.
-static void packFunctionArguments(llvm::Module *module) {
+void packFunctionArguments(llvm::Module *module) {
   auto &ctx = module->getContext();
   llvm::IRBuilder<> builder(ctx);
   llvm::DenseSet<llvm::Function *> interfaceFunctions;
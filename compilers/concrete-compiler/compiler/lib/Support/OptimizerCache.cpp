@@ -0,0 +1,420 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <cmath>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "concrete-optimizer.hpp"
+#include "concretelang/Support/Error.h"
+#include "concretelang/Support/OptimizerCache.h"
+
+namespace mlir {
+namespace concretelang {
+namespace optimizer {
+
+namespace {
+
+using concrete_optimizer::dag::BootstrapKey;
+using concrete_optimizer::dag::BrDecompositionParameters;
+using concrete_optimizer::dag::CircuitBoostrapKey;
+using concrete_optimizer::dag::ConversionKeySwitchKey;
+using concrete_optimizer::dag::InstructionKeys;
+using concrete_optimizer::dag::KeySwitchKey;
+using concrete_optimizer::dag::KsDecompositionParameters;
+using concrete_optimizer::dag::SecretLweKey;
+using llvm::json::Array;
+using llvm::json::Object;
+using llvm::json::Value;
+
+/// Version of the format of the cached solutions, to bump whenever the
+/// format or the meaning of a solution changes.
+constexpr llvm::StringLiteral CACHE_FORMAT = "circuit-solution-v1";
+
+// Serialization of the solution
+
+Value toJSON(const SecretLweKey &key);
+Value toJSON(const BootstrapKey &key);
+Value toJSON(const KeySwitchKey &key);
+Value toJSON(const ConversionKeySwitchKey &key);
+Value toJSON(const CircuitBoostrapKey &key);
+Value toJSON(const PrivateFunctionalPackingBoostrapKey &key);
+Value toJSON(const InstructionKeys &keys);
+
+Value toJSON(uint64_t value) { return (int64_t)value; }
+
+Value toJSON(const rust::String &value) { return std::string(value); }
+
+/// NaN, which JSON can't represent, is serialized as null.
+Value toJSON(double value) {
+  if (std::isnan(value))
+    return nullptr;
+  return value;
+}
+
+template <typename T> Value toJSON(const rust::Vec<T> &values) {
+  Array array;
+  for (auto &value : values)
+    array.push_back(toJSON(value));
+  return std::move(array);
+}
+
+template <typename Parameters> Value decompositionToJSON(Parameters p) {
+  return Object{{"level", toJSON(p.level)},
+                {"log2_base", toJSON(p.log2_base)}};
+}
+
+Value toJSON(const SecretLweKey &key) {
+  return Object{{"identifier", toJSON(key.identifier)},
+                {"polynomial_size", toJSON(key.polynomial_size)},
+                {"glwe_dimension", toJSON(key.glwe_dimension)},
+                {"description", toJSON(key.description)}};
+}
+
+Value toJSON(const BootstrapKey &key) {
+  return Object{
+      {"identifier", toJSON(key.identifier)},
+      {"input_key", toJSON(key.input_key)},
+      {"output_key", toJSON(key.output_key)},
+      {"br_decomposition_parameter",
+       decompositionToJSON(key.br_decomposition_parameter)},
+      {"description", toJSON(key.description)}};
+}
+
+Value toJSON(const KeySwitchKey &key) {
+  return Object{
+      {"identifier", toJSON(key.identifier)},
+      {"input_key", toJSON(key.input_key)},
+      {"output_key", toJSON(key.output_key)},
+      {"ks_decomposition_parameter",
+       decompositionToJSON(key.ks_decomposition_parameter)},
+      {"description", toJSON(key.description)}};
+}
+
+Value toJSON(const ConversionKeySwitchKey &key) {
+  return Object{
+      {"identifier", toJSON(key.identifier)},
+      {"input_key", toJSON(key.input_key)},
+      {"output_key", toJSON(key.output_key)},
+      {"ks_decomposition_parameter",
+       decompositionToJSON(key.ks_decomposition_parameter)},
+      {"fast_keyswitch", key.fast_keyswitch},
+      {"description", toJSON(key.description)}};
+}
+
+template <typename Key> Value circuitBootstrapKeyToJSON(const Key &key) {
+  return Object{
+      {"identifier", toJSON(key.identifier)},
+      {"representation_key", toJSON(key.representation_key)},
+      {"br_decomposition_parameter",
+       decompositionToJSON(key.br_decomposition_parameter)},
+      {"description", toJSON(key.description)}};
+}
+
+Value toJSON(const CircuitBoostrapKey &key) {
+  return circuitBootstrapKeyToJSON(key);
+}
+
+Value toJSON(const PrivateFunctionalPackingBoostrapKey &key) {
+  return circuitBootstrapKeyToJSON(key);
+}
+
+Value toJSON(const CircuitKeys &keys) {
+  return Object{
+      {"secret_keys", toJSON(keys.secret_keys)},
+      {"keyswitch_keys", toJSON(keys.keyswitch_keys)},
+      {"bootstrap_keys", toJSON(keys.bootstrap_keys)},
+      {"conversion_keyswitch_keys", toJSON(keys.conversion_keyswitch_keys)},
+      {"circuit_bootstrap_keys", toJSON(keys.circuit_bootstrap_keys)},
+      {"private_functional_packing_keys",
+       toJSON(keys.private_functional_packing_keys)}};
+}
+
+Value toJSON(const InstructionKeys &keys) {
+  return Object{
+      {"input_key", toJSON(keys.input_key)},
+      {"tlu_keyswitch_key", toJSON(keys.tlu_keyswitch_key)},
+      {"tlu_bootstrap_key", toJSON(keys.tlu_bootstrap_key)},
+      {"tlu_circuit_bootstrap_key", toJSON(keys.tlu_circuit_bootstrap_key)},
+      {"tlu_private_functional_packing_key",
+       toJSON(keys.tlu_private_functional_packing_key)},
+      {"output_key", toJSON(keys.output_key)},
+      {"extra_conversion_keys", toJSON(keys.extra_conversion_keys)}};
+}
+
+Value toJSON(const CircuitSolution &solution) {
+  return Object{{"format", CACHE_FORMAT},
+                {"circuit_keys", toJSON(solution.circuit_keys)},
+                {"instructions_keys", toJSON(solution.instructions_keys)},
+                {"crt_decomposition", toJSON(solution.crt_decomposition)},
+                {"complexity", toJSON(solution.complexity)},
+                {"p_error", toJSON(solution.p_error)},
+                {"global_p_error", toJSON(solution.global_p_error)},
+                {"is_feasible", solution.is_feasible},
+                {"error_msg", toJSON(solution.error_msg)}};
+}
+
+// Deserialization of the solution, each function returns false if `value`
+// is missing or malformed
+
+bool read(const Value *value, SecretLweKey &out);
+bool read(const Value *value, BootstrapKey &out);
+bool read(const Value *value, KeySwitchKey &out);
+bool read(const Value *value, ConversionKeySwitchKey &out);
+bool read(const Value *value, CircuitBoostrapKey &out);
+bool read(const Value *value, PrivateFunctionalPackingBoostrapKey &out);
+bool read(const Value *value, InstructionKeys &out);
+
+bool read(const Value *value, uint64_t &out) {
+  auto integer = value ? value->getAsInteger() : std::nullopt;
+  if (!integer || *integer < 0)
+    return false;
+  out = *integer;
+  return true;
+}
+
+bool read(const Value *value, bool &out) {
+  auto boolean = value ? value->getAsBoolean() : std::nullopt;
+  if (!boolean)
+    return false;
+  out = *boolean;
+  return true;
+}
+
+bool read(const Value *value, double &out) {
+  if (value && value->getAsNull()) {
+    out = NAN;
+    return true;
+  }
+  auto number = value ? value->getAsNumber() : std::nullopt;
+  if (!number)
+    return false;
+  out = *number;
+  return true;
+}
+
+bool read(const Value *value, rust::String &out) {
+  auto string = value ? value->getAsString() : std::nullopt;
+  if (!string)
+    return false;
+  out = rust::String(string->data(), string->size());
+  return true;
+}
+
+template <typename T> bool read(const Value *value, rust::Vec<T> &out) {
+  auto array = value ? value->getAsArray() : nullptr;
+  if (!array)
+    return false;
+  for (auto &element : *array) {
+    T item{};
+    if (!read(&element, item))
+      return false;
+    out.push_back(std::move(item));
+  }
+  return true;
+}
+
+template <typename Parameters>
+bool readDecomposition(const Value *value, Parameters &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("level"), out.level) &&
+         read(object->get("log2_base"), out.log2_base);
+}
+
+bool read(const Value *value, SecretLweKey &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("identifier"), out.identifier) &&
+         read(object->get("polynomial_size"), out.polynomial_size) &&
+         read(object->get("glwe_dimension"), out.glwe_dimension) &&
+         read(object->get("description"), out.description);
+}
+
+bool read(const Value *value, BootstrapKey &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("identifier"), out.identifier) &&
+         read(object->get("input_key"), out.input_key) &&
+         read(object->get("output_key"), out.output_key) &&
+         readDecomposition(object->get("br_decomposition_parameter"),
+                           out.br_decomposition_parameter) &&
+         read(object->get("description"), out.description);
+}
+
+bool read(const Value *value, KeySwitchKey &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("identifier"), out.identifier) &&
+         read(object->get("input_key"), out.input_key) &&
+         read(object->get("output_key"), out.output_key) &&
+         readDecomposition(object->get("ks_decomposition_parameter"),
+                           out.ks_decomposition_parameter) &&
+         read(object->get("description"), out.description);
+}
+
+bool read(const Value *value, ConversionKeySwitchKey &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("identifier"), out.identifier) &&
+         read(object->get("input_key"), out.input_key) &&
+         read(object->get("output_key"), out.output_key) &&
+         readDecomposition(object->get("ks_decomposition_parameter"),
+                           out.ks_decomposition_parameter) &&
+         read(object->get("fast_keyswitch"), out.fast_keyswitch) &&
+         read(object->get("description"), out.description);
+}
+
+template <typename Key>
+bool readCircuitBootstrapKey(const Value *value, Key &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("identifier"), out.identifier) &&
+         read(object->get("representation_key"), out.representation_key) &&
+         readDecomposition(object->get("br_decomposition_parameter"),
+                           out.br_decomposition_parameter) &&
+         read(object->get("description"), out.description);
+}
+
+bool read(const Value *value, CircuitBoostrapKey &out) {
+  return readCircuitBootstrapKey(value, out);
+}
+
+bool read(const Value *value, PrivateFunctionalPackingBoostrapKey &out) {
+  return readCircuitBootstrapKey(value, out);
+}
+
+bool read(const Value *value, CircuitKeys &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("secret_keys"), out.secret_keys) &&
+         read(object->get("keyswitch_keys"), out.keyswitch_keys) &&
+         read(object->get("bootstrap_keys"), out.bootstrap_keys) &&
+         read(object->get("conversion_keyswitch_keys"),
+              out.conversion_keyswitch_keys) &&
+         read(object->get("circuit_bootstrap_keys"),
+              out.circuit_bootstrap_keys) &&
+         read(object->get("private_functional_packing_keys"),
+              out.private_functional_packing_keys);
+}
+
+bool read(const Value *value, InstructionKeys &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && read(object->get("input_key"), out.input_key) &&
+         read(object->get("tlu_keyswitch_key"), out.tlu_keyswitch_key) &&
+         read(object->get("tlu_bootstrap_key"), out.tlu_bootstrap_key) &&
+         read(object->get("tlu_circuit_bootstrap_key"),
+              out.tlu_circuit_bootstrap_key) &&
+         read(object->get("tlu_private_functional_packing_key"),
+              out.tlu_private_functional_packing_key) &&
+         read(object->get("output_key"), out.output_key) &&
+         read(object->get("extra_conversion_keys"), out.extra_conversion_keys);
+}
+
+bool read(const Value *value, CircuitSolution &out) {
+  auto object = value ? value->getAsObject() : nullptr;
+  return object && object->getString("format") == CACHE_FORMAT &&
+         read(object->get("circuit_keys"), out.circuit_keys) &&
+         read(object->get("instructions_keys"), out.instructions_keys) &&
+         read(object->get("crt_decomposition"), out.crt_decomposition) &&
+         read(object->get("complexity"), out.complexity) &&
+         read(object->get("p_error"), out.p_error) &&
+         read(object->get("global_p_error"), out.global_p_error) &&
+         read(object->get("is_feasible"), out.is_feasible) &&
+         read(object->get("error_msg"), out.error_msg);
+}
+
+std::string solutionPath(llvm::StringRef cachePath, llvm::StringRef key) {
+  llvm::SmallString<256> path(cachePath);
+  llvm::sys::path::append(path, key + ".json");
+  return path.str().str();
+}
+
+} // namespace
+
+std::string solutionCacheKey(const Dag &dag, const Config &config) {
+  std::string description;
+  llvm::raw_string_ostream os(description);
+  // The doubles are printed in hexadecimal to be exact
+  os << CACHE_FORMAT << "\n"
+     << llvm::format("p_error=%a\n", config.p_error)
+     << llvm::format("global_p_error=%a\n", config.global_p_error)
+     << "strategy=" << (int)config.strategy << "\n"
+     << "key_sharing=" << config.key_sharing << "\n"
+     << "multi_param_strategy=" << (int)config.multi_param_strategy << "\n"
+     << "security=" << config.security << "\n"
+     << llvm::format("fallback_log_norm_woppbs=%a\n",
+                     config.fallback_log_norm_woppbs)
+     << "use_gpu_constraints=" << config.use_gpu_constraints << "\n"
+     << "encoding=" << (int)config.encoding << "\n"
+     << "ciphertext_modulus_log=" << config.ciphertext_modulus_log << "\n"
+     << "fft_precision=" << config.fft_precision << "\n"
+     << "composable=" << config.composable << "\n"
+     << "objective=" << (int)config.objective << "\n";
+  // The cores only change the latency, the other objectives share their keys
+  if (config.objective == concrete_optimizer::Objective::Latency)
+    os << "cores=" << config.cores << "\n";
+  // Keeps the keys of the analytical cost model unchanged. The handle of the
+  // profile is only valid in this process, the key holds its factors.
+  if (config.cpu_cost_profile != DEFAULT_CPU_COST_PROFILE)
+    os << "cost_profile=\n"
+       << std::string(concrete_optimizer::utils::dump_cpu_cost_profile(
+              config.cpu_cost_profile));
+  // The locations and the tables of the lookups do not change the solution
+  os << std::string(dag->canonical_dump());
+  os.flush();
+
+  llvm::SHA256 hasher;
+  hasher.update(description);
+  auto hash = hasher.final();
+  return llvm::toHex(hash, /*LowerCase=*/true);
+}
+
+std::optional<CircuitSolution> loadCircuitSolution(llvm::StringRef cachePath,
+                                                   llvm::StringRef key) {
+  auto buffer = llvm::MemoryBuffer::getFile(solutionPath(cachePath, key));
+  if (!buffer)
+    return std::nullopt;
+  auto json = llvm::json::parse((*buffer)->getBuffer());
+  if (!json) {
+    llvm::consumeError(json.takeError());
+    return std::nullopt;
+  }
+  CircuitSolution solution{};
+  if (!read(&*json, solution))
+    return std::nullopt;
+  return solution;
+}
+
+llvm::Error storeCircuitSolution(llvm::StringRef cachePath,
+                                 llvm::StringRef key,
+                                 const CircuitSolution &solution) {
+  if (auto ec = llvm::sys::fs::create_directories(cachePath))
+    return StreamStringError("Cannot create the optimizer cache directory ")
+           << cachePath.str() << ": " << ec.message();
+
+  llvm::SmallString<256> model(cachePath);
+  llvm::sys::path::append(model, key + "-%%%%%%.tmp");
+  int fd;
+  llvm::SmallString<256> tmpPath;
+  if (auto ec = llvm::sys::fs::createUniqueFile(model, fd, tmpPath))
+    return StreamStringError("Cannot create a file in the optimizer cache ")
+           << cachePath.str() << ": " << ec.message();
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << toJSON(solution);
+  }
+  if (auto ec = llvm::sys::fs::rename(tmpPath, solutionPath(cachePath, key))) {
+    llvm::sys::fs::remove(tmpPath);
+    return StreamStringError("Cannot write to the optimizer cache ")
+           << cachePath.str() << ": " << ec.message();
+  }
+  return llvm::Error::success();
+}
+
+} // namespace optimizer
+} // namespace concretelang
+} // namespace mlir
@@ -3,7 +3,11 @@
 // https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
 // for license information.
 
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Transforms/IPO/Internalize.h"
 
 #include "mlir/Conversion/BufferizationToMemRef/BufferizationToMemRef.h"
 #include "mlir/Conversion/Passes.h"
@@ -45,6 +49,7 @@
 #include "concretelang/Dialect/TFHE/Transforms/Transforms.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "concretelang/Support/Error.h"
+#include "concretelang/Support/LLVMEmitFile.h"
 #include "concretelang/Support/Pipeline.h"
 #include "concretelang/Support/logging.h"
 #include "concretelang/Support/math.h"
@@ -146,12 +151,16 @@ getFHEContextFromFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
 }
 
 mlir::LogicalResult autopar(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                            std::function<bool(mlir::Pass *)> enablePass) {
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            uint64_t taskGranularity) {
   mlir::PassManager pm(&context);
   pipelinePrinting("AutoPar", pm, context);
 
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createBuildDataflowTaskGraphPass(), enablePass);
+      pm,
+      mlir::concretelang::createBuildDataflowTaskGraphPass(false,
+                                                           taskGranularity),
+      enablePass);
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createLowerDataflowTasksPass(), enablePass);
 
@@ -181,6 +190,18 @@ markFHELinalgForTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+markFHELinalgForAutoTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                           FHELinalgTilingTarget target,
+                           std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("MarkFHELinalgForAutoTiling", pm, context);
+  addPotentiallyNestedPass(pm, createFHELinalgAutoTilingMarkerPass(target),
+                           enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult
 transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
                          std::function<bool(mlir::Pass *)> enablePass) {
@@ -196,11 +217,14 @@ transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerFHELinalgToFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass) {
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    bool lowerMatmulToGemm) {
   mlir::PassManager pm(&context);
   pipelinePrinting("FHELinalgToFHE", pm, context);
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createConvertFHETensorOpsToLinalg(), enablePass);
+      pm,
+      mlir::concretelang::createConvertFHETensorOpsToLinalg(lowerMatmulToGemm),
+      enablePass);
   addPotentiallyNestedPass(pm, mlir::createLinalgGeneralizationPass(),
                            enablePass);
 
@@ -320,12 +344,13 @@ parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult batchTFHE(mlir::MLIRContext &context,
                               mlir::ModuleOp &module,
                               std::function<bool(mlir::Pass *)> enablePass,
-                              int64_t maxBatchSize) {
+                              int64_t maxBatchSize, bool report) {
   mlir::PassManager pm(&context);
   pipelinePrinting("BatchTFHE", pm, context);
 
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createBatchingPass(maxBatchSize), enablePass);
+      pm, mlir::concretelang::createBatchingPass(maxBatchSize, report),
+      enablePass);
 
   return pm.run(module.getOperation());
 }
@@ -358,12 +383,29 @@ extractTFHEStatistics(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerTFHEToConcrete(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass) {
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    bool fuseLeveledOps) {
   mlir::PassManager pm(&context);
   pipelinePrinting("TFHEToConcrete", pm, context);
 
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createConvertTFHEToConcretePass(), enablePass);
+  if (fuseLeveledOps)
+    addPotentiallyNestedPass(
+        pm, mlir::concretelang::createFuseLeveledOpsPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+fuseBatchedOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
+               std::function<bool(mlir::Pass *)> enablePass,
+               uint64_t cacheSize) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("FuseBatchedOps", pm, context);
+
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createFuseBatchedOpsPass(cacheSize), enablePass);
 
   return pm.run(module.getOperation());
 }
@@ -381,6 +423,30 @@ computeMemoryUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+planStaticMemory(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                 std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("StaticMemoryPlanning", pm, context);
+
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createStaticMemoryPlanningPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+poolCiphertextBuffers(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("PoolCiphertextBuffers", pm, context);
+
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createPoolCiphertextBuffersPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult optimizeTFHE(mlir::MLIRContext &context,
                                  mlir::ModuleOp &module,
                                  std::function<bool(mlir::Pass *)> enablePass) {
@@ -514,6 +580,18 @@ mlir::LogicalResult lowerToCAPI(mlir::MLIRContext &context,
   return pm.run(module);
 }
 
+mlir::LogicalResult
+profileRuntimeCalls(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                    std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("ProfileRuntimeCalls", pm, context);
+
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createProfileRuntimeCallsPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult
 lowerStdToLLVMDialect(mlir::MLIRContext &context, mlir::ModuleOp &module,
                       std::function<bool(mlir::Pass *)> enablePass) {
@@ -541,11 +619,17 @@ lowerLLVMDialectToLLVMIR(mlir::MLIRContext &context,
 }
 
 mlir::LogicalResult optimizeLLVMModule(llvm::LLVMContext &llvmContext,
-                                       llvm::Module &module) {
-  // -O3 is done LLVMEmitFile.cpp
-  auto optLevel = llvm::CodeGenOpt::None;
+                                       llvm::Module &module,
+                                       unsigned optLevel) {
+  // By default, -O3 is only done by the code generation in LLVMEmitFile.cpp
+  std::unique_ptr<llvm::TargetMachine> targetMachine;
+  if (optLevel > 0) {
+    targetMachine = getTargetMachineAndSetupModule(&module);
+    if (!targetMachine)
+      return mlir::failure();
+  }
   std::function<llvm::Error(llvm::Module *)> optPipeline =
-      mlir::makeOptimizingTransformer(optLevel, 0, nullptr);
+      mlir::makeOptimizingTransformer(optLevel, 0, targetMachine.get());
 
   if (optPipeline(&module))
     return mlir::failure();
@@ -553,6 +637,33 @@ mlir::LogicalResult optimizeLLVMModule(llvm::LLVMContext &llvmContext,
     return mlir::success();
 }
 
+mlir::LogicalResult linkRuntimeBitcode(llvm::LLVMContext &llvmContext,
+                                       llvm::Module &module,
+                                       llvm::StringRef bitcodePath) {
+  llvm::SMDiagnostic diagnostic;
+  std::unique_ptr<llvm::Module> runtime =
+      llvm::parseIRFile(bitcodePath, diagnostic, llvmContext);
+  if (!runtime) {
+    diagnostic.print("concretecompiler", llvm::errs());
+    return mlir::failure();
+  }
+  // The bitcode is built for the host, as the circuits
+  runtime->setDataLayout(module.getDataLayout());
+  runtime->setTargetTriple(module.getTargetTriple());
+
+  // Only the functions called by the circuits are linked, and the linked
+  // ones are internalized, so that they are dropped once inlined
+  bool failed = llvm::Linker::linkModules(
+      module, std::move(runtime), llvm::Linker::Flags::LinkOnlyNeeded,
+      [](llvm::Module &linkedModule, const llvm::StringSet<> &linked) {
+        llvm::internalizeModule(
+            linkedModule, [&](const llvm::GlobalValue &value) {
+              return !value.hasName() || !linked.count(value.getName());
+            });
+      });
+  return mlir::failure(failed);
+}
+
 } // namespace pipeline
 } // namespace concretelang
 } // namespace mlir
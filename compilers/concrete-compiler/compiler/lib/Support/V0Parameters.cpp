@@ -8,16 +8,19 @@
 /// We should include this in our build system, but for moment it is just a cc
 /// from the optimizer output.
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cmath>
 #include <iostream>
 #include <optional>
+#include <thread>
 
 #include "llvm/Support/raw_ostream.h"
 
 #include "concrete-optimizer.hpp"
 #include "concretelang/Support/Error.h"
+#include "concretelang/Support/OptimizerCache.h"
 #include "concretelang/Support/V0Parameters.h"
 #include "concretelang/Support/logging.h"
 
@@ -36,7 +39,10 @@ concrete_optimizer::Options options_from_config(optimizer::Config config) {
       /* .cache_on_disk = */ config.cache_on_disk,
       /* .ciphertext_modulus_log = */ config.ciphertext_modulus_log,
       /* .fft_precision = */ config.fft_precision,
-      /* .composable = */ config.composable};
+      /* .composable = */ config.composable,
+      /* .objective = */ config.objective,
+      /* .cores = */ config.cores,
+      /* .cpu_cost_profile = */ config.cpu_cost_profile};
   return options;
 }
 
@@ -135,6 +141,28 @@ optimizer::CircuitSolution getDagMultiSolution(optimizer::Dag &dag,
   return optimize(options_from_config(config));
 }
 
+/// Same as `getDagMultiSolution` but looks up the solution in the cache
+/// directory `cachePath` first, and stores it there once computed. The
+/// solutions of different cost profiles are cached apart.
+optimizer::CircuitSolution
+getCachedDagMultiSolution(optimizer::Dag &dag, optimizer::Config config,
+                          llvm::StringRef cachePath) {
+  auto key = optimizer::solutionCacheKey(dag, config);
+  if (auto cached = optimizer::loadCircuitSolution(cachePath, key)) {
+    if (config.display) {
+      llvm::errs() << "Optimizer solution found in the cache (" << key
+                   << ")\n";
+    }
+    return std::move(*cached);
+  }
+  auto sol = getDagMultiSolution(dag, config);
+  if (auto err = optimizer::storeCircuitSolution(cachePath, key, sol)) {
+    // The cache is best effort, the compilation goes on without it
+    llvm::errs() << "WARNING: " << llvm::toString(std::move(err)) << "\n";
+  }
+  return sol;
+}
+
 constexpr double WARN_ABOVE_GLOBAL_ERROR_RATE = 1.0 / 1000.0;
 
 template <typename Solution> void displaySolution(const Solution &solution);
@@ -193,8 +221,13 @@ void displayOptimizer(const Solution &solution,
                  << " 1/" << int(1.0 / solution.global_p_error)
                  << " global_p_error(" << solution.global_p_error << ")\n";
   }
-  auto complexity_label =
+  std::string complexity_label =
       descr.dag ? "for the full circuit" : "for each Pbs call";
+  if (config.strategy == optimizer::Strategy::DAG_MULTI &&
+      config.objective == concrete_optimizer::Objective::Latency) {
+    complexity_label +=
+        ", latency on " + std::to_string(config.cores) + " cores";
+  }
   double mops = ceil(solution.complexity / (1000 * 1000));
   llvm::errs() << "--- Complexity " << complexity_label << "\n"
                << "  " << mops << " Millions Operations\n";
@@ -268,7 +301,13 @@ optimizer::Solution convertSolution(optimizer::CircuitSolution sol) {
 
 /// Fill the compilation `feedback` from a `solution` returned by the optmizer.
 template <typename Solution>
-void fillFeedback(Solution solution, CompilationFeedback &feedback) {
+void fillFeedback(Solution solution, CompilationFeedback &feedback,
+                  optimizer::Config config) {
+  // Only the multi-parameter optimizer minimizes the latency
+  bool latency = config.strategy == optimizer::Strategy::DAG_MULTI &&
+                 config.objective == concrete_optimizer::Objective::Latency;
+  feedback.optimizerObjective = latency ? "latency" : "total-work";
+  feedback.optimizerCores = latency ? config.cores : 0;
   feedback.complexity = solution.complexity;
   feedback.pError = solution.p_error;
   feedback.globalPError =
@@ -320,7 +359,7 @@ toCompilerSolution(Solution solution, CompilationFeedback &feedback,
   if (auto err = checkPErrorSolution(solution, config); err) {
     return std::move(err);
   }
-  fillFeedback(solution, feedback);
+  fillFeedback(solution, feedback, config);
   return convertSolution(solution);
 }
 
@@ -336,8 +375,17 @@ optimizer::Solution emptySolution() {
 
 llvm::Expected<optimizer::Solution> getSolution(optimizer::Description &descr,
                                                 CompilationFeedback &feedback,
-                                                optimizer::Config config) {
+                                                optimizer::Config config,
+                                                std::string solutionCachePath,
+                                                std::string costProfilePath) {
   namespace chrono = std::chrono;
+  if (!costProfilePath.empty()) {
+    auto profileError = concrete_optimizer::utils::load_cpu_cost_profile(
+        rust::Str(costProfilePath), config.cpu_cost_profile);
+    if (!profileError.empty()) {
+      return StreamStringError(std::string(profileError));
+    }
+  }
   // auto start = chrono::high_resolution_clock::now();
   auto naive_user =
       std::isnan(config.p_error) && std::isnan(config.global_p_error);
@@ -351,6 +399,10 @@ llvm::Expected<optimizer::Solution> getSolution(optimizer::Description &descr,
     // getV1Parameter relies on p-error and if set global-p-error
     config.p_error = config.global_p_error;
   }
+  if (config.objective == concrete_optimizer::Objective::Latency &&
+      config.cores == optimizer::DEFAULT_CORES) {
+    config.cores = std::max(1u, std::thread::hardware_concurrency());
+  }
 
   // This happens for programs without fhe computation
   if (!descr.dag) {
@@ -377,7 +429,10 @@ llvm::Expected<optimizer::Solution> getSolution(optimizer::Description &descr,
     auto encoding = config.encoding;
     if (encoding != concrete_optimizer::Encoding::Crt) {
       config.encoding = concrete_optimizer::Encoding::Native;
-      auto sol = getDagMultiSolution(descr.dag.value(), config);
+      auto sol = solutionCachePath.empty()
+                     ? getDagMultiSolution(descr.dag.value(), config)
+                     : getCachedDagMultiSolution(descr.dag.value(), config,
+                                                 solutionCachePath);
       if (sol.is_feasible || config.composable) {
         displayOptimizer(sol, descr, config);
         return toCompilerSolution(sol, feedback, config);
@@ -385,7 +440,9 @@ llvm::Expected<optimizer::Solution> getSolution(optimizer::Description &descr,
     }
     config.strategy = optimizer::Strategy::DAG_MONO;
     config.encoding = encoding;
-    return getSolution(descr, feedback, config);
+    // The profile is already loaded in the config
+    return getSolution(descr, feedback, config, solutionCachePath,
+                       /*costProfilePath=*/"");
   }
   }
   return StreamStringError("Unknown strategy: ") << config.strategy;
@@ -307,25 +307,41 @@ static mlir::Value flattenTensor(mlir::ImplicitLocOpBuilder &builder,
   }
 }
 
-// Returns a tensor with all the elements of the flat tensor `v`, but
-// shaped as a tensor with the type `targetType`.
+// Returns a tensor with all the elements of the tensor `v`, whose
+// leading dimension has been produced by `flattenTensor`, but shaped
+// as a tensor with the type `targetType`. The last
+// `trailingDimensions` dimensions of `v` are preserved as the last
+// dimensions of `targetType`.
 static mlir::Value unflattenTensor(mlir::ImplicitLocOpBuilder &builder,
                                    mlir::Value v,
-                                   mlir::RankedTensorType targetType) {
+                                   mlir::RankedTensorType targetType,
+                                   unsigned trailingDimensions = 0) {
   mlir::RankedTensorType type = v.getType().dyn_cast<mlir::RankedTensorType>();
-  assert(type && type.getShape().size() == 1 &&
-         "Value is not a tensor of rank 1");
+  assert(type && type.getShape().size() == trailingDimensions + 1 &&
+         "Value is not a tensor with a single leading dimension");
 
-  if (targetType.getShape().size() == 1) {
+  if (targetType.getShape().size() == trailingDimensions + 1) {
     return v;
   } else {
     mlir::ReassociationIndices expandGroup;
+    llvm::SmallVector<mlir::ReassociationIndices> expandGroups;
+    unsigned leadingDimensions =
+        targetType.getShape().size() - trailingDimensions;
 
-    for (unsigned i = 0; i < targetType.getShape().size(); i++)
+    for (unsigned i = 0; i < leadingDimensions; i++)
       expandGroup.push_back(i);
 
-    return builder.create<mlir::tensor::ExpandShapeOp>(
-        targetType, v, llvm::ArrayRef{expandGroup});
+    expandGroups.push_back(expandGroup);
+
+    for (unsigned i = leadingDimensions; i < targetType.getShape().size();
+         i++) {
+      mlir::ReassociationIndices suffixGroup;
+      suffixGroup.push_back(i);
+      expandGroups.push_back(suffixGroup);
+    }
+
+    return builder.create<mlir::tensor::ExpandShapeOp>(targetType, v,
+                                                       expandGroups);
   }
 }
 
@@ -1102,6 +1118,10 @@ int64_t getSliceExtents(IndexedOpTy op, size_t dimIdx) {
   assert(stride > 0 && size > 0 &&
          std::numeric_limits<int64_t>::max() / stride >= size);
 
+  // The stride of a dimension with a single element does not matter
+  if (size == 1)
+    return 1;
+
   return stride * size;
 }
 
@@ -1411,6 +1431,141 @@ operandsToValueSet(llvm::ArrayRef<mlir::OpOperand *> operands) {
   return set;
 }
 
+// Predicate for all values that a batchable operand depends on
+static bool isBatchableOperandProducer(mlir::Value v) {
+  mlir::Operation *definingOp = v.getDefiningOp();
+
+  // Skip operations with regions so that tests always only need to
+  // be performed upwards and never have to descend
+  return (!definingOp ||
+          (mlir::isPure(definingOp) && definingOp->getNumRegions() == 0)) &&
+         !valueIsRegionIterArg(v);
+}
+
+// Predicate for all values that a non-batchable operand depends on
+static bool isNonBatchableOperandProducer(mlir::Value v,
+                                          mlir::scf::ForOp forOp) {
+  mlir::Operation *definingOp = v.getDefiningOp();
+
+  return isHoistable(v, forOp) &&
+         (!definingOp || definingOp->getNumRegions() == 0);
+}
+
+// Splits the static loop `forOp` into a loop over full chunks of
+// `chunkSize` iterations and a remainder loop for the last
+// iterations, e.g., with a chunk size of 4:
+//
+//   %res = scf.for %i = %c1 to %c12 step %c1 iter_args(%arg = %T) {
+//     ...
+//   }
+//
+// becomes:
+//
+//   %chunks = scf.for %ii = %c0 to %c2 step %c1 iter_args(%arg0 = %T) {
+//     %base = ...  // 1 + 4 * %ii
+//     %chunk = scf.for %j = %c0 to %c4 step %c1 iter_args(%arg1 = %arg0) {
+//       %i = arith.addi %base, %j
+//       ...
+//     }
+//     scf.yield %chunk
+//   }
+//   %res = scf.for %i = %c9 to %c12 step %c1 iter_args(%arg = %chunks) {
+//     ...
+//   }
+//
+// The loops over the chunks and over the remainder are static and
+// can thus be batched.
+static void stripMineLoop(mlir::PatternRewriter &rewriter,
+                          mlir::scf::ForOp forOp, int64_t chunkSize) {
+  int64_t lb;
+  int64_t ub;
+  int64_t step;
+
+  bool isStatic = isStaticLoop(forOp, &lb, &ub, &step);
+  assert(isStatic && "Loop must be static");
+  (void)isStatic;
+
+  int64_t tripCount = getStaticTripCount(lb, ub, step);
+  int64_t numChunks = tripCount / chunkSize;
+  int64_t remainderLb = lb + numChunks * chunkSize * step;
+
+  assert(numChunks > 0);
+
+  mlir::scf::YieldOp yield =
+      llvm::cast<mlir::scf::YieldOp>(forOp.getBody()->getTerminator());
+
+  // Clones the body of the original loop at the current insertion
+  // point and returns the values yielded by the clone
+  auto cloneBody = [&](mlir::Value iv, mlir::ValueRange iterArgs) {
+    mlir::IRMapping mapping;
+    mapping.map(forOp.getInductionVar(), iv);
+    mapping.map(forOp.getRegionIterArgs(), iterArgs);
+
+    for (mlir::Operation &op : forOp.getBody()->without_terminator())
+      rewriter.clone(op, mapping);
+
+    return llvm::to_vector(llvm::map_range(
+        yield.getOperands(),
+        [&](mlir::Value v) { return mapping.lookupOrDefault(v); }));
+  };
+
+  rewriter.setInsertionPoint(forOp);
+  mlir::ImplicitLocOpBuilder ilob(forOp.getLoc(), rewriter);
+
+  mlir::Value c0 = ilob.create<mlir::arith::ConstantIndexOp>(0);
+  mlir::Value c1 = ilob.create<mlir::arith::ConstantIndexOp>(1);
+  mlir::Value cNumChunks = ilob.create<mlir::arith::ConstantIndexOp>(numChunks);
+  mlir::Value cChunkSize = ilob.create<mlir::arith::ConstantIndexOp>(chunkSize);
+
+  mlir::scf::ForOp chunksFor = ilob.create<mlir::scf::ForOp>(
+      c0, cNumChunks, c1, forOp.getInitArgs());
+
+  // Returns `v * mul + add`, omitting the neutral operations
+  auto buildAffine = [&](mlir::Value v, int64_t mul,
+                         int64_t add) -> mlir::Value {
+    if (mul != 1)
+      v = ilob.create<mlir::arith::MulIOp>(
+          v, ilob.create<mlir::arith::ConstantIndexOp>(mul));
+    if (add != 0)
+      v = ilob.create<mlir::arith::AddIOp>(
+          v, ilob.create<mlir::arith::ConstantIndexOp>(add));
+    return v;
+  };
+
+  rewriter.setInsertionPointToStart(chunksFor.getBody());
+  mlir::Value base =
+      buildAffine(chunksFor.getInductionVar(), chunkSize * step, lb);
+
+  mlir::scf::ForOp chunkFor = ilob.create<mlir::scf::ForOp>(
+      c0, cChunkSize, c1, chunksFor.getRegionIterArgs());
+
+  rewriter.setInsertionPointToStart(chunkFor.getBody());
+  mlir::Value iv = ilob.create<mlir::arith::AddIOp>(
+      base, buildAffine(chunkFor.getInductionVar(), step, 0));
+  ilob.create<mlir::scf::YieldOp>(
+      cloneBody(iv, chunkFor.getRegionIterArgs()));
+
+  rewriter.setInsertionPointToEnd(chunksFor.getBody());
+  ilob.create<mlir::scf::YieldOp>(chunkFor.getResults());
+
+  rewriter.setInsertionPoint(forOp);
+
+  if (remainderLb >= ub) {
+    rewriter.replaceOp(forOp, chunksFor.getResults());
+    return;
+  }
+
+  mlir::scf::ForOp remainderFor = ilob.create<mlir::scf::ForOp>(
+      ilob.create<mlir::arith::ConstantIndexOp>(remainderLb),
+      forOp.getUpperBound(), forOp.getStep(), chunksFor.getResults());
+
+  rewriter.setInsertionPointToStart(remainderFor.getBody());
+  ilob.create<mlir::scf::YieldOp>(cloneBody(
+      remainderFor.getInductionVar(), remainderFor.getRegionIterArgs()));
+
+  rewriter.replaceOp(forOp, remainderFor.getResults());
+}
+
 /// Pattern that replaces a batchable operation embedded into a static
 /// loop nest with the batched version of the operation, e.g.,
 ///
@@ -1454,9 +1609,10 @@ operandsToValueSet(llvm::ArrayRef<mlir::OpOperand *> operands) {
 class BatchingPattern : public mlir::OpRewritePattern<mlir::func::FuncOp> {
 public:
   BatchingPattern(mlir::MLIRContext *context,
-                  int64_t maxBatchSize = std::numeric_limits<int64_t>::max())
+                  int64_t maxBatchSize = std::numeric_limits<int64_t>::max(),
+                  bool report = false)
       : mlir::OpRewritePattern<mlir::func::FuncOp>(context),
-        maxBatchSize(maxBatchSize) {}
+        maxBatchSize(maxBatchSize), report(report) {}
 
   mlir::LogicalResult
   matchAndRewrite(mlir::func::FuncOp func,
@@ -1485,6 +1641,12 @@ public:
     llvm::DenseSet<mlir::Value> visitedBatched;
     llvm::DenseSet<mlir::Value> visitedNonBatched;
 
+    // Loop of the nest whose trip count exceeds the remaining batch
+    // size budget and that needs to be split into chunks of
+    // `chunkSize` iterations first
+    mlir::scf::ForOp splitFor;
+    int64_t chunkSize = 0;
+
     // Find a batchable op which is embedded into a loop nest
     func.walk([&](BatchableOpInterface scalarOp) {
       // Predicate checking whether an scf.for op is a valid candidate
@@ -1521,34 +1683,10 @@ public:
         llvm::DenseSet<mlir::Value> frontierNonBatched =
             operandsToValueSet(candidateNonBatchableOperands);
 
-        // Predicate for all values that a batchable operand depends
-        // on
-        auto batchableOperandProducerPredicate = [](mlir::Value v) {
-          mlir::Operation *definingOp = v.getDefiningOp();
-
-          // Skip operations with regions so that
-          // tests always only need to be
-          // performed upwards and never have to
-          // descend
-          return (!definingOp || (mlir::isPure(definingOp) &&
-                                  definingOp->getNumRegions() == 0)) &&
-                 !valueIsRegionIterArg(v);
-        };
-
-        // Predicate for all values that a non-batchable operand depends
-        // on
-        auto nonBatchableOperandProducerPredicate = [](mlir::Value v,
-                                                       mlir::scf::ForOp forOp) {
-          mlir::Operation *definingOp = v.getDefiningOp();
-
-          return isHoistable(v, forOp) &&
-                 (!definingOp || definingOp->getNumRegions() == 0);
-        };
-
         // Check that predicates hold for the initial frontiers
-        if (!llvm::all_of(frontierBatched, batchableOperandProducerPredicate) ||
+        if (!llvm::all_of(frontierBatched, isBatchableOperandProducer) ||
             !llvm::all_of(frontierNonBatched, [&](mlir::Value v) {
-              return nonBatchableOperandProducerPredicate(v, innermostFor);
+              return isNonBatchableOperandProducer(v, innermostFor);
             })) {
           continue;
         }
@@ -1567,14 +1705,9 @@ public:
 
           int64_t thisTripCount = getStaticTripCount(forOp);
 
-          if (maxBatchSize / candidateBatchSize < thisTripCount)
-            break;
-          else
-            candidateBatchSize *= thisTripCount;
-
           std::optional<llvm::DenseSet<mlir::Value>> nextFrontierBatched =
               extendFrontier(frontierBatched, candidateVisitedBatched, forOp,
-                             batchableOperandProducerPredicate);
+                             isBatchableOperandProducer);
 
           if (!nextFrontierBatched.has_value())
             break;
@@ -1583,13 +1716,30 @@ public:
           std::optional<llvm::DenseSet<mlir::Value>> nextFrontierNonBatched =
               extendFrontier(frontierNonBatched, candidateVisitedNonBatched,
                              forOp, [&](mlir::Value v) {
-                               return nonBatchableOperandProducerPredicate(
-                                   v, forOp);
+                               return isNonBatchableOperandProducer(v, forOp);
                              });
 
           if (!nextFrontierNonBatched.has_value())
             break;
 
+          // If the loop is too large to be batched entirely, but a
+          // chunk of at least two of its iterations still fits into
+          // the batch, split the loop first and batch the chunks
+          // later
+          if (maxBatchSize / candidateBatchSize < thisTripCount) {
+            int64_t candidateChunkSize = maxBatchSize / candidateBatchSize;
+
+            if (candidateChunkSize < 2)
+              break;
+
+            splitFor = forOp;
+            chunkSize = candidateChunkSize;
+
+            return mlir::WalkResult::interrupt();
+          }
+
+          candidateBatchSize *= thisTripCount;
+
           frontierBatched = nextFrontierBatched.value();
           frontierNonBatched = nextFrontierNonBatched.value();
 
@@ -1621,6 +1771,20 @@ public:
       return mlir::WalkResult::skip();
     });
 
+    if (splitFor) {
+      if (report) {
+        int64_t tripCount = getStaticTripCount(splitFor);
+
+        splitFor->emitRemark()
+            << "split into " << (tripCount / chunkSize) << " chunks of "
+            << chunkSize << " iterations and a remainder of "
+            << (tripCount % chunkSize) << " iterations for batching";
+      }
+
+      stripMineLoop(rewriter, splitFor, chunkSize);
+      return mlir::success();
+    }
+
     // if no suitable batchable operation was found, bail out
     if (!targetOp)
       return mlir::failure();
@@ -1783,27 +1947,33 @@ public:
     mlir::Value batchedResult = targetOp.createBatchedOperation(
         variant, ilob, batchedOperands, hoistedNonBatchableValues);
 
+    if (report) {
+      batchedResult.getDefiningOp()->emitRemark()
+          << "batched " << batchSize << " `" << targetOp->getName()
+          << "` operations";
+    }
+
     mlir::RankedTensorType batchedResultType =
         llvm::dyn_cast<mlir::RankedTensorType>(batchedResult.getType());
 
     assert(batchedResultType);
 
     // Recreate the original shape of the batched results with the
-    // normalized dimensions of the original loop nest
+    // normalized dimensions of the original loop nest, followed by
+    // the dimensions of the results of the original operation
+    unsigned trailingResultDimensions = batchedResultType.getShape().size() - 1;
     llvm::SmallVector<int64_t> structuredBatchedShape = map(
         nest, static_cast<int64_t (*)(mlir::scf::ForOp)>(&getStaticTripCount));
-    if (batchedResultType.getShape().size() > 1) {
-      structuredBatchedShape.push_back(
-          batchedResultType
-              .getShape()[batchedResultType.getShape().size() - 1]);
-    }
+    structuredBatchedShape.append(batchedResultType.getShape().begin() + 1,
+                                  batchedResultType.getShape().end());
 
     mlir::RankedTensorType structuredBatchedResultType =
         mlir::RankedTensorType::get(structuredBatchedShape,
                                     batchedResultType.getElementType());
 
     mlir::Value structuredBatchedResult =
-        unflattenTensor(ilob, batchedResult, structuredBatchedResultType);
+        unflattenTensor(ilob, batchedResult, structuredBatchedResultType,
+                        trailingResultDimensions);
 
     // Replace the original batchable operation with an operation that
     // extracts the respective scalar result from the batch of results
@@ -1813,27 +1983,30 @@ public:
         buildNormalizedIndexes(rewriter, nest);
     rewriter.setInsertionPoint(targetOp);
 
-    if (batchedResultType.getShape().size() == 1) {
+    if (trailingResultDimensions == 0) {
       rewriter.replaceOpWithNewOp<mlir::tensor::ExtractOp>(
           targetOp, structuredBatchedResult, idxUse);
     } else {
+      // Extract the tensor result of the original operation as a
+      // rank-reduced slice of the structured batch of results
       llvm::SmallVector<OpFoldResult> offsets =
           map(idxUse, getValueAsOpFoldResult);
-      llvm::SmallVector<OpFoldResult> strides(1, ilob2.getI64IntegerAttr(1));
-      llvm::SmallVector<OpFoldResult> sizes(1, ilob2.getI64IntegerAttr(1));
+      llvm::SmallVector<OpFoldResult> sizes(idxUse.size(),
+                                            ilob2.getI64IntegerAttr(1));
+      llvm::SmallVector<OpFoldResult> strides(structuredBatchedShape.size(),
+                                              ilob2.getI64IntegerAttr(1));
 
-      offsets.append(batchedResultType.getShape().size() - 1,
-                     ilob2.getI64IntegerAttr(0));
-      strides.append(batchedResultType.getShape().size() - 1,
-                     ilob2.getI64IntegerAttr(1));
+      offsets.append(trailingResultDimensions, ilob2.getI64IntegerAttr(0));
 
-      for (int64_t dim : batchedResultType.getShape().take_front()) {
-        strides.push_back(ilob2.getI64IntegerAttr(dim));
+      for (int64_t dim : batchedResultType.getShape().drop_front())
         sizes.push_back(ilob2.getI64IntegerAttr(dim));
-      }
+
+      mlir::RankedTensorType resultType =
+          targetOp->getResult(0).getType().cast<mlir::RankedTensorType>();
 
       rewriter.replaceOpWithNewOp<mlir::tensor::ExtractSliceOp>(
-          targetOp, batchedResult, offsets, sizes, strides);
+          targetOp, resultType, structuredBatchedResult, offsets, sizes,
+          strides);
     }
 
     return mlir::success();
@@ -1841,6 +2014,7 @@ public:
 
 private:
   int64_t maxBatchSize;
+  bool report;
 };
 
 // Returns a pair containing:
@@ -2477,14 +2651,73 @@ public:
   }
 };
 
+// Returns the reason why the batchable operation `op`, which is
+// still embedded into a loop after batching, could not be batched
+static std::string getNotBatchedReason(BatchableOpInterface op,
+                                       int64_t maxBatchSize) {
+  mlir::scf::ForOp forOp = llvm::cast<mlir::scf::ForOp>(op->getParentOp());
+
+  if (!isStaticLoop(forOp))
+    return "the bounds of the enclosing loop are not static";
+
+  if (op.getNumBatchingVariants() == 0)
+    return "the operation has no batched variant for its operand types";
+
+  bool batchedOperandsOk = false;
+
+  for (unsigned variant = 0; variant < op.getNumBatchingVariants();
+       variant++) {
+    llvm::SmallVector<mlir::OpOperand *> batchableOperands;
+    llvm::SmallVector<mlir::OpOperand *> nonBatchableOperands;
+
+    splitOperands(op, variant, batchableOperands, nonBatchableOperands);
+
+    llvm::DenseSet<mlir::Value> frontierBatched =
+        operandsToValueSet(batchableOperands);
+    llvm::DenseSet<mlir::Value> frontierNonBatched =
+        operandsToValueSet(nonBatchableOperands);
+    llvm::DenseSet<mlir::Value> visitedBatched;
+    llvm::DenseSet<mlir::Value> visitedNonBatched;
+
+    if (!llvm::all_of(frontierBatched, isBatchableOperandProducer) ||
+        !extendFrontier(frontierBatched, visitedBatched, forOp,
+                        isBatchableOperandProducer)
+             .has_value())
+      continue;
+
+    batchedOperandsOk = true;
+
+    if (llvm::all_of(frontierNonBatched,
+                     [&](mlir::Value v) {
+                       return isNonBatchableOperandProducer(v, forOp);
+                     }) &&
+        extendFrontier(frontierNonBatched, visitedNonBatched, forOp,
+                       [&](mlir::Value v) {
+                         return isNonBatchableOperandProducer(v, forOp);
+                       })
+            .has_value()) {
+      return "the trip count of the enclosing loop exceeds the maximum "
+             "batch size of " +
+             std::to_string(maxBatchSize);
+    }
+  }
+
+  if (!batchedOperandsOk)
+    return "the batched operands depend on loop-carried values or on "
+           "operations that are impure or have regions";
+
+  return "the non-batched operands are not loop-invariant";
+}
+
 class BatchingPass : public BatchingBase<BatchingPass> {
 public:
-  BatchingPass(int64_t maxBatchSize) : maxBatchSize(maxBatchSize) {}
+  BatchingPass(int64_t maxBatchSize, bool report)
+      : maxBatchSize(maxBatchSize), report(report) {}
   void runOnOperation() override {
     mlir::Operation *op = getOperation();
 
     mlir::RewritePatternSet patterns(op->getContext());
-    patterns.add<BatchingPattern>(op->getContext(), maxBatchSize);
+    patterns.add<BatchingPattern>(op->getContext(), maxBatchSize, report);
     patterns
         .add<CleanupPattern<mlir::tensor::ExtractOp, mlir::tensor::InsertOp>,
              CleanupPattern<mlir::tensor::ExtractSliceOp,
@@ -2494,15 +2727,29 @@ public:
 
     if (mlir::applyPatternsAndFoldGreedily(op, std::move(patterns)).failed())
       this->signalPassFailure();
+
+    // Report the batchable operations that remain embedded into loops
+    if (report) {
+      op->walk([&](BatchableOpInterface batchableOp) {
+        if (!llvm::isa_and_nonnull<mlir::scf::ForOp>(
+                batchableOp->getParentOp()))
+          return;
+
+        batchableOp->emitRemark()
+            << "not batched: "
+            << getNotBatchedReason(batchableOp, maxBatchSize);
+      });
+    }
   }
 
 private:
   int64_t maxBatchSize;
+  bool report;
 };
 
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
-createBatchingPass(int64_t maxBatchSize) {
-  return std::make_unique<BatchingPass>(maxBatchSize);
+createBatchingPass(int64_t maxBatchSize, bool report) {
+  return std::make_unique<BatchingPass>(maxBatchSize, report);
 }
 
 } // namespace concretelang
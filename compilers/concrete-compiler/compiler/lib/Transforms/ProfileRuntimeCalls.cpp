@@ -0,0 +1,127 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Transforms/Passes.h"
+
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/SymbolTable.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace {
+
+constexpr char profileStart[] = "concrete_profile_start";
+constexpr char profileRecord[] = "concrete_profile_record";
+constexpr char profileDump[] = "concrete_profile_dump";
+
+/// Returns the `file:line:col` of the first file location in `loc`, or its
+/// textual form if it has none.
+std::string getLocationString(mlir::Location loc) {
+  std::string str;
+  loc->walk([&](mlir::Location nested) {
+    if (auto fileLoc = nested.dyn_cast<mlir::FileLineColLoc>()) {
+      str = (fileLoc.getFilename().str() + ":" +
+             std::to_string(fileLoc.getLine()) + ":" +
+             std::to_string(fileLoc.getColumn()));
+      return mlir::WalkResult::interrupt();
+    }
+    return mlir::WalkResult::advance();
+  });
+  if (str.empty()) {
+    llvm::raw_string_ostream os(str);
+    loc.print(os);
+  }
+  return str;
+}
+
+void declareFunction(mlir::ModuleOp module, mlir::OpBuilder &builder,
+                     llvm::StringRef name, mlir::FunctionType type) {
+  if (module.lookupSymbol(name))
+    return;
+  mlir::OpBuilder::InsertionGuard guard(builder);
+  builder.setInsertionPointToStart(module.getBody());
+  auto func =
+      builder.create<mlir::func::FuncOp>(builder.getUnknownLoc(), name, type);
+  func.setPrivate();
+}
+
+/// Returns whether `op` is a call to the runtime or an allocation, i.e., an
+/// operation to profile.
+bool isProfiledOp(mlir::Operation *op, mlir::ModuleOp module) {
+  if (llvm::isa<mlir::memref::AllocOp, mlir::memref::DeallocOp>(op))
+    return true;
+  auto call = llvm::dyn_cast<mlir::func::CallOp>(op);
+  if (!call)
+    return false;
+  auto callee = module.lookupSymbol<mlir::func::FuncOp>(call.getCallee());
+  return callee && callee.isExternal() &&
+         !call.getCallee().startswith("concrete_profile_");
+}
+
+struct ProfileRuntimeCallsPass
+    : public ProfileRuntimeCallsBase<ProfileRuntimeCallsPass> {
+  void runOnOperation() override {
+    auto module = getOperation();
+    mlir::OpBuilder builder(&getContext());
+    auto i64 = builder.getI64Type();
+    auto ptr = mlir::LLVM::LLVMPointerType::get(builder.getI8Type());
+    declareFunction(module, builder, profileStart,
+                    builder.getFunctionType({}, {i64}));
+    declareFunction(module, builder, profileRecord,
+                    builder.getFunctionType({i64, ptr}, {}));
+    declareFunction(module, builder, profileDump,
+                    builder.getFunctionType({}, {}));
+
+    llvm::SmallVector<mlir::Operation *> profiledOps;
+    module.walk([&](mlir::Operation *op) {
+      if (isProfiledOp(op, module))
+        profiledOps.push_back(op);
+    });
+
+    size_t siteId = 0;
+    for (auto op : profiledOps) {
+      auto loc = op->getLoc();
+      std::string opName =
+          llvm::isa<mlir::func::CallOp>(op)
+              ? llvm::cast<mlir::func::CallOp>(op).getCallee().str()
+              : op->getName().getStringRef().str();
+      // The name and the location of the call site are two consecutive
+      // null-terminated strings
+      std::string site = opName + '\0' + getLocationString(loc) + '\0';
+
+      builder.setInsertionPoint(op);
+      auto start = builder.create<mlir::func::CallOp>(
+          loc, profileStart, mlir::TypeRange{i64}, mlir::ValueRange{});
+      builder.setInsertionPointAfter(op);
+      auto siteStr = mlir::LLVM::createGlobalString(
+          loc, builder, "concrete_profile_site_" + std::to_string(siteId++),
+          site, mlir::LLVM::linkage::Linkage::Internal, false);
+      builder.create<mlir::func::CallOp>(
+          loc, profileRecord, mlir::TypeRange{},
+          mlir::ValueRange{start.getResult(0), siteStr});
+    }
+
+    // The calls are dumped at the end of the entry points of the program,
+    // i.e., the public functions that are not referenced in the module
+    module.walk([&](mlir::func::FuncOp func) {
+      if (func.isExternal() || func.isPrivate() ||
+          !mlir::SymbolTable::symbolKnownUseEmpty(func, module))
+        return;
+      func.walk([&](mlir::func::ReturnOp ret) {
+        builder.setInsertionPoint(ret);
+        builder.create<mlir::func::CallOp>(ret.getLoc(), profileDump,
+                                           mlir::TypeRange{},
+                                           mlir::ValueRange{});
+      });
+    });
+  }
+};
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+mlir::concretelang::createProfileRuntimeCallsPass() {
+  return std::make_unique<ProfileRuntimeCallsPass>();
+}
@@ -0,0 +1,106 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Transforms/Passes.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/Operation.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace {
+
+/// A buffer whose lifetime ended in the block being planned: the allocation
+/// and the deallocation which may be removed to reuse it.
+struct FreedBuffer {
+  mlir::memref::AllocOp alloc;
+  mlir::memref::DeallocOp dealloc;
+};
+
+/// Returns the deallocation of a buffer allocated by `alloc`, if the buffer
+/// is deallocated once, in the block of its allocation, and has a static
+/// shape. The lifetime of such a buffer spans the operations between its
+/// allocation and its deallocation in the block, which includes all its uses
+/// and those of its aliases.
+std::optional<mlir::memref::DeallocOp>
+getPlannableDealloc(mlir::memref::AllocOp alloc) {
+  if (!alloc.getType().hasStaticShape() || !alloc.getDynamicSizes().empty() ||
+      !alloc.getSymbolOperands().empty())
+    return std::nullopt;
+
+  std::optional<mlir::memref::DeallocOp> dealloc;
+  for (auto user : alloc.getResult().getUsers()) {
+    if (auto deallocOp = llvm::dyn_cast<mlir::memref::DeallocOp>(user)) {
+      if (dealloc.has_value() || deallocOp->getBlock() != alloc->getBlock())
+        return std::nullopt;
+      dealloc = deallocOp;
+    }
+  }
+  return dealloc;
+}
+
+/// Plans the buffers allocated in a block: a buffer allocated after the
+/// deallocation of another buffer of the same type reuses the latter, whose
+/// deallocation is delayed to the one of the new buffer. Buffers with
+/// non-overlapping lifetimes thus share the same memory, the most recently
+/// freed one being reused first as it is the most likely to still be in
+/// cache.
+void planBlock(mlir::Block &block) {
+  llvm::DenseMap<std::pair<mlir::Type, mlir::Attribute>,
+                 llvm::SmallVector<FreedBuffer>>
+      freedBuffers;
+  // Maps the deallocations of the planned buffers to their allocation.
+  llvm::DenseMap<mlir::Operation *, mlir::memref::AllocOp> plannedDeallocs;
+
+  for (auto &op : llvm::make_early_inc_range(block)) {
+    if (auto alloc = llvm::dyn_cast<mlir::memref::AllocOp>(op)) {
+      auto dealloc = getPlannableDealloc(alloc);
+      if (!dealloc.has_value())
+        continue;
+      auto &candidates = freedBuffers[{alloc.getType(),
+                                       alloc.getAlignmentAttr()}];
+      if (candidates.empty()) {
+        plannedDeallocs[*dealloc] = alloc;
+        continue;
+      }
+      FreedBuffer reused = candidates.pop_back_val();
+      reused.dealloc.erase();
+      alloc.getResult().replaceAllUsesWith(reused.alloc.getResult());
+      alloc.erase();
+      plannedDeallocs[*dealloc] = reused.alloc;
+      continue;
+    }
+
+    if (auto dealloc = llvm::dyn_cast<mlir::memref::DeallocOp>(op)) {
+      auto planned = plannedDeallocs.find(dealloc);
+      if (planned == plannedDeallocs.end())
+        continue;
+      auto alloc = planned->second;
+      freedBuffers[{alloc.getType(), alloc.getAlignmentAttr()}].push_back(
+          {alloc, dealloc});
+      plannedDeallocs.erase(planned);
+      continue;
+    }
+
+    for (auto &region : op.getRegions())
+      for (auto &nestedBlock : region)
+        planBlock(nestedBlock);
+  }
+}
+
+struct StaticMemoryPlanningPass
+    : public StaticMemoryPlanningBase<StaticMemoryPlanningPass> {
+  void runOnOperation() override {
+    for (auto &region : getOperation()->getRegions())
+      for (auto &block : region)
+        planBlock(block);
+  }
+};
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+mlir::concretelang::createStaticMemoryPlanningPass() {
+  return std::make_unique<StaticMemoryPlanningPass>();
+}
@@ -0,0 +1,180 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "concrete-cpu.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace cmdline {
+llvm::cl::opt<std::string> output("o",
+                                  llvm::cl::desc("Path of the cost profile"),
+                                  llvm::cl::value_desc("filename"),
+                                  llvm::cl::init("cost-profile.txt"));
+
+llvm::cl::opt<unsigned>
+    repetitions("repetitions",
+                llvm::cl::desc("Number of measures of each operator, the "
+                               "median is kept"),
+                llvm::cl::init(5));
+
+llvm::cl::opt<unsigned> pbsLweDimension(
+    "pbs-lwe-dimension",
+    llvm::cl::desc("Input lwe dimension of the measured bootstraps"),
+    llvm::cl::init(128));
+
+llvm::cl::opt<unsigned> maxLog2PolynomialSize(
+    "max-log2-polynomial-size",
+    llvm::cl::desc("Log2 of the largest polynomial size of the measured "
+                   "bootstraps"),
+    llvm::cl::init(13));
+
+llvm::cl::opt<unsigned> maxKsLweDimension(
+    "max-ks-lwe-dimension",
+    llvm::cl::desc("Largest input lwe dimension of the measured keyswitches"),
+    llvm::cl::init(8192));
+} // namespace cmdline
+
+using Clock = std::chrono::steady_clock;
+
+/// Returns the median duration of `repetitions` calls of `run`, in
+/// nanoseconds, after a warm up call.
+template <typename Run> double medianNs(Run run) {
+  run();
+  std::vector<double> durations;
+  for (unsigned i = 0; i < cmdline::repetitions; i++) {
+    auto start = Clock::now();
+    run();
+    durations.push_back(
+        std::chrono::duration<double, std::nano>(Clock::now() - start)
+            .count());
+  }
+  std::sort(durations.begin(), durations.end());
+  return durations[durations.size() / 2];
+}
+
+/// Measures a bootstrap of a ciphertext of dimension `lweDimension` with a
+/// key of `level` levels of base 2^`baseLog`. The content of the key and
+/// of the ciphertexts doesn't change the duration, they are left to zero.
+double measureBootstrap(size_t lweDimension, size_t glweDimension,
+                        size_t polynomialSize, size_t level, size_t baseLog) {
+  auto fft = (struct Fft *)aligned_alloc(CONCRETE_FFT_ALIGN, CONCRETE_FFT_SIZE);
+  concrete_cpu_construct_concrete_fft(fft, polynomialSize);
+
+  std::vector<std::complex<double>> bsk(
+      concrete_cpu_fourier_bootstrap_key_size_u64(
+          level, glweDimension, polynomialSize, lweDimension));
+  std::vector<uint64_t> in(lweDimension + 1, 0);
+  std::vector<uint64_t> out(glweDimension * polynomialSize + 1, 0);
+  std::vector<uint64_t> accumulator((glweDimension + 1) * polynomialSize, 0);
+
+  size_t scratchSize, scratchAlign;
+  concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+      &scratchSize, &scratchAlign, glweDimension, polynomialSize, fft);
+  // The size of an aligned allocation must be a multiple of the alignment
+  scratchSize = (scratchSize + scratchAlign - 1) / scratchAlign * scratchAlign;
+  auto scratch = (uint8_t *)aligned_alloc(scratchAlign, scratchSize);
+
+  double duration = medianNs([&]() {
+    concrete_cpu_bootstrap_lwe_ciphertext_u64(
+        out.data(), in.data(), accumulator.data(), bsk.data(), level, baseLog,
+        glweDimension, polynomialSize, lweDimension, fft, scratch,
+        scratchSize);
+  });
+
+  free(scratch);
+  concrete_cpu_destroy_concrete_fft(fft);
+  free(fft);
+  return duration;
+}
+
+/// Measures a keyswitch from `inputDimension` to `outputDimension` with a
+/// key of `level` levels of base 2^`baseLog`.
+double measureKeyswitch(size_t inputDimension, size_t outputDimension,
+                        size_t level, size_t baseLog) {
+  std::vector<uint64_t> ksk(
+      concrete_cpu_keyswitch_key_size_u64(level, inputDimension,
+                                          outputDimension),
+      0);
+  std::vector<uint64_t> in(inputDimension + 1, 0);
+  std::vector<uint64_t> out(outputDimension + 1, 0);
+  return medianNs([&]() {
+    concrete_cpu_keyswitch_lwe_ciphertext_u64(out.data(), in.data(),
+                                              ksk.data(), level, baseLog,
+                                              inputDimension, outputDimension);
+  });
+}
+
+int main(int argc, char **argv) {
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv,
+      "Measures the bootstraps and keyswitches of this host, and writes the "
+      "cost profile correcting the complexity model of the optimizer (see "
+      "concretecompiler --optimizer-cost-profile)\n");
+
+  if (cmdline::repetitions == 0) {
+    llvm::errs() << "The number of repetitions must be positive\n";
+    return 1;
+  }
+
+  std::error_code error;
+  llvm::raw_fd_ostream os(cmdline::output, error, llvm::sys::fs::OF_Text);
+  if (error) {
+    llvm::errs() << "Cannot open " << cmdline::output << ": "
+                 << error.message() << "\n";
+    return 1;
+  }
+
+  os << "# pbs <input_lwe_dimension> <glwe_dimension> <polynomial_size> "
+        "<level> <log2_base> <duration_ns>\n"
+     << "# ks <input_lwe_dimension> <output_lwe_dimension> <level> "
+        "<log2_base> <duration_ns>\n";
+
+  // (level, log2_base) of the measured decompositions
+  const std::vector<std::pair<size_t, size_t>> pbsDecompositions = {{1, 23},
+                                                                    {2, 15}};
+  const std::vector<std::pair<size_t, size_t>> ksDecompositions = {{1, 8},
+                                                                   {3, 4}};
+  const size_t glweDimension = 1;
+
+  for (size_t log2Size = 9; log2Size <= cmdline::maxLog2PolynomialSize;
+       log2Size++) {
+    size_t polynomialSize = (size_t)1 << log2Size;
+    for (auto [level, baseLog] : pbsDecompositions) {
+      double duration =
+          measureBootstrap(cmdline::pbsLweDimension, glweDimension,
+                           polynomialSize, level, baseLog);
+      os << "pbs " << cmdline::pbsLweDimension << " " << glweDimension << " "
+         << polynomialSize << " " << level << " " << baseLog << " "
+         << (uint64_t)duration << "\n";
+      llvm::errs() << "pbs N=" << polynomialSize << " level=" << level
+                   << ": " << (uint64_t)duration << " ns\n";
+    }
+  }
+
+  for (size_t inputDimension = 1024;
+       inputDimension <= cmdline::maxKsLweDimension; inputDimension *= 2) {
+    for (size_t outputDimension : {512, 768}) {
+      for (auto [level, baseLog] : ksDecompositions) {
+        double duration =
+            measureKeyswitch(inputDimension, outputDimension, level, baseLog);
+        os << "ks " << inputDimension << " " << outputDimension << " "
+           << level << " " << baseLog << " " << (uint64_t)duration << "\n";
+        llvm::errs() << "ks n=" << inputDimension << "->" << outputDimension
+                     << " level=" << level << ": " << (uint64_t)duration
+                     << " ns\n";
+      }
+    }
+  }
+  return 0;
+}
@@ -4,6 +4,7 @@
 // for license information.
 
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -24,6 +25,7 @@
 #include "concretelang/Dialect/TFHE/IR/TFHEDialect.h"
 #include "concretelang/Dialect/TFHE/IR/TFHETypes.h"
 #include "concretelang/Runtime/DFRuntime.hpp"
+#include "concretelang/Support/Bench.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "concretelang/Support/Encodings.h"
 #include "concretelang/Support/Error.h"
@@ -40,7 +42,10 @@
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Support/ToolUtilities.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/ToolOutputFile.h"
 
@@ -64,6 +69,7 @@ enum Action {
   DUMP_LLVM_IR,
   DUMP_OPTIMIZED_LLVM_IR,
   COMPILE,
+  BENCH,
 };
 
 namespace cmdline {
@@ -170,7 +176,29 @@ static llvm::cl::opt<enum Action> action(
                                 "dump-optimized-llvm-ir",
                                 "Lower to LLVM-IR, optimize and dump result")),
     llvm::cl::values(clEnumValN(Action::COMPILE, "compile",
-                                "Lower to LLVM-IR, compile to a file")));
+                                "Lower to LLVM-IR, compile to a file")),
+    llvm::cl::values(clEnumValN(Action::BENCH, "bench",
+                                "Compile to a temporary library, run it on "
+                                "random inputs and dump a JSON report of "
+                                "the timings")));
+
+llvm::cl::opt<size_t>
+    benchIterations("bench-iterations",
+                    llvm::cl::desc("Number of measured calls of the circuit "
+                                   "for --action=bench"),
+                    llvm::cl::init(10));
+
+llvm::cl::opt<size_t> benchConcurrency(
+    "bench-concurrency",
+    llvm::cl::desc("Number of concurrent callers of the circuit for the "
+                   "throughput measurement of --action=bench"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<std::string> benchKeysetCache(
+    "bench-keyset-cache",
+    llvm::cl::desc("Directory of the keyset cache for --action=bench. The "
+                   "keyset is generated at each run if empty (default)"),
+    llvm::cl::init(""));
 
 llvm::cl::opt<bool> verifyDiagnostics(
     "verify-diagnostics",
@@ -205,6 +233,42 @@ llvm::cl::opt<int64_t>
                                 "batch for --batch-tfhe-ops"),
                  llvm::cl::init(std::numeric_limits<int64_t>::max()));
 
+llvm::cl::opt<bool> batchingReport(
+    "batching-report",
+    llvm::cl::desc("Emit remarks on the operations batched, the loops split "
+                   "into chunks and the operations left unbatched by "
+                   "--batch-tfhe-ops"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> fuseBatchedOps(
+    "fuse-batched-ops",
+    llvm::cl::desc("Stream the batched leveled operations, keyswitches and "
+                   "bootstraps generated by --batch-tfhe-ops through chunks "
+                   "fitting in the cache"),
+    llvm::cl::init(true));
+
+llvm::cl::opt<uint64_t> fusedBatchCacheSize(
+    "fused-batch-cache-size",
+    llvm::cl::desc("Size in bytes of the cache targeted by "
+                   "--fuse-batched-ops. 0 uses the cache size of the host "
+                   "(default)"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<std::string> runtimeBitcode(
+    "runtime-bitcode",
+    llvm::cl::desc("Link the LLVM bitcode of the leveled runtime operations "
+                   "at the given path into the circuits and optimize them "
+                   "together (e.g. ConcretelangRuntimeLeveled.bc)"),
+    llvm::cl::init(""));
+
+llvm::cl::opt<bool> profileRuntimeCalls(
+    "profile-runtime-calls",
+    llvm::cl::desc("Record the duration of the calls to the runtime and of "
+                   "the allocations, and append them to a Chrome trace in "
+                   "$CONCRETE_PROFILE_OUTPUT at the end of each call of the "
+                   "circuit"),
+    llvm::cl::init(false));
+
 llvm::cl::opt<bool> emitSDFGOps(
     "emit-sdfg-ops",
     llvm::cl::desc(
@@ -223,6 +287,33 @@ llvm::cl::opt<bool> dataflowParallelize(
     llvm::cl::desc("Generate the program as a dataflow graph"),
     llvm::cl::init(false));
 
+llvm::cl::opt<uint64_t> dataflowTaskGranularity(
+    "dataflow-task-granularity",
+    llvm::cl::desc("Target number of programmable bootstraps per dataflow "
+                   "task for --parallelize-dataflow. Smaller tasks are merged "
+                   "and larger linalg generics are split. 0 creates one task "
+                   "per candidate operation (default)"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<bool> staticMemoryPlanning(
+    "static-memory-planning",
+    llvm::cl::desc("Reuse statically-shaped buffers whose lifetimes do not "
+                   "overlap instead of allocating new ones"),
+    llvm::cl::init(true));
+
+llvm::cl::opt<bool> poolCiphertextBuffers(
+    "pool-ciphertext-buffers",
+    llvm::cl::desc("Allocate the ciphertext buffers from the buffer pool of "
+                   "the runtime context instead of malloc"),
+    llvm::cl::init(true));
+
+llvm::cl::opt<bool> lowerMatmulToGemm(
+    "lower-matmul-to-gemm",
+    llvm::cl::desc("Compute encrypted matrix and dot products, and 2D "
+                   "convolutions, with the gemm kernel of the runtime instead "
+                   "of scalar loops"),
+    llvm::cl::init(true));
+
 llvm::cl::opt<std::string>
     funcName("funcname",
              llvm::cl::desc("Name of the function to compile, default 'main'"),
@@ -323,12 +414,48 @@ llvm::cl::opt<concrete_optimizer::Encoding> optimizerEncoding(
     llvm::cl::values(clEnumValN(concrete_optimizer::Encoding::Crt, "crt",
                                 "Chineese Reminder Theorem representation")));
 
+llvm::cl::opt<concrete_optimizer::Objective> optimizerObjective(
+    "optimizer-objective",
+    llvm::cl::desc("Select the cost minimized by the multi parameter "
+                   "optimizer"),
+    llvm::cl::init(optimizer::DEFAULT_OBJECTIVE),
+    llvm::cl::values(clEnumValN(concrete_optimizer::Objective::TotalWork,
+                                "total-work",
+                                "The total work of the circuit, for batch "
+                                "workloads [default]")),
+    llvm::cl::values(clEnumValN(
+        concrete_optimizer::Objective::Latency, "latency",
+        "The latency of the circuit on --optimizer-cores cores, i.e. the "
+        "total work divided by the number of cores plus the work of the "
+        "longest chain of lookup tables")));
+
+llvm::cl::opt<uint64_t> optimizerCores(
+    "optimizer-cores",
+    llvm::cl::desc("Number of cores of the latency objective of the "
+                   "optimizer, the cores of the host if 0 (default)"),
+    llvm::cl::init(optimizer::DEFAULT_CORES));
+
 llvm::cl::opt<bool> optimizerNoCacheOnDisk(
     "optimizer-no-cache-on-disk",
     llvm::cl::desc("Optimizer cache is sync from/to disk. Usefull to debug "
                    "cache issues."),
     llvm::cl::init(false));
 
+llvm::cl::opt<std::string> optimizerSolutionCache(
+    "optimizer-solution-cache",
+    llvm::cl::desc("Directory of the persistent cache of the multi-parameter "
+                   "solutions of the optimizer, keyed on the circuit dag and "
+                   "the optimizer options. Disabled if empty (default)"),
+    llvm::cl::init(""));
+
+llvm::cl::opt<std::string> optimizerCostProfile(
+    "optimizer-cost-profile",
+    llvm::cl::desc("Cost profile of the cpu operators measured on the target "
+                   "host with concrete-cost-calibration, to correct the "
+                   "complexity model of the optimizer. The analytical model "
+                   "is used if empty (default)"),
+    llvm::cl::init(""));
+
 llvm::cl::opt<bool> optimizerAllowComposition(
     "optimizer-allow-composition",
     llvm::cl::desc("Optimizer is parameterized to allow calling the circuit on "
@@ -341,6 +468,20 @@ llvm::cl::list<int64_t> fhelinalgTileSizes(
         "Force tiling of FHELinalg operation with the given tile sizes"),
     llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated);
 
+llvm::cl::opt<bool> fhelinalgAutoTiling(
+    "fhelinalg-auto-tiling",
+    llvm::cl::desc("Tile FHELinalg operations with tile sizes chosen from the "
+                   "ciphertext size, the cache size and the number of "
+                   "threads. Ignored if --fhelinalg-tile-sizes is given"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<uint64_t> fhelinalgTilingCacheSize(
+    "fhelinalg-tiling-cache-size",
+    llvm::cl::desc("Size in bytes of the cache targeted by "
+                   "--fhelinalg-auto-tiling. 0 uses the cache size of the "
+                   "host (default)"),
+    llvm::cl::init(0));
+
 llvm::cl::list<size_t> v0Constraint(
     "v0-constraint",
     llvm::cl::desc(
@@ -412,8 +553,17 @@ cmdlineCompilationOptions() {
   options.autoParallelize = cmdline::autoParallelize;
   options.loopParallelize = cmdline::loopParallelize;
   options.dataflowParallelize = cmdline::dataflowParallelize;
+  options.dataflowTaskGranularity = cmdline::dataflowTaskGranularity;
+  options.staticMemoryPlanning = cmdline::staticMemoryPlanning;
+  options.poolCiphertextBuffers = cmdline::poolCiphertextBuffers;
+  options.lowerMatmulToGemm = cmdline::lowerMatmulToGemm;
   options.batchTFHEOps = cmdline::batchTFHEOps;
   options.maxBatchSize = cmdline::maxBatchSize;
+  options.batchingReport = cmdline::batchingReport;
+  options.fuseBatchedOps = cmdline::fuseBatchedOps;
+  options.fusedBatchCacheSize = cmdline::fusedBatchCacheSize;
+  options.runtimeBitcodePath = cmdline::runtimeBitcode;
+  options.profileRuntimeCalls = cmdline::profileRuntimeCalls;
   options.emitSDFGOps = cmdline::emitSDFGOps;
   options.unrollLoopsWithSDFGConvertibleOps =
       cmdline::unrollLoopsWithSDFGConvertibleOps;
@@ -442,6 +592,8 @@ cmdlineCompilationOptions() {
   // Convert tile sizes to `Optional`
   if (!cmdline::fhelinalgTileSizes.empty())
     options.fhelinalgTileSizes.emplace(cmdline::fhelinalgTileSizes);
+  options.fhelinalgAutoTiling = cmdline::fhelinalgAutoTiling;
+  options.fhelinalgTilingCacheSize = cmdline::fhelinalgTilingCacheSize;
 
   // Setup the v0 parameter options
   if (!cmdline::v0Parameter.empty()) {
@@ -504,6 +656,10 @@ cmdlineCompilationOptions() {
   options.optimizerConfig.encoding = cmdline::optimizerEncoding;
   options.optimizerConfig.cache_on_disk = !cmdline::optimizerNoCacheOnDisk;
   options.optimizerConfig.composable = cmdline::optimizerAllowComposition;
+  options.optimizerConfig.objective = cmdline::optimizerObjective;
+  options.optimizerConfig.cores = cmdline::optimizerCores;
+  options.optimizerSolutionCachePath = cmdline::optimizerSolutionCache;
+  options.optimizerCostProfilePath = cmdline::optimizerCostProfile;
 
   if (!std::isnan(options.optimizerConfig.global_p_error) &&
       options.optimizerConfig.strategy == optimizer::Strategy::V0) {
@@ -614,9 +770,32 @@ mlir::LogicalResult processInputBuffer(
     target = mlir::concretelang::CompilerEngine::Target::OPTIMIZED_LLVM_IR;
     break;
   case Action::COMPILE:
+  case Action::BENCH:
     target = mlir::concretelang::CompilerEngine::Target::LIBRARY;
     break;
   }
+
+  // The benchmarked library is emitted in a temporary directory
+  std::string benchDir;
+  if (action == Action::BENCH) {
+    llvm::SmallString<0> path;
+    if (auto ec = llvm::sys::fs::createUniqueDirectory("concretecompiler-bench",
+                                                       path)) {
+      mlir::concretelang::log_error()
+          << "Cannot create a temporary directory: " << ec.message() << "\n";
+      return mlir::failure();
+    }
+    benchDir = std::string(path);
+    outputLib =
+        std::make_shared<mlir::concretelang::CompilerEngine::Library>(benchDir);
+  }
+  auto removeBenchDir = llvm::make_scope_exit([&]() {
+    if (!benchDir.empty()) {
+      std::error_code ec;
+      std::filesystem::remove_all(benchDir, ec);
+    }
+  });
+
   auto retOrErr = ce.compile(std::move(buffer), target, outputLib);
 
   if (!retOrErr) {
@@ -637,6 +816,27 @@ mlir::LogicalResult processInputBuffer(
   } else if (action == Action::DUMP_LLVM_IR ||
              action == Action::DUMP_OPTIMIZED_LLVM_IR) {
     retOrErr->llvmModule->print(os, nullptr);
+  } else if (action == Action::BENCH) {
+    if (auto err = outputLib->emitArtifacts(
+            /*sharedLib=*/true, /*staticLib=*/false,
+            /*clientParameters=*/true, /*compilationFeedback=*/false)) {
+      mlir::concretelang::log_error() << llvm::toString(std::move(err)) << "\n";
+      return mlir::failure();
+    }
+    mlir::concretelang::BenchOptions benchOptions;
+    benchOptions.circuitName = funcName;
+    benchOptions.iterations = cmdline::benchIterations;
+    benchOptions.concurrency = cmdline::benchConcurrency;
+    benchOptions.keysetCachePath = cmdline::benchKeysetCache;
+    benchOptions.simulate = ce.getCompilationOptions().simulate;
+    auto report = mlir::concretelang::benchLibrary(*outputLib, benchOptions);
+    if (!report) {
+      mlir::concretelang::log_error()
+          << llvm::toString(report.takeError()) << "\n";
+      return mlir::failure();
+    }
+    os << llvm::formatv("{0:2}", llvm::json::Value(std::move(*report)))
+       << "\n";
   } else if (action != Action::COMPILE) {
     retOrErr->mlirModuleRef->get().print(os);
   }
@@ -0,0 +1,96 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "concretelang/Runtime/trace_sink.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+using mlir::concretelang::trace::RecordHeader;
+using mlir::concretelang::trace::RecordKind;
+using mlir::concretelang::trace::TRACE_MAGIC;
+
+namespace cmdline {
+llvm::cl::opt<std::string> input(llvm::cl::Positional,
+                                 llvm::cl::desc("<Binary trace file>"),
+                                 llvm::cl::Required);
+
+llvm::cl::opt<bool>
+    showThreads("show-threads",
+                llvm::cl::desc("Prefix each record with its thread and "
+                               "timestamp in nanoseconds"),
+                llvm::cl::init(false));
+} // namespace cmdline
+
+/// Prints `record` in the format of the synchronous tracing of the runtime.
+void printRecord(const RecordHeader &record, const std::string &message,
+                 llvm::raw_ostream &os) {
+  if (cmdline::showThreads)
+    os << "[" << record.thread << " " << record.timestamp << "] ";
+  if ((RecordKind)record.kind == RecordKind::MESSAGE) {
+    os << message;
+    return;
+  }
+  std::string bitstring = std::bitset<64>(record.value).to_string();
+  if ((RecordKind)record.kind == RecordKind::PLAINTEXT)
+    bitstring.erase(0, 64 - record.width);
+  bitstring.insert(std::min<size_t>(record.msb, bitstring.size()), 1, ' ');
+  os << message << " : " << bitstring << "\n";
+}
+
+int main(int argc, char **argv) {
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Decoder of the binary traces of compiled circuits\n");
+
+  auto buffer = llvm::MemoryBuffer::getFile(cmdline::input);
+  if (!buffer) {
+    llvm::errs() << "Cannot read " << cmdline::input << ": "
+                 << buffer.getError().message() << "\n";
+    return 1;
+  }
+  const char *data = (*buffer)->getBufferStart();
+  size_t size = (*buffer)->getBufferSize();
+  if (size < sizeof(TRACE_MAGIC) ||
+      memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+    llvm::errs() << cmdline::input << " is not a binary trace\n";
+    return 1;
+  }
+
+  std::unordered_map<uint32_t, std::string> strings;
+  std::vector<RecordHeader> records;
+  size_t offset = sizeof(TRACE_MAGIC);
+  while (offset + sizeof(RecordHeader) <= size) {
+    RecordHeader record;
+    memcpy(&record, data + offset, sizeof(RecordHeader));
+    offset += sizeof(RecordHeader);
+    if ((RecordKind)record.kind == RecordKind::STRING) {
+      if (offset + record.length > size)
+        break;
+      strings[record.stringId] = std::string(data + offset, record.length);
+      offset += record.length;
+    } else {
+      records.push_back(record);
+    }
+  }
+  if (offset != size)
+    llvm::errs() << "warning: the trace is truncated\n";
+
+  // The chunks of the threads are interleaved in the file
+  std::stable_sort(records.begin(), records.end(),
+                   [](const RecordHeader &a, const RecordHeader &b) {
+                     return a.timestamp < b.timestamp;
+                   });
+  for (auto &record : records)
+    printRecord(record, strings[record.stringId], llvm::outs());
+  return 0;
+}
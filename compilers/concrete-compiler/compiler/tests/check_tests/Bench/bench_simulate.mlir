@@ -0,0 +1,13 @@
+// RUN: concretecompiler --action=bench --simulate --bench-iterations=3 --bench-concurrency=2 %s | FileCheck %s
+
+// CHECK: "circuit": "main"
+// CHECK: "concurrency": 2
+// CHECK: "executeMs": {
+// CHECK: "p99":
+// CHECK: "iterations": 3
+// CHECK: "simulate": true
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %1 = "FHE.apply_lookup_table"(%arg0, %cst): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
@@ -0,0 +1,21 @@
+// RUN: env CONCRETE_TRACE_FILE=%t concretecompiler --action=bench --simulate --bench-iterations=1 %s
+// RUN: concrete-trace-decoder --show-threads %t | FileCheck %s
+
+// The measured call runs on the main thread, then the throughput call on a
+// caller thread. Each thread defines the messages it uses, the two `step`
+// messages sharing the same identifier.
+// CHECK: [0 {{[0-9]+}}] step
+// CHECK-NEXT: [0 {{[0-9]+}}] lookup
+// CHECK-NEXT: [0 {{[0-9]+}}] step
+// CHECK-NEXT: [1 {{[0-9]+}}] step
+// CHECK-NEXT: [1 {{[0-9]+}}] lookup
+// CHECK-NEXT: [1 {{[0-9]+}}] step
+// CHECK-NOT: step
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  "Tracing.trace_message"() {msg = "step\n"} : () -> ()
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  "Tracing.trace_message"() {msg = "lookup\n"} : () -> ()
+  %1 = "FHE.apply_lookup_table"(%arg0, %cst): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  "Tracing.trace_message"() {msg = "step\n"} : () -> ()
+  return %1: !FHE.eint<3>
+}
@@ -0,0 +1,17 @@
+// RUN: concretecompiler --passes concrete-to-capi --action=dump-llvm-dialect %s 2>&1| FileCheck %s
+
+// The ciphertext batches are passed as 3D memrefs, the lookup table as a 2D
+// memref and the crt decomposition as a 1D global.
+
+// CHECK-DAG: func.func private @memref_batched_wop_pbs_crt_buffer(memref<?x?x?xi64, strided<[?, ?, ?], offset: ?>>, memref<?x?x?xi64, strided<[?, ?, ?], offset: ?>>, memref<?x?xi64, strided<[?, ?], offset: ?>>, memref<?xi64, strided<[?], offset: ?>>, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, !Concrete.context)
+// CHECK-DAG: memref.global "private" constant @[[CRT:[^ ]*]] : memref<5xi64> = dense<[2, 3, 5, 7, 11]>
+// CHECK: func.func @main(%arg0: memref<4x5x2049xi64>, %arg1: memref<5x8192xi64>, %arg2: !Concrete.context) -> memref<4x5x2049xi64> {
+// CHECK: memref.get_global @[[CRT]] : memref<5xi64>
+// CHECK: call @memref_batched_wop_pbs_crt_buffer({{.*}}, %arg2) : (memref<?x?x?xi64, strided<[?, ?, ?], offset: ?>>, memref<?x?x?xi64, strided<[?, ?, ?], offset: ?>>, memref<?x?xi64, strided<[?, ?], offset: ?>>, memref<?xi64, strided<[?], offset: ?>>, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, i32, !Concrete.context) -> ()
+// CHECK-NOT: "Concrete.batched_wop_pbs_crt_lwe_buffer"
+// CHECK: return
+func.func @main(%arg0: memref<4x5x2049xi64>, %arg1: memref<5x8192xi64>, %arg2: !Concrete.context) -> memref<4x5x2049xi64> {
+  %0 = memref.alloc() : memref<4x5x2049xi64>
+  "Concrete.batched_wop_pbs_crt_lwe_buffer"(%0, %arg0, %arg1) {bootstrapBaseLog = 23 : i32, bootstrapLevel = 1 : i32, bskIndex = 0 : i32, circuitBootstrapBaseLog = 9 : i32, circuitBootstrapLevel = 2 : i32, crtDecomposition = [2, 3, 5, 7, 11], keyswitchBaseLog = 4 : i32, keyswitchLevel = 3 : i32, kskIndex = 0 : i32, packingKeySwitchBaseLog = 9 : i32, packingKeySwitchInputLweDimension = 750 : i32, packingKeySwitchLevel = 4 : i32, packingKeySwitchoutputPolynomialSize = 1024 : i32, pkskIndex = 0 : i32} : (memref<4x5x2049xi64>, memref<4x5x2049xi64>, memref<5x8192xi64>) -> ()
+  return %0 : memref<4x5x2049xi64>
+}
@@ -0,0 +1,37 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg --lower-matmul-to-gemm %s 2>&1 | FileCheck %s
+
+// -----
+
+// CHECK:      func.func @main(%[[a0:.*]]: tensor<1x4x8x8x!FHE.eint<6>>, %[[a1:.*]]: tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>> {
+// CHECK-NEXT:   %[[v0:.*]] = "FHELinalg.conv2d"(%[[a0]], %[[a1]]) {{.*}} : (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[v0]] : tensor<1x2x6x6x!FHE.eint<6>>
+// CHECK-NEXT: }
+func.func @main(%x: tensor<1x4x8x8x!FHE.eint<6>>, %w: tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>> {
+  %0 = "FHELinalg.conv2d"(%x, %w) {strides = dense<[1,1]> : tensor<2xi64>, dilations = dense<[1,1]> : tensor<2xi64>, padding = dense<[0,0,0,0]> : tensor<4xi64>} : (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>>
+  return %0 : tensor<1x2x6x6x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK:      func.func @main(%[[a0:.*]]: tensor<1x4x8x8x!FHE.eint<6>>, %[[a1:.*]]: tensor<2x4x3x3xi7>, %[[a2:.*]]: tensor<2xi7>) -> tensor<1x2x6x6x!FHE.eint<6>> {
+// CHECK-NEXT:   %[[v0:.*]] = "FHELinalg.conv2d"(%[[a0]], %[[a1]]) {{.*}} : (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>>
+// CHECK-NEXT:   %[[v1:.*]] = tensor.expand_shape %[[a2]] {{\[\[}}0, 1, 2]] : tensor<2xi7> into tensor<2x1x1xi7>
+// CHECK:        %[[v2:.*]] = linalg.generic {{.*}} ins(%[[v0]], %[[v1]] : tensor<1x2x6x6x!FHE.eint<6>>, tensor<2x1x1xi7>)
+// CHECK:          "FHE.add_eint_int"
+// CHECK:        return %[[v2]] : tensor<1x2x6x6x!FHE.eint<6>>
+func.func @main(%x: tensor<1x4x8x8x!FHE.eint<6>>, %w: tensor<2x4x3x3xi7>, %b: tensor<2xi7>) -> tensor<1x2x6x6x!FHE.eint<6>> {
+  %0 = "FHELinalg.conv2d"(%x, %w, %b) {strides = dense<[1,1]> : tensor<2xi64>, dilations = dense<[1,1]> : tensor<2xi64>, padding = dense<[0,0,0,0]> : tensor<4xi64>} : (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>, tensor<2xi7>) -> tensor<1x2x6x6x!FHE.eint<6>>
+  return %0 : tensor<1x2x6x6x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK:      func.func @main(%[[a0:.*]]: tensor<1x4x8x8x!FHE.eint<6>>, %[[a1:.*]]: tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>> {
+// CHECK-NEXT:   %[[v0:.*]] = "FHELinalg.conv2d"(%[[a0]], %[[a1]]) {{.*}} : (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[v0]] : tensor<1x2x6x6x!FHE.eint<6>>
+// CHECK-NEXT: }
+func.func @main(%x: tensor<1x4x8x8x!FHE.eint<6>>, %w: tensor<2x4x3x3xi7>) -> tensor<1x2x6x6x!FHE.eint<6>> {
+  %b = arith.constant dense<0> : tensor<2xi7>
+  %0 = "FHELinalg.conv2d"(%x, %w, %b) {strides = dense<[1,1]> : tensor<2xi64>, dilations = dense<[1,1]> : tensor<2xi64>, padding = dense<[0,0,0,0]> : tensor<4xi64>} : (tensor<1x4x8x8x!FHE.eint<6>>, tensor<2x4x3x3xi7>, tensor<2xi7>) -> tensor<1x2x6x6x!FHE.eint<6>>
+  return %0 : tensor<1x2x6x6x!FHE.eint<6>>
+}
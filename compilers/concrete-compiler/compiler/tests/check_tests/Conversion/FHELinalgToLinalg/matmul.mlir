@@ -1,4 +1,4 @@
-// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg %s 2>&1 | FileCheck %s
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg --lower-matmul-to-gemm=false %s 2>&1 | FileCheck %s
 
 // -----
 
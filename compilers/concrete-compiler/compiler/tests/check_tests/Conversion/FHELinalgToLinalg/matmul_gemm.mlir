@@ -0,0 +1,27 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg --lower-matmul-to-gemm %s 2>&1 | FileCheck %s
+
+// -----
+
+// CHECK:      func.func @main(%[[a0:.*]]: tensor<3x4x!FHE.eint<5>>, %[[a1:.*]]: tensor<4x2xi6>) -> tensor<3x2x!FHE.eint<5>> {
+// CHECK-NEXT:   %[[v0:.*]] = "FHELinalg.matmul_eint_int"(%[[a0]], %[[a1]]) : (tensor<3x4x!FHE.eint<5>>, tensor<4x2xi6>) -> tensor<3x2x!FHE.eint<5>>
+// CHECK-NEXT:   return %[[v0]] : tensor<3x2x!FHE.eint<5>>
+// CHECK-NEXT: }
+func.func @main(%x: tensor<3x4x!FHE.eint<5>>, %y: tensor<4x2xi6>) -> tensor<3x2x!FHE.eint<5>> {
+  %0 = "FHELinalg.matmul_eint_int"(%x, %y): (tensor<3x4x!FHE.eint<5>>, tensor<4x2xi6>) -> tensor<3x2x!FHE.eint<5>>
+  return %0 : tensor<3x2x!FHE.eint<5>>
+}
+
+// -----
+
+// CHECK:      func.func @main(%[[a0:.*]]: tensor<4x!FHE.eint<5>>, %[[a1:.*]]: tensor<4xi6>) -> !FHE.eint<5> {
+// CHECK-NEXT:   %[[v0:.*]] = tensor.expand_shape %[[a0]] {{\[\[}}0, 1]] : tensor<4x!FHE.eint<5>> into tensor<1x4x!FHE.eint<5>>
+// CHECK-NEXT:   %[[v1:.*]] = tensor.expand_shape %[[a1]] {{\[\[}}0, 1]] : tensor<4xi6> into tensor<4x1xi6>
+// CHECK-NEXT:   %[[v2:.*]] = "FHELinalg.matmul_eint_int"(%[[v0]], %[[v1]]) : (tensor<1x4x!FHE.eint<5>>, tensor<4x1xi6>) -> tensor<1x1x!FHE.eint<5>>
+// CHECK-NEXT:   %[[c0:.*]] = arith.constant 0 : index
+// CHECK-NEXT:   %[[v3:.*]] = tensor.extract %[[v2]][%[[c0]], %[[c0]]] : tensor<1x1x!FHE.eint<5>>
+// CHECK-NEXT:   return %[[v3]] : !FHE.eint<5>
+// CHECK-NEXT: }
+func.func @main(%x: tensor<4x!FHE.eint<5>>, %y: tensor<4xi6>) -> !FHE.eint<5> {
+  %0 = "FHELinalg.dot_eint_int"(%x, %y) : (tensor<4x!FHE.eint<5>>, tensor<4xi6>) -> !FHE.eint<5>
+  return %0 : !FHE.eint<5>
+}
@@ -0,0 +1,12 @@
+// RUN: printf 'pbs 128 1 1024 1 23 2000000\npbs 128 1 4096 1 23 12000000\nks 1024 512 3 4 300000\n' > %t.profile
+// RUN: concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-cost-profile=%t.profile %s | FileCheck %s
+// RUN: printf 'pbs 128 1 1000 1 23 2000000\n' > %t.invalid
+// RUN: not concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-cost-profile=%t.invalid %s 2>&1 | FileCheck %s --check-prefix=INVALID
+
+// CHECK: func.func @main
+// INVALID: line 1: invalid measure `pbs 128 1 1000 1 23 2000000`
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %1 = "FHE.apply_lookup_table"(%arg0, %cst): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
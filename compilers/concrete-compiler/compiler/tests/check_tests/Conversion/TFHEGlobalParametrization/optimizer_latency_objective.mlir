@@ -0,0 +1,9 @@
+// RUN: concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-objective=latency --optimizer-cores=64 --display-optimizer-choice %s 2>&1 | FileCheck %s
+
+// CHECK: --- Complexity for the full circuit, latency on 64 cores
+func.func @main(%arg0: tensor<1024x!FHE.eint<4>>) -> tensor<1024x!FHE.eint<4>> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0]> : tensor<16xi64>
+  %1 = "FHELinalg.apply_lookup_table"(%arg0, %cst): (tensor<1024x!FHE.eint<4>>, tensor<16xi64>) -> (tensor<1024x!FHE.eint<4>>)
+  %2 = "FHELinalg.apply_lookup_table"(%1, %cst): (tensor<1024x!FHE.eint<4>>, tensor<16xi64>) -> (tensor<1024x!FHE.eint<4>>)
+  return %2: tensor<1024x!FHE.eint<4>>
+}
@@ -0,0 +1,16 @@
+// RUN: rm -rf %t.cache
+// RUN: concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-solution-cache=%t.cache %s > %t.computed
+// RUN: ls %t.cache | FileCheck %s --check-prefix=STORED
+// RUN: concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-solution-cache=%t.cache --display-optimizer-choice %s 2>&1 | FileCheck %s --check-prefix=CACHED
+// RUN: concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-solution-cache=%t.cache %s > %t.cached
+// RUN: diff %t.computed %t.cached
+
+// STORED: {{^[0-9a-f]+}}.json
+// CACHED: Optimizer solution found in the cache
+func.func @main(%arg0: !FHE.eint<3>, %arg1: !FHE.eint<6>) -> (!FHE.eint<3>, !FHE.eint<6>) {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %1 = "FHE.apply_lookup_table"(%arg0, %cst): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  %cst2 = arith.constant dense<0> : tensor<64xi64>
+  %2 = "FHE.apply_lookup_table"(%arg1, %cst2): (!FHE.eint<6>, tensor<64xi64>) -> (!FHE.eint<6>)
+  return %1, %2: !FHE.eint<3>, !FHE.eint<6>
+}
@@ -0,0 +1,14 @@
+// RUN: rm -rf %t.cache
+// RUN: concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-solution-cache=%t.cache %s > /dev/null
+// The same circuit in another file, at other lines and with other tables
+// RUN: echo "// Shifts the locations" > %t.other.mlir
+// RUN: sed -e 's/dense<3>/dense<5>/' %s >> %t.other.mlir
+// RUN: concretecompiler --action=dump-parametrized-tfhe --optimizer-strategy=dag-multi --optimizer-solution-cache=%t.cache --display-optimizer-choice %t.other.mlir 2>&1 | FileCheck %s
+
+// CHECK: Optimizer solution found in the cache
+func.func @main(%arg0: tensor<4x!FHE.eint<4>>, %arg1: tensor<4x!FHE.eint<4>>) -> tensor<4x!FHE.eint<4>> {
+  %0 = "FHELinalg.add_eint"(%arg0, %arg1) : (tensor<4x!FHE.eint<4>>, tensor<4x!FHE.eint<4>>) -> tensor<4x!FHE.eint<4>>
+  %cst = arith.constant dense<3> : tensor<16xi64>
+  %1 = "FHELinalg.apply_lookup_table"(%0, %cst) : (tensor<4x!FHE.eint<4>>, tensor<16xi64>) -> tensor<4x!FHE.eint<4>>
+  return %1 : tensor<4x!FHE.eint<4>>
+}
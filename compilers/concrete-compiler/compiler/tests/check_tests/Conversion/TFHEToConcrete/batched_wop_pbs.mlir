@@ -0,0 +1,10 @@
+// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete %s 2>&1| FileCheck %s
+
+// CHECK: func.func @batched_wop_pbs_glwe(%[[A0:.*]]: tensor<4x5x2049xi64>, %[[A1:.*]]: tensor<5x8192xi64>) -> tensor<4x5x2049xi64> {
+// CHECK-NEXT:   %[[V0:.*]] = "Concrete.batched_wop_pbs_crt_lwe_tensor"(%[[A0]], %[[A1]]) {bootstrapBaseLog = 23 : i32, bootstrapLevel = 1 : i32, bskIndex = -1 : i32, circuitBootstrapBaseLog = 9 : i32, circuitBootstrapLevel = 2 : i32, crtDecomposition = [2, 3, 5, 7, 11], keyswitchBaseLog = 4 : i32, keyswitchLevel = 3 : i32, kskIndex = -1 : i32, packingKeySwitchBaseLog = 9 : i32, packingKeySwitchInputLweDimension = 750 : i32, packingKeySwitchLevel = 4 : i32, packingKeySwitchoutputPolynomialSize = 1024 : i32, pkskIndex = -1 : i32} : (tensor<4x5x2049xi64>, tensor<5x8192xi64>) -> tensor<4x5x2049xi64>
+// CHECK-NEXT:   return %[[V0]] : tensor<4x5x2049xi64>
+// CHECK-NEXT: }
+func.func @batched_wop_pbs_glwe(%arg0: tensor<4x5x!TFHE.glwe<sk[1]<1,2048>>>, %arg1: tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk[1]<1,2048>>> {
+  %0 = "TFHE.batched_wop_pbs_glwe"(%arg0, %arg1) {bsk = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, cbsBaseLog = 9 : i32, cbsLevels = 2 : i32, crtDecomposition = [2, 3, 5, 7, 11], ksk = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>, pksk = #TFHE.pksk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 750, 1, 4, 9>} : (tensor<4x5x!TFHE.glwe<sk[1]<1,2048>>>, tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk[1]<1,2048>>>
+  return %0 : tensor<4x5x!TFHE.glwe<sk[1]<1,2048>>>
+}
@@ -0,0 +1,10 @@
+// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete %s 2>&1| FileCheck %s
+
+//CHECK: func.func @conv2d_glwe_int(%[[A0:.*]]: tensor<1x4x8x8x1025xi64>, %[[A1:.*]]: tensor<2x2x3x3xi64>) -> tensor<1x2x3x3x1025xi64> {
+//CHECK:   %[[V0:.*]] = "Concrete.conv2d_cleartext_lwe_tensor"(%[[A0]], %[[A1]]) {dilations = array<i64: 1, 1>, group = 2 : i64, strides = array<i64: 2, 2>} : (tensor<1x4x8x8x1025xi64>, tensor<2x2x3x3xi64>) -> tensor<1x2x3x3x1025xi64>
+//CHECK:   return %[[V0]] : tensor<1x2x3x3x1025xi64>
+//CHECK: }
+func.func @conv2d_glwe_int(%arg0: tensor<1x4x8x8x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<2x2x3x3xi64>) -> tensor<1x2x3x3x!TFHE.glwe<sk[1]<1,1024>>> {
+  %0 = "TFHE.conv2d_glwe_int"(%arg0, %arg1) {strides = array<i64: 2, 2>, dilations = array<i64: 1, 1>, group = 2 : i64} : (tensor<1x4x8x8x!TFHE.glwe<sk[1]<1,1024>>>, tensor<2x2x3x3xi64>) -> (tensor<1x2x3x3x!TFHE.glwe<sk[1]<1,1024>>>)
+  return %0: tensor<1x2x3x3x!TFHE.glwe<sk[1]<1,1024>>>
+}
@@ -0,0 +1,48 @@
+// RUN: concretecompiler --action=dump-std %s 2>&1| FileCheck %s
+
+// The arguments are not writable, so the negation gets a new buffer, in
+// which the next leveled operations are computed in place.
+// CHECK-LABEL: func.func @chain(%arg0: memref<2049xi64{{.*}}>, %arg1: memref<2049xi64{{.*}}>, %arg2: i64{{.*}}) -> memref<2049xi64>
+// CHECK-NEXT:   %[[A:.*]] = memref.alloc(){{.*}} : memref<2049xi64>
+// CHECK-NEXT:   "Concrete.negate_lwe_buffer"(%[[A]], %arg0)
+// CHECK-NEXT:   "Concrete.add_lwe_buffer"(%[[A]], %[[A]], %arg1)
+// CHECK-NEXT:   "Concrete.mul_cleartext_lwe_buffer"(%[[A]], %[[A]], %arg2)
+// CHECK-NEXT:   "Concrete.add_plaintext_lwe_buffer"(%[[A]], %[[A]], %arg2)
+// CHECK-NEXT:   return %[[A]] : memref<2049xi64>
+func.func @chain(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> tensor<2049xi64> {
+  %0 = "Concrete.negate_lwe_tensor"(%arg0) : (tensor<2049xi64>) -> tensor<2049xi64>
+  %1 = "Concrete.add_lwe_tensor"(%0, %arg1) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  %2 = "Concrete.mul_cleartext_lwe_tensor"(%1, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+  %3 = "Concrete.add_plaintext_lwe_tensor"(%2, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+  return %3 : tensor<2049xi64>
+}
+
+// The first operand of the first addition is read afterwards, so its result
+// gets a new buffer instead of overwriting it, while the second addition is
+// computed in place.
+// CHECK-LABEL: func.func @live_operand(%arg0: memref<2049xi64{{.*}}>, %arg1: memref<2049xi64{{.*}}>) -> memref<2049xi64>
+// CHECK-NEXT:   %[[A:.*]] = memref.alloc(){{.*}} : memref<2049xi64>
+// CHECK-NEXT:   "Concrete.negate_lwe_buffer"(%[[A]], %arg0)
+// CHECK-NEXT:   %[[B:.*]] = memref.alloc(){{.*}} : memref<2049xi64>
+// CHECK-NEXT:   "Concrete.add_lwe_buffer"(%[[B]], %[[A]], %arg1)
+// CHECK-NEXT:   "Concrete.add_lwe_buffer"(%[[A]], %[[A]], %[[B]])
+// CHECK-NEXT:   memref.dealloc %[[B]]
+// CHECK-NEXT:   return %[[A]] : memref<2049xi64>
+func.func @live_operand(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>) -> tensor<2049xi64> {
+  %0 = "Concrete.negate_lwe_tensor"(%arg0) : (tensor<2049xi64>) -> tensor<2049xi64>
+  %1 = "Concrete.add_lwe_tensor"(%0, %arg1) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  %2 = "Concrete.add_lwe_tensor"(%0, %1) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  return %2 : tensor<2049xi64>
+}
+
+// Batches are computed in place as well.
+// CHECK-LABEL: func.func @batched(%arg0: memref<4x2049xi64{{.*}}>, %arg1: memref<4x2049xi64{{.*}}>) -> memref<4x2049xi64>
+// CHECK-NEXT:   %[[A:.*]] = memref.alloc(){{.*}} : memref<4x2049xi64>
+// CHECK-NEXT:   "Concrete.batched_negate_lwe_buffer"(%[[A]], %arg0)
+// CHECK-NEXT:   "Concrete.batched_add_lwe_buffer"(%[[A]], %[[A]], %arg1)
+// CHECK-NEXT:   return %[[A]] : memref<4x2049xi64>
+func.func @batched(%arg0: tensor<4x2049xi64>, %arg1: tensor<4x2049xi64>) -> tensor<4x2049xi64> {
+  %0 = "Concrete.batched_negate_lwe_tensor"(%arg0) : (tensor<4x2049xi64>) -> tensor<4x2049xi64>
+  %1 = "Concrete.batched_add_lwe_tensor"(%0, %arg1) : (tensor<4x2049xi64>, tensor<4x2049xi64>) -> tensor<4x2049xi64>
+  return %1 : tensor<4x2049xi64>
+}
@@ -0,0 +1,33 @@
+// RUN: concretecompiler --passes tfhe-to-concrete --passes concrete-fuse-batched-ops --batch-tfhe-ops --fused-batch-cache-size=120000 --action=dump-concrete %s 2>&1| FileCheck %s
+
+// A row of the chain takes 2049 + 1 words of inputs and 2049 + 751 + 2049
+// words of results, so two rows fit in 120000 bytes.
+
+// CHECK:      func.func @main(%[[A0:.*]]: tensor<9x2049xi64>, %[[A1:.*]]: tensor<9xi64>, %[[A2:.*]]: tensor<1024xi64>) -> tensor<9x2049xi64> {
+// CHECK:        %[[INIT:.*]] = tensor.empty() : tensor<9x2049xi64>
+// CHECK-DAG:    %[[C0:.*]] = arith.constant 0 : index
+// CHECK-DAG:    %[[C8:.*]] = arith.constant 8 : index
+// CHECK-DAG:    %[[C2:.*]] = arith.constant 2 : index
+// CHECK:        %[[LOOP:.*]] = scf.for %[[I:.*]] = %[[C0]] to %[[C8]] step %[[C2]] iter_args(%[[ACC:.*]] = %[[INIT]]) -> (tensor<9x2049xi64>) {
+// CHECK-NEXT:     %[[CTS:.*]] = tensor.extract_slice %[[A0]][%[[I]], 0] [2, 2049] [1, 1] : tensor<9x2049xi64> to tensor<2x2049xi64>
+// CHECK-NEXT:     %[[CS:.*]] = tensor.extract_slice %[[A1]][%[[I]]] [2] [1] : tensor<9xi64> to tensor<2xi64>
+// CHECK-NEXT:     %[[MUL:.*]] = "Concrete.batched_mul_cleartext_lwe_tensor"(%[[CTS]], %[[CS]]) : (tensor<2x2049xi64>, tensor<2xi64>) -> tensor<2x2049xi64>
+// CHECK-NEXT:     %[[KS:.*]] = "Concrete.batched_keyswitch_lwe_tensor"(%[[MUL]]) {{.*}} : (tensor<2x2049xi64>) -> tensor<2x751xi64>
+// CHECK-NEXT:     %[[BS:.*]] = "Concrete.batched_bootstrap_lwe_tensor"(%[[KS]], %[[A2]]) {{.*}} : (tensor<2x751xi64>, tensor<1024xi64>) -> tensor<2x2049xi64>
+// CHECK-NEXT:     %[[INS:.*]] = tensor.insert_slice %[[BS]] into %[[ACC]][%[[I]], 0] [2, 2049] [1, 1] : tensor<2x2049xi64> into tensor<9x2049xi64>
+// CHECK-NEXT:     scf.yield %[[INS]] : tensor<9x2049xi64>
+// CHECK-NEXT:   }
+// CHECK-NEXT:   %[[LCTS:.*]] = tensor.extract_slice %[[A0]][8, 0] [1, 2049] [1, 1] : tensor<9x2049xi64> to tensor<1x2049xi64>
+// CHECK-NEXT:   %[[LCS:.*]] = tensor.extract_slice %[[A1]][8] [1] [1] : tensor<9xi64> to tensor<1xi64>
+// CHECK-NEXT:   %[[LMUL:.*]] = "Concrete.batched_mul_cleartext_lwe_tensor"(%[[LCTS]], %[[LCS]]) : (tensor<1x2049xi64>, tensor<1xi64>) -> tensor<1x2049xi64>
+// CHECK-NEXT:   %[[LKS:.*]] = "Concrete.batched_keyswitch_lwe_tensor"(%[[LMUL]]) {{.*}} : (tensor<1x2049xi64>) -> tensor<1x751xi64>
+// CHECK-NEXT:   %[[LBS:.*]] = "Concrete.batched_bootstrap_lwe_tensor"(%[[LKS]], %[[A2]]) {{.*}} : (tensor<1x751xi64>, tensor<1024xi64>) -> tensor<1x2049xi64>
+// CHECK-NEXT:   %[[RES:.*]] = tensor.insert_slice %[[LBS]] into %[[LOOP]][8, 0] [1, 2049] [1, 1] : tensor<1x2049xi64> into tensor<9x2049xi64>
+// CHECK-NEXT:   return %[[RES]] : tensor<9x2049xi64>
+// CHECK-NEXT: }
+func.func @main(%arg0: tensor<9x!TFHE.glwe<sk[1]<1,2048>>>, %arg1: tensor<9xi64>, %arg2: tensor<1024xi64>) -> tensor<9x!TFHE.glwe<sk[1]<1,2048>>> {
+  %0 = "TFHE.batched_mul_glwe_int"(%arg0, %arg1) : (tensor<9x!TFHE.glwe<sk[1]<1,2048>>>, tensor<9xi64>) -> tensor<9x!TFHE.glwe<sk[1]<1,2048>>>
+  %1 = "TFHE.batched_keyswitch_glwe"(%0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (tensor<9x!TFHE.glwe<sk[1]<1,2048>>>) -> tensor<9x!TFHE.glwe<sk[2]<1,750>>>
+  %2 = "TFHE.batched_bootstrap_glwe"(%1, %arg2) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>} : (tensor<9x!TFHE.glwe<sk[2]<1,750>>>, tensor<1024xi64>) -> tensor<9x!TFHE.glwe<sk[1]<1,2048>>>
+  return %2 : tensor<9x!TFHE.glwe<sk[1]<1,2048>>>
+}
@@ -0,0 +1,42 @@
+// RUN: concretecompiler --passes concrete-fuse-leveled-ops --action=dump-concrete %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @product_rhs(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> tensor<2049xi64>
+// CHECK-NEXT:   %[[V0:.*]] = "Concrete.mul_cleartext_add_lwe_tensor"(%arg0, %arg1, %arg2) : (tensor<2049xi64>, tensor<2049xi64>, i64) -> tensor<2049xi64>
+// CHECK-NEXT:   return %[[V0]] : tensor<2049xi64>
+func.func @product_rhs(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> tensor<2049xi64> {
+  %0 = "Concrete.mul_cleartext_lwe_tensor"(%arg1, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+  %1 = "Concrete.add_lwe_tensor"(%arg0, %0) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  return %1 : tensor<2049xi64>
+}
+
+// CHECK-LABEL: func.func @product_lhs(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> tensor<2049xi64>
+// CHECK-NEXT:   %[[V0:.*]] = "Concrete.mul_cleartext_add_lwe_tensor"(%arg0, %arg1, %arg2) : (tensor<2049xi64>, tensor<2049xi64>, i64) -> tensor<2049xi64>
+// CHECK-NEXT:   return %[[V0]] : tensor<2049xi64>
+func.func @product_lhs(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> tensor<2049xi64> {
+  %0 = "Concrete.mul_cleartext_lwe_tensor"(%arg1, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+  %1 = "Concrete.add_lwe_tensor"(%0, %arg0) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  return %1 : tensor<2049xi64>
+}
+
+// A dot product accumulates all its products
+// CHECK-LABEL: func.func @dot(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64, %arg3: i64) -> tensor<2049xi64>
+// CHECK-NEXT:   %[[V0:.*]] = "Concrete.mul_cleartext_lwe_tensor"(%arg0, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+// CHECK-NEXT:   %[[V1:.*]] = "Concrete.mul_cleartext_add_lwe_tensor"(%[[V0]], %arg1, %arg3) : (tensor<2049xi64>, tensor<2049xi64>, i64) -> tensor<2049xi64>
+// CHECK-NEXT:   return %[[V1]] : tensor<2049xi64>
+func.func @dot(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64, %arg3: i64) -> tensor<2049xi64> {
+  %0 = "Concrete.mul_cleartext_lwe_tensor"(%arg0, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+  %1 = "Concrete.mul_cleartext_lwe_tensor"(%arg1, %arg3) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+  %2 = "Concrete.add_lwe_tensor"(%0, %1) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  return %2 : tensor<2049xi64>
+}
+
+// A product with other uses is still needed, and is not fused
+// CHECK-LABEL: func.func @shared_product(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> (tensor<2049xi64>, tensor<2049xi64>)
+// CHECK-NEXT:   %[[V0:.*]] = "Concrete.mul_cleartext_lwe_tensor"(%arg1, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+// CHECK-NEXT:   %[[V1:.*]] = "Concrete.add_lwe_tensor"(%arg0, %[[V0]]) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+// CHECK-NEXT:   return %[[V1]], %[[V0]] : tensor<2049xi64>, tensor<2049xi64>
+func.func @shared_product(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> (tensor<2049xi64>, tensor<2049xi64>) {
+  %0 = "Concrete.mul_cleartext_lwe_tensor"(%arg1, %arg2) : (tensor<2049xi64>, i64) -> tensor<2049xi64>
+  %1 = "Concrete.add_lwe_tensor"(%arg0, %0) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  return %1, %0 : tensor<2049xi64>, tensor<2049xi64>
+}
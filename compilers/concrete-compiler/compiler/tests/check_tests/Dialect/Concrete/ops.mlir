@@ -29,6 +29,15 @@ func.func @mul_cleartext_lwe_ciphertext(%arg0: tensor<2049xi64>, %arg1: i64) ->
   return %0 : tensor<2049xi64>
 }
 
+//CHECK: func.func @mul_cleartext_add_lwe_ciphertext(%[[A0:.*]]: tensor<2049xi64>, %[[A1:.*]]: tensor<2049xi64>, %[[A2:.*]]: i64) -> tensor<2049xi64> {
+//CHECK:   %[[V0:.*]] = "Concrete.mul_cleartext_add_lwe_tensor"(%[[A0]], %[[A1]], %[[A2]]) : (tensor<2049xi64>, tensor<2049xi64>, i64) -> tensor<2049xi64>
+//CHECK:   return %[[V0]] : tensor<2049xi64>
+//CHECK: }
+func.func @mul_cleartext_add_lwe_ciphertext(%arg0: tensor<2049xi64>, %arg1: tensor<2049xi64>, %arg2: i64) -> tensor<2049xi64> {
+  %0 = "Concrete.mul_cleartext_add_lwe_tensor"(%arg0, %arg1, %arg2) : (tensor<2049xi64>, tensor<2049xi64>, i64) -> (tensor<2049xi64>)
+  return %0 : tensor<2049xi64>
+}
+
 //CHECK: func.func @negate_lwe_ciphertext(%[[A0:.*]]: tensor<2049xi64>) -> tensor<2049xi64> {
 //CHECK:   %[[V0:.*]] = "Concrete.negate_lwe_tensor"(%[[A0]]) : (tensor<2049xi64>) -> tensor<2049xi64>
 //CHECK:   return %[[V0]] : tensor<2049xi64>
@@ -173,3 +173,15 @@ func.func @concat(%arg0: tensor<4x!FHE.eint<7>>, %arg1:tensor<5x!FHE.eint<7>>, %
 
   return %9 : tensor<3x!FHE.eint<7>>
 }
+
+// -----
+
+func.func @large_sum(%arg0: tensor<256x1024x!FHE.eint<7>>) -> tensor<1024x!FHE.eint<7>> {
+  // CHECK: MANP = 512 : ui{{[0-9]+}}
+  %1 = "FHELinalg.sum"(%arg0) : (tensor<256x1024x!FHE.eint<7>>) -> !FHE.eint<7>
+
+  // CHECK: MANP = 16 : ui{{[0-9]+}}
+  %2 = "FHELinalg.sum"(%arg0) { axes = [0] } : (tensor<256x1024x!FHE.eint<7>>) -> tensor<1024x!FHE.eint<7>>
+
+  return %2 : tensor<1024x!FHE.eint<7>>
+}
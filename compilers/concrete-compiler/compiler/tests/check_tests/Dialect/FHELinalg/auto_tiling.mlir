@@ -0,0 +1,27 @@
+// RUN: concretecompiler --action=dump-fhe --fhelinalg-auto-tiling --fhelinalg-tiling-cache-size=100000 --v0-parameter=2,10,750,1,23,3,4 %s 2>&1 --split-input-file | FileCheck %s
+
+// Ciphertexts take 16392 bytes, so at most 6 of them fit in the cache:
+// the largest tile keeps a single row of the encrypted matrix.
+
+// CHECK:      func.func @tiled_rows(%[[Varg0:.*]]: tensor<8x4x!FHE.eint<6>>, %[[Varg1:.*]]: tensor<4x2xi7>) -> tensor<8x2x!FHE.eint<6>> {
+// CHECK:        scf.for %[[Varg2:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args
+// CHECK:          tensor.extract_slice %[[Varg0]][%[[Varg2]], %{{.*}}] [1, 4] [1, 1] : tensor<8x4x!FHE.eint<6>> to tensor<1x4x!FHE.eint<6>>
+// CHECK:          tensor.extract_slice %[[Varg1]][%{{.*}}, %{{.*}}] [4, 2] [1, 1] : tensor<4x2xi7> to tensor<4x2xi7>
+// CHECK:          "FHELinalg.matmul_eint_int"(%{{.*}}, %{{.*}}) : (tensor<1x4x!FHE.eint<6>>, tensor<4x2xi7>) -> tensor<1x2x!FHE.eint<6>>
+func.func @tiled_rows(%a: tensor<8x4x!FHE.eint<6>>, %b: tensor<4x2xi7>) -> tensor<8x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) : (tensor<8x4x!FHE.eint<6>>, tensor<4x2xi7>) -> tensor<8x2x!FHE.eint<6>>
+  return %0 : tensor<8x2x!FHE.eint<6>>
+}
+
+// -----
+
+// The whole multiplication fits in the cache and is left untiled.
+
+// CHECK:      func.func @untiled(%[[Varg0:.*]]: tensor<2x2x!FHE.eint<6>>, %[[Varg1:.*]]: tensor<2x1xi7>) -> tensor<2x1x!FHE.eint<6>> {
+// CHECK-NEXT:   %[[V0:.*]] = "FHELinalg.matmul_eint_int"(%[[Varg0]], %[[Varg1]]) : (tensor<2x2x!FHE.eint<6>>, tensor<2x1xi7>) -> tensor<2x1x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[V0]] : tensor<2x1x!FHE.eint<6>>
+// CHECK-NEXT: }
+func.func @untiled(%a: tensor<2x2x!FHE.eint<6>>, %b: tensor<2x1xi7>) -> tensor<2x1x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) : (tensor<2x2x!FHE.eint<6>>, tensor<2x1xi7>) -> tensor<2x1x!FHE.eint<6>>
+  return %0 : tensor<2x1x!FHE.eint<6>>
+}
@@ -0,0 +1,30 @@
+// RUN: concretecompiler --action=dump-llvm-dialect %s 2>&1| FileCheck %s
+// RUN: concretecompiler --action=dump-llvm-dialect --pool-ciphertext-buffers=false %s 2>&1| FileCheck %s --check-prefix=NOPOOL
+
+// The temporary ciphertexts come from the buffer pool of the runtime
+// context, while the returned one is left to malloc as the client frees it.
+
+// CHECK-LABEL: llvm.func @main
+// CHECK: llvm.call @memref_pool_alloc_u64(
+// CHECK: llvm.call @memref_keyswitch_lwe_u64(
+// CHECK: llvm.call @memref_pool_alloc_u64(
+// CHECK: llvm.call @memref_bootstrap_lwe_u64(
+// CHECK: llvm.call @memref_keyswitch_lwe_u64(
+// CHECK: llvm.call @memref_pool_free_u64(
+// CHECK: llvm.call @{{(malloc|aligned_alloc)}}(
+// CHECK: llvm.call @memref_bootstrap_lwe_u64(
+// CHECK: llvm.call @memref_pool_free_u64(
+// CHECK-NOT: llvm.call @memref_pool_
+// CHECK: llvm.return
+
+// NOPOOL-LABEL: llvm.func @main
+// NOPOOL-NOT: memref_pool_
+// NOPOOL: llvm.return
+func.func @main(%arg0: tensor<1025xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 576 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %2 = "Concrete.keyswitch_lwe_tensor"(%1) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %3 = "Concrete.bootstrap_lwe_tensor"(%2, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 576 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %3 : tensor<1025xi64>
+}
@@ -0,0 +1,62 @@
+// RUN: concretecompiler --action=dump-tfhe --optimizer-strategy=dag-mono --parallelize-dataflow --dataflow-task-granularity=2 --passes BuildDataflowTaskGraph %s 2>&1 | FileCheck %s
+// RUN: concretecompiler --action=dump-tfhe --optimizer-strategy=dag-mono --parallelize-dataflow --passes BuildDataflowTaskGraph %s 2>&1 | FileCheck %s --check-prefix=STRUCT
+
+#map = affine_map<(d0) -> (d0)>
+
+// Lookup tables are merged by pairs to reach the granularity
+
+// CHECK-LABEL: func.func @merge
+// CHECK:        %[[T0:.*]]:2 = "RT.dataflow_task"(%arg0, %arg1) ({
+// CHECK-COUNT-2:  "FHE.apply_lookup_table"
+// CHECK-NOT:      "FHE.apply_lookup_table"
+// CHECK:          "RT.dataflow_yield"
+// CHECK:        %[[T1:.*]]:2 = "RT.dataflow_task"(%arg2, %arg3) ({
+// CHECK-COUNT-2:  "FHE.apply_lookup_table"
+// CHECK-NOT:      "FHE.apply_lookup_table"
+// CHECK:          "RT.dataflow_yield"
+// CHECK-NOT:    "RT.dataflow_task"
+// CHECK:        return %[[T0]]#0, %[[T0]]#1, %[[T1]]#0, %[[T1]]#1
+
+// Without granularity, each lookup table is a task of its own
+
+// STRUCT-LABEL:  func.func @merge
+// STRUCT-COUNT-4: "RT.dataflow_task"
+// STRUCT-NOT:     "RT.dataflow_task"
+// STRUCT-LABEL:  func.func @split
+func.func @merge(%arg0: !FHE.eint<3>, %arg1: !FHE.eint<3>, %arg2: !FHE.eint<3>, %arg3: !FHE.eint<3>) -> (!FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>) {
+  %cst = arith.constant dense<[0, 1, 4, 1, 6, 5, 4, 1]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  %1 = "FHE.apply_lookup_table"(%arg1, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  %2 = "FHE.apply_lookup_table"(%arg2, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  %3 = "FHE.apply_lookup_table"(%arg3, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  return %0, %1, %2, %3 : !FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>
+}
+
+// The generic of 4 bootstraps is split in 2 tasks of 2 bootstraps
+
+// CHECK-LABEL: func.func @split
+// CHECK:        %[[IN0:.*]] = tensor.extract_slice %arg0[0] [2] [1] : tensor<4x!FHE.eint<3>> to tensor<2x!FHE.eint<3>>
+// CHECK:        %[[T0:.*]] = "RT.dataflow_task"({{.*}}) ({
+// CHECK:          linalg.generic {{.*}} ins(%[[IN0]] : tensor<2x!FHE.eint<3>>)
+// CHECK:          "RT.dataflow_yield"
+// CHECK:        %[[IN1:.*]] = tensor.extract_slice %arg0[2] [2] [1] : tensor<4x!FHE.eint<3>> to tensor<2x!FHE.eint<3>>
+// CHECK:        %[[T1:.*]] = "RT.dataflow_task"({{.*}}) ({
+// CHECK:          linalg.generic {{.*}} ins(%[[IN1]] : tensor<2x!FHE.eint<3>>)
+// CHECK:          "RT.dataflow_yield"
+// CHECK-NOT:    "RT.dataflow_task"
+// CHECK:        %[[R0:.*]] = tensor.insert_slice %[[T0]] into %{{.*}}[0] [2] [1]
+// CHECK:        %[[R1:.*]] = tensor.insert_slice %[[T1]] into %[[R0]][2] [2] [1]
+// CHECK:        return %[[R1]]
+
+// STRUCT:        "RT.dataflow_task"
+// STRUCT-NOT:    "RT.dataflow_task"
+func.func @split(%arg0: tensor<4x!FHE.eint<3>>) -> tensor<4x!FHE.eint<3>> {
+  %cst = arith.constant dense<[0, 1, 4, 1, 6, 5, 4, 1]> : tensor<8xi64>
+  %init = "FHE.zero_tensor"() : () -> tensor<4x!FHE.eint<3>>
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel"]} ins(%arg0 : tensor<4x!FHE.eint<3>>) outs(%init : tensor<4x!FHE.eint<3>>) {
+  ^bb0(%in: !FHE.eint<3>, %out: !FHE.eint<3>):
+    %1 = "FHE.apply_lookup_table"(%in, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+    linalg.yield %1 : !FHE.eint<3>
+  } -> tensor<4x!FHE.eint<3>>
+  return %0 : tensor<4x!FHE.eint<3>>
+}
@@ -0,0 +1,50 @@
+// RUN: rm -rf %t && concretecompiler --action=compile -o %t %s
+// RUN: FileCheck %s --input-file=%t/compilation_feedback.json
+
+// The iterations of the first loop bootstrap distinct elements of the loop
+// carried tensor, and run along the first iteration of the nested loops,
+// which bootstrap the loop carried scalar 6 times in a row, and along the
+// iterations of the last loops, nested as in the lowering of the
+// multi-dimensional elementwise operations, which bootstrap distinct
+// elements.
+// CHECK: "pbsCriticalPath": 6,
+// CHECK: "pbsWidthProfile": [
+// CHECK-NEXT: 17,
+// CHECK-NEXT: 1,
+// CHECK-NEXT: 1,
+// CHECK-NEXT: 1,
+// CHECK-NEXT: 1,
+// CHECK-NEXT: 1
+// CHECK-NEXT: ],
+func.func @main(%arg0: tensor<4x!FHE.eint<3>>, %arg1: !FHE.eint<3>, %arg2: tensor<3x4x!FHE.eint<3>>) -> (tensor<4x!FHE.eint<3>>, !FHE.eint<3>, tensor<3x4x!FHE.eint<3>>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c3 = arith.constant 3 : index
+  %c4 = arith.constant 4 : index
+  %cst = arith.constant dense<[0, 1, 4, 1, 6, 5, 4, 1]> : tensor<8xi64>
+  %0 = scf.for %i = %c0 to %c4 step %c1 iter_args(%t = %arg0) -> (tensor<4x!FHE.eint<3>>) {
+    %e = tensor.extract %t[%i] : tensor<4x!FHE.eint<3>>
+    %l = "FHE.apply_lookup_table"(%e, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+    %u = tensor.insert %l into %t[%i] : tensor<4x!FHE.eint<3>>
+    scf.yield %u : tensor<4x!FHE.eint<3>>
+  }
+  %1 = scf.for %i = %c0 to %c2 step %c1 iter_args(%a = %arg1) -> (!FHE.eint<3>) {
+    %2 = scf.for %j = %c0 to %c3 step %c1 iter_args(%b = %a) -> (!FHE.eint<3>) {
+      %l = "FHE.apply_lookup_table"(%b, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+      scf.yield %l : !FHE.eint<3>
+    }
+    scf.yield %2 : !FHE.eint<3>
+  }
+  %init = "FHE.zero_tensor"() : () -> tensor<3x4x!FHE.eint<3>>
+  %3 = scf.for %i = %c0 to %c3 step %c1 iter_args(%a = %init) -> (tensor<3x4x!FHE.eint<3>>) {
+    %4 = scf.for %j = %c0 to %c4 step %c1 iter_args(%b = %a) -> (tensor<3x4x!FHE.eint<3>>) {
+      %e = tensor.extract %arg2[%i, %j] : tensor<3x4x!FHE.eint<3>>
+      %l = "FHE.apply_lookup_table"(%e, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+      %u = tensor.insert %l into %b[%i, %j] : tensor<3x4x!FHE.eint<3>>
+      scf.yield %u : tensor<3x4x!FHE.eint<3>>
+    }
+    scf.yield %4 : tensor<3x4x!FHE.eint<3>>
+  }
+  return %0, %1, %3 : tensor<4x!FHE.eint<3>>, !FHE.eint<3>, tensor<3x4x!FHE.eint<3>>
+}
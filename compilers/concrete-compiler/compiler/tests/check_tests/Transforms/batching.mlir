@@ -325,3 +325,24 @@ func.func @apply_lookup_table_contiguous_hoistable_nonbatchable(%arg0: tensor<2x
   }
   return %1 : tensor<2x3x4x!TFHE.glwe<sk<0,1,2048>>>
 }
+
+// -----
+
+// CHECK-LABEL: func.func @batch_wop_pbs
+// CHECK: (%arg0: tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK:.*]]{{\]}}<1,2048>>>, %arg1: tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>> {
+// CHECK: %[[V0:.*]] = "TFHE.batched_wop_pbs_glwe"(%arg0, %arg1) {{.*}} : (tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>>, tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK]]{{\]}}<1,2048>>>
+// CHECK-NOT: "TFHE.wop_pbs_glwe"
+// CHECK: return %[[V0]]
+func.func @batch_wop_pbs(%arg0: tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>, %arg1: tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk<0,1,2048>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %0 = bufferization.alloc_tensor() : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+  %1 = scf.for %arg2 = %c0 to %c4 step %c1 iter_args(%arg3 = %0) -> (tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>) {
+    %2 = tensor.extract_slice %arg0[%arg2, 0] [1, 5] [1, 1] : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>> to tensor<5x!TFHE.glwe<sk<0,1,2048>>>
+    %3 = "TFHE.wop_pbs_glwe"(%2, %arg1) {bsk = #TFHE.bsk<sk<1,1,750>, sk<0,1,2048>, 1024, 2, 1, 23>, cbsBaseLog = 9 : i32, cbsLevels = 2 : i32, crtDecomposition = [2, 3, 5, 7, 11], ksk = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>, pksk = #TFHE.pksk<sk<1,1,750>, sk<0,1,2048>, 1024, 750, 1, 4, 9>} : (tensor<5x!TFHE.glwe<sk<0,1,2048>>>, tensor<5x8192xi64>) -> tensor<5x!TFHE.glwe<sk<0,1,2048>>>
+    %4 = tensor.insert_slice %3 into %arg3[%arg2, 0] [1, 5] [1, 1] : tensor<5x!TFHE.glwe<sk<0,1,2048>>> into tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+    scf.yield %4 : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+  }
+  return %1 : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+}
@@ -0,0 +1,46 @@
+// RUN: concretecompiler --split-input-file --action=dump-batched-tfhe --batch-tfhe-ops --max-batch-size=4 %s 2>&1| FileCheck %s
+// RUN: concretecompiler --split-input-file --verify-diagnostics --action=dump-batched-tfhe --batch-tfhe-ops --max-batch-size=4 --batching-report %s
+
+// CHECK-LABEL: func.func @batch_partial_keyswitch
+// CHECK: scf.for %{{.*}} = %c0 to %c2 step %c1
+// CHECK: "TFHE.batched_keyswitch_glwe"({{.*}}) {{.*}} : (tensor<4x!TFHE.glwe<{{.*}}>>) -> tensor<4x!TFHE.glwe<{{.*}}>>
+// CHECK: scf.yield
+// CHECK: "TFHE.batched_keyswitch_glwe"({{.*}}) {{.*}} : (tensor<2x!TFHE.glwe<{{.*}}>>) -> tensor<2x!TFHE.glwe<{{.*}}>>
+// CHECK: return
+func.func @batch_partial_keyswitch(%arg0: tensor<10x!TFHE.glwe<sk<0,1,2048>>>) -> tensor<10x!TFHE.glwe<sk<1,1,750>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c10 = arith.constant 10 : index
+
+  %0 = bufferization.alloc_tensor() : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+  // expected-remark@+3 {{split into 2 chunks of 4 iterations and a remainder of 2 iterations for batching}}
+  // expected-remark@+2 {{batched 4 `TFHE.keyswitch_glwe` operations}}
+  // expected-remark@+1 {{batched 2 `TFHE.keyswitch_glwe` operations}}
+  %1 = scf.for %arg1 = %c0 to %c10 step %c1 iter_args(%arg2 = %0) -> (tensor<10x!TFHE.glwe<sk<1,1,750>>>) {
+    %2 = tensor.extract %arg0[%arg1] : tensor<10x!TFHE.glwe<sk<0,1,2048>>>
+    %3 = "TFHE.keyswitch_glwe"(%2) {key = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>} : (!TFHE.glwe<sk<0,1,2048>>) -> !TFHE.glwe<sk<1,1,750>>
+    %4 = tensor.insert %3 into %arg2[%arg1] : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+    scf.yield %4 : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+  }
+  return %1 : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @no_batch_dynamic_loop
+// CHECK: scf.for
+// CHECK: "TFHE.keyswitch_glwe"
+func.func @no_batch_dynamic_loop(%arg0: tensor<10x!TFHE.glwe<sk<0,1,2048>>>, %n: index) -> tensor<10x!TFHE.glwe<sk<1,1,750>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+
+  %0 = bufferization.alloc_tensor() : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+  %1 = scf.for %arg1 = %c0 to %n step %c1 iter_args(%arg2 = %0) -> (tensor<10x!TFHE.glwe<sk<1,1,750>>>) {
+    %2 = tensor.extract %arg0[%arg1] : tensor<10x!TFHE.glwe<sk<0,1,2048>>>
+    // expected-remark@+1 {{not batched: the bounds of the enclosing loop are not static}}
+    %3 = "TFHE.keyswitch_glwe"(%2) {key = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>} : (!TFHE.glwe<sk<0,1,2048>>) -> !TFHE.glwe<sk<1,1,750>>
+    %4 = tensor.insert %3 into %arg2[%arg1] : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+    scf.yield %4 : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+  }
+  return %1 : tensor<10x!TFHE.glwe<sk<1,1,750>>>
+}
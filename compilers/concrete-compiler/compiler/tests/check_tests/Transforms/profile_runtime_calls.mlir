@@ -0,0 +1,19 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --profile-runtime-calls %s 2>&1| FileCheck %s
+
+// CHECK-DAG: llvm.mlir.global internal constant @concrete_profile_site_{{[0-9]+}}("memref_keyswitch_lwe_u64\00{{.*}}profile_runtime_calls.mlir:{{[0-9]+}}:{{[0-9]+}}\00")
+// CHECK-DAG: llvm.mlir.global internal constant @concrete_profile_site_{{[0-9]+}}("memref_bootstrap_lwe_u64\00{{.*}}profile_runtime_calls.mlir:{{[0-9]+}}:{{[0-9]+}}\00")
+// CHECK-LABEL: llvm.func @main
+// CHECK: llvm.call @concrete_profile_start() : () -> i64
+// CHECK: llvm.call @memref_keyswitch_lwe_u64
+// CHECK: llvm.call @concrete_profile_record(%{{.*}}, %{{.*}}) : (i64, !llvm.ptr<i8>) -> ()
+// CHECK: llvm.call @concrete_profile_start() : () -> i64
+// CHECK: llvm.call @memref_bootstrap_lwe_u64
+// CHECK: llvm.call @concrete_profile_record(%{{.*}}, %{{.*}}) : (i64, !llvm.ptr<i8>) -> ()
+// CHECK: llvm.call @concrete_profile_dump() : () -> ()
+// CHECK-NEXT: llvm.return
+func.func @main(%arg0: tensor<1025xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 576 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %1 : tensor<1025xi64>
+}
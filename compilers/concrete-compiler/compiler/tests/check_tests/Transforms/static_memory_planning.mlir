@@ -0,0 +1,34 @@
+// RUN: concretecompiler --action=dump-std %s 2>&1| FileCheck %s
+// RUN: concretecompiler --action=dump-std --static-memory-planning=false %s 2>&1| FileCheck %s --check-prefix=NOPLAN
+
+// The second keyswitch reuses the buffer of the first one, which is dead
+// once the first bootstrap has consumed it. The output of the second
+// bootstrap escapes the function and is not planned.
+
+// CHECK-LABEL: func.func @main
+// CHECK: %[[KS:.*]] = memref.alloc(){{.*}} : memref<576xi64>
+// CHECK: "Concrete.keyswitch_lwe_buffer"(%[[KS]], %{{.*}})
+// CHECK: %[[BS:.*]] = memref.alloc(){{.*}} : memref<1025xi64>
+// CHECK: "Concrete.bootstrap_lwe_buffer"(%[[BS]], %[[KS]], %{{.*}})
+// CHECK-NOT: memref.alloc(){{.*}} : memref<576xi64>
+// CHECK: "Concrete.keyswitch_lwe_buffer"(%[[KS]], %[[BS]])
+// CHECK: memref.dealloc %[[BS]]
+// CHECK: %[[OUT:.*]] = memref.alloc(){{.*}} : memref<1025xi64>
+// CHECK: "Concrete.bootstrap_lwe_buffer"(%[[OUT]], %[[KS]], %{{.*}})
+// CHECK: memref.dealloc %[[KS]]
+// CHECK-NOT: memref.dealloc
+// CHECK: return
+
+// NOPLAN-LABEL: func.func @main
+// NOPLAN: %[[KS1:.*]] = memref.alloc(){{.*}} : memref<576xi64>
+// NOPLAN: "Concrete.keyswitch_lwe_buffer"(%[[KS1]], %{{.*}})
+// NOPLAN: %[[KS2:.*]] = memref.alloc(){{.*}} : memref<576xi64>
+// NOPLAN: "Concrete.keyswitch_lwe_buffer"(%[[KS2]], %{{.*}})
+func.func @main(%arg0: tensor<1025xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 576 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %2 = "Concrete.keyswitch_lwe_tensor"(%1) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %3 = "Concrete.bootstrap_lwe_tensor"(%2, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 576 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %3 : tensor<1025xi64>
+}
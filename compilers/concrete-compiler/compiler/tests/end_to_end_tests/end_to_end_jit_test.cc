@@ -460,3 +460,49 @@ func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
 )XXX");
   assert(err.has_value());
 }
+
+TEST(CompileAndRunInMemory, apply_lookup_table) {
+  mlir::concretelang::CompilationOptions options("main");
+  TestCircuit circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compileJIT(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %1 = "FHE.apply_lookup_table"(%arg0, %cst): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  for (uint64_t i = 0; i < 8; i++) {
+    auto res = circuit.call({Tensor<uint64_t>(i)});
+    ASSERT_OUTCOME_HAS_VALUE(res);
+    ASSERT_EQ(res.value()[0].template getTensor<uint64_t>().value()[0],
+              (i + 1) % 8);
+  }
+}
+
+#ifdef CONCRETELANG_RUNTIME_BITCODE
+TEST(CompileAndRunWithRuntimeBitcode, leveled_ops) {
+  mlir::concretelang::CompilationOptions options("main");
+  options.runtimeBitcodePath = CONCRETELANG_RUNTIME_BITCODE;
+  TestCircuit circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<4>, %arg1: !FHE.eint<4>) -> !FHE.eint<4> {
+  %c2 = arith.constant 2 : i5
+  %c1 = arith.constant 1 : i5
+  %0 = "FHE.mul_eint_int"(%arg0, %c2) : (!FHE.eint<4>, i5) -> !FHE.eint<4>
+  %1 = "FHE.add_eint"(%0, %arg1) : (!FHE.eint<4>, !FHE.eint<4>) -> !FHE.eint<4>
+  %2 = "FHE.add_eint_int"(%1, %c1) : (!FHE.eint<4>, i5) -> !FHE.eint<4>
+  return %2: !FHE.eint<4>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  for (uint64_t a = 0; a < 4; a++) {
+    for (uint64_t b = 0; b < 4; b++) {
+      auto res = circuit.call({Tensor<uint64_t>(a), Tensor<uint64_t>(b)});
+      ASSERT_OUTCOME_HAS_VALUE(res);
+      ASSERT_EQ(res.value()[0].template getTensor<uint64_t>().value()[0],
+                2 * a + b + 1);
+    }
+  }
+}
+#endif
@@ -467,3 +467,32 @@ def test_memory_usage(mlir: str, expected_memory_usage_per_loc: dict):
     )
 
     shutil.rmtree(artifact_dir)
+
+
+def test_peak_memory_usage():
+    mlir = """
+    func.func @main(%arg0: tensor<4x2x!FHE.eint<6>>) -> tensor<4x2x!FHE.eint<6>> {
+        %tlu = arith.constant dense<[40, 13, 20, 62, 47, 41, 46, 30, 59, 58, 17, 4, 34, 44, 49, 5, 10, 63, 18, 21, 33, 45, 7, 14, 24, 53, 56, 3, 22, 29, 1, 39, 48, 32, 38, 28, 15, 12, 52, 35, 42, 11, 6, 43, 0, 16, 27, 9, 31, 51, 36, 37, 55, 57, 54, 2, 8, 25, 50, 23, 61, 60, 26, 19]> : tensor<64xi64>
+        %0 = "FHELinalg.apply_lookup_table"(%arg0, %tlu): (tensor<4x2x!FHE.eint<6>>, tensor<64xi64>) -> (tensor<4x2x!FHE.eint<6>>)
+        %1 = "FHELinalg.apply_lookup_table"(%0, %tlu): (tensor<4x2x!FHE.eint<6>>, tensor<64xi64>) -> (tensor<4x2x!FHE.eint<6>>)
+        %2 = "FHELinalg.apply_lookup_table"(%1, %tlu): (tensor<4x2x!FHE.eint<6>>, tensor<64xi64>) -> (tensor<4x2x!FHE.eint<6>>)
+        return %2: tensor<4x2x!FHE.eint<6>>
+    }
+    """
+
+    def peak_memory_usage(static_memory_planning: bool) -> int:
+        artifact_dir = "./test_peak_memory_usage"
+        engine = LibrarySupport.new(artifact_dir)
+        options = CompilationOptions.new("main")
+        options.set_static_memory_planning(static_memory_planning)
+        compilation_result = engine.compile(mlir, options)
+        compilation_feedback = engine.load_compilation_feedback(compilation_result)
+        shutil.rmtree(artifact_dir)
+        return compilation_feedback.peak_memory_usage
+
+    planned = peak_memory_usage(True)
+    unplanned = peak_memory_usage(False)
+    # 4*2*4097*8 (result buffer), which is alive at the end of the function
+    assert planned >= 262208
+    # Reusing dead buffers never extends the lifetime of the live bytes
+    assert planned <= unplanned
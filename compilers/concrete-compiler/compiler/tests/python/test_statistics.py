@@ -72,3 +72,36 @@ module {
             )
         )
         assert pbs_counts_per_tag_per_parameter == {}
+
+
+def test_pbs_parallelism():
+    mlir = """
+
+module {
+  func.func @main(%arg0: tensor<4x!FHE.eint<3>>, %arg1: !FHE.eint<3>, %arg2: tensor<3x5x!FHE.eint<3>>) -> (tensor<4x!FHE.eint<3>>, !FHE.eint<3>, tensor<3x5x!FHE.eint<3>>) {
+    %cst = arith.constant dense<[0, 1, 4, 1, 6, 5, 4, 1]> : tensor<8xi64>
+    %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> tensor<4x!FHE.eint<3>>
+    %1 = "FHELinalg.apply_lookup_table"(%0, %cst) : (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> tensor<4x!FHE.eint<3>>
+    %2 = "FHE.apply_lookup_table"(%arg1, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+    %3 = "FHELinalg.apply_lookup_table"(%arg2, %cst) : (tensor<3x5x!FHE.eint<3>>, tensor<8xi64>) -> tensor<3x5x!FHE.eint<3>>
+    return %1, %2, %3 : tensor<4x!FHE.eint<3>>, !FHE.eint<3>, tensor<3x5x!FHE.eint<3>>
+  }
+}
+
+    """.strip()
+
+    with tempfile.TemporaryDirectory() as tmpdirname:
+        support = LibrarySupport.new(str(tmpdirname))
+        compilation_result = support.compile(mlir)
+        compilation_feedback = support.load_compilation_feedback(compilation_result)
+
+        # The scalar lookup table and the 3x5 lookup table, whose elements are
+        # independent, run along the first 1-D tensor lookup table
+        assert compilation_feedback.pbs_critical_path == 2
+        assert compilation_feedback.pbs_width_profile == [20, 4]
+
+        cores = compilation_feedback.prediction_cores
+        assert cores > 0
+        assert compilation_feedback.predicted_pbs_rounds == sum(
+            (width + cores - 1) // cores for width in [20, 4]
+        )
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include "concretelang/Common/Csprng.h"
+#include "concretelang/Common/Keys.h"
+#include "concretelang/Common/Keysets.h"
+#include "concretelang/Common/Transformers.h"
+#include "tests_tools/assert.h"
+
+namespace {
+using concretelang::csprng::EncryptionCSPRNG;
+using concretelang::csprng::SecretCSPRNG;
+using concretelang::keys::LweSecretKey;
+using concretelang::transformers::TransformerFactory;
+
+const uint32_t LWE_DIMENSION = 512;
+
+ClientKeyset generateClientKeyset() {
+  auto info = Message<concreteprotocol::LweSecretKeyInfo>();
+  info.asBuilder().setId(0);
+  auto params = info.asBuilder().initParams();
+  params.setLweDimension(LWE_DIMENSION);
+  params.setIntegerPrecision(64);
+  params.setKeyType(concreteprotocol::KeyType::BINARY);
+  SecretCSPRNG csprng(0);
+  ClientKeyset keyset;
+  keyset.lweSecretKeys.push_back(LweSecretKey(info, csprng));
+  return keyset;
+}
+
+/// Returns the info of a gate of shape `dimensions`, whose values are encoded
+/// in `blocks` ciphertexts each if non-zero. The encoding is left to the
+/// caller.
+Message<concreteprotocol::GateInfo>
+lweGateInfo(const std::vector<size_t> &dimensions, size_t blocks) {
+  auto gateInfo = Message<concreteprotocol::GateInfo>();
+  auto concreteDimensions = dimensions;
+  if (blocks != 0)
+    concreteDimensions.push_back(blocks);
+  concreteDimensions.push_back(LWE_DIMENSION + 1);
+
+  auto rawInfo = gateInfo.asBuilder().initRawInfo();
+  rawInfo.setShape(dimensionsToProtoShape(concreteDimensions).asReader());
+  rawInfo.setIntegerPrecision(64);
+  rawInfo.setIsSigned(false);
+
+  auto type = gateInfo.asBuilder().initTypeInfo().initLweCiphertext();
+  type.setAbstractShape(dimensionsToProtoShape(dimensions).asReader());
+  type.setConcreteShape(dimensionsToProtoShape(concreteDimensions).asReader());
+  type.setIntegerPrecision(64);
+  type.setCompression(concreteprotocol::Compression::NONE);
+  auto encryption = type.initEncryption();
+  encryption.setKeyId(0);
+  // A negligible noise, the decryption is exact
+  encryption.setVariance(1e-40);
+  encryption.setLweDimension(LWE_DIMENSION);
+  encryption.initModulus().initMod().initNative();
+  return gateInfo;
+}
+
+/// Encrypts `input` through the input transformer of `gateInfo`, and checks
+/// that the output transformer decrypts it back.
+template <typename T>
+void checkRoundTrip(const Message<concreteprotocol::GateInfo> &gateInfo,
+                    Tensor<T> input) {
+  auto keyset = generateClientKeyset();
+  auto csprng = std::make_shared<EncryptionCSPRNG>(0);
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      encrypt, TransformerFactory::getLweCiphertextInputTransformer(
+                   keyset, gateInfo, csprng, false));
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      decrypt, TransformerFactory::getLweCiphertextOutputTransformer(
+                   keyset, gateInfo, false));
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(transportValue, encrypt(Value(input)));
+  ASSERT_ASSIGN_OUTCOME_VALUE(output, decrypt(transportValue));
+  ASSERT_TRUE(output.template hasElementType<T>());
+  ASSERT_EQ(output.template getTensor<T>().value(), input);
+}
+
+TEST(Transformers, native_unsigned_round_trip) {
+  auto gateInfo = lweGateInfo({2, 3}, 0);
+  auto integer = gateInfo.asBuilder()
+                     .getTypeInfo()
+                     .getLweCiphertext()
+                     .getEncoding()
+                     .initInteger();
+  integer.setWidth(4);
+  integer.setIsSigned(false);
+  integer.getMode().initNative();
+  checkRoundTrip(gateInfo, Tensor<uint64_t>({0, 1, 7, 8, 14, 15}, {2, 3}));
+}
+
+TEST(Transformers, native_signed_round_trip) {
+  auto gateInfo = lweGateInfo({4}, 0);
+  auto integer = gateInfo.asBuilder()
+                     .getTypeInfo()
+                     .getLweCiphertext()
+                     .getEncoding()
+                     .initInteger();
+  integer.setWidth(4);
+  integer.setIsSigned(true);
+  integer.getMode().initNative();
+  checkRoundTrip(gateInfo, Tensor<int64_t>({-8, -1, 0, 7}, {4}));
+}
+
+TEST(Transformers, chunked_round_trip) {
+  auto gateInfo = lweGateInfo({3}, 4);
+  auto integer = gateInfo.asBuilder()
+                     .getTypeInfo()
+                     .getLweCiphertext()
+                     .getEncoding()
+                     .initInteger();
+  integer.setWidth(8);
+  integer.setIsSigned(false);
+  auto chunked = integer.getMode().initChunked();
+  chunked.setSize(4);
+  chunked.setWidth(2);
+  checkRoundTrip(gateInfo, Tensor<uint64_t>({0, 123, 255}, {3}));
+}
+
+TEST(Transformers, crt_round_trip) {
+  auto gateInfo = lweGateInfo({3}, 5);
+  auto integer = gateInfo.asBuilder()
+                     .getTypeInfo()
+                     .getLweCiphertext()
+                     .getEncoding()
+                     .initInteger();
+  integer.setWidth(16);
+  integer.setIsSigned(false);
+  auto moduli = integer.getMode().initCrt().initModuli(5);
+  std::vector<uint32_t> values = {7, 8, 9, 11, 13};
+  for (size_t i = 0; i < values.size(); i++)
+    moduli.set(i, values[i]);
+  checkRoundTrip(gateInfo, Tensor<uint64_t>({0, 4242, 65535}, {3}));
+}
+
+TEST(Transformers, boolean_round_trip) {
+  auto gateInfo = lweGateInfo({2}, 0);
+  gateInfo.asBuilder()
+      .getTypeInfo()
+      .getLweCiphertext()
+      .getEncoding()
+      .initBoolean();
+  checkRoundTrip(gateInfo, Tensor<uint64_t>({0, 1}, {2}));
+}
+
+} // namespace
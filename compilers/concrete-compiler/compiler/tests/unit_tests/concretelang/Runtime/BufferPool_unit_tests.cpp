@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "concretelang/Runtime/buffer_pool.h"
+#include "concretelang/Runtime/context.h"
+#include "concretelang/Runtime/wrappers.h"
+
+namespace {
+using mlir::concretelang::BufferPool;
+using mlir::concretelang::RuntimeContext;
+
+TEST(BufferPool, reuses_buffers_of_the_same_size_class) {
+  BufferPool pool;
+  void *buffer = pool.allocate(100);
+  pool.release(buffer, 100);
+  EXPECT_EQ(pool.getStats().bytesCached, 128u);
+
+  EXPECT_EQ(pool.allocate(90), buffer);
+  void *other = pool.allocate(200);
+  EXPECT_NE(other, buffer);
+  pool.release(buffer, 90);
+  pool.release(other, 200);
+
+  auto stats = pool.getStats();
+  EXPECT_EQ(stats.allocations, 3u);
+  EXPECT_EQ(stats.cacheHits, 1u);
+  EXPECT_EQ(stats.bytesCached, 128u + 256u);
+  EXPECT_EQ(stats.highWaterMark, 128u + 256u);
+}
+
+TEST(BufferPool, pool_alloc_and_dealloc_go_through_the_context) {
+  auto pool = std::make_shared<BufferPool>();
+  RuntimeContext context(ServerKeyset(), pool);
+  uint64_t *buffer = memref_pool_alloc_u64(577 * sizeof(uint64_t), &context);
+  EXPECT_EQ((uintptr_t)buffer % BufferPool::alignment, 0u);
+  // The buffer is writable in its entirety
+  for (size_t i = 0; i < 577; i++)
+    buffer[i] = i;
+  memref_pool_free_u64(buffer, 577 * sizeof(uint64_t), &context);
+  EXPECT_EQ(pool->getStats().allocations, 1u);
+  // 577 words rounded up to the alignment
+  EXPECT_EQ(pool->getStats().bytesCached, 4672u);
+}
+
+TEST(BufferPool, pool_outlives_the_contexts_of_the_calls) {
+  // Each call of a circuit has its own runtime context, but the buffers
+  // released by a call serve the next ones.
+  auto pool = std::make_shared<BufferPool>();
+  uint64_t *first;
+  {
+    RuntimeContext context(ServerKeyset(), pool);
+    first = memref_pool_alloc_u64(4104, &context);
+    memref_pool_free_u64(first, 4104, &context);
+  }
+  {
+    RuntimeContext context(ServerKeyset(), pool);
+    uint64_t *second = memref_pool_alloc_u64(4104, &context);
+    EXPECT_EQ(second, first);
+    memref_pool_free_u64(second, 4104, &context);
+  }
+  EXPECT_EQ(pool->getStats().allocations, 2u);
+  EXPECT_EQ(pool->getStats().cacheHits, 1u);
+}
+
+} // namespace
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "concretelang/Runtime/leveled_wrappers.h"
+
+namespace {
+
+const uint64_t LWE_SIZE = 5;
+
+/// Returns two ciphertexts interleaved in a buffer, i.e. the columns of a
+/// LWE_SIZE x 2 row-major matrix, each of them being a view of stride 2.
+std::vector<uint64_t> interleavedCiphertexts() {
+  std::vector<uint64_t> buffer(2 * LWE_SIZE);
+  for (uint64_t i = 0; i < LWE_SIZE; i++) {
+    buffer[2 * i] = 10 * i + 1;
+    buffer[2 * i + 1] = 100 * i + 3;
+  }
+  return buffer;
+}
+
+TEST(LeveledWrappers, add_in_place_of_a_strided_ciphertext) {
+  auto buffer = interleavedCiphertexts();
+  uint64_t *b = buffer.data();
+  memref_add_lwe_ciphertexts_u64(b, b, 0, LWE_SIZE, 2, b, b, 0, LWE_SIZE, 2,
+                                 b, b, 1, LWE_SIZE, 2);
+  for (uint64_t i = 0; i < LWE_SIZE; i++) {
+    EXPECT_EQ(buffer[2 * i], 110 * i + 4);
+    EXPECT_EQ(buffer[2 * i + 1], 100 * i + 3);
+  }
+}
+
+TEST(LeveledWrappers, add_plaintext_in_place_of_a_strided_ciphertext) {
+  auto buffer = interleavedCiphertexts();
+  uint64_t *b = buffer.data();
+  memref_add_plaintext_lwe_ciphertext_u64(b, b, 1, LWE_SIZE, 2, b, b, 1,
+                                          LWE_SIZE, 2, 7);
+  for (uint64_t i = 0; i < LWE_SIZE; i++) {
+    EXPECT_EQ(buffer[2 * i], 10 * i + 1);
+    uint64_t body = i == LWE_SIZE - 1 ? 7 : 0;
+    EXPECT_EQ(buffer[2 * i + 1], 100 * i + 3 + body);
+  }
+}
+
+TEST(LeveledWrappers, mul_cleartext_and_negate_in_place) {
+  auto buffer = interleavedCiphertexts();
+  uint64_t *b = buffer.data();
+  memref_mul_cleartext_lwe_ciphertext_u64(b, b, 0, LWE_SIZE, 2, b, b, 0,
+                                          LWE_SIZE, 2, 3);
+  memref_negate_lwe_ciphertext_u64(b, b, 1, LWE_SIZE, 2, b, b, 1, LWE_SIZE,
+                                   2);
+  for (uint64_t i = 0; i < LWE_SIZE; i++) {
+    EXPECT_EQ(buffer[2 * i], 3 * (10 * i + 1));
+    EXPECT_EQ(buffer[2 * i + 1], -(100 * i + 3));
+  }
+}
+
+TEST(LeveledWrappers, mul_cleartext_add_in_place_of_the_accumulator) {
+  auto buffer = interleavedCiphertexts();
+  uint64_t *b = buffer.data();
+  memref_mul_cleartext_add_lwe_ciphertext_u64(b, b, 0, LWE_SIZE, 2, b, b, 0,
+                                              LWE_SIZE, 2, b, b, 1, LWE_SIZE,
+                                              2, 2);
+  for (uint64_t i = 0; i < LWE_SIZE; i++)
+    EXPECT_EQ(buffer[2 * i], 10 * i + 1 + 2 * (100 * i + 3));
+}
+
+TEST(LeveledWrappers, batched_add_in_place_of_padded_rows) {
+  // Two ciphertexts whose rows are padded to 8 words
+  const uint64_t rowStride = 8;
+  std::vector<uint64_t> ct0(2 * rowStride, 0), ct1(2 * LWE_SIZE, 0);
+  for (uint64_t r = 0; r < 2; r++) {
+    for (uint64_t i = 0; i < LWE_SIZE; i++) {
+      ct0[r * rowStride + i] = r + i;
+      ct1[r * LWE_SIZE + i] = 1000;
+    }
+  }
+  uint64_t *b0 = ct0.data(), *b1 = ct1.data();
+  memref_batched_add_lwe_ciphertexts_u64(
+      b0, b0, 0, 2, LWE_SIZE, rowStride, 1, b0, b0, 0, 2, LWE_SIZE, rowStride,
+      1, b1, b1, 0, 2, LWE_SIZE, LWE_SIZE, 1);
+  for (uint64_t r = 0; r < 2; r++) {
+    for (uint64_t i = 0; i < LWE_SIZE; i++)
+      EXPECT_EQ(ct0[r * rowStride + i], 1000 + r + i);
+    // The padding is left untouched
+    for (uint64_t i = LWE_SIZE; i < rowStride; i++)
+      EXPECT_EQ(ct0[r * rowStride + i], 0u);
+  }
+}
+
+} // namespace
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "concretelang/Common/Keys.h"
+#include "concretelang/Common/Keysets.h"
+#include "concretelang/Common/Protocol.h"
+#include "concretelang/Runtime/context.h"
+
+namespace {
+using mlir::concretelang::PreparedKeysetCache;
+using mlir::concretelang::RuntimeContext;
+
+const uint32_t INPUT_LWE_DIMENSION = 4;
+const uint32_t POLYNOMIAL_SIZE = 256;
+
+/// Returns a keyset with a single bootstrap key of small parameters. The key
+/// is not a valid encryption, but it can be converted to the fourier domain.
+ServerKeyset smallServerKeyset() {
+  auto info = Message<concreteprotocol::LweBootstrapKeyInfo>();
+  info.asBuilder().setCompression(concreteprotocol::Compression::NONE);
+  auto params = info.asBuilder().initParams();
+  params.setLevelCount(1);
+  params.setBaseLog(10);
+  params.setGlweDimension(1);
+  params.setPolynomialSize(POLYNOMIAL_SIZE);
+  params.setInputLweDimension(INPUT_LWE_DIMENSION);
+  auto buffer = std::make_shared<std::vector<uint64_t>>(
+      concrete_cpu_bootstrap_key_size_u64(1, 1, POLYNOMIAL_SIZE,
+                                          INPUT_LWE_DIMENSION),
+      0);
+
+  ServerKeyset keyset;
+  keyset.lweBootstrapKeys.push_back(LweBootstrapKey(buffer, info));
+  return keyset;
+}
+
+TEST(PreparedKeysetCache, prepares_the_keys_of_a_keyset_once) {
+  PreparedKeysetCache cache;
+  ServerKeyset keyset = smallServerKeyset();
+
+  auto prepared = cache.get(keyset);
+  ASSERT_EQ(prepared->fourier_bootstrap_keys.size(), 1u);
+  ASSERT_EQ(prepared->ffts.size(), 1u);
+  EXPECT_GT(prepared->bootstrap_scratches[0].size, 0u);
+
+  // The copies of a keyset share its keys
+  ServerKeyset copy = keyset;
+  EXPECT_EQ(cache.get(keyset), prepared);
+  EXPECT_EQ(cache.get(copy), prepared);
+}
+
+TEST(PreparedKeysetCache, prepares_the_keys_of_another_keyset) {
+  PreparedKeysetCache cache;
+  ServerKeyset keyset = smallServerKeyset();
+  ServerKeyset other = smallServerKeyset();
+
+  auto prepared = cache.get(keyset);
+  auto otherPrepared = cache.get(other);
+  EXPECT_NE(otherPrepared, prepared);
+  EXPECT_NE(otherPrepared->fourier_bootstrap_keys[0],
+            prepared->fourier_bootstrap_keys[0]);
+  // The keys prepared before stay valid for the calls still using them
+  EXPECT_EQ(prepared->fourier_bootstrap_keys.size(), 1u);
+  EXPECT_EQ(cache.get(other), otherPrepared);
+}
+
+TEST(PreparedKeysetCache, contexts_of_the_calls_share_the_prepared_keys) {
+  // Each call of a circuit has its own runtime context, but only the first
+  // one converts the bootstrap keys to the fourier domain.
+  auto cache = std::make_shared<PreparedKeysetCache>();
+  auto pool = std::make_shared<mlir::concretelang::BufferPool>();
+  ServerKeyset keyset = smallServerKeyset();
+
+  RuntimeContext first(keyset, pool, cache->get(keyset));
+  RuntimeContext second(keyset, pool, cache->get(keyset));
+  EXPECT_EQ(first.fourier_bootstrap_key_buffer(0),
+            second.fourier_bootstrap_key_buffer(0));
+  EXPECT_EQ(first.fft(0), second.fft(0));
+
+  // Without the cache, a context prepares its own keys
+  RuntimeContext standalone(keyset, pool);
+  EXPECT_NE(standalone.fourier_bootstrap_key_buffer(0),
+            first.fourier_bootstrap_key_buffer(0));
+  EXPECT_EQ(standalone.bootstrap_scratch(0).size,
+            first.bootstrap_scratch(0).size);
+}
+
+} // namespace
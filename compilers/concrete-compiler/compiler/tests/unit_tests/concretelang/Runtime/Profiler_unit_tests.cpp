@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concretelang/Runtime/profiler.h"
+
+namespace {
+
+size_t countOccurrences(const std::string &text, const std::string &pattern) {
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + 1))
+    count++;
+  return count;
+}
+
+std::string readFile(const std::string &path) {
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+/// Returns the path of the trace, which is created by the first dump of the
+/// process and shared by the tests.
+std::string tracePath() {
+  static std::string path = [] {
+    std::string path = testing::TempDir() + "concrete-profile-test.json";
+    setenv("CONCRETE_PROFILE_OUTPUT", path.c_str(), 1);
+    return path;
+  }();
+  return path;
+}
+
+char site[] = "memref_bootstrap_lwe_u64\0main.mlir:3:8";
+
+TEST(Profiler, dumps_append_the_calls_recorded_concurrently) {
+  std::string path = tracePath();
+
+  const size_t threads = 4;
+  const size_t callsPerThread = 10000;
+  std::atomic<size_t> running(threads);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      for (size_t i = 0; i < callsPerThread; i++)
+        concrete_profile_record(concrete_profile_start(), site);
+      running--;
+    });
+  }
+  // Dumps while the threads record their calls
+  while (running > 0)
+    concrete_profile_dump();
+  for (auto &worker : workers)
+    worker.join();
+  concrete_profile_dump();
+  concrete_profile_dump();
+
+  std::string trace = readFile(path);
+  EXPECT_EQ(trace.front(), '[');
+  EXPECT_EQ(countOccurrences(trace, "\"name\":\"memref_bootstrap_lwe_u64\""),
+            threads * callsPerThread);
+  EXPECT_EQ(countOccurrences(trace, "\"loc\":\"main.mlir:3:8\""),
+            threads * callsPerThread);
+
+  // A single line totals all the dumped calls of the site
+  std::string folded = readFile(path + ".folded");
+  EXPECT_EQ(countOccurrences(folded, "\n"), 1u);
+  EXPECT_EQ(folded.rfind("main.mlir:3:8;memref_bootstrap_lwe_u64 ", 0), 0u);
+}
+
+TEST(Profiler, dumps_escape_the_control_characters) {
+  char tabSite[] = "memref_keyswitch_lwe_u64\0main\t\"1\".mlir:1:1";
+  concrete_profile_record(concrete_profile_start(), tabSite);
+  concrete_profile_dump();
+
+  std::string trace = readFile(tracePath());
+  EXPECT_NE(trace.find("\"loc\":\"main\\u0009\\\"1\\\".mlir:1:1\""),
+            std::string::npos);
+}
+
+} // namespace
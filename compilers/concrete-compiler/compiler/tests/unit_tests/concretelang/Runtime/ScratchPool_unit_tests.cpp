@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "concretelang/Runtime/scratch_pool.h"
+
+namespace {
+using mlir::concretelang::ScratchPool;
+
+TEST(ScratchPool, rounds_sizes_up_to_the_alignment) {
+  ScratchPool pool;
+  auto scratch = pool.acquire(100, 64);
+  EXPECT_EQ(scratch.size, 128u);
+  EXPECT_EQ((uintptr_t)scratch.ptr % 64, 0u);
+  pool.release(scratch);
+}
+
+TEST(ScratchPool, reuses_released_buffers) {
+  ScratchPool pool;
+  auto scratch = pool.acquire(1024, 64);
+  uint8_t *ptr = scratch.ptr;
+  pool.release(scratch);
+  EXPECT_EQ(pool.retainedBytes(), 1024u);
+
+  // A smaller request with a weaker alignment fits in the released buffer
+  auto reused = pool.acquire(512, 32);
+  EXPECT_EQ(reused.ptr, ptr);
+  EXPECT_EQ(pool.retainedBytes(), 0u);
+  pool.release(reused);
+}
+
+TEST(ScratchPool, frees_the_oldest_buffers_beyond_its_bound) {
+  ScratchPool pool(2048);
+  auto first = pool.acquire(1024, 64);
+  auto second = pool.acquire(1024, 64);
+  auto third = pool.acquire(1024, 64);
+  uint8_t *secondPtr = second.ptr;
+  uint8_t *thirdPtr = third.ptr;
+  pool.release(first);
+  pool.release(second);
+  pool.release(third);
+  EXPECT_EQ(pool.retainedBytes(), 2048u);
+
+  auto a = pool.acquire(1024, 64);
+  auto b = pool.acquire(1024, 64);
+  EXPECT_EQ(a.ptr, secondPtr);
+  EXPECT_EQ(b.ptr, thirdPtr);
+  pool.release(a);
+  pool.release(b);
+}
+
+TEST(ScratchPool, retains_nothing_without_bound) {
+  ScratchPool pool(0);
+  pool.release(pool.acquire(1024, 64));
+  EXPECT_EQ(pool.retainedBytes(), 0u);
+}
+
+} // namespace
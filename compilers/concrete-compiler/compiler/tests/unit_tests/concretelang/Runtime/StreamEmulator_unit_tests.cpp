@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concretelang/Runtime/stream_emulator_api.h"
+
+namespace {
+
+/// Size of the ciphertexts flowing through the streams, the content of which
+/// is irrelevant to the additions.
+const uint64_t CIPHERTEXT_SIZE = 4;
+
+/// Returns the ciphertext filled with `value`.
+std::vector<uint64_t> ciphertext(uint64_t value) {
+  return std::vector<uint64_t>(CIPHERTEXT_SIZE, value);
+}
+
+void put(void *stream, std::vector<uint64_t> &ct) {
+  stream_emulator_put_memref(stream, ct.data(), ct.data(), 0, ct.size(), 1);
+}
+
+std::vector<uint64_t> get(void *stream) {
+  std::vector<uint64_t> ct(CIPHERTEXT_SIZE);
+  stream_emulator_get_memref(stream, ct.data(), ct.data(), 0, ct.size(), 1);
+  return ct;
+}
+
+TEST(StreamEmulator, host_puts_more_than_the_stream_capacity) {
+  // More elements than the default stream capacity, all put on the first
+  // input before the second one, which the process needs to make progress.
+  const uint64_t n = 100;
+  void *dfg = stream_emulator_init();
+  void *sin1 = stream_emulator_make_memref_stream(
+      "sin1", TS_STREAM_TYPE_X86_TO_TOPO_LSAP);
+  void *sin2 = stream_emulator_make_memref_stream(
+      "sin2", TS_STREAM_TYPE_X86_TO_TOPO_LSAP);
+  void *sout = stream_emulator_make_memref_stream(
+      "sout", TS_STREAM_TYPE_TOPO_TO_X86_LSAP);
+  stream_emulator_make_memref_add_lwe_ciphertexts_u64_process(dfg, sin1, sin2,
+                                                              sout);
+  stream_emulator_run(dfg);
+
+  for (uint64_t i = 0; i < n; i++) {
+    auto ct = ciphertext(i);
+    put(sin1, ct);
+  }
+  for (uint64_t i = 0; i < n; i++) {
+    auto ct = ciphertext(1000 * i);
+    put(sin2, ct);
+  }
+  for (uint64_t i = 0; i < n; i++)
+    ASSERT_EQ(get(sout), ciphertext(1001 * i));
+
+  stream_emulator_delete(dfg);
+}
+
+/// Runs the pipeline `-((x + y) * c)` of three processes with `numThreads`
+/// workers, feeding its inputs and draining its output concurrently.
+void checkPipeline(size_t numThreads) {
+  const uint64_t n = 1000;
+  setenv("SDFG_NUM_THREADS", std::to_string(numThreads).c_str(), 1);
+  void *dfg = stream_emulator_init();
+  void *x = stream_emulator_make_memref_stream(
+      "x", TS_STREAM_TYPE_X86_TO_TOPO_LSAP);
+  void *y = stream_emulator_make_memref_stream(
+      "y", TS_STREAM_TYPE_X86_TO_TOPO_LSAP);
+  void *c = stream_emulator_make_uint64_stream(
+      "c", TS_STREAM_TYPE_X86_TO_TOPO_LSAP);
+  void *sum = stream_emulator_make_memref_stream(
+      "sum", TS_STREAM_TYPE_TOPO_TO_TOPO_LSAP);
+  void *product = stream_emulator_make_memref_stream(
+      "product", TS_STREAM_TYPE_TOPO_TO_TOPO_LSAP);
+  void *out = stream_emulator_make_memref_stream(
+      "out", TS_STREAM_TYPE_TOPO_TO_X86_LSAP);
+  stream_emulator_make_memref_add_lwe_ciphertexts_u64_process(dfg, x, y, sum);
+  stream_emulator_make_memref_mul_cleartext_lwe_ciphertext_u64_process(
+      dfg, sum, c, product);
+  stream_emulator_make_memref_negate_lwe_ciphertext_u64_process(dfg, product,
+                                                                out);
+  stream_emulator_run(dfg);
+
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < n; i++) {
+      auto ctx = ciphertext(i);
+      auto cty = ciphertext(2 * i);
+      put(x, ctx);
+      put(y, cty);
+      stream_emulator_put_uint64(c, i % 7);
+    }
+  });
+  for (uint64_t i = 0; i < n; i++)
+    EXPECT_EQ(get(out), ciphertext(-(3 * i * (i % 7))));
+  producer.join();
+
+  stream_emulator_delete(dfg);
+  unsetenv("SDFG_NUM_THREADS");
+}
+
+TEST(StreamEmulator, single_worker_runs_all_processes) { checkPipeline(1); }
+
+TEST(StreamEmulator, worker_pool_runs_processes_concurrently) {
+  checkPipeline(2);
+  checkPipeline(3);
+}
+
+} // namespace
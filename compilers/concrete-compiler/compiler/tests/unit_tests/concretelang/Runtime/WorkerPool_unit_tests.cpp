@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "concretelang/Runtime/worker_pool.h"
+
+namespace {
+using mlir::concretelang::WorkerPool;
+
+TEST(WorkerPool, runs_each_task_once) {
+  WorkerPool pool(3);
+  EXPECT_EQ(pool.concurrency(), 4u);
+  std::vector<std::atomic<int>> runs(1000);
+  pool.parallelFor(runs.size(), [&](size_t i) { runs[i]++; });
+  for (auto &r : runs)
+    EXPECT_EQ(r.load(), 1);
+}
+
+TEST(WorkerPool, runs_tasks_on_the_workers) {
+  WorkerPool pool(3);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  // Each task waits for the others, so they all run at the same time
+  std::atomic<size_t> started{0};
+  pool.parallelFor(4, [&](size_t) {
+    started++;
+    while (started.load() < 4)
+      std::this_thread::yield();
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+  EXPECT_EQ(threads.size(), 4u);
+}
+
+TEST(WorkerPool, runs_nested_calls_sequentially) {
+  WorkerPool pool(3);
+  std::atomic<size_t> count{0};
+  pool.parallelFor(8, [&](size_t) {
+    EXPECT_EQ(pool.concurrency(), 1u);
+    auto self = std::this_thread::get_id();
+    pool.parallelFor(8, [&](size_t) {
+      EXPECT_EQ(std::this_thread::get_id(), self);
+      count++;
+    });
+  });
+  EXPECT_EQ(count.load(), 64u);
+  EXPECT_EQ(pool.concurrency(), 4u);
+}
+
+TEST(WorkerPool, serves_concurrent_callers) {
+  WorkerPool pool(2);
+  std::atomic<size_t> count{0};
+  std::vector<std::thread> callers;
+  for (size_t c = 0; c < 4; c++)
+    callers.emplace_back([&]() {
+      for (size_t k = 0; k < 100; k++)
+        pool.parallelFor(16, [&](size_t) { count++; });
+    });
+  for (auto &caller : callers)
+    caller.join();
+  EXPECT_EQ(count.load(), 4u * 100 * 16);
+}
+
+} // namespace
@@ -3,7 +3,7 @@ use concrete_optimizer::computing_cost::cpu::CpuComplexity;
 use concrete_optimizer::config;
 use concrete_optimizer::global_parameters::DEFAUT_DOMAINS;
 use concrete_optimizer::optimization::atomic_pattern::{self as optimize_atomic_pattern};
-use concrete_optimizer::optimization::config::{Config, SearchSpace};
+use concrete_optimizer::optimization::config::{Config, Objective, SearchSpace};
 use concrete_optimizer::optimization::decomposition;
 use concrete_optimizer::optimization::wop_atomic_pattern::optimize as optimize_wop_atomic_pattern;
 
@@ -48,6 +48,7 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
         fft_precision,
         complexity_model: &CpuComplexity::default(),
         composable: false,
+        objective: Objective::TotalWork,
     };
 
     let cache = decomposition::cache(
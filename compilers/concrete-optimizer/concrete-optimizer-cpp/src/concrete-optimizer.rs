@@ -1,3 +1,6 @@
+use std::sync::{Arc, RwLock};
+
+use concrete_optimizer::computing_cost::cost_profile::CostProfile;
 use concrete_optimizer::computing_cost::cpu::CpuComplexity;
 use concrete_optimizer::config;
 use concrete_optimizer::config::ProcessingUnit;
@@ -5,7 +8,7 @@ use concrete_optimizer::dag::operator::{
     self, FunctionTable, LevelledComplexity, OperatorIndex, Precision, Shape,
 };
 use concrete_optimizer::dag::unparametrized;
-use concrete_optimizer::optimization::config::{Config, SearchSpace};
+use concrete_optimizer::optimization::config::{Config, Objective, SearchSpace};
 use concrete_optimizer::optimization::dag::multi_parameters::keys_spec;
 use concrete_optimizer::optimization::dag::multi_parameters::keys_spec::CircuitSolution;
 use concrete_optimizer::optimization::dag::multi_parameters::partition_cut::PartitionCut;
@@ -30,6 +33,55 @@ fn no_dag_solution() -> ffi::DagSolution {
     }
 }
 
+/// Measured cost profiles of the cpu operators, see `load_cpu_cost_profile`. The profile of
+/// handle `i` is at index `i - 1`, the handle 0 standing for the analytical model. Profiles are
+/// never removed, so that a handle stays valid for the whole process.
+static CPU_COST_PROFILES: RwLock<Vec<Arc<CostProfile>>> = RwLock::new(Vec::new());
+
+/// Loads the cost profile at `path` and sets `profile` to its handle, to be passed in the
+/// `cpu_cost_profile` field of the options. The profiles with the same factors share a handle.
+/// Returns an error message, empty on success.
+fn load_cpu_cost_profile(path: &str, profile: &mut u64) -> String {
+    match CostProfile::load(path) {
+        Ok(loaded) => {
+            let mut profiles = CPU_COST_PROFILES.write().unwrap();
+            let index = profiles
+                .iter()
+                .position(|known| **known == loaded)
+                .unwrap_or_else(|| {
+                    profiles.push(Arc::new(loaded));
+                    profiles.len() - 1
+                });
+            *profile = index as u64 + 1;
+            String::new()
+        }
+        Err(err) => err,
+    }
+}
+
+fn cpu_cost_profile(profile: u64) -> Option<Arc<CostProfile>> {
+    let index = profile.checked_sub(1)?;
+    let profiles = CPU_COST_PROFILES.read().unwrap();
+    assert!(
+        (index as usize) < profiles.len(),
+        "Internal error: Invalid cost profile handle"
+    );
+    Some(profiles[index as usize].clone())
+}
+
+/// Returns an exact textual form of the factors of the cost profile `profile`, empty for the
+/// analytical model.
+fn dump_cpu_cost_profile(profile: u64) -> String {
+    cpu_cost_profile(profile).map_or_else(String::new, |profile| profile.dump())
+}
+
+fn cpu_complexity(options: ffi::Options) -> CpuComplexity {
+    CpuComplexity {
+        profile: cpu_cost_profile(options.cpu_cost_profile),
+        ..CpuComplexity::default()
+    }
+}
+
 fn caches_from(options: ffi::Options) -> decomposition::PersistDecompCaches {
     if !options.cache_on_disk {
         println!("optimizer: Using stateless cache.");
@@ -37,11 +89,14 @@ fn caches_from(options: ffi::Options) -> decomposition::PersistDecompCaches {
         println!("optimizer: To clear the cache, remove directory {cache_dir}");
     }
     let processing_unit = processing_unit(options);
+    let complexity_model = cpu_complexity(options);
+    // The decompositions on disk are chosen with the analytical model
+    let cache_on_disk = options.cache_on_disk && complexity_model.profile.is_none();
     decomposition::cache(
         options.security_level,
         processing_unit,
-        Some(ProcessingUnit::Cpu.complexity_model()),
-        options.cache_on_disk,
+        Some(Arc::new(complexity_model)),
+        cache_on_disk,
         options.ciphertext_modulus_log,
         options.fft_precision,
     )
@@ -57,8 +112,9 @@ fn optimize_bootstrap(precision: u64, noise_factor: f64, options: ffi::Options)
         key_sharing: options.key_sharing,
         ciphertext_modulus_log: options.ciphertext_modulus_log,
         fft_precision: options.fft_precision,
-        complexity_model: &CpuComplexity::default(),
+        complexity_model: &cpu_complexity(options),
         composable: options.composable,
+        objective: objective(options),
     };
 
     let sum_size = 1;
@@ -561,8 +617,9 @@ impl OperationDag {
             key_sharing: options.key_sharing,
             ciphertext_modulus_log: options.ciphertext_modulus_log,
             fft_precision: options.fft_precision,
-            complexity_model: &CpuComplexity::default(),
+            complexity_model: &cpu_complexity(options),
             composable: options.composable,
+            objective: objective(options),
         };
 
         let search_space = SearchSpace::default(processing_unit);
@@ -599,6 +656,10 @@ impl OperationDag {
         self.0.dump()
     }
 
+    fn canonical_dump(&self) -> String {
+        self.0.canonical_dump()
+    }
+
     fn tag_operator_as_output(&mut self, op: ffi::OperatorIndex) {
         self.0.tag_operator_as_output(op.into());
     }
@@ -611,8 +672,9 @@ impl OperationDag {
             key_sharing: options.key_sharing,
             ciphertext_modulus_log: options.ciphertext_modulus_log,
             fft_precision: options.fft_precision,
-            complexity_model: &CpuComplexity::default(),
+            complexity_model: &cpu_complexity(options),
             composable: options.composable,
+            objective: objective(options),
         };
         let search_space = SearchSpace::default(processing_unit);
 
@@ -691,6 +753,12 @@ mod ffi {
             dag: &OperationDag,
         ) -> CircuitSolution;
 
+        #[namespace = "concrete_optimizer::utils"]
+        fn load_cpu_cost_profile(path: &str, profile: &mut u64) -> String;
+
+        #[namespace = "concrete_optimizer::utils"]
+        fn dump_cpu_cost_profile(profile: u64) -> String;
+
         type OperationDag;
 
         #[namespace = "concrete_optimizer::dag"]
@@ -741,6 +809,8 @@ mod ffi {
 
         fn dump(self: &OperationDag) -> String;
 
+        fn canonical_dump(self: &OperationDag) -> String;
+
         #[namespace = "concrete_optimizer::dag"]
         fn dump(self: &CircuitSolution) -> String;
 
@@ -822,6 +892,13 @@ mod ffi {
         ByPrecisionAndNorm2,
     }
 
+    #[derive(Debug, Clone, Copy)]
+    #[namespace = "concrete_optimizer"]
+    pub enum Objective {
+        TotalWork,
+        Latency,
+    }
+
     #[namespace = "concrete_optimizer"]
     #[derive(Debug, Clone, Copy)]
     pub struct Options {
@@ -836,6 +913,9 @@ mod ffi {
         pub ciphertext_modulus_log: u32,
         pub fft_precision: u32,
         pub composable: bool,
+        pub objective: Objective,
+        pub cores: u64,
+        pub cpu_cost_profile: u64,
     }
 
     #[namespace = "concrete_optimizer::dag"]
@@ -947,6 +1027,16 @@ mod ffi {
     }
 }
 
+fn objective(options: ffi::Options) -> Objective {
+    #[allow(clippy::wildcard_in_or_patterns)]
+    match options.objective {
+        ffi::Objective::Latency => Objective::Latency {
+            cores: options.cores,
+        },
+        ffi::Objective::TotalWork | _ => Objective::TotalWork,
+    }
+}
+
 fn processing_unit(options: ffi::Options) -> ProcessingUnit {
     if options.use_gpu_constraints {
         config::ProcessingUnit::Gpu {
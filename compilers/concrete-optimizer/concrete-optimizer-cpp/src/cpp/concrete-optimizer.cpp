@@ -945,6 +945,7 @@ namespace concrete_optimizer {
   struct Weights;
   enum class Encoding : ::std::uint8_t;
   enum class MultiParamStrategy : ::std::uint8_t;
+  enum class Objective : ::std::uint8_t;
   struct Options;
   namespace dag {
     struct OperatorIndex;
@@ -976,6 +977,7 @@ struct OperationDag final : public ::rust::Opaque {
   ::concrete_optimizer::dag::OperatorIndex add_unsafe_cast_op(::concrete_optimizer::dag::OperatorIndex input, ::std::uint8_t rounded_precision) noexcept;
   ::concrete_optimizer::dag::DagSolution optimize(::concrete_optimizer::Options options) const noexcept;
   ::rust::String dump() const noexcept;
+  ::rust::String canonical_dump() const noexcept;
   void tag_operator_as_output(::concrete_optimizer::dag::OperatorIndex op) noexcept;
   ::concrete_optimizer::dag::CircuitSolution optimize_multi(::concrete_optimizer::Options options) const noexcept;
   ~OperationDag() = delete;
@@ -1080,6 +1082,14 @@ enum class MultiParamStrategy : ::std::uint8_t {
 };
 #endif // CXXBRIDGE1_ENUM_concrete_optimizer$MultiParamStrategy
 
+#ifndef CXXBRIDGE1_ENUM_concrete_optimizer$Objective
+#define CXXBRIDGE1_ENUM_concrete_optimizer$Objective
+enum class Objective : ::std::uint8_t {
+  TotalWork = 0,
+  Latency = 1,
+};
+#endif // CXXBRIDGE1_ENUM_concrete_optimizer$Objective
+
 #ifndef CXXBRIDGE1_STRUCT_concrete_optimizer$Options
 #define CXXBRIDGE1_STRUCT_concrete_optimizer$Options
 struct Options final {
@@ -1094,6 +1104,9 @@ struct Options final {
   ::std::uint32_t ciphertext_modulus_log;
   ::std::uint32_t fft_precision;
   bool composable;
+  ::concrete_optimizer::Objective objective;
+  ::std::uint64_t cores;
+  ::std::uint64_t cpu_cost_profile;
 
   using IsRelocatable = ::std::true_type;
 };
@@ -1259,6 +1272,10 @@ extern "C" {
 void concrete_optimizer$utils$cxxbridge1$convert_to_dag_solution(::concrete_optimizer::v0::Solution const &solution, ::concrete_optimizer::dag::DagSolution *return$) noexcept;
 
 void concrete_optimizer$utils$cxxbridge1$convert_to_circuit_solution(::concrete_optimizer::dag::DagSolution const &solution, ::concrete_optimizer::OperationDag const &dag, ::concrete_optimizer::dag::CircuitSolution *return$) noexcept;
+
+void concrete_optimizer$utils$cxxbridge1$load_cpu_cost_profile(::rust::Str path, ::std::uint64_t &profile, ::rust::String *return$) noexcept;
+
+void concrete_optimizer$utils$cxxbridge1$dump_cpu_cost_profile(::std::uint64_t profile, ::rust::String *return$) noexcept;
 } // extern "C"
 } // namespace utils
 
@@ -1289,6 +1306,8 @@ extern "C" {
 void concrete_optimizer$cxxbridge1$OperationDag$optimize(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options options, ::concrete_optimizer::dag::DagSolution *return$) noexcept;
 
 void concrete_optimizer$cxxbridge1$OperationDag$dump(::concrete_optimizer::OperationDag const &self, ::rust::String *return$) noexcept;
+
+void concrete_optimizer$cxxbridge1$OperationDag$canonical_dump(::concrete_optimizer::OperationDag const &self, ::rust::String *return$) noexcept;
 } // extern "C"
 
 namespace dag {
@@ -1338,6 +1357,18 @@ namespace utils {
   concrete_optimizer$utils$cxxbridge1$convert_to_circuit_solution(solution, dag, &return$.value);
   return ::std::move(return$.value);
 }
+
+::rust::String load_cpu_cost_profile(::rust::Str path, ::std::uint64_t &profile) noexcept {
+  ::rust::MaybeUninit<::rust::String> return$;
+  concrete_optimizer$utils$cxxbridge1$load_cpu_cost_profile(path, profile, &return$.value);
+  return ::std::move(return$.value);
+}
+
+::rust::String dump_cpu_cost_profile(::std::uint64_t profile) noexcept {
+  ::rust::MaybeUninit<::rust::String> return$;
+  concrete_optimizer$utils$cxxbridge1$dump_cpu_cost_profile(profile, &return$.value);
+  return ::std::move(return$.value);
+}
 } // namespace utils
 
 ::std::size_t OperationDag::layout::size() noexcept {
@@ -1390,6 +1421,12 @@ namespace dag {
   return ::std::move(return$.value);
 }
 
+::rust::String OperationDag::canonical_dump() const noexcept {
+  ::rust::MaybeUninit<::rust::String> return$;
+  concrete_optimizer$cxxbridge1$OperationDag$canonical_dump(*this, &return$.value);
+  return ::std::move(return$.value);
+}
+
 namespace dag {
 ::rust::String CircuitSolution::dump() const noexcept {
   ::rust::MaybeUninit<::rust::String> return$;
@@ -926,6 +926,7 @@ namespace concrete_optimizer {
   struct Weights;
   enum class Encoding : ::std::uint8_t;
   enum class MultiParamStrategy : ::std::uint8_t;
+  enum class Objective : ::std::uint8_t;
   struct Options;
   namespace dag {
     struct OperatorIndex;
@@ -957,6 +958,7 @@ struct OperationDag final : public ::rust::Opaque {
   ::concrete_optimizer::dag::OperatorIndex add_unsafe_cast_op(::concrete_optimizer::dag::OperatorIndex input, ::std::uint8_t rounded_precision) noexcept;
   ::concrete_optimizer::dag::DagSolution optimize(::concrete_optimizer::Options options) const noexcept;
   ::rust::String dump() const noexcept;
+  ::rust::String canonical_dump() const noexcept;
   void tag_operator_as_output(::concrete_optimizer::dag::OperatorIndex op) noexcept;
   ::concrete_optimizer::dag::CircuitSolution optimize_multi(::concrete_optimizer::Options options) const noexcept;
   ~OperationDag() = delete;
@@ -1061,6 +1063,14 @@ enum class MultiParamStrategy : ::std::uint8_t {
 };
 #endif // CXXBRIDGE1_ENUM_concrete_optimizer$MultiParamStrategy
 
+#ifndef CXXBRIDGE1_ENUM_concrete_optimizer$Objective
+#define CXXBRIDGE1_ENUM_concrete_optimizer$Objective
+enum class Objective : ::std::uint8_t {
+  TotalWork = 0,
+  Latency = 1,
+};
+#endif // CXXBRIDGE1_ENUM_concrete_optimizer$Objective
+
 #ifndef CXXBRIDGE1_STRUCT_concrete_optimizer$Options
 #define CXXBRIDGE1_STRUCT_concrete_optimizer$Options
 struct Options final {
@@ -1075,6 +1085,9 @@ struct Options final {
   ::std::uint32_t ciphertext_modulus_log;
   ::std::uint32_t fft_precision;
   bool composable;
+  ::concrete_optimizer::Objective objective;
+  ::std::uint64_t cores;
+  ::std::uint64_t cpu_cost_profile;
 
   using IsRelocatable = ::std::true_type;
 };
@@ -1237,6 +1250,10 @@ namespace utils {
 ::concrete_optimizer::dag::DagSolution convert_to_dag_solution(::concrete_optimizer::v0::Solution const &solution) noexcept;
 
 ::concrete_optimizer::dag::CircuitSolution convert_to_circuit_solution(::concrete_optimizer::dag::DagSolution const &solution, ::concrete_optimizer::OperationDag const &dag) noexcept;
+
+::rust::String load_cpu_cost_profile(::rust::Str path, ::std::uint64_t &profile) noexcept;
+
+::rust::String dump_cpu_cost_profile(::std::uint64_t profile) noexcept;
 } // namespace utils
 
 namespace dag {
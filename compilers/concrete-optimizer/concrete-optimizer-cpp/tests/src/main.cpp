@@ -30,7 +30,10 @@ concrete_optimizer::Options default_options() {
       .cache_on_disk = true,
       .ciphertext_modulus_log = CIPHERTEXT_MODULUS_LOG,
       .fft_precision = 53,
-      .composable = false
+      .composable = false,
+      .objective = concrete_optimizer::Objective::TotalWork,
+      .cores = 1,
+      .cpu_cost_profile = 0
   };
 }
 
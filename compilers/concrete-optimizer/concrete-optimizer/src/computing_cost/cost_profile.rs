@@ -0,0 +1,268 @@
+use super::complexity::Complexity;
+use super::operators::keyswitch_lwe::KsComplexity;
+use super::operators::pbs::PbsComplexity;
+use crate::parameters::{
+    BrDecompositionParameters, GlweParameters, KeyswitchParameters, KsDecompositionParameters,
+    LweDimension, PbsParameters,
+};
+
+/// The measurements are done on 64 bits ciphertexts.
+const MEASURE_CIPHERTEXT_MODULUS_LOG: u32 = 64;
+
+/// Corrections of the analytical cpu complexity of the operators, measured on a given host.
+///
+/// A profile is built from the durations of bootstraps and keyswitches measured for a grid of
+/// parameters (see `concrete-cost-calibration`). For each measure, the ratio between the duration
+/// and the analytical complexity is computed, and normalized by the geometric mean of all the
+/// ratios, so that the corrected complexities stay in the unit of the analytical ones.
+/// The correction factor of an operator is the one measured for the closest size.
+#[derive(Clone, Debug, Default, PartialEq)]
+pub struct CostProfile {
+    /// Correction factors of the bootstraps, by polynomial size.
+    pub pbs: Vec<(u64, f64)>,
+    /// Correction factors of the keyswitches, by input lwe dimension.
+    pub ks: Vec<(u64, f64)>,
+}
+
+impl CostProfile {
+    /// Builds a profile from the durations of bootstraps and keyswitches.
+    pub fn from_measures(pbs: &[(PbsParameters, f64)], ks: &[(KeyswitchParameters, f64)]) -> Self {
+        let pbs_ratios: Vec<(u64, f64)> = pbs
+            .iter()
+            .map(|&(params, duration)| {
+                let complexity =
+                    PbsComplexity::default().complexity(params, MEASURE_CIPHERTEXT_MODULUS_LOG);
+                (
+                    params.output_glwe_params.polynomial_size(),
+                    duration / complexity,
+                )
+            })
+            .collect();
+        let ks_ratios: Vec<(u64, f64)> = ks
+            .iter()
+            .map(|&(params, duration)| {
+                let complexity = KsComplexity.complexity(params, MEASURE_CIPHERTEXT_MODULUS_LOG);
+                (params.input_lwe_dimension.0, duration / complexity)
+            })
+            .collect();
+        let all_ratios: Vec<f64> = pbs_ratios
+            .iter()
+            .chain(ks_ratios.iter())
+            .map(|&(_, ratio)| ratio)
+            .collect();
+        let norm = geometric_mean(&all_ratios);
+        Self {
+            pbs: factors_by_size(&pbs_ratios, norm),
+            ks: factors_by_size(&ks_ratios, norm),
+        }
+    }
+
+    /// Parses a profile file, made of one measure per line:
+    ///
+    /// `pbs <input_lwe_dimension> <glwe_dimension> <polynomial_size> <level> <log2_base> <duration>`
+    ///
+    /// `ks <input_lwe_dimension> <output_lwe_dimension> <level> <log2_base> <duration>`
+    ///
+    /// Empty lines and lines starting with `#` are ignored.
+    #[allow(clippy::cast_sign_loss, clippy::missing_errors_doc)]
+    pub fn parse(content: &str) -> Result<Self, String> {
+        let mut pbs = vec![];
+        let mut ks = vec![];
+        for (line_number, line) in content.lines().enumerate() {
+            let line = line.trim();
+            if line.is_empty() || line.starts_with('#') {
+                continue;
+            }
+            let error = || format!("line {}: invalid measure `{line}`", line_number + 1);
+            let fields: Vec<&str> = line.split_whitespace().collect();
+            let numbers: Vec<f64> = fields[1..]
+                .iter()
+                .map(|field| field.parse::<f64>())
+                .collect::<Result<_, _>>()
+                .map_err(|_| error())?;
+            if numbers
+                .iter()
+                .any(|number| !number.is_finite() || *number <= 0.0)
+            {
+                return Err(error());
+            }
+            match (fields[0], numbers.as_slice()) {
+                (
+                    "pbs",
+                    &[input_lwe_dimension, glwe_dimension, polynomial_size, level, log2_base, duration],
+                ) => {
+                    if !(polynomial_size as u64).is_power_of_two() {
+                        return Err(error());
+                    }
+                    let params = PbsParameters {
+                        internal_lwe_dimension: LweDimension(input_lwe_dimension as u64),
+                        br_decomposition_parameter: BrDecompositionParameters {
+                            level: level as u64,
+                            log2_base: log2_base as u64,
+                        },
+                        output_glwe_params: GlweParameters {
+                            log2_polynomial_size: (polynomial_size as u64).trailing_zeros() as u64,
+                            glwe_dimension: glwe_dimension as u64,
+                        },
+                    };
+                    pbs.push((params, duration));
+                }
+                (
+                    "ks",
+                    &[input_lwe_dimension, output_lwe_dimension, level, log2_base, duration],
+                ) => {
+                    let params = KeyswitchParameters {
+                        input_lwe_dimension: LweDimension(input_lwe_dimension as u64),
+                        output_lwe_dimension: LweDimension(output_lwe_dimension as u64),
+                        ks_decomposition_parameter: KsDecompositionParameters {
+                            level: level as u64,
+                            log2_base: log2_base as u64,
+                        },
+                    };
+                    ks.push((params, duration));
+                }
+                _ => return Err(error()),
+            }
+        }
+        Ok(Self::from_measures(&pbs, &ks))
+    }
+
+    /// Loads a profile file, see `parse`.
+    #[allow(clippy::missing_errors_doc)]
+    pub fn load(path: &str) -> Result<Self, String> {
+        let content = std::fs::read_to_string(path)
+            .map_err(|err| format!("cannot read cost profile {path}: {err}"))?;
+        Self::parse(&content).map_err(|err| format!("{path}: {err}"))
+    }
+
+    pub fn pbs_factor(&self, polynomial_size: u64) -> f64 {
+        closest_factor(&self.pbs, polynomial_size)
+    }
+
+    pub fn ks_factor(&self, input_lwe_dimension: u64) -> f64 {
+        closest_factor(&self.ks, input_lwe_dimension)
+    }
+
+    /// Returns the factors of the profile, one per line, printed in hexadecimal to be exact:
+    ///
+    /// `pbs <polynomial_size> <factor bits>` or `ks <input_lwe_dimension> <factor bits>`
+    pub fn dump(&self) -> String {
+        let pbs = self.pbs.iter().map(|factor| ("pbs", factor));
+        let ks = self.ks.iter().map(|factor| ("ks", factor));
+        pbs.chain(ks)
+            .map(|(kind, &(size, factor))| format!("{kind} {size} {:#x}\n", factor.to_bits()))
+            .collect()
+    }
+}
+
+fn geometric_mean(values: &[f64]) -> f64 {
+    if values.is_empty() {
+        return 1.0;
+    }
+    (values.iter().map(|value| value.ln()).sum::<f64>() / values.len() as f64).exp()
+}
+
+/// Returns the normalized geometric mean of the ratios of each size, sorted by size.
+fn factors_by_size(ratios: &[(u64, f64)], norm: Complexity) -> Vec<(u64, f64)> {
+    let mut sizes: Vec<u64> = ratios.iter().map(|&(size, _)| size).collect();
+    sizes.sort_unstable();
+    sizes.dedup();
+    sizes
+        .into_iter()
+        .map(|size| {
+            let size_ratios: Vec<f64> = ratios
+                .iter()
+                .filter(|&&(s, _)| s == size)
+                .map(|&(_, ratio)| ratio)
+                .collect();
+            (size, geometric_mean(&size_ratios) / norm)
+        })
+        .collect()
+}
+
+/// Returns the factor of the closest size in logarithmic scale, 1.0 without factors.
+fn closest_factor(factors: &[(u64, f64)], size: u64) -> f64 {
+    let log_distance = |s: u64| ((s.max(1) as f64).log2() - (size.max(1) as f64).log2()).abs();
+    factors
+        .iter()
+        .min_by(|&&(lhs, _), &&(rhs, _)| log_distance(lhs).total_cmp(&log_distance(rhs)))
+        .map_or(1.0, |&(_, factor)| factor)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn empty_profile_is_neutral() {
+        let profile = CostProfile::parse("# no measure\n\n").unwrap();
+        assert_eq!(profile, CostProfile::default());
+        approx::assert_relative_eq!(profile.pbs_factor(2048), 1.0);
+        approx::assert_relative_eq!(profile.ks_factor(2048), 1.0);
+    }
+
+    #[test]
+    fn factors_are_relative() {
+        let pbs = |polynomial_size: u64| PbsParameters {
+            internal_lwe_dimension: LweDimension(128),
+            br_decomposition_parameter: BrDecompositionParameters {
+                level: 1,
+                log2_base: 23,
+            },
+            output_glwe_params: GlweParameters {
+                log2_polynomial_size: polynomial_size.trailing_zeros() as u64,
+                glwe_dimension: 1,
+            },
+        };
+        let complexity = |polynomial_size: u64| {
+            PbsComplexity::default()
+                .complexity(pbs(polynomial_size), MEASURE_CIPHERTEXT_MODULUS_LOG)
+        };
+        // The large polynomials are twice as slow as modeled
+        let profile = CostProfile::from_measures(
+            &[
+                (pbs(1024), complexity(1024)),
+                (pbs(4096), 2.0 * complexity(4096)),
+            ],
+            &[],
+        );
+        approx::assert_relative_eq!(
+            profile.pbs_factor(4096) / profile.pbs_factor(1024),
+            2.0,
+            epsilon = 1e-9
+        );
+        // The closest size in logarithmic scale is used
+        approx::assert_relative_eq!(profile.pbs_factor(512), profile.pbs_factor(1024));
+        approx::assert_relative_eq!(profile.pbs_factor(8192), profile.pbs_factor(4096));
+    }
+
+    #[test]
+    fn parse_measures() {
+        let profile = CostProfile::parse(
+            "# kind parameters duration\n\
+             pbs 128 1 1024 1 23 1000\n\
+             ks 1024 512 3 4 2000\n",
+        )
+        .unwrap();
+        assert_eq!(profile.pbs.len(), 1);
+        assert_eq!(profile.ks.len(), 1);
+        assert!(CostProfile::parse("pbs 128 1 1000 1 23 1000").is_err());
+        assert!(CostProfile::parse("ks 1024 512 3 4").is_err());
+        assert!(CostProfile::parse("bs 1024 512 3 4 1000").is_err());
+    }
+
+    #[test]
+    fn dump_factors() {
+        let profile = CostProfile {
+            pbs: vec![(1024, 0.5), (4096, 2.0)],
+            ks: vec![(512, 1.0)],
+        };
+        assert_eq!(
+            profile.dump(),
+            "pbs 1024 0x3fe0000000000000\n\
+             pbs 4096 0x4000000000000000\n\
+             ks 512 0x3ff0000000000000\n"
+        );
+        assert_eq!(CostProfile::default().dump(), "");
+    }
+}
@@ -1,5 +1,8 @@
+use std::sync::Arc;
+
 use super::complexity::Complexity;
 use super::complexity_model::ComplexityModel;
+use super::cost_profile::CostProfile;
 use super::operators::keyswitch_lwe::KsComplexity;
 use super::operators::{keyswitch_lwe, multi_bit_pbs, pbs};
 use crate::computing_cost::operators::multi_bit_pbs::MultiBitPbsComplexity;
@@ -10,11 +13,28 @@ pub struct CpuComplexity {
     pub ks_lwe: keyswitch_lwe::KsComplexity,
     pub pbs: pbs::PbsComplexity,
     pub multi_bit_pbs: MultiBitPbsComplexity,
+    /// Measured corrections of the analytical complexities, if any.
+    pub profile: Option<Arc<CostProfile>>,
+}
+
+impl CpuComplexity {
+    fn pbs_factor(&self, polynomial_size: u64) -> f64 {
+        self.profile
+            .as_ref()
+            .map_or(1.0, |profile| profile.pbs_factor(polynomial_size))
+    }
+
+    fn ks_factor(&self, input_lwe_dimension: u64) -> f64 {
+        self.profile
+            .as_ref()
+            .map_or(1.0, |profile| profile.ks_factor(input_lwe_dimension))
+    }
 }
 
 impl ComplexityModel for CpuComplexity {
     fn pbs_complexity(&self, params: PbsParameters, ciphertext_modulus_log: u32) -> Complexity {
         self.pbs.complexity(params, ciphertext_modulus_log)
+            * self.pbs_factor(params.output_glwe_params.polynomial_size())
     }
     fn multi_bit_pbs_complexity(
         &self,
@@ -25,10 +45,12 @@ impl ComplexityModel for CpuComplexity {
     ) -> Complexity {
         self.multi_bit_pbs
             .complexity(params, ciphertext_modulus_log, grouping_factor, jit_fft)
+            * self.pbs_factor(params.output_glwe_params.polynomial_size())
     }
 
     fn cmux_complexity(&self, params: CmuxParameters, ciphertext_modulus_log: u32) -> Complexity {
         self.pbs.cmux.complexity(params, ciphertext_modulus_log)
+            * self.pbs_factor(params.output_glwe_params.polynomial_size())
     }
 
     fn ks_complexity(
@@ -37,6 +59,7 @@ impl ComplexityModel for CpuComplexity {
         ciphertext_modulus_log: u32,
     ) -> Complexity {
         self.ks_lwe.complexity(params, ciphertext_modulus_log)
+            * self.ks_factor(params.input_lwe_dimension.0)
     }
 
     fn fft_complexity(&self, glwe_polynomial_size: f64, ciphertext_modulus_log: u32) -> Complexity {
@@ -61,6 +84,7 @@ impl Default for CpuComplexity {
             ks_lwe: KsComplexity,
             pbs: pbs::PbsComplexity::default(),
             multi_bit_pbs: multi_bit_pbs::MultiBitPbsComplexity::default(),
+            profile: None,
         }
     }
 }
@@ -1,6 +1,7 @@
 mod atomic_pattern;
 pub mod complexity;
 pub mod complexity_model;
+pub mod cost_profile;
 pub mod cpu;
 mod fft;
 pub mod gpu;
@@ -153,6 +153,43 @@ impl OperationDag {
         acc
     }
 
+    /// Returns a dump of the operators and the outputs, without the contents of the lookup tables
+    /// nor the comments, which do not change the optimization.
+    pub fn canonical_dump(&self) -> String {
+        let mut acc = String::new();
+        let err_msg = "Optimizer: Can't dump OperationDag";
+        for (i, op) in self.operators.iter().enumerate() {
+            let op = match op {
+                Operator::Lut {
+                    input,
+                    out_precision,
+                    ..
+                } => Operator::Lut {
+                    input: *input,
+                    table: FunctionTable::UNKWOWN,
+                    out_precision: *out_precision,
+                },
+                Operator::LevelledOp {
+                    inputs,
+                    complexity,
+                    manp,
+                    out_shape,
+                    ..
+                } => Operator::LevelledOp {
+                    inputs: inputs.clone(),
+                    complexity: *complexity,
+                    manp: *manp,
+                    out_shape: out_shape.clone(),
+                    comment: String::new(),
+                },
+                op => op.clone(),
+            };
+            let output = if self.output_tags[i] { " (output)" } else { "" };
+            writeln!(acc, "%{i} <- {op:?}{output}").expect(err_msg);
+        }
+        acc
+    }
+
     fn add_shift_left_lsb_to_msb_no_padding(&mut self, input: OperatorIndex) -> OperatorIndex {
         // Convert any input to simple 1bit msb replacing the padding
         // For now encoding is not explicit, so 1 bit content without padding <=> 0 bit content with padding.
@@ -523,4 +560,24 @@ mod tests {
             assert_eq!(expected, actual, "{i}-th operation");
         }
     }
+
+    #[test]
+    fn test_canonical_dump() {
+        let circuit = |comment: &str, table: Vec<u64>| {
+            let mut graph = OperationDag::new();
+            let input = graph.add_input(2, Shape::vector(3));
+            let cpx_add = LevelledComplexity::ADDITION;
+            let sum = graph.add_levelled_op([input], cpx_add, 1.0, Shape::vector(3), comment);
+            let lut = graph.add_lut(sum, FunctionTable { values: table }, 2);
+            (graph, lut)
+        };
+        let (mut graph1, lut1) = circuit("add loc(\"a.py\":1:1)", vec![0, 1, 2, 3]);
+        let (mut graph2, lut2) = circuit("add loc(\"b.py\":7:3)", vec![3, 2, 1, 0]);
+        assert_ne!(graph1.dump(), graph2.dump());
+        assert_eq!(graph1.canonical_dump(), graph2.canonical_dump());
+        graph1.tag_operator_as_output(lut1);
+        assert_ne!(graph1.canonical_dump(), graph2.canonical_dump());
+        graph2.tag_operator_as_output(lut2);
+        assert_eq!(graph1.canonical_dump(), graph2.canonical_dump());
+    }
 }
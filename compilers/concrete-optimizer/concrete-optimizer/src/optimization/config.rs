@@ -10,6 +10,17 @@ pub struct NoiseBoundConfig {
     pub ciphertext_modulus_log: u32,
 }
 
+/// The cost minimized by the optimizer.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Objective {
+    /// The total complexity of the circuit, for batch workloads.
+    TotalWork,
+    /// A bound of the latency of the circuit on `cores` cores (Brent's theorem): the total
+    /// complexity divided by the number of cores, plus the complexity of the longest chain of
+    /// dependent lookup tables.
+    Latency { cores: u64 },
+}
+
 #[derive(Clone, Copy)]
 pub struct Config<'a> {
     pub security_level: u64,
@@ -19,6 +30,7 @@ pub struct Config<'a> {
     pub fft_precision: u32,
     pub complexity_model: &'a dyn ComplexityModel,
     pub composable: bool,
+    pub objective: Objective,
 }
 
 #[derive(Clone, Debug)]
@@ -41,6 +41,8 @@ pub struct AnalyzedDag {
     pub undominated_variance_constraints: Vec<VarianceConstraint>,
     pub operations_count_per_instrs: Vec<OperationsCount>,
     pub operations_count: OperationsCount,
+    // Operations of the longest chain of dependent lookup tables
+    pub critical_path_operations_count: OperationsCount,
     pub instruction_rewrite_index: Vec<Vec<OperatorIndex>>,
     pub p_cut: PartitionCut,
 }
@@ -94,6 +96,8 @@ pub fn analyze(
     let operations_count_per_instrs =
         collect_operations_count(&dag, nb_partitions, &instrs_partition);
     let operations_count = sum_operations_count(&operations_count_per_instrs);
+    let critical_path_operations_count =
+        critical_path_operations_count(&dag, nb_partitions, &operations_count_per_instrs);
     Ok(AnalyzedDag {
         operators: dag.operators,
         instruction_rewrite_index,
@@ -105,6 +109,7 @@ pub fn analyze(
         undominated_variance_constraints,
         operations_count_per_instrs,
         operations_count,
+        critical_path_operations_count,
         p_cut,
     })
 }
@@ -436,6 +441,38 @@ fn sum_operations_count(all_counts: &[OperationsCount]) -> OperationsCount {
     OperationsCount { counts: sum_counts }
 }
 
+/// Returns the operations of the longest chain of dependent lookup tables. The lookup tables of a
+/// tensor operator are independent, so each operator of the chain counts for a single one.
+fn critical_path_operations_count(
+    dag: &unparametrized::OperationDag,
+    nb_partitions: usize,
+    operations_count_per_instrs: &[OperationsCount],
+) -> OperationsCount {
+    // Length of the longest chain ending at each operator, and the input it continues
+    let mut chains: Vec<(u64, Option<usize>)> = Vec::with_capacity(dag.operators.len());
+    for op in &dag.operators {
+        let longest_input = op
+            .get_inputs_iter()
+            .map(|input| input.i)
+            .max_by_key(|&input| chains[input].0);
+        let is_lut = u64::from(matches!(op, Op::Lut { .. }));
+        let length = longest_input.map_or(0, |input| chains[input].0) + is_lut;
+        chains.push((length, longest_input));
+    }
+    let mut counts = OperationsValue::zero(nb_partitions);
+    let mut current = (0..chains.len()).max_by_key(|&i| chains[i].0);
+    while let Some(i) = current {
+        if let Op::Lut { input, .. } = &dag.operators[i] {
+            let nb_lut = dag.out_shapes[input.i].flat_size() as f64;
+            if nb_lut > 0.0 {
+                counts += operations_count_per_instrs[i].counts.clone() * (1.0 / nb_lut);
+            }
+        }
+        current = chains[i].1;
+    }
+    OperationsCount { counts }
+}
+
 #[cfg(test)]
 pub mod tests {
     use super::*;
@@ -1031,6 +1068,30 @@ pub mod tests {
         );
     }
 
+    #[test]
+    fn test_critical_path_complexity() {
+        let mut dag = unparametrized::OperationDag::new();
+        let input = dag.add_input(3, Shape::vector(4));
+        let lut1 = dag.add_lut(input, FunctionTable::UNKWOWN, 3);
+        let _lut2 = dag.add_lut(lut1, FunctionTable::UNKWOWN, 3);
+        let _lut3 = dag.add_lut(input, FunctionTable::UNKWOWN, 3);
+        dag.detect_outputs();
+        let dag = analyze(&dag);
+        assert_eq!(format!("{}", dag.operations_count), "12¢K[0] + 12¢Br[0]");
+        // The lookup tables of a tensor are independent
+        assert_eq!(
+            format!("{}", dag.critical_path_operations_count),
+            "2¢K[0] + 2¢Br[0]"
+        );
+    }
+
+    #[test]
+    fn test_critical_path_empty_dag() {
+        let dag = unparametrized::OperationDag::new();
+        let counts = critical_path_operations_count(&dag, 1, &[]);
+        assert_eq!(counts.counts.nb_partitions(), 1);
+    }
+
     #[test]
     fn test_high_partition_number() {
         let mut dag = unparametrized::OperationDag::new();
@@ -4,7 +4,7 @@ use concrete_cpu_noise_model::gaussian_noise::noise::modulus_switching::estimate
 use crate::dag::unparametrized;
 use crate::noise_estimator::error;
 use crate::optimization;
-use crate::optimization::config::{Config, NoiseBoundConfig, SearchSpace};
+use crate::optimization::config::{Config, NoiseBoundConfig, Objective, SearchSpace};
 use crate::optimization::dag::multi_parameters::analyze::{analyze, AnalyzedDag};
 use crate::optimization::dag::multi_parameters::fast_keyswitch;
 use crate::optimization::dag::multi_parameters::fast_keyswitch::FksComplexityNoise;
@@ -16,7 +16,7 @@ use crate::optimization::decomposition::keyswitch::KsComplexityNoise;
 use crate::optimization::decomposition::{cmux, keyswitch, DecompCaches, PersistDecompCaches};
 use crate::parameters::GlweParameters;
 
-use crate::optimization::dag::multi_parameters::complexity::Complexity;
+use crate::optimization::dag::multi_parameters::complexity::{Complexity, OperationsCount};
 use crate::optimization::dag::multi_parameters::feasible::Feasible;
 use crate::optimization::dag::multi_parameters::partition_cut::PartitionCut;
 use crate::optimization::dag::multi_parameters::partitions::PartitionIndex;
@@ -894,6 +894,18 @@ fn optimize_macro(
     best_parameters
 }
 
+/// Returns the operations whose complexity is minimized for `objective`.
+fn objective_operations_count(dag: &AnalyzedDag, objective: Objective) -> OperationsCount {
+    match objective {
+        Objective::TotalWork => dag.operations_count.clone(),
+        Objective::Latency { cores } => {
+            let mut counts = dag.operations_count.counts.clone() * (1.0 / cores.max(1) as f64);
+            counts += &dag.critical_path_operations_count.counts;
+            OperationsCount { counts }
+        }
+    }
+}
+
 fn cross_partition(nb_partitions: usize) -> impl Iterator<Item = (usize, usize)> {
     (0..nb_partitions).flat_map(move |a: usize| (0..nb_partitions).map(move |b: usize| (a, b)))
 }
@@ -924,7 +936,8 @@ pub fn optimize(
     let mut caches = persistent_caches.caches();
 
     let feasible = Feasible::of(&dag.variance_constraints, kappa, None).compressed();
-    let complexity = Complexity::of(&dag.operations_count).compressed();
+    let complexity =
+        Complexity::of(&objective_operations_count(&dag, config.objective)).compressed();
     let used_tlu_keyswitch = used_tlu_keyswitch(&dag);
     let used_conversion_keyswitch = used_conversion_keyswitch(&dag);
 
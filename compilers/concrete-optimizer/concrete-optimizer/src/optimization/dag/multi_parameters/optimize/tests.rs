@@ -42,6 +42,7 @@ fn default_config() -> Config<'static> {
         fft_precision: 53,
         complexity_model,
         composable: false,
+        objective: Objective::TotalWork,
     }
 }
 
@@ -664,6 +665,7 @@ fn test_big_secret_key_sharing() {
         fft_precision: 53,
         complexity_model: &CpuComplexity::default(),
         composable: false,
+        objective: Objective::TotalWork,
     };
     let config_no_sharing = Config {
         key_sharing: false,
@@ -715,6 +717,7 @@ fn test_big_and_small_secret_key() {
         fft_precision: 53,
         complexity_model: &CpuComplexity::default(),
         composable: false,
+        objective: Objective::TotalWork,
     };
     let config_no_sharing = Config {
         key_sharing: false,
@@ -845,3 +848,42 @@ fn test_maximal_multi() {
     // note: we have a 5% relative margin since dag complexity is slightly better than v0
     assert!(sol.complexity < 1.05 * (sol_ref.complexity / expected_speedup));
 }
+
+#[test]
+fn test_latency_objective() {
+    let mut dag = unparametrized::OperationDag::new();
+    let input1 = dag.add_input(4, Shape::vector(1024));
+    let lut1 = dag.add_lut(input1, FunctionTable::UNKWOWN, 4);
+    let _ = dag.add_lut(lut1, FunctionTable::UNKWOWN, 4);
+    dag.detect_outputs();
+    let total_work_config = default_config();
+    let latency_config = Config {
+        objective: Objective::Latency { cores: 64 },
+        ..total_work_config
+    };
+    let search_space = SearchSpace::default_cpu();
+    let total_work_sol = super::optimize(
+        &dag,
+        total_work_config,
+        &search_space,
+        &SHARED_CACHES,
+        &None,
+        1,
+    )
+    .unwrap()
+    .1;
+    let latency_sol = super::optimize(
+        &dag,
+        latency_config,
+        &search_space,
+        &SHARED_CACHES,
+        &None,
+        1,
+    )
+    .unwrap()
+    .1;
+    assert!(latency_sol.is_feasible);
+    // 2048/64 waves of lookup tables plus the 2 of the critical path, instead of 2048
+    let expected_latency = (2048.0 / 64.0 + 2.0) / 2048.0 * total_work_sol.complexity;
+    assert!(latency_sol.complexity <= 1.01 * expected_latency);
+}